@@ -128,6 +128,11 @@ void z_arch_sched_ipi(void)
 	}
 }
 
+void z_arch_sched_ipi_cpu(int cpu)
+{
+	z_arc_connect_ici_generate(cpu);
+}
+
 static int arc_smp_init(struct device *dev)
 {
 	ARG_UNUSED(dev);
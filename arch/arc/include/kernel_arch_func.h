@@ -79,6 +79,7 @@ extern void z_arch_switch(void *switch_to, void **switched_from);
 extern void z_arc_fatal_error(unsigned int reason, const z_arch_esf_t *esf);
 
 extern void z_arch_sched_ipi(void);
+extern void z_arch_sched_ipi_cpu(int cpu);
 
 #ifdef __cplusplus
 }
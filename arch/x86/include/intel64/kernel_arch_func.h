@@ -48,6 +48,14 @@ static inline void z_arch_sched_ipi(void)
 	z_loapic_ipi(0, LOAPIC_ICR_IPI_OTHERS, CONFIG_SCHED_IPI_VECTOR);
 }
 
+extern u8_t x86_cpu_loapics[];
+
+static inline void z_arch_sched_ipi_cpu(int cpu)
+{
+	z_loapic_ipi(x86_cpu_loapics[cpu], LOAPIC_ICR_IPI_SPECIFIC,
+		     CONFIG_SCHED_IPI_VECTOR);
+}
+
 #endif
 
 
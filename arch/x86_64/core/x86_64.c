@@ -141,6 +141,18 @@ void z_arch_sched_ipi(void)
 	};
 }
 
+void z_arch_sched_ipi_cpu(int cpu)
+{
+	/* xuk brings CPUs up with APIC IDs equal to their index */
+	_apic.ICR_HI = (struct apic_icr_hi) {
+		.destination = cpu,
+	};
+	_apic.ICR_LO = (struct apic_icr_lo) {
+		.delivery_mode = FIXED,
+		.vector = SCHED_IPI_VECTOR,
+	};
+}
+
 
 /* Called from xuk layer on actual CPU start */
 void z_cpu_start(int cpu)
@@ -112,5 +112,6 @@ extern int x86_64_except_reason;
 	} while (false)
 
 void z_arch_sched_ipi(void);
+void z_arch_sched_ipi_cpu(int cpu);
 
 #endif /* _KERNEL_ARCH_FUNC_H */
@@ -175,6 +175,36 @@ static void update_gptp(struct net_if *iface, struct net_pkt *pkt,
 #define update_gptp(iface, pkt, send)
 #endif /* CONFIG_NET_GPTP */
 
+#if defined(CONFIG_ETH_NATIVE_POSIX_TX_OFFLOAD)
+static int eth_write_frame(u8_t *frame, size_t len, void *user_data)
+{
+	struct eth_context *ctx = user_data;
+	int ret;
+
+	ret = eth_write_data(ctx->dev_fd, frame, len);
+
+	return ret < 0 ? ret : 0;
+}
+
+static int eth_send(struct device *dev, struct net_pkt *pkt)
+{
+	struct eth_context *ctx = dev->driver_data;
+	int ret;
+
+	update_gptp(net_pkt_iface(pkt), pkt, true);
+
+	LOG_DBG("Send pkt %p len %zd mss %u", pkt, net_pkt_get_len(pkt),
+		net_pkt_tso_mss(pkt));
+
+	ret = net_eth_tx_offload(pkt, ctx->send, sizeof(ctx->send),
+				 eth_write_frame, ctx);
+	if (ret < 0) {
+		LOG_DBG("Cannot send pkt %p (%d)", pkt, ret);
+	}
+
+	return ret;
+}
+#else
 static int eth_send(struct device *dev, struct net_pkt *pkt)
 {
 	struct eth_context *ctx = dev->driver_data;
@@ -197,6 +227,7 @@ static int eth_send(struct device *dev, struct net_pkt *pkt)
 
 	return ret < 0 ? ret : 0;
 }
+#endif /* CONFIG_ETH_NATIVE_POSIX_TX_OFFLOAD */
 
 static int eth_init(struct device *dev)
 {
@@ -473,6 +504,10 @@ enum ethernet_hw_caps eth_posix_native_get_capabilities(struct device *dev)
 #endif
 #if defined(CONFIG_NET_LLDP)
 		| ETHERNET_LLDP
+#endif
+#if defined(CONFIG_ETH_NATIVE_POSIX_TX_OFFLOAD)
+		| ETHERNET_HW_TX_CHKSUM_OFFLOAD
+		| ETHERNET_HW_TX_TSO
 #endif
 		;
 }
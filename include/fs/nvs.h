@@ -30,6 +30,32 @@ extern "C" {
  * @{
  */
 
+/**
+ * @brief Non-volatile Storage garbage collection counters
+ *
+ * @param write_bytes Bytes written by nvs_write(), allocation table entries
+ * included
+ * @param gc_bytes Bytes copied by garbage collection, allocation table
+ * entries included. The write amplification is
+ * (write_bytes + gc_bytes) / write_bytes.
+ * @param gc_sectors Sectors garbage collected
+ * @param gc_write_sectors Sectors garbage collected, entirely or partly, by
+ * a write or at initialization, because background garbage collection had
+ * not freed them
+ * @param free_sectors Sectors erased by background garbage collection, or
+ * found blank at initialization, ahead of the sector written
+ * @param gc_ates Allocation table entries done in the sector that background
+ * garbage collection is working on
+ */
+struct nvs_gc_stats {
+	u32_t write_bytes;
+	u32_t gc_bytes;
+	u32_t gc_sectors;
+	u32_t gc_write_sectors;
+	u16_t free_sectors;
+	u16_t gc_ates;
+};
+
 /**
  * @brief Non-volatile Storage File system structure
  *
@@ -43,6 +69,17 @@ extern "C" {
  * @param write_block_size Alignment size
  * @param nvs_lock Mutex
  * @param flash_device Flash Device
+ * @param lookup_cache Address of the latest entry of each cached id
+ * @param lookup_cache_id Cached ids
+ * @param lookup_cache_full Some ids did not fit in the lookup cache
+ * @param gc_work Background garbage collection work item
+ * @param gc_addr Next allocation table entry to collect in background
+ * @param gc_free Sectors erased in background, or found blank at
+ * initialization, ahead of the sector written
+ * @param gc_ates Allocation table entries collected in background in the
+ * sector being collected
+ * @param gc_blocked Background garbage collection waits for a sector close
+ * @param gc_stats Garbage collection counters
  */
 struct nvs_fs {
 	off_t offset;		/* filesystem offset in flash */
@@ -57,6 +94,22 @@ struct nvs_fs {
 
 	struct k_mutex nvs_lock;
 	struct device *flash_device;
+#if defined(CONFIG_NVS_LOOKUP_CACHE)
+	u32_t lookup_cache[CONFIG_NVS_LOOKUP_CACHE_SIZE];
+	u16_t lookup_cache_id[CONFIG_NVS_LOOKUP_CACHE_SIZE];
+	bool lookup_cache_full;
+#endif
+#if defined(CONFIG_NVS_GC_BACKGROUND)
+	struct k_work gc_work;
+	bool gc_init;		/* nvs_lock and gc_work are initialized */
+	u32_t gc_addr;
+	u16_t gc_free;
+	u16_t gc_ates;
+	bool gc_blocked;
+#endif
+#if defined(CONFIG_NVS_GC_STATS)
+	struct nvs_gc_stats gc_stats;
+#endif
 };
 
 /**
@@ -170,6 +223,18 @@ ssize_t nvs_read_hist(struct nvs_fs *fs, u16_t id, void *data, size_t len,
  */
 ssize_t nvs_calc_free_space(struct nvs_fs *fs);
 
+/**
+ * @brief nvs_gc_stats_get
+ *
+ * Get the garbage collection counters of the file system.
+ *
+ * @param fs Pointer to file system
+ * @param stats Pointer to the counters to fill in
+ * @retval 0 Success
+ * @retval -ERRNO errno code if error
+ */
+int nvs_gc_stats_get(struct nvs_fs *fs, struct nvs_gc_stats *stats);
+
 /**
  * @}
  */
@@ -455,6 +455,11 @@ struct _thread_base {
 	/* CPU index on which thread was last run */
 	u8_t cpu;
 
+#ifdef CONFIG_SCHED_CPU_RUNQ
+	/* CPU index whose run queue holds the thread while queued */
+	u8_t runq_cpu;
+#endif
+
 	/* Recursive count of irq_lock() calls */
 	u8_t global_lock_count;
 
@@ -2680,6 +2685,34 @@ __syscall int k_stack_pop(struct k_stack *stack, stack_data_t *data, s32_t timeo
 
 /** @} */
 
+/**
+ * @cond INTERNAL_HIDDEN
+ */
+
+struct k_sem {
+	_wait_q_t wait_q;
+	u32_t count;
+	u32_t limit;
+	_POLL_EVENT;
+
+	_OBJECT_TRACING_NEXT_PTR(k_sem)
+};
+
+#define Z_SEM_INITIALIZER(obj, initial_count, count_limit) \
+	{ \
+	.wait_q = Z_WAIT_Q_INIT(&obj.wait_q), \
+	.count = initial_count, \
+	.limit = count_limit, \
+	_POLL_EVENT_OBJ_INIT(obj) \
+	_OBJECT_TRACING_INIT \
+	}
+
+#define K_SEM_INITIALIZER DEPRECATED_MACRO Z_SEM_INITIALIZER
+
+/**
+ * INTERNAL_HIDDEN @endcond
+ */
+
 struct k_work;
 struct k_work_poll;
 
@@ -2717,6 +2750,12 @@ typedef void (*k_work_handler_t)(struct k_work *work);
 struct k_work_q {
 	struct k_queue queue;
 	struct k_thread thread;
+#if CONFIG_WORKQUEUE_LANES > 1
+	/* Lanes 1 and up, lane 0 is the queue above */
+	struct k_queue lanes[CONFIG_WORKQUEUE_LANES - 1];
+	/* One count per item submitted to any lane */
+	struct k_sem ready;
+#endif
 };
 
 enum {
@@ -2727,6 +2766,9 @@ struct k_work {
 	void *_reserved;		/* Used by k_queue implementation. */
 	k_work_handler_t handler;
 	atomic_t flags[1];
+#if CONFIG_WORKQUEUE_LANES > 1
+	u8_t lane;
+#endif
 };
 
 struct k_delayed_work {
@@ -2747,6 +2789,26 @@ struct k_work_poll {
 
 extern struct k_work_q k_sys_work_q;
 
+static inline struct k_queue *z_work_q_lane(struct k_work_q *work_q,
+					    struct k_work *work)
+{
+#if CONFIG_WORKQUEUE_LANES > 1
+	if (work->lane != 0U) {
+		return &work_q->lanes[work->lane - 1U];
+	}
+#endif
+	return &work_q->queue;
+}
+
+#if CONFIG_WORKQUEUE_LANES > 1
+extern void z_work_q_ready(struct k_work_q *work_q);
+#else
+static inline void z_work_q_ready(struct k_work_q *work_q)
+{
+	ARG_UNUSED(work_q);
+}
+#endif
+
 /**
  * INTERNAL_HIDDEN @endcond
  */
@@ -2791,6 +2853,35 @@ static inline void k_work_init(struct k_work *work, k_work_handler_t handler)
 	*work = (struct k_work)Z_WORK_INITIALIZER(handler);
 }
 
+/**
+ * @brief Set the priority lane of a work item.
+ *
+ * A workqueue keeps one queue per lane, and its threads always take the
+ * oldest item of the highest non-empty lane.  Work items start out in
+ * lane 0, the lowest one.  The number of lanes is set by
+ * :option:`CONFIG_WORKQUEUE_LANES`; with a single lane this routine has
+ * no effect.
+ *
+ * The lane applies to every later submission of the work item, whether
+ * direct or through a delayed or triggered work item embedding it.  It
+ * must not be changed while the work item is pending.
+ *
+ * @param work Address of work item.
+ * @param lane Lane, below CONFIG_WORKQUEUE_LANES.
+ *
+ * @return N/A
+ */
+static inline void k_work_lane_set(struct k_work *work, unsigned int lane)
+{
+	__ASSERT(lane < CONFIG_WORKQUEUE_LANES, "invalid lane %u", lane);
+#if CONFIG_WORKQUEUE_LANES > 1
+	work->lane = lane;
+#else
+	ARG_UNUSED(work);
+	ARG_UNUSED(lane);
+#endif
+}
+
 /**
  * @brief Submit a work item.
  *
@@ -2817,7 +2908,8 @@ static inline void k_work_submit_to_queue(struct k_work_q *work_q,
 					  struct k_work *work)
 {
 	if (!atomic_test_and_set_bit(work->flags, K_WORK_STATE_PENDING)) {
-		k_queue_append(&work_q->queue, work);
+		k_queue_append(z_work_q_lane(work_q, work), work);
+		z_work_q_ready(work_q);
 	}
 }
 
@@ -2828,7 +2920,8 @@ static inline void k_work_submit_to_queue(struct k_work_q *work_q,
  * memory allocation is made from the caller's resource pool which is freed
  * once the worker thread consumes the k_work item. The workqueue
  * thread must have memory access to the k_work item being submitted. The caller
- * must have permission granted on the work_q parameter's queue object.
+ * must have permission granted on the work_q parameter's queue object, and
+ * with several priority lanes on its lane queues and ready semaphore as well.
  *
  * Otherwise this works the same as k_work_submit_to_queue().
  *
@@ -2848,13 +2941,15 @@ static inline int k_work_submit_to_user_queue(struct k_work_q *work_q,
 	int ret = -EBUSY;
 
 	if (!atomic_test_and_set_bit(work->flags, K_WORK_STATE_PENDING)) {
-		ret = k_queue_alloc_append(&work_q->queue, work);
+		ret = k_queue_alloc_append(z_work_q_lane(work_q, work), work);
 
 		/* Couldn't insert into the queue. Clear the pending bit
 		 * so the work item can be submitted again
 		 */
 		if (ret != 0) {
 			atomic_clear_bit(work->flags, K_WORK_STATE_PENDING);
+		} else {
+			z_work_q_ready(work_q);
 		}
 	}
 
@@ -2900,6 +2995,41 @@ extern void k_work_q_start(struct k_work_q *work_q,
 			   k_thread_stack_t *stack,
 			   size_t stack_size, int prio);
 
+/**
+ * @brief Add a thread to a workqueue.
+ *
+ * This routine spawns one more thread processing the work items of
+ * workqueue @a work_q, which must have been started already.  Work items
+ * are handed to whichever thread is free first, so a handler that blocks
+ * only holds up its own thread.  Handlers of different work items may then
+ * run at the same time, and a work item resubmitted while its handler runs
+ * may be processed again by another thread before the first call returns.
+ *
+ * The thread can be pinned to a CPU, which needs
+ * :option:`CONFIG_SCHED_CPU_MASK`.
+ *
+ * If @a work_q was started with k_work_q_user_start(), the new thread
+ * runs in user mode as well.  Like the first thread, it inherits the
+ * object permissions and memory domain of the caller, and is granted
+ * access to the workqueue's own objects.
+ *
+ * @param work_q Address of workqueue.
+ * @param thread Thread object for the new thread.
+ * @param stack Pointer to the thread's stack space, as defined by
+ *		K_THREAD_STACK_DEFINE()
+ * @param stack_size Size of the thread's stack (in bytes).
+ * @param prio Priority of the thread.
+ * @param cpu CPU to run the thread on, or -1 to let it run on any CPU.
+ *
+ * @retval 0 Thread started.
+ * @retval -EINVAL @a cpu is not a valid CPU index.
+ * @retval -ENOTSUP CPU pinning is not supported by the configuration.
+ */
+extern int k_work_q_thread_add(struct k_work_q *work_q,
+			       struct k_thread *thread,
+			       k_thread_stack_t *stack,
+			       size_t stack_size, int prio, int cpu);
+
 /**
  * @brief Start a workqueue in user mode
  *
@@ -3296,34 +3426,6 @@ __syscall void k_mutex_unlock(struct k_mutex *mutex);
  * @}
  */
 
-/**
- * @cond INTERNAL_HIDDEN
- */
-
-struct k_sem {
-	_wait_q_t wait_q;
-	u32_t count;
-	u32_t limit;
-	_POLL_EVENT;
-
-	_OBJECT_TRACING_NEXT_PTR(k_sem)
-};
-
-#define Z_SEM_INITIALIZER(obj, initial_count, count_limit) \
-	{ \
-	.wait_q = Z_WAIT_Q_INIT(&obj.wait_q), \
-	.count = initial_count, \
-	.limit = count_limit, \
-	_POLL_EVENT_OBJ_INIT(obj) \
-	_OBJECT_TRACING_INIT \
-	}
-
-#define K_SEM_INITIALIZER DEPRECATED_MACRO Z_SEM_INITIALIZER
-
-/**
- * INTERNAL_HIDDEN @endcond
- */
-
 /**
  * @defgroup semaphore_apis Semaphore APIs
  * @ingroup kernel_apis
@@ -3466,6 +3568,17 @@ struct k_msgq {
 
 	_OBJECT_TRACING_NEXT_PTR(k_msgq)
 	u8_t flags;
+
+#ifdef CONFIG_MSGQ_LOCKFREE
+	/* Lock-free mode only: free-running message indices, the
+	 * blocked-waiter hint and, for multiple producers, the
+	 * per-slot publication sequence.
+	 */
+	atomic_t lf_head;
+	atomic_t lf_tail;
+	atomic_t lf_waiters;
+	atomic_t *lf_seq;
+#endif
 };
 /**
  * @cond INTERNAL_HIDDEN
@@ -3485,12 +3598,29 @@ struct k_msgq {
 	_OBJECT_TRACING_INIT \
 	}
 #define K_MSGQ_INITIALIZER DEPRECATED_MACRO _K_MSGQ_INITIALIZER
+
+#define Z_MSGQ_LOCKFREE_INITIALIZER(obj, q_buffer, q_msg_size, q_max_msgs, \
+				    q_seq) \
+	{ \
+	.wait_q = Z_WAIT_Q_INIT(&obj.wait_q), \
+	.msg_size = q_msg_size, \
+	.max_msgs = q_max_msgs, \
+	.buffer_start = q_buffer, \
+	.buffer_end = q_buffer + (q_max_msgs * q_msg_size), \
+	.read_ptr = q_buffer, \
+	.write_ptr = q_buffer, \
+	.used_msgs = 0, \
+	_OBJECT_TRACING_INIT \
+	.flags = K_MSGQ_FLAG_LOCKFREE, \
+	.lf_seq = q_seq, \
+	}
 /**
  * INTERNAL_HIDDEN @endcond
  */
 
 
 #define K_MSGQ_FLAG_ALLOC	BIT(0)
+#define K_MSGQ_FLAG_LOCKFREE	BIT(1)
 
 /**
  * @brief Message Queue Attributes
@@ -3530,6 +3660,52 @@ struct k_msgq_attrs {
 	       _K_MSGQ_INITIALIZER(q_name, _k_fifo_buf_##q_name,	\
 				  q_msg_size, q_max_msgs)
 
+#ifdef CONFIG_MSGQ_LOCKFREE
+/**
+ * @brief Statically define a lock-free single-producer message queue.
+ *
+ * Like K_MSGQ_DEFINE(), but the queue runs in lock-free mode (see
+ * k_msgq_lockfree_init()) for exactly one producer context and one
+ * consumer context. @a q_max_msgs must be a power of 2.
+ *
+ * @param q_name Name of the message queue.
+ * @param q_msg_size Message size (in bytes).
+ * @param q_max_msgs Maximum number of messages that can be queued.
+ * @param q_align Alignment of the message queue's ring buffer.
+ */
+#define K_MSGQ_DEFINE_SPSC(q_name, q_msg_size, q_max_msgs, q_align)	\
+	static char __noinit __aligned(q_align)				\
+		_k_fifo_buf_##q_name[(q_max_msgs) * (q_msg_size)];	\
+	Z_STRUCT_SECTION_ITERABLE(k_msgq, q_name) =			\
+	       Z_MSGQ_LOCKFREE_INITIALIZER(q_name, _k_fifo_buf_##q_name, \
+					   q_msg_size, q_max_msgs, NULL); \
+	BUILD_ASSERT(((q_max_msgs) != 0) &&				\
+		     (((q_max_msgs) & ((q_max_msgs) - 1)) == 0))
+
+/**
+ * @brief Statically define a lock-free multi-producer message queue.
+ *
+ * Like K_MSGQ_DEFINE_SPSC(), but any number of threads and ISRs may
+ * send to the queue concurrently. There must still be only one
+ * consumer context. @a q_max_msgs must be a power of 2.
+ *
+ * @param q_name Name of the message queue.
+ * @param q_msg_size Message size (in bytes).
+ * @param q_max_msgs Maximum number of messages that can be queued.
+ * @param q_align Alignment of the message queue's ring buffer.
+ */
+#define K_MSGQ_DEFINE_MPSC(q_name, q_msg_size, q_max_msgs, q_align)	\
+	static char __noinit __aligned(q_align)				\
+		_k_fifo_buf_##q_name[(q_max_msgs) * (q_msg_size)];	\
+	static atomic_t _k_msgq_seq_##q_name[q_max_msgs];		\
+	Z_STRUCT_SECTION_ITERABLE(k_msgq, q_name) =			\
+	       Z_MSGQ_LOCKFREE_INITIALIZER(q_name, _k_fifo_buf_##q_name, \
+					   q_msg_size, q_max_msgs,	\
+					   _k_msgq_seq_##q_name); \
+	BUILD_ASSERT(((q_max_msgs) != 0) &&				\
+		     (((q_max_msgs) & ((q_max_msgs) - 1)) == 0))
+#endif /* CONFIG_MSGQ_LOCKFREE */
+
 /**
  * @brief Initialize a message queue.
  *
@@ -3576,6 +3752,40 @@ __syscall int k_msgq_alloc_init(struct k_msgq *q, size_t msg_size,
 				u32_t max_msgs);
 
 
+#ifdef CONFIG_MSGQ_LOCKFREE
+/**
+ * @brief Initialize a message queue in lock-free mode.
+ *
+ * This routine initializes a message queue like k_msgq_init(), but
+ * puts it in lock-free mode. Senders and the receiver then exchange
+ * messages through atomic ring buffer indices, without taking the
+ * queue's spinlock, and only enter the scheduler when a caller has to
+ * block on an empty or full queue, or has to wake a blocked one.
+ *
+ * All message queue APIs remain available, with these restrictions:
+ *
+ * - Only one context at a time may receive from the queue, i.e. call
+ *   k_msgq_get(), k_msgq_get_many(), k_msgq_peek() or k_msgq_purge().
+ * - If @a seq is NULL, only one context at a time may send to the
+ *   queue. Otherwise any number of threads and ISRs may send
+ *   concurrently, and @a seq must point to @a max_msgs zero-initialized
+ *   entries of private storage.
+ * - @a max_msgs must be a power of 2.
+ * - Senders blocked on a full queue are not served in FIFO order.
+ *
+ * @param q Address of the message queue.
+ * @param buffer Pointer to ring buffer that holds queued messages.
+ * @param msg_size Message size (in bytes).
+ * @param max_msgs Maximum number of messages that can be queued.
+ * @param seq Slot sequence storage for multiple producers, or NULL.
+ *
+ * @retval 0 Message queue initialized.
+ * @retval -EINVAL @a max_msgs is not a power of 2.
+ */
+int k_msgq_lockfree_init(struct k_msgq *q, char *buffer, size_t msg_size,
+			 u32_t max_msgs, atomic_t *seq);
+#endif /* CONFIG_MSGQ_LOCKFREE */
+
 void k_msgq_cleanup(struct k_msgq *q);
 
 /**
@@ -3617,6 +3827,56 @@ __syscall int k_msgq_put(struct k_msgq *q, void *data, s32_t timeout);
  */
 __syscall int k_msgq_get(struct k_msgq *q, void *data, s32_t timeout);
 
+/**
+ * @brief Send several messages to a message queue.
+ *
+ * This routine sends up to @a num messages, stored back to back at
+ * @a data, to message queue @a q. It waits up to @a timeout for room
+ * for the first message, then sends as many messages as fit without
+ * waiting any further.
+ *
+ * @note Can be called by ISRs, but @a timeout must be set to K_NO_WAIT.
+ *
+ * @param q Address of the message queue.
+ * @param data Pointer to the messages.
+ * @param num Number of messages at @a data.
+ * @param timeout Waiting period to add the first message (in
+ *                milliseconds), or one of the special values K_NO_WAIT
+ *                and K_FOREVER.
+ *
+ * @return Number of messages sent (at least 1) on success.
+ * @retval -ENOMSG Returned without waiting or queue purged.
+ * @retval -EAGAIN Waiting period timed out.
+ * @retval -EINVAL @a num is zero.
+ */
+__syscall int k_msgq_put_many(struct k_msgq *q, const void *data, u32_t num,
+			      s32_t timeout);
+
+/**
+ * @brief Receive several messages from a message queue.
+ *
+ * This routine receives up to @a num messages from message queue @a q
+ * into @a data, back to back. It waits up to @a timeout for the first
+ * message, then receives whatever else is queued without waiting any
+ * further.
+ *
+ * @note Can be called by ISRs, but @a timeout must be set to K_NO_WAIT.
+ *
+ * @param q Address of the message queue.
+ * @param data Address of area to hold @a num received messages.
+ * @param num Maximum number of messages to receive.
+ * @param timeout Waiting period to receive the first message (in
+ *                milliseconds), or one of the special values K_NO_WAIT
+ *                and K_FOREVER.
+ *
+ * @return Number of messages received (at least 1) on success.
+ * @retval -ENOMSG Returned without waiting.
+ * @retval -EAGAIN Waiting period timed out.
+ * @retval -EINVAL @a num is zero.
+ */
+__syscall int k_msgq_get_many(struct k_msgq *q, void *data, u32_t num,
+			      s32_t timeout);
+
 /**
  * @brief Peek/read a message from a message queue.
  *
@@ -3675,9 +3935,22 @@ __syscall u32_t k_msgq_num_free_get(struct k_msgq *q);
 __syscall void  k_msgq_get_attrs(struct k_msgq *q, struct k_msgq_attrs *attrs);
 
 
+static inline u32_t z_msgq_used(struct k_msgq *q)
+{
+#ifdef CONFIG_MSGQ_LOCKFREE
+	if ((q->flags & K_MSGQ_FLAG_LOCKFREE) != 0U) {
+		/* Tail first, so a racing consumer can't pass head */
+		u32_t tail = (u32_t)atomic_get(&q->lf_tail);
+
+		return (u32_t)atomic_get(&q->lf_head) - tail;
+	}
+#endif
+	return q->used_msgs;
+}
+
 static inline u32_t z_impl_k_msgq_num_free_get(struct k_msgq *q)
 {
-	return q->max_msgs - q->used_msgs;
+	return q->max_msgs - z_msgq_used(q);
 }
 
 /**
@@ -3694,7 +3967,7 @@ __syscall u32_t k_msgq_num_used_get(struct k_msgq *q);
 
 static inline u32_t z_impl_k_msgq_num_used_get(struct k_msgq *q)
 {
-	return q->used_msgs;
+	return z_msgq_used(q);
 }
 
 /** @} */
@@ -4106,12 +4379,112 @@ __syscall int k_pipe_get(struct k_pipe *pipe, void *data,
 extern void k_pipe_block_put(struct k_pipe *pipe, struct k_mem_block *block,
 			     size_t size, struct k_sem *sem);
 
+/**
+ * @brief Claim pipe buffer space for writing in place.
+ *
+ * This routine returns a pointer to, and the size of, the largest
+ * contiguous free region at the write end of the pipe's ring buffer, up to
+ * @a size bytes. The caller fills it in place and then publishes the data
+ * with k_pipe_put_commit(), which also hands it to any waiting readers.
+ * Several claim/commit rounds may be needed when the free space wraps
+ * around the end of the buffer. This routine never waits.
+ *
+ * @warning
+ * From the claim until the matching commit, the caller must be the only
+ * writer to the pipe: no other thread may call k_pipe_put(),
+ * k_pipe_block_put() or k_pipe_put_claim() on it.
+ *
+ * @param pipe Address of the pipe.
+ * @param data Address of area to hold a pointer into the pipe's buffer.
+ * @param size Maximum number of bytes to claim.
+ *
+ * @return Number of bytes claimed, which is 0 if the pipe is full or has
+ *         no buffer.
+ */
+size_t k_pipe_put_claim(struct k_pipe *pipe, u8_t **data, size_t size);
+
+/**
+ * @brief Publish data written in place into a pipe.
+ *
+ * This routine appends the first @a size bytes of the region obtained
+ * from k_pipe_put_claim() to the pipe, and releases the claim. Waiting
+ * readers are served from the new data and woken with a single
+ * reschedule.
+ *
+ * @param pipe Address of the pipe.
+ * @param size Number of bytes written, at most the claimed size.
+ *
+ * @retval 0 Data published.
+ * @retval -EINVAL @a size exceeds the free space of the pipe.
+ */
+int k_pipe_put_commit(struct k_pipe *pipe, size_t size);
+
+/**
+ * @brief Claim pipe data for reading in place.
+ *
+ * This routine returns a pointer to, and the size of, the largest
+ * contiguous run of data at the read end of the pipe's ring buffer, up to
+ * @a size bytes. The caller consumes it in place and then releases it
+ * with k_pipe_get_commit(), which also lets any waiting writers refill
+ * the space. Several claim/commit rounds may be needed when the data
+ * wraps around the end of the buffer. This routine never waits.
+ *
+ * @warning
+ * From the claim until the matching commit, the caller must be the only
+ * reader of the pipe: no other thread may call k_pipe_get() or
+ * k_pipe_get_claim() on it.
+ *
+ * @param pipe Address of the pipe.
+ * @param data Address of area to hold a pointer into the pipe's buffer.
+ * @param size Maximum number of bytes to claim.
+ *
+ * @return Number of bytes claimed, which is 0 if the pipe's buffer is
+ *         empty.
+ */
+size_t k_pipe_get_claim(struct k_pipe *pipe, u8_t **data, size_t size);
+
+/**
+ * @brief Release data read in place from a pipe.
+ *
+ * This routine removes the first @a size bytes of the region obtained
+ * from k_pipe_get_claim() from the pipe, and releases the claim. Waiting
+ * writers refill the freed space and are woken with a single reschedule.
+ *
+ * @param pipe Address of the pipe.
+ * @param size Number of bytes consumed, at most the claimed size.
+ *
+ * @retval 0 Data released.
+ * @retval -EINVAL @a size exceeds the data in the pipe's buffer.
+ */
+int k_pipe_get_commit(struct k_pipe *pipe, size_t size);
+
 /** @} */
 
 /**
  * @cond INTERNAL_HIDDEN
  */
 
+#ifdef CONFIG_MEM_SLAB_MAGAZINE
+/* A magazine is a stack of free blocks linked through their first word */
+struct z_mem_slab_mag {
+	char *head;
+	char *tail;
+	u32_t count;
+};
+
+struct z_mem_slab_cpu {
+	struct k_spinlock lock;
+	struct z_mem_slab_mag loaded;
+	struct z_mem_slab_mag prev;
+	/* Blocks allocated minus blocks freed on this CPU's fast path */
+	u32_t num_used;
+	u32_t hits;
+	u32_t misses;
+	u32_t refills;
+	u32_t flushes;
+};
+#endif
+
 struct k_mem_slab {
 	_wait_q_t wait_q;
 	u32_t num_blocks;
@@ -4119,10 +4492,24 @@ struct k_mem_slab {
 	char *buffer;
 	char *free_list;
 	u32_t num_used;
+#ifdef CONFIG_MEM_SLAB_MAGAZINE
+	atomic_t waiting;
+	struct z_mem_slab_cpu cpu[CONFIG_MP_NUM_CPUS];
+#endif
+#ifdef CONFIG_MEM_SLAB_USAGE
+	struct sys_mem_usage usage;
+#endif
 
 	_OBJECT_TRACING_NEXT_PTR(k_mem_slab)
 };
 
+#ifdef CONFIG_MEM_SLAB_USAGE
+#define Z_MEM_SLAB_USAGE_INIT(obj) \
+	.usage = Z_MEM_USAGE_INITIALIZER(STRINGIFY(obj)),
+#else
+#define Z_MEM_SLAB_USAGE_INIT(obj)
+#endif
+
 #define _K_MEM_SLAB_INITIALIZER(obj, slab_buffer, slab_block_size, \
 			       slab_num_blocks) \
 	{ \
@@ -4132,6 +4519,7 @@ struct k_mem_slab {
 	.buffer = slab_buffer, \
 	.free_list = NULL, \
 	.num_used = 0, \
+	Z_MEM_SLAB_USAGE_INIT(obj) \
 	_OBJECT_TRACING_INIT \
 	}
 
@@ -4245,7 +4633,18 @@ extern void k_mem_slab_free(struct k_mem_slab *slab, void **mem);
  */
 static inline u32_t k_mem_slab_num_used_get(struct k_mem_slab *slab)
 {
+#ifdef CONFIG_MEM_SLAB_MAGAZINE
+	u32_t num_used = slab->num_used;
+
+	/* The counters are deltas and may wrap individually */
+	for (int i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		num_used += slab->cpu[i].num_used;
+	}
+
+	return num_used;
+#else
 	return slab->num_used;
+#endif
 }
 
 /**
@@ -4261,9 +4660,59 @@ static inline u32_t k_mem_slab_num_used_get(struct k_mem_slab *slab)
  */
 static inline u32_t k_mem_slab_num_free_get(struct k_mem_slab *slab)
 {
-	return slab->num_blocks - slab->num_used;
+	return slab->num_blocks - k_mem_slab_num_used_get(slab);
 }
 
+#ifdef CONFIG_MEM_SLAB_USAGE
+/**
+ * @brief Get memory slab usage.
+ *
+ * Allocations that fail with K_NO_WAIT or time out count as failed.
+ * With per-CPU magazine caches the peak is sampled whenever blocks move
+ * to or from the slab itself or it runs empty, so it can miss short
+ * peaks.
+ *
+ * @param slab Address of the memory slab.
+ * @param usage Set to the blocks in use, their peak and the number of
+ *	  failed allocations.
+ *
+ * @return N/A
+ */
+extern void k_mem_slab_usage_get(struct k_mem_slab *slab,
+				 struct sys_mem_usage *usage);
+#endif
+
+#ifdef CONFIG_MEM_SLAB_MAGAZINE
+/**
+ * @brief Memory slab per-CPU cache statistics
+ *
+ * Counters are summed over all CPUs and wrap around.
+ */
+struct k_mem_slab_cache_stats {
+	/** Allocations served from a CPU's magazines */
+	u32_t hits;
+	/** Allocations that had to take the slab lock */
+	u32_t misses;
+	/** Full magazines loaded from the depot */
+	u32_t refills;
+	/** Full magazines returned to the depot */
+	u32_t flushes;
+	/** Free blocks currently held in magazines */
+	u32_t cached;
+};
+
+/**
+ * @brief Get the per-CPU cache statistics of a memory slab.
+ *
+ * @param slab Address of the memory slab.
+ * @param stats Address of the structure to fill.
+ *
+ * @return N/A
+ */
+extern void k_mem_slab_cache_stats_get(struct k_mem_slab *slab,
+				       struct k_mem_slab_cache_stats *stats);
+#endif
+
 /** @} */
 
 /**
@@ -4271,10 +4720,21 @@ static inline u32_t k_mem_slab_num_free_get(struct k_mem_slab *slab)
  */
 
 struct k_mem_pool {
+#ifdef CONFIG_MEM_POOL_TLSF
+	struct sys_tlsf tlsf;
+#else
 	struct sys_mem_pool_base base;
+#endif
 	_wait_q_t wait_q;
 };
 
+#ifdef CONFIG_MEM_POOL_USAGE
+#define Z_MEM_POOL_USAGE_INIT(name) \
+	.usage = Z_MEM_USAGE_INITIALIZER(STRINGIFY(name)),
+#else
+#define Z_MEM_POOL_USAGE_INIT(name)
+#endif
+
 /**
  * INTERNAL_HIDDEN @endcond
  */
@@ -4292,6 +4752,11 @@ struct k_mem_pool {
  * quarters, down to blocks of @a min_size bytes long. The buffer is aligned
  * to a @a align -byte boundary.
  *
+ * With CONFIG_MEM_POOL_TLSF, blocks of any size up to the whole buffer are
+ * carved out as requested instead. The buffer is enlarged by the per-block
+ * overhead so that @a n_max blocks of @a max_size bytes, or as many blocks
+ * of @a min_size bytes as the buddy allocator provides, still fit at once.
+ *
  * If the pool is to be accessed outside the module where it is defined, it
  * can be declared via
  *
@@ -4304,6 +4769,23 @@ struct k_mem_pool {
  * @param align Alignment of the pool's buffer (power of 2).
  * @req K-MPOOL-001
  */
+#ifdef CONFIG_MEM_POOL_TLSF
+#define K_MEM_POOL_DEFINE(name, minsz, maxsz, nmax, align)		\
+	char __aligned(MAX(WB_UP(align), Z_TLSF_ALIGN))			\
+		_mpool_buf_##name[Z_TLSF_BUF_SIZE(minsz, maxsz, nmax)];	\
+	struct sys_tlsf_fl _mpool_fl_##name[				\
+		Z_TLSF_FL_COUNT(Z_TLSF_BUF_SIZE(minsz, maxsz, nmax))];	\
+	Z_STRUCT_SECTION_ITERABLE(k_mem_pool, name) = { \
+		.tlsf = {						\
+			.buf = _mpool_buf_##name,			\
+			.size = sizeof(_mpool_buf_##name),		\
+			.n_fl = ARRAY_SIZE(_mpool_fl_##name),		\
+			.fl = _mpool_fl_##name,				\
+			Z_MEM_POOL_USAGE_INIT(name)			\
+		} \
+	}; \
+	BUILD_ASSERT(sizeof(_mpool_buf_##name) <= (Z_TLSF_ALIGN << 24))
+#else
 #define K_MEM_POOL_DEFINE(name, minsz, maxsz, nmax, align)		\
 	char __aligned(WB_UP(align)) _mpool_buf_##name[WB_UP(maxsz) * nmax \
 				  + _MPOOL_BITS_SIZE(maxsz, minsz, nmax)]; \
@@ -4315,10 +4797,12 @@ struct k_mem_pool {
 			.n_max = nmax,					\
 			.n_levels = Z_MPOOL_LVLS(maxsz, minsz),		\
 			.levels = _mpool_lvls_##name,			\
-			.flags = SYS_MEM_POOL_KERNEL			\
+			.flags = SYS_MEM_POOL_KERNEL,			\
+			Z_MEM_POOL_USAGE_INIT(name)			\
 		} \
 	}; \
 	BUILD_ASSERT(WB_UP(maxsz) >= _MPOOL_MINBLK)
+#endif
 
 /**
  * @brief Allocate memory from a memory pool.
@@ -4353,6 +4837,27 @@ extern int k_mem_pool_alloc(struct k_mem_pool *pool, struct k_mem_block *block,
  */
 extern void *k_mem_pool_malloc(struct k_mem_pool *pool, size_t size);
 
+/**
+ * @brief Resize memory allocated from a memory pool with realloc() semantics
+ *
+ * The memory must have been allocated with k_mem_pool_malloc() or k_malloc(),
+ * and stays in the pool it was allocated from. If its block can hold
+ * @a size bytes in place (with CONFIG_MEM_POOL_TLSF, by taking over the free
+ * memory that follows it), the address doesn't change; otherwise a new
+ * block is allocated, the contents copied, and the old block freed.
+ *
+ * If @a ptr is NULL, this behaves like k_mem_pool_malloc() on @a pool. If
+ * @a size is zero, the memory is freed and NULL is returned.
+ *
+ * @param pool Address of the memory pool used if @a ptr is NULL.
+ * @param ptr Pointer to previously allocated memory, or NULL.
+ * @param size New size of the memory (in bytes).
+ * @return Address of the resized memory if successful, otherwise NULL, in
+ *         which case @a ptr is left untouched.
+ */
+extern void *k_mem_pool_realloc(struct k_mem_pool *pool, void *ptr,
+				size_t size);
+
 /**
  * @brief Free memory allocated from a memory pool.
  *
@@ -4379,6 +4884,45 @@ extern void k_mem_pool_free(struct k_mem_block *block);
  */
 extern void k_mem_pool_free_id(struct k_mem_block_id *id);
 
+#ifdef CONFIG_MEM_POOL_USAGE
+/**
+ * @brief Get memory pool usage.
+ *
+ * Sizes are those of the blocks handed out, so they include rounding up
+ * to the block size (and, for k_mem_pool_malloc(), the hidden block
+ * descriptor).  An allocation that waits counts as failed each time it
+ * finds the pool exhausted.
+ *
+ * @param pool Address of the memory pool.
+ * @param usage Set to the bytes in use, their peak and the number of
+ *	  failed allocation attempts.
+ *
+ * @return N/A
+ */
+extern void k_mem_pool_usage_get(struct k_mem_pool *pool,
+				 struct sys_mem_usage *usage);
+#endif
+
+/**
+ * @brief Count the free blocks of one size in a memory pool.
+ *
+ * This is meant for fragmentation diagnostics: a pool with plenty of
+ * free memory but no large free blocks can't serve large requests.  With
+ * the buddy allocator, level 0 holds blocks of the pool's maximum size
+ * and every following level blocks a quarter that size.  With the TLSF
+ * allocator, levels are its first level size classes, starting with the
+ * smallest.
+ *
+ * @param pool Address of the memory pool.
+ * @param level Block size level.
+ * @param block_size Set to the block size of the level, or to the
+ *	  smallest block size of the size class.
+ *
+ * @return Number of free blocks, or -EINVAL if the level doesn't exist.
+ */
+extern int k_mem_pool_free_blocks_get(struct k_mem_pool *pool, int level,
+				      size_t *block_size);
+
 /**
  * @}
  */
@@ -4418,6 +4962,20 @@ extern void *k_malloc(size_t size);
  */
 extern void k_free(void *ptr);
 
+/**
+ * @brief Resize memory allocated from heap.
+ *
+ * This routine provides traditional realloc() semantics. It is
+ * k_mem_pool_realloc() using the heap memory pool when @a ptr is NULL.
+ *
+ * @param ptr Pointer to previously allocated memory, or NULL.
+ * @param size New size of the memory (in bytes).
+ *
+ * @return Address of the resized memory if successful; otherwise NULL, in
+ *         which case @a ptr is left untouched.
+ */
+extern void *k_realloc(void *ptr, size_t size);
+
 /**
  * @brief Allocate memory from heap, array style
  *
@@ -4735,6 +5293,90 @@ __syscall void k_poll_signal_check(struct k_poll_signal *signal,
 
 __syscall int k_poll_signal_raise(struct k_poll_signal *signal, int result);
 
+#ifdef CONFIG_POLL_SET
+/**
+ * @brief Poll set
+ *
+ * A set of poll events that stay registered with their objects across
+ * waits.  Events whose object signaled are moved to the set's ready list,
+ * so waiting on the set costs in the number of ready events, not in the
+ * number of events watched.
+ */
+struct k_poll_set {
+	/* PRIVATE - DO NOT TOUCH */
+	struct k_spinlock lock;
+	sys_dlist_t ready;
+	_wait_q_t wait_q;
+	struct _poller poller;
+};
+
+/**
+ * @brief Initialize a poll set.
+ *
+ * @param set The poll set to initialize.
+ *
+ * @return N/A
+ */
+extern void k_poll_set_init(struct k_poll_set *set);
+
+/**
+ * @brief Add an event to a poll set.
+ *
+ * The event, initialized with k_poll_event_init(), is watched until it is
+ * removed from the set again, and must not be modified or passed to
+ * k_poll() in the meantime.  An event can only belong to one set.
+ *
+ * Like with k_poll(), threads pending on the object itself and threads
+ * polling it with k_poll() have precedence over the set.
+ *
+ * @param set The poll set.
+ * @param event The event to watch.
+ *
+ * @retval 0 Event added.
+ * @retval -EBUSY Event already in a set or being polled.
+ * @retval -EINVAL Event of type K_POLL_TYPE_IGNORE.
+ */
+extern int k_poll_set_add(struct k_poll_set *set, struct k_poll_event *event);
+
+/**
+ * @brief Remove an event from a poll set.
+ *
+ * @param set The poll set.
+ * @param event An event added to @a set.
+ *
+ * @retval 0 Event removed.
+ * @retval -EINVAL Event not in @a set.
+ */
+extern int k_poll_set_remove(struct k_poll_set *set,
+			     struct k_poll_event *event);
+
+/**
+ * @brief Wait for events of a poll set to be ready.
+ *
+ * Stores the events of @a set whose condition is met, at most @a max of
+ * them, in @a ready, with their state field set.  The events stay in the
+ * set, and are reported again by the next wait for as long as their
+ * condition is met.  Events reported are moved behind the others still
+ * ready, so that no ready event is left out for good when there are more
+ * than @a max.
+ *
+ * The cost of a wait is in the number of events signaled since the last
+ * one, not in the number of events in the set.
+ *
+ * @param set The poll set.
+ * @param ready Array receiving the ready events.
+ * @param max Size of @a ready.
+ * @param timeout Waiting period for an event to be ready (in milliseconds),
+ *                or one of the special values K_NO_WAIT and K_FOREVER.
+ *
+ * @return Number of events stored in @a ready, or -EAGAIN if the waiting
+ *         period timed out.
+ */
+extern int k_poll_set_wait(struct k_poll_set *set,
+			   struct k_poll_event **ready, int max,
+			   s32_t timeout);
+#endif /* CONFIG_POLL_SET */
+
 /**
  * @internal
  */
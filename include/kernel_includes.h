@@ -26,6 +26,7 @@
 #include <sys/sflist.h>
 #include <sys/util.h>
 #include <sys/mempool_base.h>
+#include <sys/tlsf.h>
 #include <kernel_version.h>
 #include <random/rand32.h>
 #include <kernel_arch_thread.h>
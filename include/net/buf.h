@@ -13,6 +13,7 @@
 #include <stddef.h>
 #include <zephyr/types.h>
 #include <sys/util.h>
+#include <sys/mem_usage.h>
 #include <zephyr.h>
 
 #ifdef __cplusplus
@@ -576,6 +577,9 @@ struct net_buf_pool {
 
 	/** Name of the pool. Used when printing pool information. */
 	const char *name;
+
+	/** Buffers in use, their peak and failed allocations. */
+	struct sys_mem_usage usage;
 #endif /* CONFIG_NET_BUF_POOL_USAGE */
 
 	/** Optional destroy callback when buffer is freed. */
@@ -126,6 +126,18 @@ enum ethernet_hw_caps {
 
 	/** VLAN Tag stripping */
 	ETHERNET_HW_VLAN_TAG_STRIP	= BIT(14),
+
+	/** TCP segmentation offload (TSO) supported. The device splits TCP
+	 * segments with net_pkt_tso_mss() set into segments of that many
+	 * bytes of payload, and calculates their checksums.
+	 */
+	ETHERNET_HW_TX_TSO		= BIT(15),
+
+	/** Large receive offload (LRO) supported. The device can merge
+	 * consecutive TCP segments of a connection into one packet larger
+	 * than the MTU.
+	 */
+	ETHERNET_HW_RX_LRO		= BIT(16),
 };
 
 /** @cond INTERNAL_HIDDEN */
@@ -664,6 +676,43 @@ void net_eth_carrier_off(struct net_if *iface);
  */
 int net_eth_promisc_mode(struct net_if *iface, bool enable);
 
+/**
+ * @typedef net_eth_tx_frame_cb_t
+ * @brief Callback used by net_eth_tx_offload() to send out a frame.
+ * The frame must not be modified, its headers are reused for the next
+ * segment.
+ *
+ * @param frame Ethernet frame
+ * @param len Length of the frame
+ * @param user_data User data given to net_eth_tx_offload()
+ *
+ * @return 0 if the frame was sent, <0 otherwise.
+ */
+typedef int (*net_eth_tx_frame_cb_t)(u8_t *frame, size_t len,
+				     void *user_data);
+
+/**
+ * @brief Do in software what a device doing checksum offload and TCP
+ * segmentation offload does to an outgoing packet. This is meant for
+ * drivers emulating these offloads.
+ *
+ * The packet, Ethernet header included, is copied to @a buf and its IPv4
+ * header checksum and TCP or UDP checksum are calculated. If
+ * net_pkt_tso_mss() is set, the packet is split into TCP segments with
+ * that much payload first.
+ *
+ * @param pkt Packet to send
+ * @param buf Buffer the frames are built in
+ * @param buf_len Length of the buffer
+ * @param cb Callback called for each frame
+ * @param user_data User data given to the callback
+ *
+ * @return 0 if all frames were sent, -EMSGSIZE if a frame does not fit
+ * in @a buf, or the error returned by the callback.
+ */
+int net_eth_tx_offload(struct net_pkt *pkt, u8_t *buf, size_t buf_len,
+		       net_eth_tx_frame_cb_t cb, void *user_data);
+
 /**
  * @brief Return PTP clock that is tied to this ethernet network interface.
  *
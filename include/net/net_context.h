@@ -905,6 +905,35 @@ int net_context_sendmsg(struct net_context *context,
 			s32_t timeout,
 			void *user_data);
 
+/**
+ * @brief Send a chain of network buffers without copying it.
+ *
+ * @details The fragments are sent as the payload of a single UDP or TCP
+ * packet. The stack takes its own reference to @a frags, so the caller
+ * keeps theirs and must release it with net_buf_unref() whether the call
+ * succeeds or not. The data must not be modified after the call, as TCP
+ * may still retransmit it. Allocate the fragments with
+ * net_pkt_get_reserve_tx_data() so they come from the TX data pool.
+ *
+ * @param context The network context to use.
+ * @param frags The payload fragments.
+ * @param dst_addr Destination address, or NULL to use the connected peer.
+ * @param addrlen Length of the address.
+ * @param cb Caller-supplied callback function.
+ * @param timeout Currently this value is not used.
+ * @param user_data Caller-supplied user data.
+ *
+ * @return numbers of bytes sent on success, -EMSGSIZE if the payload does
+ * not fit a single packet, a negative errno otherwise
+ */
+int net_context_send_buf(struct net_context *context,
+			 struct net_buf *frags,
+			 const struct sockaddr *dst_addr,
+			 socklen_t addrlen,
+			 net_context_send_cb_t cb,
+			 s32_t timeout,
+			 void *user_data);
+
 /**
  * @brief Receive network data from a peer specified by context.
  *
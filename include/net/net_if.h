@@ -1905,6 +1905,17 @@ bool net_if_need_calc_rx_checksum(struct net_if *iface);
  */
 bool net_if_need_calc_tx_checksum(struct net_if *iface);
 
+/**
+ * @brief Check if the IP stack needs to split outgoing TCP data into
+ * segments that fit the MTU, or if the network device can do it (TCP
+ * segmentation offload).
+ *
+ * @param iface Network interface
+ *
+ * @return True if TCP data needs to be segmented, false otherwise.
+ */
+bool net_if_need_tcp_segmentation(struct net_if *iface);
+
 /**
  * @brief Get interface according to index
  *
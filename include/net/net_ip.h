@@ -230,6 +230,12 @@ struct msghdr {
 	int           msg_flags;      /* flags on received message */
 };
 
+/** Message vector entry for sendmmsg() and recvmmsg() */
+struct mmsghdr {
+	struct msghdr msg_hdr;        /* message header */
+	unsigned int  msg_len;        /* number of bytes transferred */
+};
+
 struct cmsghdr {
 	socklen_t cmsg_len;    /* Number of bytes, including header */
 	int       cmsg_level;  /* Originating protocol */
@@ -207,6 +207,13 @@ struct net_pkt {
 	u8_t ipv6_next_hdr;	/* What is the very first next header */
 #endif /* CONFIG_NET_IPV6 */
 
+#if defined(CONFIG_NET_TCP_TSO)
+	/* Largest TCP payload of the segments the network device is to
+	 * split this packet into, or 0 if the packet is not to be split.
+	 */
+	u16_t tso_mss;
+#endif
+
 #if defined(CONFIG_IEEE802154)
 	u8_t ieee802154_rssi; /* Received Signal Strength Indication */
 	u8_t ieee802154_lqi;  /* Link Quality Indicator */
@@ -742,6 +749,31 @@ static inline void net_pkt_set_txtime(struct net_pkt *pkt, u64_t txtime)
 }
 #endif /* CONFIG_NET_PKT_TXTIME */
 
+#if defined(CONFIG_NET_TCP_TSO)
+static inline u16_t net_pkt_tso_mss(struct net_pkt *pkt)
+{
+	return pkt->tso_mss;
+}
+
+static inline void net_pkt_set_tso_mss(struct net_pkt *pkt, u16_t mss)
+{
+	pkt->tso_mss = mss;
+}
+#else
+static inline u16_t net_pkt_tso_mss(struct net_pkt *pkt)
+{
+	ARG_UNUSED(pkt);
+
+	return 0;
+}
+
+static inline void net_pkt_set_tso_mss(struct net_pkt *pkt, u16_t mss)
+{
+	ARG_UNUSED(pkt);
+	ARG_UNUSED(mss);
+}
+#endif /* CONFIG_NET_TCP_TSO */
+
 static inline size_t net_pkt_get_len(struct net_pkt *pkt)
 {
 	return net_buf_frags_len(pkt->frags);
@@ -54,6 +54,10 @@ struct zsock_pollfd {
 
 /** zsock_recv: Read data without removing it from socket input queue */
 #define ZSOCK_MSG_PEEK 0x02
+/** zsock_recvmmsg: Datagram was larger than the buffer and got truncated
+ *  (output value only, in msg_flags)
+ */
+#define ZSOCK_MSG_TRUNC 0x20
 /** zsock_recv/zsock_send: Override operation to non-blocking */
 #define ZSOCK_MSG_DONTWAIT 0x40
 
@@ -301,6 +305,49 @@ __syscall ssize_t zsock_recvfrom(int sock, void *buf, size_t max_len,
 				 int flags, struct sockaddr *src_addr,
 				 socklen_t *addrlen);
 
+/**
+ * @brief Send multiple messages in one call
+ *
+ * @details
+ * @rst
+ * Calls ``zsock_sendmsg()`` for each of the *vlen* entries of *msgvec*,
+ * with a single socket lookup and system call, and stores the number of
+ * bytes sent in the ``msg_len`` field of each entry. Stops at the first
+ * message that fails; that error is only reported if no message was
+ * sent. From user mode, each message may have at most 8 iovec entries.
+ * Follows the Linux ``sendmmsg()`` call, and is also exposed as
+ * ``sendmmsg()`` if :option:`CONFIG_NET_SOCKETS_POSIX_NAMES` is defined.
+ * @endrst
+ *
+ * @return Number of messages sent, or -1 with errno set.
+ */
+__syscall int zsock_sendmmsg(int sock, struct mmsghdr *msgvec,
+			     unsigned int vlen, int flags);
+
+/**
+ * @brief Receive multiple datagrams in one call
+ *
+ * @details
+ * @rst
+ * Receives up to *vlen* datagrams into *msgvec*, with a single socket
+ * lookup and system call. For each datagram, the source address goes
+ * to ``msg_name``, the payload is scattered over ``msg_iov``, its length
+ * is stored in ``msg_len``, and ``msg_flags`` gets ``ZSOCK_MSG_TRUNC``
+ * if the payload did not fit. Only the first datagram is waited for,
+ * as if ``MSG_WAITFORONE`` were always given; the call then returns
+ * with the datagrams that are already queued. There is no timeout
+ * argument, unlike Linux ``recvmmsg()``. ``ZSOCK_MSG_PEEK`` is not
+ * supported, and neither is ancillary data. Stream sockets are
+ * supported with a single iovec entry per message only. From user mode,
+ * each message may have at most 8 iovec entries. Also exposed as
+ * ``recvmmsg()`` if :option:`CONFIG_NET_SOCKETS_POSIX_NAMES` is defined.
+ * @endrst
+ *
+ * @return Number of messages received, or -1 with errno set.
+ */
+__syscall int zsock_recvmmsg(int sock, struct mmsghdr *msgvec,
+			     unsigned int vlen, int flags);
+
 /**
  * @brief Receive data from a connected peer
  *
@@ -319,6 +366,46 @@ static inline ssize_t zsock_recv(int sock, void *buf, size_t max_len,
 	return zsock_recvfrom(sock, buf, max_len, flags, NULL, NULL);
 }
 
+struct net_buf;
+
+/**
+ * @brief Send a chain of network buffers without copying it
+ *
+ * @details
+ * @rst
+ * Zero-copy counterpart of ``zsock_sendto()``: the fragments are sent as
+ * the payload of one packet, which must fit the path MTU (or the TCP
+ * MSS). The stack takes its own reference to *frags*, the caller must
+ * still release theirs with ``net_buf_unref()``, and must not modify the
+ * data afterwards. Set *dest_addr* to NULL on connected sockets.
+ * Not a system call, available if
+ * :option:`CONFIG_NET_SOCKETS_ZEROCOPY` is enabled.
+ * @endrst
+ *
+ * @return Number of bytes sent, or -1 with errno set.
+ */
+ssize_t zsock_sendbuf(int sock, struct net_buf *frags, int flags,
+		      const struct sockaddr *dest_addr, socklen_t addrlen);
+
+/**
+ * @brief Receive data as a chain of network buffers
+ *
+ * @details
+ * @rst
+ * Zero-copy counterpart of ``zsock_recvfrom()``: instead of copying,
+ * hands over the fragments of the next received packet, with the
+ * protocol headers removed. The caller owns *frags* and releases it with
+ * ``net_buf_unref()``. On stream sockets a whole segment is returned,
+ * and 0 with *frags* set to NULL means the peer closed the connection.
+ * ``ZSOCK_MSG_PEEK`` is not supported. Not a system call, available if
+ * :option:`CONFIG_NET_SOCKETS_ZEROCOPY` is enabled.
+ * @endrst
+ *
+ * @return Number of bytes in *frags*, or -1 with errno set.
+ */
+ssize_t zsock_recvbuf(int sock, struct net_buf **frags, int flags,
+		      struct sockaddr *src_addr, socklen_t *addrlen);
+
 /**
  * @brief Control blocking/non-blocking mode of a socket
  *
@@ -624,6 +711,18 @@ static inline ssize_t recvfrom(int sock, void *buf, size_t max_len, int flags,
 	return zsock_recvfrom(sock, buf, max_len, flags, src_addr, addrlen);
 }
 
+static inline int sendmmsg(int sock, struct mmsghdr *msgvec,
+			   unsigned int vlen, int flags)
+{
+	return zsock_sendmmsg(sock, msgvec, vlen, flags);
+}
+
+static inline int recvmmsg(int sock, struct mmsghdr *msgvec,
+			   unsigned int vlen, int flags)
+{
+	return zsock_recvmmsg(sock, msgvec, vlen, flags);
+}
+
 static inline int poll(struct zsock_pollfd *fds, int nfds, int timeout)
 {
 	return zsock_poll(fds, nfds, timeout);
@@ -727,6 +826,7 @@ static inline int inet_pton(sa_family_t family, const char *src, void *dst)
 #define POLLNVAL ZSOCK_POLLNVAL
 
 #define MSG_PEEK ZSOCK_MSG_PEEK
+#define MSG_TRUNC ZSOCK_MSG_TRUNC
 #define MSG_DONTWAIT ZSOCK_MSG_DONTWAIT
 
 #define SHUT_RD ZSOCK_SHUT_RD
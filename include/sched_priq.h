@@ -9,6 +9,7 @@
 #include <sys/util.h>
 #include <sys/dlist.h>
 #include <sys/rb.h>
+#include <zephyr/types.h>
 
 /* Two abstractions are defined here for "thread priority queues".
  *
@@ -43,6 +44,7 @@ struct _priq_rb {
 void z_priq_rb_add(struct _priq_rb *pq, struct k_thread *thread);
 void z_priq_rb_remove(struct _priq_rb *pq, struct k_thread *thread);
 struct k_thread *z_priq_rb_best(struct _priq_rb *pq);
+bool z_priq_rb_lessthan(struct rbnode *a, struct rbnode *b);
 
 /* Traditional/textbook "multi-queue" structure.  Separate lists for a
  * small number (max 32 here) of fixed priorities.  This corresponds
@@ -60,4 +62,29 @@ void z_priq_mq_add(struct _priq_mq *pq, struct k_thread *thread);
 void z_priq_mq_remove(struct _priq_mq *pq, struct k_thread *thread);
 struct k_thread *z_priq_mq_best(struct _priq_mq *pq);
 
+/* Bitmap-indexed multi-queue.  Like the multi-queue above there is
+ * one list per priority, but the set of non-empty lists is tracked in
+ * a two-level bitmap (one summary word with a bit per 32-priority
+ * word), so any priority range representable by the kernel can be
+ * scanned with two find-first-set operations.  The best thread is
+ * cached in the structure, making z_priq_bmq_best() a single load.
+ * With CONFIG_SCHED_DEADLINE each per-priority list is kept sorted by
+ * deadline, so only threads sharing one priority pay for the sort.
+ */
+#define Z_PRIQ_BMQ_NUM_PRIOS (CONFIG_NUM_COOP_PRIORITIES + \
+			      CONFIG_NUM_PREEMPT_PRIORITIES + 1)
+#define Z_PRIQ_BMQ_NUM_WORDS ceiling_fraction(Z_PRIQ_BMQ_NUM_PRIOS, 32)
+
+struct _priq_bmq {
+	sys_dlist_t queues[Z_PRIQ_BMQ_NUM_PRIOS];
+	u32_t bitmap[Z_PRIQ_BMQ_NUM_WORDS]; /* bit set if queue non-empty */
+	u32_t summary; /* bit 1<<i set if bitmap[i] is non-zero */
+	struct k_thread *best; /* cached head of the best non-empty queue */
+};
+
+void z_priq_bmq_init(struct _priq_bmq *pq);
+void z_priq_bmq_add(struct _priq_bmq *pq, struct k_thread *thread);
+void z_priq_bmq_remove(struct _priq_bmq *pq, struct k_thread *thread);
+struct k_thread *z_priq_bmq_best(struct _priq_bmq *pq);
+
 #endif /* ZEPHYR_INCLUDE_SCHED_PRIQ_H_ */
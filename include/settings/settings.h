@@ -312,6 +312,52 @@ int settings_save_one(const char *name, const void *value, size_t val_len);
  */
 int settings_delete(const char *name);
 
+/**
+ * Start a batch of saves.
+ *
+ * Until the batch is committed or aborted, @ref settings_save_one and
+ * @ref settings_delete calls from the calling thread only record the values
+ * in RAM, a value replacing the one saved before under the same name, and
+ * settings calls from other threads wait.
+ *
+ * The settings lock is held by the calling thread until then, with no
+ * timeout: the batch must be committed or aborted by the same thread on
+ * every path, including error paths, or all other settings calls block
+ * forever. Keep the code between begin and commit short and do not wait on
+ * other threads there.
+ *
+ * Requires CONFIG_SETTINGS_BATCH.
+ *
+ * @return 0 on success, -EBUSY if a batch is already open.
+ */
+int settings_batch_begin(void);
+
+/**
+ * Write the values of the batch to persisted storage, those that have
+ * changed value, and end the batch.
+ *
+ * Back-ends implementing @ref settings_store_itf::csi_save_batch write them
+ * in one pass, the others one by one.
+ *
+ * The FCB and file back-ends write the values between a begin and a commit
+ * marker record, and load them only when the commit marker is there, so
+ * either all the values of the batch or none are loaded after a reset or a
+ * write error. The NVS back-end first writes all the values to a journal
+ * entry, and fails without writing anything when they do not fit in one.
+ * After a reset it writes the values of the journal on init. Other back-ends
+ * write the values one by one, the first error stops the writes, and a reset
+ * during the commit leaves only part of the values written.
+ *
+ * @return 0 on success, -EINVAL if the calling thread has no batch open,
+ * other non-zero values on failure.
+ */
+int settings_batch_commit(void);
+
+/**
+ * Drop the values of the batch and end it.
+ */
+void settings_batch_abort(void);
+
 /**
  * Call commit for all settings handler. This should apply all
  * settings which has been set, but not applied yet.
@@ -341,6 +387,20 @@ int settings_commit_subtree(const char *subtree);
 
 struct settings_store_itf;
 
+/**
+ * Value of a batch of saves, see @ref settings_batch_begin.
+ */
+struct settings_batch_entry {
+	const char *name;
+	/**< Key in string format. */
+
+	const void *value;
+	/**< Binary value, NULL to delete the key. */
+
+	size_t val_len;
+	/**< Length of value in bytes. */
+};
+
 /**
  * Backend handler node for storage handling.
  */
@@ -416,6 +476,18 @@ struct settings_store_itf {
 	 * Parameters:
 	 *  - cs - Corresponding backend handler node
 	 */
+
+	int (*csi_save_batch)(struct settings_store *cs,
+			      const struct settings_batch_entry *entries,
+			      int count);
+	/**< Save the key-value pairs of a batch to storage. Optional, the
+	 * pairs are saved one by one with csi_save otherwise.
+	 *
+	 * Parameters:
+	 *  - cs - Corresponding backend handler node
+	 *  - entries - Key-value pairs, each key appears once
+	 *  - count - Number of key-value pairs
+	 */
 };
 
 /**
@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2019 Wind River Systems, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef ZEPHYR_INCLUDE_SYS_MEM_USAGE_H_
+#define ZEPHYR_INCLUDE_SYS_MEM_USAGE_H_
+
+#include <zephyr/types.h>
+#ifdef CONFIG_MEM_USAGE_STATS
+#include <stats/stats.h>
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Allocator usage counters
+ *
+ * Kept by memory pools, memory slabs and network buffer pools when
+ * their usage tracking option is enabled.  Counts are in the
+ * allocator's own unit: bytes for memory pools, blocks for memory
+ * slabs and network buffer pools.  The owning object updates them
+ * under its own lock.
+ *
+ * With CONFIG_MEM_USAGE_STATS the counters also form a group of the
+ * statistics subsystem, and are preceded by its header.
+ */
+struct sys_mem_usage {
+#ifdef CONFIG_MEM_USAGE_STATS
+	struct stats_hdr s_hdr;
+#endif
+	/** Units currently allocated */
+	u32_t used;
+	/** Highest number of units allocated at once */
+	u32_t max_used;
+	/** Allocation attempts that found nothing to allocate */
+	u32_t failed;
+};
+
+/** @cond INTERNAL_HIDDEN */
+#ifdef CONFIG_MEM_USAGE_STATS
+#define Z_MEM_USAGE_INITIALIZER(_name) { .s_hdr = { .s_name = _name } }
+#define Z_MEM_USAGE_NAME(usage) ((usage)->s_hdr.s_name)
+#else
+#define Z_MEM_USAGE_INITIALIZER(_name) { 0 }
+#endif
+/** @endcond */
+
+static inline void sys_mem_usage_set(struct sys_mem_usage *usage, u32_t used)
+{
+	usage->used = used;
+	if (used > usage->max_used) {
+		usage->max_used = used;
+	}
+}
+
+static inline void sys_mem_usage_alloc(struct sys_mem_usage *usage, u32_t n)
+{
+	sys_mem_usage_set(usage, usage->used + n);
+}
+
+static inline void sys_mem_usage_free(struct sys_mem_usage *usage, u32_t n)
+{
+	usage->used -= n;
+}
+
+static inline void sys_mem_usage_fail(struct sys_mem_usage *usage)
+{
+	usage->failed++;
+}
+
+static inline void sys_mem_usage_reset(struct sys_mem_usage *usage)
+{
+	usage->used = 0U;
+	usage->max_used = 0U;
+	usage->failed = 0U;
+}
+
+/**
+ * @brief Copy usage counters
+ *
+ * Only the counters are copied, not the statistics group header.
+ *
+ * @param dst Destination counters
+ * @param src Counters to copy
+ */
+static inline void sys_mem_usage_copy(struct sys_mem_usage *dst,
+				      const struct sys_mem_usage *src)
+{
+	dst->used = src->used;
+	dst->max_used = src->max_used;
+	dst->failed = src->failed;
+}
+
+#ifdef CONFIG_MEM_USAGE_STATS
+/**
+ * @brief Register usage counters with the statistics subsystem
+ *
+ * The counters show up as the "used", "max_used" and "failed" entries
+ * of a statistics group called @a name.  Statically defined objects are
+ * registered at boot under their variable name; objects initialized at
+ * run time can be registered with this call.  The current counter
+ * values are kept.
+ *
+ * @param usage Counters of the object
+ * @param name Name of the statistics group, which must stay valid
+ * @return 0 on success, -EALREADY if the name is taken
+ */
+int sys_mem_usage_register(struct sys_mem_usage *usage, const char *name);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ZEPHYR_INCLUDE_SYS_MEM_USAGE_H_ */
@@ -9,6 +9,7 @@
 
 #include <zephyr/types.h>
 #include <stddef.h>
+#include <sys/mem_usage.h>
 
 /*
  * Definitions and macros used by both the IRQ-safe k_mem_pool and user-mode
@@ -34,6 +35,9 @@ struct sys_mem_pool_base {
 	s8_t max_inline_level;
 	struct sys_mem_pool_lvl *levels;
 	u8_t flags;
+#ifdef CONFIG_MEM_POOL_USAGE
+	struct sys_mem_usage usage;
+#endif
 };
 
 #define _MPOOL_MINBLK sizeof(sys_dnode_t)
@@ -103,4 +107,7 @@ int z_sys_mem_pool_block_alloc(struct sys_mem_pool_base *p, size_t size,
 void z_sys_mem_pool_block_free(struct sys_mem_pool_base *p, u32_t level,
 			      u32_t block);
 
+int z_sys_mem_pool_free_blocks(struct sys_mem_pool_base *p, int level,
+			       size_t *block_size);
+
 #endif /* ZEPHYR_INCLUDE_SYS_MEMPOOL_BASE_H_ */
@@ -0,0 +1,145 @@
+/*
+ * Copyright (c) 2019 Wind River Systems, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef ZEPHYR_INCLUDE_SYS_TLSF_H_
+#define ZEPHYR_INCLUDE_SYS_TLSF_H_
+
+#include <zephyr/types.h>
+#include <stddef.h>
+#include <sys/util.h>
+#include <sys/mem_usage.h>
+
+/*
+ * Two-Level Segregated Fit allocator.  Free blocks are kept in lists
+ * indexed by a first level (power of two size class) and a second
+ * level (Z_TLSF_SL_COUNT linear subdivisions of it); a bitmap per
+ * level finds a suitable non-empty list with two find-first-set
+ * operations, so allocation and free take constant time regardless of
+ * the number of blocks.  Adjacent free blocks are merged immediately
+ * using boundary tags.
+ *
+ * The allocator does no locking of its own: callers serialize access.
+ */
+
+#define Z_TLSF_ALIGN_SHIFT	3
+#define Z_TLSF_ALIGN		(1 << Z_TLSF_ALIGN_SHIFT)
+#define Z_TLSF_SL_LOG2		3
+#define Z_TLSF_SL_COUNT		(1 << Z_TLSF_SL_LOG2)
+#define Z_TLSF_FL_SHIFT		(Z_TLSF_SL_LOG2 + Z_TLSF_ALIGN_SHIFT)
+
+/* Per-block overhead: previous physical block and size/flags word */
+#define Z_TLSF_HDR_SIZE		(2 * sizeof(void *))
+
+struct z_tlsf_block;
+
+struct sys_tlsf_fl {
+	u32_t sl_bitmap;
+	struct z_tlsf_block *free[Z_TLSF_SL_COUNT];
+};
+
+struct sys_tlsf {
+	void *buf;
+	size_t size;
+	u32_t fl_bitmap;
+	u8_t n_fl;
+	struct sys_tlsf_fl *fl;
+#ifdef CONFIG_MEM_POOL_USAGE
+	struct sys_mem_usage usage;
+#endif
+};
+
+/* Number of first level classes needed for a buffer of sz bytes */
+#define Z_TLSF_HAVE_FL(sz, l) \
+	((size_t)(sz) >= ((size_t)1 << (Z_TLSF_FL_SHIFT + (l))) ? 1 : 0)
+
+#define Z_TLSF_FL_COUNT(sz)			 \
+	(1 + Z_TLSF_HAVE_FL(sz, 0) + Z_TLSF_HAVE_FL(sz, 1) + \
+	 Z_TLSF_HAVE_FL(sz, 2) + Z_TLSF_HAVE_FL(sz, 3) +	 \
+	 Z_TLSF_HAVE_FL(sz, 4) + Z_TLSF_HAVE_FL(sz, 5) +	 \
+	 Z_TLSF_HAVE_FL(sz, 6) + Z_TLSF_HAVE_FL(sz, 7) +	 \
+	 Z_TLSF_HAVE_FL(sz, 8) + Z_TLSF_HAVE_FL(sz, 9) +	 \
+	 Z_TLSF_HAVE_FL(sz, 10) + Z_TLSF_HAVE_FL(sz, 11) +	 \
+	 Z_TLSF_HAVE_FL(sz, 12) + Z_TLSF_HAVE_FL(sz, 13) +	 \
+	 Z_TLSF_HAVE_FL(sz, 14) + Z_TLSF_HAVE_FL(sz, 15) +	 \
+	 Z_TLSF_HAVE_FL(sz, 16) + Z_TLSF_HAVE_FL(sz, 17) +	 \
+	 Z_TLSF_HAVE_FL(sz, 18) + Z_TLSF_HAVE_FL(sz, 19) +	 \
+	 Z_TLSF_HAVE_FL(sz, 20) + Z_TLSF_HAVE_FL(sz, 21))
+
+#define Z_TLSF_BLK_SIZE(sz) \
+	((((sz) + Z_TLSF_ALIGN - 1) & ~(Z_TLSF_ALIGN - 1)) + Z_TLSF_HDR_SIZE)
+
+/* Buffer size that holds n blocks of maxsz bytes at once, as well as
+ * the n * maxsz / minsz blocks of minsz bytes a buddy pool of the same
+ * geometry would, plus the zero-sized sentinel block ending the buffer
+ */
+#define Z_TLSF_BUF_SIZE(minsz, maxsz, n)				\
+	(MAX((n) * Z_TLSF_BLK_SIZE(maxsz),				\
+	     (n) * ((maxsz) / (minsz)) * Z_TLSF_BLK_SIZE(minsz))	\
+	 + Z_TLSF_HDR_SIZE)
+
+/**
+ * @brief Initialize a TLSF heap
+ *
+ * The buf, size, n_fl and fl fields must be set; n_fl must be at least
+ * Z_TLSF_FL_COUNT(size).  The whole buffer becomes one free block.
+ *
+ * @param t TLSF heap
+ */
+void sys_tlsf_init(struct sys_tlsf *t);
+
+/**
+ * @brief Allocate a block
+ *
+ * @param t TLSF heap
+ * @param size Requested size in bytes
+ * @return Pointer aligned to Z_TLSF_ALIGN bytes, or NULL
+ */
+void *sys_tlsf_alloc(struct sys_tlsf *t, size_t size);
+
+/**
+ * @brief Free a block
+ *
+ * @param t TLSF heap
+ * @param ptr Block returned by sys_tlsf_alloc(), or NULL
+ */
+void sys_tlsf_free(struct sys_tlsf *t, void *ptr);
+
+/**
+ * @brief Resize a block without moving it
+ *
+ * Shrinking always succeeds and returns the tail to the heap.  Growing
+ * succeeds if the physically following block is free and large enough.
+ *
+ * @param t TLSF heap
+ * @param ptr Block returned by sys_tlsf_alloc()
+ * @param size New size in bytes
+ * @retval 0 The block now holds at least @a size bytes
+ * @retval -ENOMEM The block can't grow in place; it is left unchanged
+ */
+int sys_tlsf_realloc_in_place(struct sys_tlsf *t, void *ptr, size_t size);
+
+/**
+ * @brief Usable size of an allocated block
+ *
+ * @param ptr Block returned by sys_tlsf_alloc()
+ * @return Number of bytes usable at @a ptr, at least the size requested
+ */
+size_t sys_tlsf_usable_size(void *ptr);
+
+/**
+ * @brief Count the free blocks of a first level size class
+ *
+ * For fragmentation diagnostics; walks the free lists of the class.
+ *
+ * @param t TLSF heap
+ * @param fl First level class, 0 for blocks smaller than
+ *	     1 << Z_TLSF_FL_SHIFT bytes
+ * @param min_size Set to the smallest block size in the class
+ * @return Number of free blocks, or -EINVAL if there is no such class
+ */
+int sys_tlsf_free_blocks(struct sys_tlsf *t, int fl, size_t *min_size);
+
+#endif /* ZEPHYR_INCLUDE_SYS_TLSF_H_ */
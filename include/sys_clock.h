@@ -237,6 +237,10 @@ struct _timeout {
 	sys_dnode_t node;
 	s32_t dticks;
 	_timeout_func_t fn;
+#ifdef CONFIG_TIMEOUT_WHEEL
+	u32_t expiry;
+	u8_t slot;
+#endif
 };
 
 #ifdef __cplusplus
@@ -81,6 +81,8 @@ struct _ready_q {
 	struct _priq_rb runq;
 #elif defined(CONFIG_SCHED_MULTIQ)
 	struct _priq_mq runq;
+#elif defined(CONFIG_SCHED_BITMAP)
+	struct _priq_bmq runq;
 #endif
 };
 
@@ -115,6 +117,11 @@ struct _cpu {
 	/* True when _current is allowed to context switch */
 	u8_t swap_ok;
 #endif
+
+#ifdef CONFIG_SCHED_CPU_RUNQ
+	/* threads placed on this CPU, see z_add_thread_to_ready_q() */
+	struct _ready_q ready_q;
+#endif
 };
 
 typedef struct _cpu _cpu_t;
@@ -13,6 +13,7 @@
 #include <sys/dlist.h>
 #include <ksched.h>
 #include <init.h>
+#include <string.h>
 
 static struct k_spinlock lock;
 
@@ -20,6 +21,264 @@ static struct k_spinlock lock;
 struct k_mem_slab *_trace_list_k_mem_slab;
 #endif	/* CONFIG_OBJECT_TRACING */
 
+#ifdef CONFIG_MEM_SLAB_USAGE
+/* Called with the slab lock held */
+static void usage_update(struct k_mem_slab *slab)
+{
+	sys_mem_usage_set(&slab->usage, k_mem_slab_num_used_get(slab));
+}
+
+static void usage_fail(struct k_mem_slab *slab)
+{
+	k_spinlock_key_t key = k_spin_lock(&lock);
+
+	sys_mem_usage_fail(&slab->usage);
+	k_spin_unlock(&lock, key);
+}
+
+void k_mem_slab_usage_get(struct k_mem_slab *slab, struct sys_mem_usage *usage)
+{
+	k_spinlock_key_t key = k_spin_lock(&lock);
+
+	usage_update(slab);
+	sys_mem_usage_copy(usage, &slab->usage);
+	k_spin_unlock(&lock, key);
+}
+#endif /* CONFIG_MEM_SLAB_USAGE */
+
+#ifdef CONFIG_MEM_SLAB_MAGAZINE
+#define MAG_SIZE CONFIG_MEM_SLAB_MAGAZINE_SIZE
+
+/*
+ * Per-CPU magazine layer, after Bonwick's slab depot.  Each CPU holds
+ * two magazines of up to MAG_SIZE free blocks: the loaded one, which
+ * allocations pop from and frees push to, and the previous one.  When
+ * the loaded magazine runs empty (full) it is exchanged with the
+ * previous one if that is full (empty), so a CPU going back and forth
+ * across a magazine boundary doesn't bounce blocks through the depot.
+ * Only when both are exhausted does a CPU take the slab lock, to load
+ * a magazine's worth of blocks from the depot (the slab's free list),
+ * or to return a whole magazine to it.
+ *
+ * The per-CPU state has a spinlock of its own, which is normally only
+ * taken by its CPU, so that an allocation about to fail or block can
+ * still take a block from another CPU's magazines.  Lock order is the
+ * slab lock, then a CPU lock.  A thread about to wait sets
+ * slab->waiting before scanning the magazines; frees that see it skip
+ * the magazines and hand their block to the waiter under the slab lock.
+ */
+
+static void mag_push(struct z_mem_slab_mag *mag, char *block)
+{
+	*(char **)block = mag->head;
+	if (mag->count == 0U) {
+		mag->tail = block;
+	}
+	mag->head = block;
+	mag->count++;
+}
+
+static char *mag_pop(struct z_mem_slab_mag *mag)
+{
+	char *block = mag->head;
+
+	mag->head = *(char **)block;
+	mag->count--;
+
+	return block;
+}
+
+static void mag_swap(struct z_mem_slab_cpu *cpu)
+{
+	struct z_mem_slab_mag tmp = cpu->loaded;
+
+	cpu->loaded = cpu->prev;
+	cpu->prev = tmp;
+}
+
+/* Called with the slab lock held */
+static void depot_get(struct k_mem_slab *slab, struct z_mem_slab_mag *mag)
+{
+	mag->head = slab->free_list;
+	mag->count = 0U;
+
+	while (slab->free_list != NULL && mag->count < MAG_SIZE) {
+		mag->tail = slab->free_list;
+		slab->free_list = *(char **)slab->free_list;
+		mag->count++;
+	}
+}
+
+/* Called with the slab lock held */
+static void depot_put(struct k_mem_slab *slab, struct z_mem_slab_mag *mag)
+{
+	if (mag->count != 0U) {
+		*(char **)mag->tail = slab->free_list;
+		slab->free_list = mag->head;
+		mag->count = 0U;
+	}
+}
+
+static bool cache_alloc(struct k_mem_slab *slab, void **mem)
+{
+	unsigned int irq = z_arch_irq_lock();
+	struct z_mem_slab_cpu *cpu = &slab->cpu[_current_cpu->id];
+	k_spinlock_key_t key = k_spin_lock(&cpu->lock);
+	bool hit;
+
+	if (cpu->loaded.count == 0U && cpu->prev.count != 0U) {
+		mag_swap(cpu);
+	}
+
+	hit = cpu->loaded.count != 0U;
+	if (hit) {
+		*mem = mag_pop(&cpu->loaded);
+		cpu->num_used++;
+		cpu->hits++;
+	} else {
+		cpu->misses++;
+	}
+
+	k_spin_unlock(&cpu->lock, key);
+	z_arch_irq_unlock(irq);
+
+	return hit;
+}
+
+/* Called with the slab lock held: moves up to a magazine of blocks from
+ * the depot to this CPU
+ */
+static void cache_refill(struct k_mem_slab *slab)
+{
+	struct z_mem_slab_cpu *cpu = &slab->cpu[_current_cpu->id];
+	struct z_mem_slab_mag mag;
+	k_spinlock_key_t key;
+
+	depot_get(slab, &mag);
+	if (mag.count == 0U) {
+		return;
+	}
+
+	key = k_spin_lock(&cpu->lock);
+	if (cpu->loaded.count == 0U) {
+		cpu->loaded = mag;
+		cpu->refills++;
+		mag.count = 0U;
+	}
+	k_spin_unlock(&cpu->lock, key);
+
+	/* An ISR beat us to it */
+	depot_put(slab, &mag);
+}
+
+/* Called with the slab lock held when the depot is empty: takes a block
+ * from any CPU's magazines
+ */
+static char *cache_steal(struct k_mem_slab *slab)
+{
+	char *block = NULL;
+
+	atomic_set(&slab->waiting, 1);
+
+	for (int i = 0; i < CONFIG_MP_NUM_CPUS && block == NULL; i++) {
+		struct z_mem_slab_cpu *cpu = &slab->cpu[i];
+		k_spinlock_key_t key = k_spin_lock(&cpu->lock);
+
+		if (cpu->loaded.count == 0U && cpu->prev.count != 0U) {
+			mag_swap(cpu);
+		}
+		if (cpu->loaded.count != 0U) {
+			block = mag_pop(&cpu->loaded);
+		}
+
+		k_spin_unlock(&cpu->lock, key);
+	}
+
+	return block;
+}
+
+static bool cache_free(struct k_mem_slab *slab, void **mem)
+{
+	unsigned int irq = z_arch_irq_lock();
+	struct z_mem_slab_cpu *cpu = &slab->cpu[_current_cpu->id];
+	k_spinlock_key_t key = k_spin_lock(&cpu->lock);
+	struct z_mem_slab_mag full = { .count = 0U };
+	struct k_thread *pending_thread;
+	bool woken = false;
+
+	if (atomic_get(&slab->waiting) != 0) {
+		k_spin_unlock(&cpu->lock, key);
+		z_arch_irq_unlock(irq);
+		return false;
+	}
+
+	if (cpu->loaded.count == MAG_SIZE) {
+		if (cpu->prev.count != 0U) {
+			full = cpu->prev;
+			cpu->prev.count = 0U;
+			cpu->flushes++;
+		}
+		mag_swap(cpu);
+	}
+
+	mag_push(&cpu->loaded, *mem);
+	cpu->num_used--;
+
+	k_spin_unlock(&cpu->lock, key);
+	z_arch_irq_unlock(irq);
+
+	if (full.count == 0U) {
+		return true;
+	}
+
+	/* Return the full magazine to the depot, serving any thread that
+	 * started waiting since we checked
+	 */
+	key = k_spin_lock(&lock);
+
+	while (full.count != 0U) {
+		pending_thread = z_unpend_first_thread(&slab->wait_q);
+		if (pending_thread == NULL) {
+			break;
+		}
+		z_thread_return_value_set_with_data(pending_thread, 0,
+						    mag_pop(&full));
+		z_ready_thread(pending_thread);
+		slab->num_used++;
+		woken = true;
+	}
+
+	depot_put(slab, &full);
+#ifdef CONFIG_MEM_SLAB_USAGE
+	usage_update(slab);
+#endif
+
+	if (woken) {
+		z_reschedule(&lock, key);
+	} else {
+		k_spin_unlock(&lock, key);
+	}
+
+	return true;
+}
+
+void k_mem_slab_cache_stats_get(struct k_mem_slab *slab,
+				struct k_mem_slab_cache_stats *stats)
+{
+	(void)memset(stats, 0, sizeof(*stats));
+
+	for (int i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		struct z_mem_slab_cpu *cpu = &slab->cpu[i];
+
+		stats->hits += cpu->hits;
+		stats->misses += cpu->misses;
+		stats->refills += cpu->refills;
+		stats->flushes += cpu->flushes;
+		stats->cached += cpu->loaded.count + cpu->prev.count;
+	}
+}
+#endif /* CONFIG_MEM_SLAB_MAGAZINE */
+
 /**
  * @brief Initialize kernel memory slab subsystem.
  *
@@ -61,6 +320,10 @@ static int init_mem_slab_module(struct device *dev)
 
 	Z_STRUCT_SECTION_FOREACH(k_mem_slab, slab) {
 		create_free_list(slab);
+#if defined(CONFIG_MEM_SLAB_USAGE) && defined(CONFIG_MEM_USAGE_STATS)
+		(void)sys_mem_usage_register(&slab->usage,
+					     Z_MEM_USAGE_NAME(&slab->usage));
+#endif
 		SYS_TRACING_OBJ_INIT(k_mem_slab, slab);
 		z_object_init(slab);
 	}
@@ -77,6 +340,13 @@ void k_mem_slab_init(struct k_mem_slab *slab, void *buffer,
 	slab->block_size = block_size;
 	slab->buffer = buffer;
 	slab->num_used = 0U;
+#ifdef CONFIG_MEM_SLAB_MAGAZINE
+	slab->waiting = 0;
+	(void)memset(slab->cpu, 0, sizeof(slab->cpu));
+#endif
+#ifdef CONFIG_MEM_SLAB_USAGE
+	sys_mem_usage_reset(&slab->usage);
+#endif
 	create_free_list(slab);
 	z_waitq_init(&slab->wait_q);
 	SYS_TRACING_OBJ_INIT(k_mem_slab, slab);
@@ -86,28 +356,60 @@ void k_mem_slab_init(struct k_mem_slab *slab, void *buffer,
 
 int k_mem_slab_alloc(struct k_mem_slab *slab, void **mem, s32_t timeout)
 {
-	k_spinlock_key_t key = k_spin_lock(&lock);
+	k_spinlock_key_t key;
 	int result;
 
+#ifdef CONFIG_MEM_SLAB_MAGAZINE
+	if (cache_alloc(slab, mem)) {
+		return 0;
+	}
+#endif
+
+	key = k_spin_lock(&lock);
+
 	if (slab->free_list != NULL) {
 		/* take a free block */
 		*mem = slab->free_list;
 		slab->free_list = *(char **)(slab->free_list);
 		slab->num_used++;
 		result = 0;
+#ifdef CONFIG_MEM_SLAB_MAGAZINE
+		cache_refill(slab);
+	} else if ((*mem = cache_steal(slab)) != NULL) {
+		slab->num_used++;
+		result = 0;
+		if (z_waitq_head(&slab->wait_q) == NULL) {
+			atomic_clear(&slab->waiting);
+		}
+#endif
 	} else if (timeout == K_NO_WAIT) {
 		/* don't wait for a free block to become available */
 		*mem = NULL;
 		result = -ENOMEM;
 	} else {
+#ifdef CONFIG_MEM_SLAB_USAGE
+		usage_update(slab);
+#endif
 		/* wait for a free block or timeout */
 		result = z_pend_curr(&lock, key, &slab->wait_q, timeout);
 		if (result == 0) {
 			*mem = _current->base.swap_data;
 		}
+#ifdef CONFIG_MEM_SLAB_USAGE
+		if (result != 0) {
+			usage_fail(slab);
+		}
+#endif
 		return result;
 	}
 
+#ifdef CONFIG_MEM_SLAB_USAGE
+	usage_update(slab);
+	if (result != 0) {
+		sys_mem_usage_fail(&slab->usage);
+	}
+#endif
+
 	k_spin_unlock(&lock, key);
 
 	return result;
@@ -115,17 +417,32 @@ int k_mem_slab_alloc(struct k_mem_slab *slab, void **mem, s32_t timeout)
 
 void k_mem_slab_free(struct k_mem_slab *slab, void **mem)
 {
-	k_spinlock_key_t key = k_spin_lock(&lock);
-	struct k_thread *pending_thread = z_unpend_first_thread(&slab->wait_q);
+	k_spinlock_key_t key;
+	struct k_thread *pending_thread;
+
+#ifdef CONFIG_MEM_SLAB_MAGAZINE
+	if (cache_free(slab, mem)) {
+		return;
+	}
+#endif
+
+	key = k_spin_lock(&lock);
+	pending_thread = z_unpend_first_thread(&slab->wait_q);
 
 	if (pending_thread != NULL) {
 		z_thread_return_value_set_with_data(pending_thread, 0, *mem);
 		z_ready_thread(pending_thread);
 		z_reschedule(&lock, key);
 	} else {
+#ifdef CONFIG_MEM_SLAB_MAGAZINE
+		atomic_clear(&slab->waiting);
+#endif
 		**(char ***)mem = slab->free_list;
 		slab->free_list = *(char **)mem;
 		slab->num_used--;
+#ifdef CONFIG_MEM_SLAB_USAGE
+		usage_update(slab);
+#endif
 		k_spin_unlock(&lock, key);
 	}
 }
@@ -27,12 +27,161 @@ static int pool_id(struct k_mem_pool *pool)
 	return pool - &_k_mem_pool_list_start[0];
 }
 
+#ifdef CONFIG_MEM_POOL_TLSF
+/* TLSF blocks are identified by their offset in the pool buffer, in
+ * Z_TLSF_ALIGN units, spread over the level and block fields of the id
+ */
+static void *block_data(struct k_mem_pool *p, struct k_mem_block_id *id)
+{
+	size_t off = ((size_t)id->level << 20) | id->block;
+
+	return (u8_t *)p->tlsf.buf + off * Z_TLSF_ALIGN;
+}
+
+static void k_mem_pool_init(struct k_mem_pool *p)
+{
+	z_waitq_init(&p->wait_q);
+	sys_tlsf_init(&p->tlsf);
+#if defined(CONFIG_MEM_POOL_USAGE) && defined(CONFIG_MEM_USAGE_STATS)
+	(void)sys_mem_usage_register(&p->tlsf.usage,
+				     Z_MEM_USAGE_NAME(&p->tlsf.usage));
+#endif
+}
+
+static int pool_block_alloc(struct k_mem_pool *p, size_t size,
+			    struct k_mem_block *block)
+{
+	k_spinlock_key_t key = k_spin_lock(&lock);
+	void *data = sys_tlsf_alloc(&p->tlsf, size);
+	size_t off;
+
+	k_spin_unlock(&lock, key);
+
+	if (data == NULL) {
+		return -ENOMEM;
+	}
+
+	off = ((u8_t *)data - (u8_t *)p->tlsf.buf) / Z_TLSF_ALIGN;
+	block->data = data;
+	block->id.level = off >> 20;
+	block->id.block = off & 0xfffff;
+
+	return 0;
+}
+
+static void pool_block_free(struct k_mem_pool *p, struct k_mem_block_id *id)
+{
+	k_spinlock_key_t key = k_spin_lock(&lock);
+
+	sys_tlsf_free(&p->tlsf, block_data(p, id));
+	k_spin_unlock(&lock, key);
+}
+
+static size_t pool_block_size(struct k_mem_pool *p, struct k_mem_block_id *id)
+{
+	return sys_tlsf_usable_size(block_data(p, id));
+}
+
+#ifdef CONFIG_MEM_POOL_USAGE
+void k_mem_pool_usage_get(struct k_mem_pool *pool, struct sys_mem_usage *usage)
+{
+	k_spinlock_key_t key = k_spin_lock(&lock);
+
+	sys_mem_usage_copy(usage, &pool->tlsf.usage);
+	k_spin_unlock(&lock, key);
+}
+#endif
+
+int k_mem_pool_free_blocks_get(struct k_mem_pool *pool, int level,
+			       size_t *block_size)
+{
+	k_spinlock_key_t key = k_spin_lock(&lock);
+	int ret = sys_tlsf_free_blocks(&pool->tlsf, level, block_size);
+
+	k_spin_unlock(&lock, key);
+
+	return ret;
+}
+
+static bool pool_block_resize(struct k_mem_pool *p, struct k_mem_block_id *id,
+			      size_t size)
+{
+	k_spinlock_key_t key = k_spin_lock(&lock);
+	int ret = sys_tlsf_realloc_in_place(&p->tlsf, block_data(p, id), size);
+
+	k_spin_unlock(&lock, key);
+
+	return ret == 0;
+}
+#else
 static void k_mem_pool_init(struct k_mem_pool *p)
 {
 	z_waitq_init(&p->wait_q);
 	z_sys_mem_pool_base_init(&p->base);
+#if defined(CONFIG_MEM_POOL_USAGE) && defined(CONFIG_MEM_USAGE_STATS)
+	(void)sys_mem_usage_register(&p->base.usage,
+				     Z_MEM_USAGE_NAME(&p->base.usage));
+#endif
+}
+
+static int pool_block_alloc(struct k_mem_pool *p, size_t size,
+			    struct k_mem_block *block)
+{
+	u32_t level_num, block_num;
+	int ret;
+
+	ret = z_sys_mem_pool_block_alloc(&p->base, size,
+					 &level_num, &block_num,
+					 &block->data);
+	block->id.level = level_num;
+	block->id.block = block_num;
+
+	return ret;
+}
+
+static void pool_block_free(struct k_mem_pool *p, struct k_mem_block_id *id)
+{
+	z_sys_mem_pool_block_free(&p->base, id->level, id->block);
+}
+
+static size_t pool_block_size(struct k_mem_pool *p, struct k_mem_block_id *id)
+{
+	size_t lsz = p->base.max_sz;
+
+	for (int i = 0; i < id->level; i++) {
+		lsz = WB_DN(lsz / 4);
+	}
+
+	return lsz;
 }
 
+#ifdef CONFIG_MEM_POOL_USAGE
+void k_mem_pool_usage_get(struct k_mem_pool *pool, struct sys_mem_usage *usage)
+{
+	/* The buddy code updates the counters under irq_lock() */
+	unsigned int key = irq_lock();
+
+	sys_mem_usage_copy(usage, &pool->base.usage);
+	irq_unlock(key);
+}
+#endif
+
+int k_mem_pool_free_blocks_get(struct k_mem_pool *pool, int level,
+			       size_t *block_size)
+{
+	return z_sys_mem_pool_free_blocks(&pool->base, level, block_size);
+}
+
+/* Buddy blocks have a fixed size, so resizing in place only works
+ * within the block already held
+ */
+static bool pool_block_resize(struct k_mem_pool *p, struct k_mem_block_id *id,
+			      size_t size)
+{
+	return size <= pool_block_size(p, id);
+}
+#endif /* CONFIG_MEM_POOL_TLSF */
+
 int init_static_pools(struct device *unused)
 {
 	ARG_UNUSED(unused);
@@ -59,14 +208,8 @@ int k_mem_pool_alloc(struct k_mem_pool *p, struct k_mem_block *block,
 	}
 
 	while (true) {
-		u32_t level_num, block_num;
-
-		ret = z_sys_mem_pool_block_alloc(&p->base, size,
-						 &level_num, &block_num,
-						 &block->data);
+		ret = pool_block_alloc(p, size, block);
 		block->id.pool = pool_id(p);
-		block->id.level = level_num;
-		block->id.block = block_num;
 
 		if (ret == 0 || timeout == K_NO_WAIT ||
 		    ret != -ENOMEM) {
@@ -86,12 +229,9 @@ int k_mem_pool_alloc(struct k_mem_pool *p, struct k_mem_block *block,
 	return -EAGAIN;
 }
 
-void k_mem_pool_free_id(struct k_mem_block_id *id)
+static void wake_waiters(struct k_mem_pool *p)
 {
 	int need_sched = 0;
-	struct k_mem_pool *p = get_pool(id->pool);
-
-	z_sys_mem_pool_block_free(&p->base, id->level, id->block);
 
 	/* Wake up anyone blocked on this pool and let them repeat
 	 * their allocation attempts
@@ -111,6 +251,14 @@ void k_mem_pool_free_id(struct k_mem_block_id *id)
 	}
 }
 
+void k_mem_pool_free_id(struct k_mem_block_id *id)
+{
+	struct k_mem_pool *p = get_pool(id->pool);
+
+	pool_block_free(p, id);
+	wake_waiters(p);
+}
+
 void k_mem_pool_free(struct k_mem_block *block)
 {
 	k_mem_pool_free_id(&block->id);
@@ -150,6 +298,48 @@ void k_free(void *ptr)
 	}
 }
 
+void *k_mem_pool_realloc(struct k_mem_pool *pool, void *ptr, size_t size)
+{
+	struct k_mem_block_id *id;
+	struct k_mem_pool *p;
+	size_t old_size, new_size;
+	void *ret;
+
+	if (ptr == NULL) {
+		return k_mem_pool_malloc(pool, size);
+	}
+
+	if (size == 0) {
+		k_free(ptr);
+		return NULL;
+	}
+
+	/* point to hidden block descriptor at start of block */
+	id = (struct k_mem_block_id *)((char *)ptr -
+				       WB_UP(sizeof(struct k_mem_block_id)));
+	p = get_pool(id->pool);
+	old_size = pool_block_size(p, id) -
+		WB_UP(sizeof(struct k_mem_block_id));
+
+	if (!size_add_overflow(size, WB_UP(sizeof(struct k_mem_block_id)),
+			       &new_size) &&
+	    pool_block_resize(p, id, new_size)) {
+		if (size < old_size) {
+			/* The tail may have gone back to the pool */
+			wake_waiters(p);
+		}
+		return ptr;
+	}
+
+	ret = k_mem_pool_malloc(p, size);
+	if (ret != NULL) {
+		(void)memcpy(ret, ptr, MIN(size, old_size));
+		k_free(ptr);
+	}
+
+	return ret;
+}
+
 #if (CONFIG_HEAP_MEM_POOL_SIZE > 0)
 
 /*
@@ -184,6 +374,11 @@ void *k_calloc(size_t nmemb, size_t size)
 	return ret;
 }
 
+void *k_realloc(void *ptr, size_t size)
+{
+	return k_mem_pool_realloc(_HEAP_MEM_POOL, ptr, size);
+}
+
 void k_thread_system_pool_assign(struct k_thread *thread)
 {
 	thread->resource_pool = _HEAP_MEM_POOL;
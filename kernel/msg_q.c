@@ -44,6 +44,240 @@ SYS_INIT(init_msgq_module, PRE_KERNEL_1, CONFIG_KERNEL_INIT_PRIORITY_OBJECTS);
 
 #endif /* CONFIG_OBJECT_TRACING */
 
+#ifdef CONFIG_MSGQ_LOCKFREE
+/*
+ * Lock-free mode.  lf_head and lf_tail are free-running message
+ * counters (hence the power of 2 size), so head - tail is the number of
+ * messages queued or, with several producers, reserved.  With a single
+ * producer the producer publishes by advancing lf_head after copying.
+ * With several producers lf_head only reserves slots (via CAS), and
+ * each slot is published by storing its message index + 1 in lf_seq[];
+ * the consumer stops at the first slot not yet published, so a
+ * producer preempted in the middle of its copy delays later messages
+ * but never exposes a partial one.
+ *
+ * Nothing here takes the queue's spinlock unless a caller must block,
+ * or lf_waiters says somebody is blocked.  Waiters set lf_waiters and
+ * re-check the queue under the lock before pending; the other side
+ * makes its change visible before reading lf_waiters, and takes the
+ * lock to wake, so a wakeup can't be lost.  Woken waiters simply
+ * retry.
+ */
+static inline bool is_lockfree(struct k_msgq *msgq)
+{
+	return (msgq->flags & K_MSGQ_FLAG_LOCKFREE) != 0U;
+}
+
+static void lf_copy_in(struct k_msgq *msgq, u32_t idx, const char *data,
+		       u32_t num)
+{
+	u32_t slot = idx & (msgq->max_msgs - 1U);
+	u32_t first = MIN(num, msgq->max_msgs - slot);
+
+	(void)memcpy(msgq->buffer_start + slot * msgq->msg_size, data,
+		     first * msgq->msg_size);
+	(void)memcpy(msgq->buffer_start, data + first * msgq->msg_size,
+		     (num - first) * msgq->msg_size);
+}
+
+static void lf_copy_out(struct k_msgq *msgq, u32_t idx, char *data,
+			u32_t num)
+{
+	u32_t slot = idx & (msgq->max_msgs - 1U);
+	u32_t first = MIN(num, msgq->max_msgs - slot);
+
+	(void)memcpy(data, msgq->buffer_start + slot * msgq->msg_size,
+		     first * msgq->msg_size);
+	(void)memcpy(data + first * msgq->msg_size, msgq->buffer_start,
+		     (num - first) * msgq->msg_size);
+}
+
+/* Free slots as seen from head, or -1 if head is already stale */
+static inline s32_t lf_space(struct k_msgq *msgq, u32_t head)
+{
+	s32_t used = (s32_t)(head - (u32_t)atomic_get(&msgq->lf_tail));
+
+	return used < 0 ? -1 : (s32_t)msgq->max_msgs - used;
+}
+
+/* Number of published messages from tail on, up to num */
+static u32_t lf_ready(struct k_msgq *msgq, u32_t tail, u32_t num)
+{
+	u32_t n = 0U;
+
+	if (msgq->lf_seq == NULL) {
+		return MIN(num, (u32_t)atomic_get(&msgq->lf_head) - tail);
+	}
+
+	while (n < num &&
+	       (u32_t)atomic_get(&msgq->lf_seq[(tail + n) &
+						(msgq->max_msgs - 1U)])
+	       == tail + n + 1U) {
+		n++;
+	}
+
+	return n;
+}
+
+static u32_t lf_try_put(struct k_msgq *msgq, const char *data, u32_t num)
+{
+	u32_t head;
+	s32_t space;
+
+	while (true) {
+		head = (u32_t)atomic_get(&msgq->lf_head);
+		space = lf_space(msgq, head);
+		if (space == 0) {
+			return 0;
+		} else if (space < 0) {
+			continue;
+		}
+
+		num = MIN(num, (u32_t)space);
+		if (msgq->lf_seq == NULL ||
+		    atomic_cas(&msgq->lf_head, head, head + num)) {
+			break;
+		}
+	}
+
+	lf_copy_in(msgq, head, data, num);
+
+	if (msgq->lf_seq == NULL) {
+		atomic_set(&msgq->lf_head, head + num);
+	} else {
+		for (u32_t i = 0; i < num; i++) {
+			atomic_set(&msgq->lf_seq[(head + i) &
+						 (msgq->max_msgs - 1U)],
+				   head + i + 1U);
+		}
+	}
+
+	return num;
+}
+
+static u32_t lf_try_get(struct k_msgq *msgq, char *data, u32_t num,
+			bool peek)
+{
+	u32_t tail = (u32_t)atomic_get(&msgq->lf_tail);
+
+	num = lf_ready(msgq, tail, num);
+	if (num != 0U) {
+		lf_copy_out(msgq, tail, data, num);
+		if (!peek) {
+			atomic_set(&msgq->lf_tail, tail + num);
+		}
+	}
+
+	return num;
+}
+
+static void lf_wake(struct k_msgq *msgq, int ret)
+{
+	struct k_thread *pending_thread;
+	k_spinlock_key_t key;
+
+	if (atomic_get(&msgq->lf_waiters) == 0) {
+		return;
+	}
+
+	key = k_spin_lock(&msgq->lock);
+	atomic_clear(&msgq->lf_waiters);
+	while ((pending_thread = z_unpend_first_thread(&msgq->wait_q)) != NULL) {
+		z_arch_thread_return_value_set(pending_thread, ret);
+		z_ready_thread(pending_thread);
+	}
+	z_reschedule(&msgq->lock, key);
+}
+
+static int lf_pend(struct k_msgq *msgq, bool put, s32_t timeout)
+{
+	k_spinlock_key_t key = k_spin_lock(&msgq->lock);
+	bool ready;
+
+	atomic_set(&msgq->lf_waiters, 1);
+
+	if (put) {
+		ready = lf_space(msgq, (u32_t)atomic_get(&msgq->lf_head)) != 0;
+	} else {
+		ready = lf_ready(msgq, (u32_t)atomic_get(&msgq->lf_tail),
+				 1U) != 0U;
+	}
+
+	if (ready) {
+		k_spin_unlock(&msgq->lock, key);
+		return 0;
+	}
+
+	return z_pend_curr(&msgq->lock, key, &msgq->wait_q, timeout);
+}
+
+static inline u32_t lf_try(struct k_msgq *msgq, char *data, u32_t num,
+			   bool put)
+{
+	num = put ? lf_try_put(msgq, data, num) :
+		    lf_try_get(msgq, data, num, false);
+	if (num != 0U) {
+		lf_wake(msgq, 0);
+	}
+
+	return num;
+}
+
+static int lf_transfer(struct k_msgq *msgq, char *data, u32_t num,
+		       s32_t timeout, bool put)
+{
+	s64_t end;
+	u32_t n;
+	int ret;
+
+	n = lf_try(msgq, data, num, put);
+	if (n != 0U) {
+		return n;
+	} else if (timeout == K_NO_WAIT) {
+		return -ENOMSG;
+	}
+
+	end = timeout == K_FOREVER ? 0 : k_uptime_get() + timeout;
+
+	while (true) {
+		ret = lf_pend(msgq, put, timeout);
+		if (ret != 0) {
+			return ret;
+		}
+
+		/* Woken up, or raced with the other side: retry, and
+		 * keep waiting for whatever is left of the period if
+		 * another producer got there first.
+		 */
+		n = lf_try(msgq, data, num, put);
+		if (n != 0U) {
+			return n;
+		}
+
+		if (timeout != K_FOREVER) {
+			timeout = (s32_t)(end - k_uptime_get());
+			if (timeout <= 0) {
+				return -EAGAIN;
+			}
+		}
+	}
+}
+
+int k_msgq_lockfree_init(struct k_msgq *msgq, char *buffer, size_t msg_size,
+			 u32_t max_msgs, atomic_t *seq)
+{
+	if (max_msgs == 0U || (max_msgs & (max_msgs - 1U)) != 0U) {
+		return -EINVAL;
+	}
+
+	k_msgq_init(msgq, buffer, msg_size, max_msgs);
+	msgq->flags = K_MSGQ_FLAG_LOCKFREE;
+	msgq->lf_seq = seq;
+
+	return 0;
+}
+#endif /* CONFIG_MSGQ_LOCKFREE */
+
 void k_msgq_init(struct k_msgq *msgq, char *buffer, size_t msg_size,
 		 u32_t max_msgs)
 {
@@ -57,6 +291,12 @@ void k_msgq_init(struct k_msgq *msgq, char *buffer, size_t msg_size,
 	msgq->flags = 0;
 	z_waitq_init(&msgq->wait_q);
 	msgq->lock = (struct k_spinlock) {};
+#ifdef CONFIG_MSGQ_LOCKFREE
+	atomic_clear(&msgq->lf_head);
+	atomic_clear(&msgq->lf_tail);
+	atomic_clear(&msgq->lf_waiters);
+	msgq->lf_seq = NULL;
+#endif
 
 	SYS_TRACING_OBJ_INIT(k_msgq, msgq);
 
@@ -116,6 +356,13 @@ int z_impl_k_msgq_put(struct k_msgq *msgq, void *data, s32_t timeout)
 	k_spinlock_key_t key;
 	int result;
 
+#ifdef CONFIG_MSGQ_LOCKFREE
+	if (is_lockfree(msgq)) {
+		result = lf_transfer(msgq, data, 1, timeout, true);
+		return result < 0 ? result : 0;
+	}
+#endif
+
 	key = k_spin_lock(&msgq->lock);
 
 	if (msgq->used_msgs < msgq->max_msgs) {
@@ -169,7 +416,7 @@ void z_impl_k_msgq_get_attrs(struct k_msgq *msgq, struct k_msgq_attrs *attrs)
 {
 	attrs->msg_size = msgq->msg_size;
 	attrs->max_msgs = msgq->max_msgs;
-	attrs->used_msgs = msgq->used_msgs;
+	attrs->used_msgs = z_msgq_used(msgq);
 }
 
 #ifdef CONFIG_USERSPACE
@@ -191,6 +438,13 @@ int z_impl_k_msgq_get(struct k_msgq *msgq, void *data, s32_t timeout)
 	struct k_thread *pending_thread;
 	int result;
 
+#ifdef CONFIG_MSGQ_LOCKFREE
+	if (is_lockfree(msgq)) {
+		result = lf_transfer(msgq, data, 1, timeout, false);
+		return result < 0 ? result : 0;
+	}
+#endif
+
 	key = k_spin_lock(&msgq->lock);
 
 	if (msgq->used_msgs > 0) {
@@ -246,11 +500,187 @@ static inline int z_vrfy_k_msgq_get(struct k_msgq *q, void *data, s32_t timeout)
 #include <syscalls/k_msgq_get_mrsh.c>
 #endif
 
+int z_impl_k_msgq_put_many(struct k_msgq *msgq, const void *data, u32_t num,
+			   s32_t timeout)
+{
+	__ASSERT(!z_arch_is_in_isr() || timeout == K_NO_WAIT, "");
+
+	const char *msg = data;
+	struct k_thread *pending_thread;
+	k_spinlock_key_t key;
+	bool woken = false;
+	u32_t n;
+	int ret;
+
+	if (num == 0U) {
+		return -EINVAL;
+	}
+
+#ifdef CONFIG_MSGQ_LOCKFREE
+	if (is_lockfree(msgq)) {
+		return lf_transfer(msgq, (char *)msg, num, timeout, true);
+	}
+#endif
+
+	key = k_spin_lock(&msgq->lock);
+
+	/* Same as a run of k_msgq_put() calls, but under one lock and
+	 * with one reschedule for the whole batch.
+	 */
+	for (n = 0U; n < num; n++, msg += msgq->msg_size) {
+		if (msgq->used_msgs == msgq->max_msgs) {
+			break;
+		}
+
+		pending_thread = z_unpend_first_thread(&msgq->wait_q);
+		if (pending_thread != NULL) {
+			/* give message to waiting thread */
+			(void)memcpy(pending_thread->base.swap_data, msg,
+				     msgq->msg_size);
+			z_arch_thread_return_value_set(pending_thread, 0);
+			z_ready_thread(pending_thread);
+			woken = true;
+		} else {
+			(void)memcpy(msgq->write_ptr, msg, msgq->msg_size);
+			msgq->write_ptr += msgq->msg_size;
+			if (msgq->write_ptr == msgq->buffer_end) {
+				msgq->write_ptr = msgq->buffer_start;
+			}
+			msgq->used_msgs++;
+		}
+	}
+
+	if (n == 0U) {
+		if (timeout == K_NO_WAIT) {
+			k_spin_unlock(&msgq->lock, key);
+			return -ENOMSG;
+		}
+
+		/* queue is full: wait to hand over the first message */
+		_current->base.swap_data = (void *)data;
+		ret = z_pend_curr(&msgq->lock, key, &msgq->wait_q, timeout);
+		return ret == 0 ? 1 : ret;
+	}
+
+	if (woken) {
+		z_reschedule(&msgq->lock, key);
+	} else {
+		k_spin_unlock(&msgq->lock, key);
+	}
+
+	return n;
+}
+
+#ifdef CONFIG_USERSPACE
+static inline int z_vrfy_k_msgq_put_many(struct k_msgq *q, const void *data,
+					 u32_t num, s32_t timeout)
+{
+	Z_OOPS(Z_SYSCALL_OBJ(q, K_OBJ_MSGQ));
+	Z_OOPS(Z_SYSCALL_MEMORY_ARRAY_READ(data, num, q->msg_size));
+
+	return z_impl_k_msgq_put_many(q, data, num, timeout);
+}
+#include <syscalls/k_msgq_put_many_mrsh.c>
+#endif
+
+int z_impl_k_msgq_get_many(struct k_msgq *msgq, void *data, u32_t num,
+			   s32_t timeout)
+{
+	__ASSERT(!z_arch_is_in_isr() || timeout == K_NO_WAIT, "");
+
+	char *msg = data;
+	struct k_thread *pending_thread;
+	k_spinlock_key_t key;
+	bool woken = false;
+	u32_t n;
+	int ret;
+
+	if (num == 0U) {
+		return -EINVAL;
+	}
+
+#ifdef CONFIG_MSGQ_LOCKFREE
+	if (is_lockfree(msgq)) {
+		return lf_transfer(msgq, msg, num, timeout, false);
+	}
+#endif
+
+	key = k_spin_lock(&msgq->lock);
+
+	/* Same as a run of k_msgq_get() calls, but under one lock and
+	 * with one reschedule for the whole batch.
+	 */
+	for (n = 0U; n < num && msgq->used_msgs > 0; n++) {
+		(void)memcpy(msg, msgq->read_ptr, msgq->msg_size);
+		msg += msgq->msg_size;
+		msgq->read_ptr += msgq->msg_size;
+		if (msgq->read_ptr == msgq->buffer_end) {
+			msgq->read_ptr = msgq->buffer_start;
+		}
+		msgq->used_msgs--;
+
+		/* refill from the first thread waiting to write (if any) */
+		pending_thread = z_unpend_first_thread(&msgq->wait_q);
+		if (pending_thread != NULL) {
+			(void)memcpy(msgq->write_ptr,
+				     pending_thread->base.swap_data,
+				     msgq->msg_size);
+			msgq->write_ptr += msgq->msg_size;
+			if (msgq->write_ptr == msgq->buffer_end) {
+				msgq->write_ptr = msgq->buffer_start;
+			}
+			msgq->used_msgs++;
+
+			z_arch_thread_return_value_set(pending_thread, 0);
+			z_ready_thread(pending_thread);
+			woken = true;
+		}
+	}
+
+	if (n == 0U) {
+		if (timeout == K_NO_WAIT) {
+			k_spin_unlock(&msgq->lock, key);
+			return -ENOMSG;
+		}
+
+		/* queue is empty: wait for a sender to hand one over */
+		_current->base.swap_data = data;
+		ret = z_pend_curr(&msgq->lock, key, &msgq->wait_q, timeout);
+		return ret == 0 ? 1 : ret;
+	}
+
+	if (woken) {
+		z_reschedule(&msgq->lock, key);
+	} else {
+		k_spin_unlock(&msgq->lock, key);
+	}
+
+	return n;
+}
+
+#ifdef CONFIG_USERSPACE
+static inline int z_vrfy_k_msgq_get_many(struct k_msgq *q, void *data,
+					 u32_t num, s32_t timeout)
+{
+	Z_OOPS(Z_SYSCALL_OBJ(q, K_OBJ_MSGQ));
+	Z_OOPS(Z_SYSCALL_MEMORY_ARRAY_WRITE(data, num, q->msg_size));
+
+	return z_impl_k_msgq_get_many(q, data, num, timeout);
+}
+#include <syscalls/k_msgq_get_many_mrsh.c>
+#endif
+
 int z_impl_k_msgq_peek(struct k_msgq *msgq, void *data)
 {
 	k_spinlock_key_t key;
 	int result;
 
+#ifdef CONFIG_MSGQ_LOCKFREE
+	if (is_lockfree(msgq)) {
+		return lf_try_get(msgq, data, 1, true) != 0U ? 0 : -ENOMSG;
+	}
+#endif
+
 	key = k_spin_lock(&msgq->lock);
 
 	if (msgq->used_msgs > 0) {
@@ -283,6 +713,20 @@ void z_impl_k_msgq_purge(struct k_msgq *msgq)
 	k_spinlock_key_t key;
 	struct k_thread *pending_thread;
 
+#ifdef CONFIG_MSGQ_LOCKFREE
+	if (is_lockfree(msgq)) {
+		u32_t tail = (u32_t)atomic_get(&msgq->lf_tail);
+
+		/* Discard what is published; slots still being filled by
+		 * a preempted producer show up once it is done.
+		 */
+		tail += lf_ready(msgq, tail, msgq->max_msgs);
+		atomic_set(&msgq->lf_tail, tail);
+		lf_wake(msgq, -ENOMSG);
+		return;
+	}
+#endif
+
 	key = k_spin_lock(&msgq->lock);
 
 	/* wake up any threads that are waiting to write */
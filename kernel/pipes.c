@@ -753,6 +753,158 @@ int z_vrfy_k_pipe_put(struct k_pipe *pipe, void *data, size_t bytes_to_write,
 #include <syscalls/k_pipe_put_mrsh.c>
 #endif
 
+size_t k_pipe_put_claim(struct k_pipe *pipe, u8_t **data, size_t size)
+{
+	k_spinlock_key_t key = k_spin_lock(&pipe->lock);
+
+	size = MIN(size, MIN(pipe->size - pipe->bytes_used,
+			     pipe->size - pipe->write_index));
+	*data = pipe->buffer + pipe->write_index;
+
+	k_spin_unlock(&pipe->lock, key);
+
+	return size;
+}
+
+int k_pipe_put_commit(struct k_pipe *pipe, size_t size)
+{
+	struct k_thread    *reader;
+	struct k_pipe_desc *desc;
+	size_t         bytes_copied;
+
+	k_spinlock_key_t key = k_spin_lock(&pipe->lock);
+
+	if (size > pipe->size - pipe->bytes_used ||
+	    size > pipe->size - pipe->write_index) {
+		k_spin_unlock(&pipe->lock, key);
+		return -EINVAL;
+	}
+
+	pipe->bytes_used  += size;
+	pipe->write_index += size;
+	if (pipe->write_index == pipe->size) {
+		pipe->write_index = 0;
+	}
+
+	/*
+	 * Readers only wait on an empty buffer, so hand them the new
+	 * data in order. As in k_pipe_put(), a reader that can't be
+	 * completely satisfied keeps what it got and stays pended.
+	 */
+	while ((pipe->bytes_used != 0) &&
+	       ((reader = z_waitq_head(&pipe->wait_q.readers)) != NULL)) {
+		desc = (struct k_pipe_desc *)reader->base.swap_data;
+		bytes_copied = pipe_buffer_get(pipe, desc->buffer,
+						desc->bytes_to_xfer);
+
+		desc->buffer        += bytes_copied;
+		desc->bytes_to_xfer -= bytes_copied;
+
+		if (desc->bytes_to_xfer != 0) {
+			break;
+		}
+
+		z_unpend_thread(reader);
+		z_ready_thread(reader);
+	}
+
+	/* One reschedule for the whole batch */
+	z_reschedule(&pipe->lock, key);
+
+	return 0;
+}
+
+size_t k_pipe_get_claim(struct k_pipe *pipe, u8_t **data, size_t size)
+{
+	k_spinlock_key_t key = k_spin_lock(&pipe->lock);
+
+	size = MIN(size, MIN(pipe->bytes_used,
+			     pipe->size - pipe->read_index));
+	*data = pipe->buffer + pipe->read_index;
+
+	k_spin_unlock(&pipe->lock, key);
+
+	return size;
+}
+
+int k_pipe_get_commit(struct k_pipe *pipe, size_t size)
+{
+	struct k_thread    *writer;
+	struct k_pipe_desc *desc;
+	size_t         bytes_copied;
+#if (CONFIG_NUM_PIPE_ASYNC_MSGS > 0)
+	sys_dlist_t    async_list;
+
+	sys_dlist_init(&async_list);
+#endif
+
+	k_spinlock_key_t key = k_spin_lock(&pipe->lock);
+
+	if (size > pipe->bytes_used ||
+	    size > pipe->size - pipe->read_index) {
+		k_spin_unlock(&pipe->lock, key);
+		return -EINVAL;
+	}
+
+	pipe->bytes_used -= size;
+	pipe->read_index += size;
+	if (pipe->read_index == pipe->size) {
+		pipe->read_index = 0;
+	}
+
+	/*
+	 * Writers only wait on a full buffer, so let them refill the
+	 * freed space in order. A writer that doesn't fit entirely
+	 * stays pended with the rest of its data.
+	 */
+	while ((writer = z_waitq_head(&pipe->wait_q.writers)) != NULL) {
+		desc = (struct k_pipe_desc *)writer->base.swap_data;
+		bytes_copied = pipe_buffer_put(pipe, desc->buffer,
+						desc->bytes_to_xfer);
+
+		desc->buffer        += bytes_copied;
+		desc->bytes_to_xfer -= bytes_copied;
+
+		if (desc->bytes_to_xfer != 0) {
+			break;
+		}
+
+		z_unpend_thread(writer);
+
+#if (CONFIG_NUM_PIPE_ASYNC_MSGS > 0)
+		if ((writer->base.thread_state & _THREAD_DUMMY) != 0U) {
+			/* Finished once the lock is released */
+			sys_dlist_append(&async_list,
+					 &writer->base.qnode_dlist);
+			continue;
+		}
+#endif
+		z_ready_thread(writer);
+	}
+
+#if (CONFIG_NUM_PIPE_ASYNC_MSGS > 0)
+	if (!sys_dlist_is_empty(&async_list)) {
+		z_sched_lock();
+		k_spin_unlock(&pipe->lock, key);
+
+		while ((writer = (struct k_thread *)
+				 sys_dlist_get(&async_list)) != NULL) {
+			pipe_async_finish((struct k_pipe_async *)writer);
+		}
+
+		/* One reschedule for the whole batch */
+		k_sched_unlock();
+
+		return 0;
+	}
+#endif
+
+	/* One reschedule for the whole batch */
+	z_reschedule(&pipe->lock, key);
+
+	return 0;
+}
+
 #if (CONFIG_NUM_PIPE_ASYNC_MSGS > 0)
 void k_pipe_block_put(struct k_pipe *pipe, struct k_mem_block *block,
 		      size_t bytes_to_write, struct k_sem *sem)
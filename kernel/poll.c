@@ -84,6 +84,21 @@ static inline bool is_condition_met(struct k_poll_event *event, u32_t *state)
 	return false;
 }
 
+/* Poll sets have no thread, and rank below every thread */
+static inline bool is_poller_higher_prio(struct _poller *p1,
+					 struct _poller *p2)
+{
+	if (p1->thread == NULL) {
+		return false;
+	}
+
+	if (p2->thread == NULL) {
+		return true;
+	}
+
+	return z_is_t1_higher_prio_than_t2(p1->thread, p2->thread);
+}
+
 static inline void add_event(sys_dlist_t *events, struct k_poll_event *event,
 			     struct _poller *poller)
 {
@@ -91,15 +106,13 @@ static inline void add_event(sys_dlist_t *events, struct k_poll_event *event,
 
 	pending = (struct k_poll_event *)sys_dlist_peek_tail(events);
 	if ((pending == NULL) ||
-		z_is_t1_higher_prio_than_t2(pending->poller->thread,
-					    poller->thread)) {
+	    !is_poller_higher_prio(poller, pending->poller)) {
 		sys_dlist_append(events, &event->_node);
 		return;
 	}
 
 	SYS_DLIST_FOR_EACH_CONTAINER(events, pending, _node) {
-		if (z_is_t1_higher_prio_than_t2(poller->thread,
-						pending->poller->thread)) {
+		if (is_poller_higher_prio(poller, pending->poller)) {
 			sys_dlist_insert(&pending->_node, &event->_node);
 			return;
 		}
@@ -376,6 +389,174 @@ oops_free:
 #include <syscalls/k_poll_mrsh.c>
 #endif
 
+#ifdef CONFIG_POLL_SET
+/* Called by the signaling object, which already unlinked the event */
+static int poll_set_cb(struct k_poll_event *event, u32_t state)
+{
+	struct k_poll_set *set = CONTAINER_OF(event->poller,
+					      struct k_poll_set, poller);
+	k_spinlock_key_t key = k_spin_lock(&set->lock);
+	struct k_thread *thread;
+
+	ARG_UNUSED(state);
+
+	sys_dlist_append(&set->ready, &event->_node);
+
+	/* One event is enough for one waiter */
+	thread = z_unpend_first_thread(&set->wait_q);
+	if (thread != NULL) {
+		z_arch_thread_return_value_set(thread, 0);
+		z_ready_thread(thread);
+	}
+
+	k_spin_unlock(&set->lock, key);
+
+	return 0;
+}
+
+void k_poll_set_init(struct k_poll_set *set)
+{
+	sys_dlist_init(&set->ready);
+	z_waitq_init(&set->wait_q);
+	set->poller.is_polling = true;
+	set->poller.thread = NULL;
+	set->poller.cb = poll_set_cb;
+}
+
+int k_poll_set_add(struct k_poll_set *set, struct k_poll_event *event)
+{
+	k_spinlock_key_t key;
+	u32_t state;
+
+	if (event->type == K_POLL_TYPE_IGNORE) {
+		return -EINVAL;
+	}
+
+	key = k_spin_lock(&lock);
+	if (event->poller != NULL) {
+		k_spin_unlock(&lock, key);
+		return -EBUSY;
+	}
+
+	event->state = K_POLL_STATE_NOT_READY;
+
+	if (is_condition_met(event, &state)) {
+		/* Goes through the same path as a signaling object */
+		event->poller = &set->poller;
+		(void)poll_set_cb(event, state);
+	} else {
+		(void)register_event(event, &set->poller);
+	}
+
+	k_spin_unlock(&lock, key);
+
+	return 0;
+}
+
+int k_poll_set_remove(struct k_poll_set *set, struct k_poll_event *event)
+{
+	k_spinlock_key_t key, set_key;
+
+	key = k_spin_lock(&lock);
+	if (event->poller != &set->poller) {
+		k_spin_unlock(&lock, key);
+		return -EINVAL;
+	}
+
+	/* Linked either to its object or to the ready list */
+	set_key = k_spin_lock(&set->lock);
+	if (sys_dnode_is_linked(&event->_node)) {
+		sys_dlist_remove(&event->_node);
+	}
+	event->poller = NULL;
+	k_spin_unlock(&set->lock, set_key);
+
+	k_spin_unlock(&lock, key);
+
+	return 0;
+}
+
+/* Collects up to max events still ready, the others go back to their
+ * objects.  Must be called with both locks held.
+ */
+static int poll_set_collect(struct k_poll_set *set,
+			    struct k_poll_event **ready, int max)
+{
+	struct k_poll_event *event, *next;
+	int num_ready = 0;
+
+	SYS_DLIST_FOR_EACH_CONTAINER_SAFE(&set->ready, event, next, _node) {
+		u32_t cancelled = event->state & K_POLL_STATE_CANCELLED;
+		u32_t state = K_POLL_STATE_NOT_READY;
+
+		if (num_ready == max) {
+			break;
+		}
+
+		(void)is_condition_met(event, &state);
+		event->state = state | cancelled;
+
+		if (event->state == K_POLL_STATE_NOT_READY) {
+			sys_dlist_remove(&event->_node);
+			(void)register_event(event, &set->poller);
+		} else {
+			ready[num_ready++] = event;
+		}
+	}
+
+	/* Give the events not reported this time their turn next time */
+	for (int i = 0; i < num_ready; i++) {
+		sys_dlist_remove(&ready[i]->_node);
+		sys_dlist_append(&set->ready, &ready[i]->_node);
+	}
+
+	return num_ready;
+}
+
+int k_poll_set_wait(struct k_poll_set *set, struct k_poll_event **ready,
+		    int max, s32_t timeout)
+{
+	s64_t end = k_uptime_get() + timeout;
+	k_spinlock_key_t key, set_key;
+	int num_ready;
+
+	__ASSERT(!z_arch_is_in_isr() || timeout == K_NO_WAIT, "");
+	__ASSERT(max > 0, "no room for events\n");
+
+	while (true) {
+		key = k_spin_lock(&lock);
+		set_key = k_spin_lock(&set->lock);
+		num_ready = poll_set_collect(set, ready, max);
+		k_spin_unlock(&set->lock, set_key);
+		k_spin_unlock(&lock, key);
+
+		if (num_ready > 0) {
+			return num_ready;
+		}
+
+		if (timeout != K_FOREVER) {
+			timeout = MAX(end - k_uptime_get(), 0);
+		}
+
+		if (timeout == K_NO_WAIT) {
+			return -EAGAIN;
+		}
+
+		/* Events signaled since the collection are on the list */
+		set_key = k_spin_lock(&set->lock);
+		if (!sys_dlist_is_empty(&set->ready)) {
+			k_spin_unlock(&set->lock, set_key);
+			continue;
+		}
+
+		if (z_pend_curr(&set->lock, set_key, &set->wait_q,
+				timeout) != 0) {
+			return -EAGAIN;
+		}
+	}
+}
+#endif /* CONFIG_POLL_SET */
+
 /* must be called with interrupts locked */
 static int signal_poll_event(struct k_poll_event *event, u32_t state)
 {
@@ -387,6 +568,14 @@ static int signal_poll_event(struct k_poll_event *event, u32_t state)
 			retcode = poller->cb(event, state);
 		}
 
+#ifdef CONFIG_POLL_SET
+		if (poller->cb == poll_set_cb) {
+			/* Stays a member of its set */
+			event->state |= state;
+			return retcode;
+		}
+#endif
+
 		poller->is_polling = false;
 
 		if (retcode < 0) {
@@ -31,6 +31,10 @@
 #define _priq_run_add		z_priq_mq_add
 #define _priq_run_remove	z_priq_mq_remove
 #define _priq_run_best		z_priq_mq_best
+#elif defined(CONFIG_SCHED_BITMAP)
+#define _priq_run_add		z_priq_bmq_add
+#define _priq_run_remove	z_priq_bmq_remove
+#define _priq_run_best		z_priq_bmq_best
 #endif
 
 #if defined(CONFIG_WAITQ_SCALABLE)
@@ -167,7 +171,287 @@ static ALWAYS_INLINE struct k_thread *_priq_dumb_mask_best(sys_dlist_t *pq)
 }
 #endif
 
-static ALWAYS_INLINE struct k_thread *next_up(void)
+/* Run queue access.  Without CONFIG_SCHED_CPU_RUNQ there is only the
+ * one global queue and the CPU arguments are ignored.
+ */
+static ALWAYS_INLINE _ready_q_t *cpu_ready_q(int cpu)
+{
+#ifdef CONFIG_SCHED_CPU_RUNQ
+	return &_kernel.cpus[cpu].ready_q;
+#else
+	ARG_UNUSED(cpu);
+	return &_kernel.ready_q;
+#endif
+}
+
+#ifdef CONFIG_SCHED_CPU_RUNQ
+/* Each CPU's run queue has its own lock, so CPUs placing and picking
+ * threads on different queues don't serialize on sched_spinlock,
+ * which still protects everything else.  sched_spinlock is never
+ * held together with a run queue lock, and two queue locks are only
+ * held together when stealing, lowest CPU index first.
+ */
+static struct k_spinlock runq_spinlock[CONFIG_MP_NUM_CPUS];
+#endif
+
+/* Lock of a CPU's run queue, sched_spinlock for the global queue.
+ * Threads no CPU may run are accounted under the lock of CPU 0.
+ */
+static ALWAYS_INLINE struct k_spinlock *runq_lock(int cpu)
+{
+#ifdef CONFIG_SCHED_CPU_RUNQ
+	return &runq_spinlock[cpu < 0 ? 0 : cpu];
+#else
+	ARG_UNUSED(cpu);
+	return &sched_spinlock;
+#endif
+}
+
+#ifdef CONFIG_SCHED_CPU_RUNQ
+/* runq_cpu value of a ready thread that no CPU is allowed to run */
+#define NO_RUNQ_CPU 0xffU
+
+static ALWAYS_INLINE bool cpu_allowed(struct k_thread *thread, int cpu)
+{
+#ifdef CONFIG_SCHED_CPU_MASK
+	return (thread->base.cpu_mask & BIT(cpu)) != 0;
+#else
+	ARG_UNUSED(thread);
+	ARG_UNUSED(cpu);
+	return true;
+#endif
+}
+
+/* Placement policy for a thread becoming ready: an idle CPU
+ * (preferably the one it last ran on), else the CPU it last ran on
+ * if it would preempt there or would not preempt anywhere, else the
+ * CPU running the lowest priority thread.  Returns -1 if the
+ * affinity mask excludes every CPU.  The other CPUs' current threads
+ * are read unlocked, stealing makes up for a stale choice.
+ */
+static int select_cpu(struct k_thread *thread)
+{
+	int last = thread->base.cpu;
+	int best = -1;
+
+	if (last >= CONFIG_MP_NUM_CPUS || !cpu_allowed(thread, last) ||
+	    _kernel.cpus[last].current == NULL) {
+		last = -1;
+	} else if (z_is_idle_thread_object(_kernel.cpus[last].current)) {
+		return last;
+	}
+
+	for (int i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		struct k_thread *curr = _kernel.cpus[i].current;
+
+		/* Not yet started CPUs have no current thread */
+		if (curr == NULL || !cpu_allowed(thread, i)) {
+			continue;
+		}
+
+		if (z_is_idle_thread_object(curr)) {
+			return i;
+		}
+
+		if (best < 0 ||
+		    z_is_t1_higher_prio_than_t2(_kernel.cpus[best].current,
+						curr)) {
+			best = i;
+		}
+	}
+
+	if (last >= 0 &&
+	    (best < 0 ||
+	     z_is_t1_higher_prio_than_t2(thread, _kernel.cpus[last].current) ||
+	     !z_is_t1_higher_prio_than_t2(thread,
+					  _kernel.cpus[best].current))) {
+		return last;
+	}
+
+	return best;
+}
+#endif
+
+/* Index of the CPU queue holding a queued thread, -1 for none */
+static ALWAYS_INLINE int thread_runq_cpu(struct k_thread *thread)
+{
+#ifdef CONFIG_SCHED_CPU_RUNQ
+	return thread->base.runq_cpu == NO_RUNQ_CPU ?
+		-1 : thread->base.runq_cpu;
+#else
+	ARG_UNUSED(thread);
+	return 0;
+#endif
+}
+
+static ALWAYS_INLINE void runq_add(struct k_thread *thread, int cpu)
+{
+#ifdef CONFIG_SCHED_CPU_RUNQ
+	/* A thread that may not run anywhere is marked queued without
+	 * being visible to any CPU.  Its mask can't change until it
+	 * stops being ready, which removes it again.
+	 */
+	if (cpu < 0) {
+		thread->base.runq_cpu = NO_RUNQ_CPU;
+		return;
+	}
+	thread->base.runq_cpu = cpu;
+#endif
+	_priq_run_add(&cpu_ready_q(cpu)->runq, thread);
+}
+
+static ALWAYS_INLINE void runq_remove(struct k_thread *thread)
+{
+#ifdef CONFIG_SCHED_CPU_RUNQ
+	if (thread->base.runq_cpu == NO_RUNQ_CPU) {
+		return;
+	}
+	_priq_run_remove(&cpu_ready_q(thread->base.runq_cpu)->runq, thread);
+#else
+	_priq_run_remove(&_kernel.ready_q.runq, thread);
+#endif
+}
+
+/* Re-insert a thread at its (possibly changed) sort position on the
+ * same CPU's queue it was on.
+ */
+static ALWAYS_INLINE void runq_requeue(struct k_thread *thread)
+{
+	int cpu = thread_runq_cpu(thread);
+
+	runq_remove(thread);
+	runq_add(thread, cpu);
+}
+
+/* CPU whose run queue an operation on a thread uses: the one whose
+ * queue holds it, else cpu.
+ */
+static ALWAYS_INLINE int runq_target(struct k_thread *thread, int cpu)
+{
+	return z_is_thread_queued(thread) ? thread_runq_cpu(thread) : cpu;
+}
+
+/* Lock the run queue holding a thread, or the queue of *cpu if the
+ * thread is not queued, and store the CPU of the locked queue in
+ * *cpu.  A queued thread only changes queue by being removed and
+ * added again, so retry if that happened before the lock was taken.
+ */
+static k_spinlock_key_t runq_lock_thread(struct k_thread *thread, int *cpu)
+{
+	for (;;) {
+		int target = runq_target(thread, *cpu);
+		k_spinlock_key_t key = k_spin_lock(runq_lock(target));
+
+		if (runq_target(thread, *cpu) == target) {
+			*cpu = target;
+			return key;
+		}
+		k_spin_unlock(runq_lock(target), key);
+	}
+}
+
+#ifdef CONFIG_SCHED_CPU_RUNQ
+/* Work stealing candidate: the other CPU whose queue head may run
+ * here and beats the other queue heads, -1 for none.  Each queue is
+ * peeked under its own lock only, so this is a hint that runq_best()
+ * checks again with both queues locked.
+ */
+static int steal_cpu(void)
+{
+	int me = _current_cpu->id;
+	int victim = -1;
+	struct k_thread *best = NULL;
+
+	for (int i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		if (i == me) {
+			continue;
+		}
+
+		LOCKED(runq_lock(i)) {
+			struct k_thread *t;
+
+			t = _priq_run_best(&cpu_ready_q(i)->runq);
+			if (t != NULL && cpu_allowed(t, me) &&
+			    (best == NULL ||
+			     z_is_t1_higher_prio_than_t2(t, best))) {
+				best = t;
+				victim = i;
+			}
+		}
+	}
+
+	return victim;
+}
+#endif
+
+/* Best thread of the local queue, or the head of the queue of CPU
+ * victim (-1 for none) when stealing it is better.  Both queues are
+ * locked.
+ */
+static ALWAYS_INLINE struct k_thread *runq_best(int victim)
+{
+	int me = _current_cpu->id;
+	struct k_thread *th = _priq_run_best(&cpu_ready_q(me)->runq);
+
+#ifdef CONFIG_SCHED_CPU_RUNQ
+	/* Work stealing: the victim's head wins if it may run here and
+	 * beats the local choice, so priority order holds across CPUs
+	 * and an idle CPU takes anything it may run.  With
+	 * SCHED_CPU_MASK and the dumb backend, _priq_run_best() already
+	 * skips threads masked off this CPU.
+	 */
+	if (victim >= 0) {
+		struct k_thread *t = _priq_run_best(&cpu_ready_q(victim)->runq);
+
+		if (t != NULL && cpu_allowed(t, me) &&
+		    (th == NULL || z_is_t1_higher_prio_than_t2(t, th))) {
+			th = t;
+		}
+	}
+#else
+	ARG_UNUSED(victim);
+#endif
+
+	return th;
+}
+
+#if defined(CONFIG_SMP) && defined(CONFIG_SCHED_IPI_SUPPORTED)
+/* Signal a thread newly placed on a CPU's run queue.  With per-CPU
+ * queues only that CPU is interrupted, and only when it needs to
+ * reschedule; otherwise all other CPUs re-evaluate.
+ */
+static void sched_ipi_for(struct k_thread *thread, int cpu)
+{
+#ifdef CONFIG_SCHED_CPU_RUNQ
+	struct k_thread *curr;
+
+	if (cpu < 0 || cpu == _current_cpu->id) {
+		return;
+	}
+
+	curr = _kernel.cpus[cpu].current;
+	if (!z_is_idle_thread_object(curr) &&
+	    !z_is_t1_higher_prio_than_t2(thread, curr)) {
+		return;
+	}
+
+# ifdef CONFIG_SCHED_IPI_CPU_SUPPORTED
+	z_arch_sched_ipi_cpu(cpu);
+# else
+	z_arch_sched_ipi();
+# endif
+#else
+	ARG_UNUSED(thread);
+	ARG_UNUSED(cpu);
+	z_arch_sched_ipi();
+#endif
+}
+#endif
+
+/* Pick the next thread, the locks of the local run queue and of the
+ * queue of CPU victim (-1 for none) are held.
+ */
+static ALWAYS_INLINE struct k_thread *next_up(int victim)
 {
 #ifndef CONFIG_SMP
 	/* In uniprocessor mode, we can leave the current thread in
@@ -176,7 +460,7 @@ static ALWAYS_INLINE struct k_thread *next_up(void)
 	 * responsible for putting it back in z_swap and ISR return!),
 	 * which makes this choice simple.
 	 */
-	struct k_thread *th = _priq_run_best(&_kernel.ready_q.runq);
+	struct k_thread *th = runq_best(victim);
 
 	return th ? th : _current_cpu->idle_thread;
 #else
@@ -194,7 +478,7 @@ static ALWAYS_INLINE struct k_thread *next_up(void)
 	int active = !z_is_thread_prevented_from_running(_current);
 
 	/* Choose the best thread that is not current */
-	struct k_thread *th = _priq_run_best(&_kernel.ready_q.runq);
+	struct k_thread *th = runq_best(victim);
 	if (th == NULL) {
 		th = _current_cpu->idle_thread;
 	}
@@ -213,20 +497,62 @@ static ALWAYS_INLINE struct k_thread *next_up(void)
 	/* Put _current back into the queue */
 	if (th != _current && active && !z_is_idle_thread_object(_current) &&
 	    !queued) {
-		_priq_run_add(&_kernel.ready_q.runq, _current);
+		runq_add(_current, _current_cpu->id);
 		z_mark_thread_as_queued(_current);
 	}
 
 	/* Take the new _current out of the queue */
 	if (z_is_thread_queued(th)) {
-		_priq_run_remove(&_kernel.ready_q.runq, th);
+		runq_remove(th);
 	}
 	z_mark_thread_as_not_queued(th);
 
+#ifdef CONFIG_SCHED_CPU_RUNQ
+	/* Not all switch paths record this, and placement needs it */
+	th->base.cpu = _current_cpu->id;
+#endif
+
 	return th;
 #endif
 }
 
+#ifdef CONFIG_SCHED_CPU_RUNQ
+/* next_up() taking the run queue locks it needs: the local queue's
+ * and the stealing candidate's, or the queue's of _current if
+ * something readied it onto another CPU's queue meanwhile.
+ */
+static struct k_thread *next_up_runq(void)
+{
+	int me = _current_cpu->id;
+	int victim = steal_cpu();
+	int lo, hi;
+	k_spinlock_key_t lo_key, hi_key = {};
+	struct k_thread *th;
+
+	if (z_is_thread_queued(_current) &&
+	    thread_runq_cpu(_current) != me) {
+		victim = thread_runq_cpu(_current);
+	}
+
+	lo = (victim >= 0 && victim < me) ? victim : me;
+	hi = (victim > me) ? victim : me;
+
+	lo_key = k_spin_lock(runq_lock(lo));
+	if (hi != lo) {
+		hi_key = k_spin_lock(runq_lock(hi));
+	}
+
+	th = next_up(victim);
+
+	if (hi != lo) {
+		k_spin_unlock(runq_lock(hi), hi_key);
+	}
+	k_spin_unlock(runq_lock(lo), lo_key);
+
+	return th;
+}
+#endif
+
 #ifdef CONFIG_TIMESLICING
 
 static int slice_time;
@@ -298,7 +624,7 @@ void z_time_slice(int ticks)
 static void update_cache(int preempt_ok)
 {
 #ifndef CONFIG_SMP
-	struct k_thread *th = next_up();
+	struct k_thread *th = next_up(-1);
 
 	if (should_preempt(th, preempt_ok)) {
 #ifdef CONFIG_TIMESLICING
@@ -324,37 +650,50 @@ static void update_cache(int preempt_ok)
 
 void z_add_thread_to_ready_q(struct k_thread *thread)
 {
-	LOCKED(&sched_spinlock) {
-		_priq_run_add(&_kernel.ready_q.runq, thread);
+#ifdef CONFIG_SCHED_CPU_RUNQ
+	int cpu = select_cpu(thread);
+#else
+	int cpu = _current_cpu->id;
+#endif
+
+	LOCKED(runq_lock(cpu)) {
+		runq_add(thread, cpu);
 		z_mark_thread_as_queued(thread);
 		update_cache(0);
 #if defined(CONFIG_SMP) &&  defined(CONFIG_SCHED_IPI_SUPPORTED)
-		z_arch_sched_ipi();
+		sched_ipi_for(thread, cpu);
 #endif
 	}
 }
 
 void z_move_thread_to_end_of_prio_q(struct k_thread *thread)
 {
-	LOCKED(&sched_spinlock) {
-		if (z_is_thread_queued(thread)) {
-			_priq_run_remove(&_kernel.ready_q.runq, thread);
-		}
-		_priq_run_add(&_kernel.ready_q.runq, thread);
-		z_mark_thread_as_queued(thread);
-		update_cache(thread == _current);
+	int cpu = _current_cpu->id;
+	k_spinlock_key_t key = runq_lock_thread(thread, &cpu);
+
+	if (z_is_thread_queued(thread)) {
+		runq_requeue(thread);
+	} else {
+		runq_add(thread, cpu);
 	}
+	z_mark_thread_as_queued(thread);
+	update_cache(thread == _current);
+
+	k_spin_unlock(runq_lock(cpu), key);
 }
 
 void z_remove_thread_from_ready_q(struct k_thread *thread)
 {
-	LOCKED(&sched_spinlock) {
-		if (z_is_thread_queued(thread)) {
-			_priq_run_remove(&_kernel.ready_q.runq, thread);
-			z_mark_thread_as_not_queued(thread);
-		}
-		update_cache(thread == _current);
+	int cpu = _current_cpu->id;
+	k_spinlock_key_t key = runq_lock_thread(thread, &cpu);
+
+	if (z_is_thread_queued(thread)) {
+		runq_remove(thread);
+		z_mark_thread_as_not_queued(thread);
 	}
+	update_cache(thread == _current);
+
+	k_spin_unlock(runq_lock(cpu), key);
 }
 
 static void pend(struct k_thread *thread, _wait_q_t *wait_q, s32_t timeout)
@@ -480,24 +819,32 @@ void z_unpend_thread(struct k_thread *thread)
 bool z_set_prio(struct k_thread *thread, int prio)
 {
 	bool need_sched = 0;
+	int cpu = _current_cpu->id;
+	k_spinlock_key_t key = runq_lock_thread(thread, &cpu);
 
-	LOCKED(&sched_spinlock) {
-		need_sched = z_is_thread_ready(thread);
-
-		if (need_sched) {
-			/* Don't requeue on SMP if it's the running thread */
-			if (!IS_ENABLED(CONFIG_SMP) || z_is_thread_queued(thread)) {
-				_priq_run_remove(&_kernel.ready_q.runq, thread);
-				thread->base.prio = prio;
-				_priq_run_add(&_kernel.ready_q.runq, thread);
-			} else {
-				thread->base.prio = prio;
-			}
-			update_cache(1);
+	need_sched = z_is_thread_ready(thread);
+
+	if (need_sched) {
+		/* Don't requeue on SMP if it's the running thread */
+		if (!IS_ENABLED(CONFIG_SMP) || z_is_thread_queued(thread)) {
+			runq_remove(thread);
+			thread->base.prio = prio;
+			runq_add(thread, cpu);
+#if defined(CONFIG_SCHED_CPU_RUNQ) && defined(CONFIG_SCHED_IPI_SUPPORTED)
+			/* Only the CPU whose queue holds it may have to
+			 * preempt now.
+			 */
+			sched_ipi_for(thread, cpu);
+#endif
 		} else {
 			thread->base.prio = prio;
 		}
+		update_cache(1);
+	} else {
+		thread->base.prio = prio;
 	}
+
+	k_spin_unlock(runq_lock(cpu), key);
 	sys_trace_thread_priority_set(thread);
 
 	return need_sched;
@@ -572,13 +919,17 @@ void k_sched_unlock(void)
 #ifdef CONFIG_SMP
 struct k_thread *z_get_next_ready_thread(void)
 {
+#ifdef CONFIG_SCHED_CPU_RUNQ
+	return next_up_runq();
+#else
 	struct k_thread *ret = 0;
 
 	LOCKED(&sched_spinlock) {
-		ret = next_up();
+		ret = next_up(-1);
 	}
 
 	return ret;
+#endif
 }
 #endif
 
@@ -596,25 +947,35 @@ void *z_get_next_switch_handle(void *interrupted)
 	z_check_stack_sentinel();
 
 #ifdef CONFIG_SMP
-	LOCKED(&sched_spinlock) {
-		struct k_thread *th = next_up();
+#ifdef CONFIG_SCHED_CPU_RUNQ
+	/* The run queue locks are dropped before _current changes,
+	 * as z_swap() does.
+	 */
+	struct k_thread *th = next_up_runq();
+#else
+	k_spinlock_key_t key = k_spin_lock(&sched_spinlock);
+	struct k_thread *th = next_up(-1);
+#endif
 
-		if (_current != th) {
+	if (_current != th) {
 #ifdef CONFIG_TIMESLICING
-			z_reset_time_slice();
+		z_reset_time_slice();
 #endif
-			_current_cpu->swap_ok = 0;
-			set_current(th);
-#ifdef SPIN_VALIDATE
-			/* Changed _current!  Update the spinlock
-			 * bookeeping so the validation doesn't get
-			 * confused when the "wrong" thread tries to
-			 * release the lock.
-			 */
-			z_spin_lock_set_owner(&sched_spinlock);
+		_current_cpu->swap_ok = 0;
+		set_current(th);
+#if defined(SPIN_VALIDATE) && !defined(CONFIG_SCHED_CPU_RUNQ)
+		/* Changed _current!  Update the spinlock
+		 * bookeeping so the validation doesn't get
+		 * confused when the "wrong" thread tries to
+		 * release the lock.
+		 */
+		z_spin_lock_set_owner(&sched_spinlock);
 #endif
-		}
 	}
+
+#ifndef CONFIG_SCHED_CPU_RUNQ
+	k_spin_unlock(&sched_spinlock, key);
+#endif
 #else
 	set_current(z_get_next_ready_thread());
 #endif
@@ -786,6 +1147,112 @@ struct k_thread *z_priq_mq_best(struct _priq_mq *pq)
 	return t;
 }
 
+BUILD_ASSERT_MSG(Z_PRIQ_BMQ_NUM_PRIOS ==
+		 K_LOWEST_THREAD_PRIO - K_HIGHEST_THREAD_PRIO + 1,
+		 "Bitmap multiqueue sized for the wrong priority range");
+BUILD_ASSERT_MSG(Z_PRIQ_BMQ_NUM_WORDS <= 32,
+		 "Too many priorities for bitmap multiqueue (max 1024)");
+
+void z_priq_bmq_init(struct _priq_bmq *pq)
+{
+	for (int i = 0; i < ARRAY_SIZE(pq->queues); i++) {
+		sys_dlist_init(&pq->queues[i]);
+	}
+
+	for (int i = 0; i < ARRAY_SIZE(pq->bitmap); i++) {
+		pq->bitmap[i] = 0U;
+	}
+
+	pq->summary = 0U;
+	pq->best = NULL;
+}
+
+static ALWAYS_INLINE struct k_thread *priq_bmq_head(struct _priq_bmq *pq)
+{
+	if (pq->summary == 0U) {
+		return NULL;
+	}
+
+	int word = __builtin_ctz(pq->summary);
+	int idx = word * 32 + __builtin_ctz(pq->bitmap[word]);
+	sys_dnode_t *n = sys_dlist_peek_head(&pq->queues[idx]);
+
+	return CONTAINER_OF(n, struct k_thread, base.qnode_dlist);
+}
+
+ALWAYS_INLINE void z_priq_bmq_add(struct _priq_bmq *pq,
+				  struct k_thread *thread)
+{
+	int idx = thread->base.prio - K_HIGHEST_THREAD_PRIO;
+	sys_dlist_t *l = &pq->queues[idx];
+
+	__ASSERT_NO_MSG(!z_is_idle_thread_object(thread));
+
+#ifdef CONFIG_SCHED_DEADLINE
+	struct k_thread *t;
+
+	/* Only threads of this same priority are compared, and those
+	 * differ only by deadline.  Equal deadlines stay FIFO.
+	 */
+	SYS_DLIST_FOR_EACH_CONTAINER(l, t, base.qnode_dlist) {
+		if (z_is_t1_higher_prio_than_t2(thread, t)) {
+			sys_dlist_insert(&t->base.qnode_dlist,
+					 &thread->base.qnode_dlist);
+			break;
+		}
+	}
+
+	if (t == NULL) {
+		sys_dlist_append(l, &thread->base.qnode_dlist);
+	}
+#else
+	sys_dlist_append(l, &thread->base.qnode_dlist);
+#endif
+
+	pq->bitmap[idx / 32] |= BIT(idx % 32);
+	pq->summary |= BIT(idx / 32);
+
+	/* The new thread displaces the cached best only if it went to
+	 * the head of its list at an equal or better priority.
+	 */
+	if (pq->best == NULL ||
+	    (thread->base.prio <= pq->best->base.prio &&
+	     sys_dlist_peek_head(l) == &thread->base.qnode_dlist)) {
+		pq->best = thread;
+	}
+}
+
+ALWAYS_INLINE void z_priq_bmq_remove(struct _priq_bmq *pq,
+				     struct k_thread *thread)
+{
+#if defined(CONFIG_SWAP_NONATOMIC) && defined(CONFIG_SCHED_BITMAP)
+	if (pq == &_kernel.ready_q.runq && thread == _current &&
+	    z_is_thread_prevented_from_running(thread)) {
+		return;
+	}
+#endif
+	int idx = thread->base.prio - K_HIGHEST_THREAD_PRIO;
+
+	__ASSERT_NO_MSG(!z_is_idle_thread_object(thread));
+
+	sys_dlist_remove(&thread->base.qnode_dlist);
+	if (sys_dlist_is_empty(&pq->queues[idx])) {
+		pq->bitmap[idx / 32] &= ~BIT(idx % 32);
+		if (pq->bitmap[idx / 32] == 0U) {
+			pq->summary &= ~BIT(idx / 32);
+		}
+	}
+
+	if (thread == pq->best) {
+		pq->best = priq_bmq_head(pq);
+	}
+}
+
+struct k_thread *z_priq_bmq_best(struct _priq_bmq *pq)
+{
+	return pq->best;
+}
+
 int z_unpend_all(_wait_q_t *wait_q)
 {
 	int need_sched = 0;
@@ -800,14 +1267,14 @@ int z_unpend_all(_wait_q_t *wait_q)
 	return need_sched;
 }
 
-void z_sched_init(void)
+static void init_ready_q(_ready_q_t *ready_q)
 {
 #ifdef CONFIG_SCHED_DUMB
-	sys_dlist_init(&_kernel.ready_q.runq);
+	sys_dlist_init(&ready_q->runq);
 #endif
 
 #ifdef CONFIG_SCHED_SCALABLE
-	_kernel.ready_q.runq = (struct _priq_rb) {
+	ready_q->runq = (struct _priq_rb) {
 		.tree = {
 			.lessthan_fn = z_priq_rb_lessthan,
 		}
@@ -815,8 +1282,23 @@ void z_sched_init(void)
 #endif
 
 #ifdef CONFIG_SCHED_MULTIQ
-	for (int i = 0; i < ARRAY_SIZE(_kernel.ready_q.runq.queues); i++) {
-		sys_dlist_init(&_kernel.ready_q.runq.queues[i]);
+	for (int i = 0; i < ARRAY_SIZE(ready_q->runq.queues); i++) {
+		sys_dlist_init(&ready_q->runq.queues[i]);
+	}
+#endif
+
+#ifdef CONFIG_SCHED_BITMAP
+	z_priq_bmq_init(&ready_q->runq);
+#endif
+}
+
+void z_sched_init(void)
+{
+	init_ready_q(&_kernel.ready_q);
+
+#ifdef CONFIG_SCHED_CPU_RUNQ
+	for (int i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		init_ready_q(&_kernel.cpus[i].ready_q);
 	}
 #endif
 
@@ -873,14 +1355,15 @@ static inline void z_vrfy_k_thread_priority_set(k_tid_t thread, int prio)
 void z_impl_k_thread_deadline_set(k_tid_t tid, int deadline)
 {
 	struct k_thread *th = tid;
+	int cpu = _current_cpu->id;
+	k_spinlock_key_t key = runq_lock_thread(th, &cpu);
 
-	LOCKED(&sched_spinlock) {
-		th->base.prio_deadline = k_cycle_get_32() + deadline;
-		if (z_is_thread_queued(th)) {
-			_priq_run_remove(&_kernel.ready_q.runq, th);
-			_priq_run_add(&_kernel.ready_q.runq, th);
-		}
+	th->base.prio_deadline = k_cycle_get_32() + deadline;
+	if (z_is_thread_queued(th)) {
+		runq_requeue(th);
 	}
+
+	k_spin_unlock(runq_lock(cpu), key);
 }
 
 #ifdef CONFIG_USERSPACE
@@ -904,16 +1387,17 @@ void z_impl_k_yield(void)
 	__ASSERT(!z_arch_is_in_isr(), "");
 
 	if (!z_is_idle_thread_object(_current)) {
-		LOCKED(&sched_spinlock) {
-			if (!IS_ENABLED(CONFIG_SMP) ||
-			    z_is_thread_queued(_current)) {
-				_priq_run_remove(&_kernel.ready_q.runq,
-						 _current);
-			}
-			_priq_run_add(&_kernel.ready_q.runq, _current);
-			z_mark_thread_as_queued(_current);
-			update_cache(1);
+		int cpu = _current_cpu->id;
+		k_spinlock_key_t key = runq_lock_thread(_current, &cpu);
+
+		if (!IS_ENABLED(CONFIG_SMP) || z_is_thread_queued(_current)) {
+			runq_remove(_current);
 		}
+		runq_add(_current, cpu);
+		z_mark_thread_as_queued(_current);
+		update_cache(1);
+
+		k_spin_unlock(runq_lock(cpu), key);
 	}
 	z_swap_unlocked();
 }
@@ -1057,7 +1541,12 @@ void z_sched_abort(struct k_thread *thread)
 	 * we don't have it, we need to wait for some other interrupt.
 	 */
 	thread->base.thread_state |= _THREAD_ABORTING;
-#ifdef CONFIG_SCHED_IPI_SUPPORTED
+#if defined(CONFIG_SCHED_CPU_RUNQ) && defined(CONFIG_SCHED_IPI_CPU_SUPPORTED)
+	/* If it is running anywhere, it is on the CPU it last ran on */
+	if (thread->base.cpu < CONFIG_MP_NUM_CPUS) {
+		z_arch_sched_ipi_cpu(thread->base.cpu);
+	}
+#elif defined(CONFIG_SCHED_IPI_SUPPORTED)
 	z_arch_sched_ipi();
 #endif
 
@@ -1065,18 +1554,21 @@ void z_sched_abort(struct k_thread *thread)
 	 * running on or because we caught it idle in the queue
 	 */
 	while ((thread->base.thread_state & _THREAD_DEAD) == 0U) {
-		LOCKED(&sched_spinlock) {
-			if (z_is_thread_prevented_from_running(thread)) {
-				__ASSERT(!z_is_thread_queued(thread), "");
-				thread->base.thread_state |= _THREAD_DEAD;
-			} else if (z_is_thread_queued(thread)) {
-				_priq_run_remove(&_kernel.ready_q.runq, thread);
-				z_mark_thread_as_not_queued(thread);
-				thread->base.thread_state |= _THREAD_DEAD;
-			} else {
-				k_busy_wait(100);
-			}
+		int cpu = _current_cpu->id;
+		k_spinlock_key_t key = runq_lock_thread(thread, &cpu);
+
+		if (z_is_thread_prevented_from_running(thread)) {
+			__ASSERT(!z_is_thread_queued(thread), "");
+			thread->base.thread_state |= _THREAD_DEAD;
+		} else if (z_is_thread_queued(thread)) {
+			runq_remove(thread);
+			z_mark_thread_as_not_queued(thread);
+			thread->base.thread_state |= _THREAD_DEAD;
+		} else {
+			k_busy_wait(100);
 		}
+
+		k_spin_unlock(runq_lock(cpu), key);
 	}
 }
 #endif
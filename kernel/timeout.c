@@ -17,7 +17,9 @@
 
 static u64_t curr_tick;
 
+#ifndef CONFIG_TIMEOUT_WHEEL
 static sys_dlist_t timeout_list = SYS_DLIST_STATIC_INIT(&timeout_list);
+#endif
 
 static struct k_spinlock timeout_lock;
 
@@ -39,6 +41,155 @@ static inline int z_vrfy_z_clock_hw_cycles_per_sec_runtime_get(void)
 #endif /* CONFIG_USERSPACE */
 #endif /* CONFIG_TIMER_READS_ITS_FREQUENCY_AT_RUNTIME */
 
+#ifdef CONFIG_TIMEOUT_WHEEL
+/* Hierarchical timing wheel (Varghese & Lauck).  Level L has
+ * WHEEL_SLOTS slots, each covering 2^(WHEEL_BITS * L) ticks of
+ * absolute time, so level 0 resolves single ticks and the four levels
+ * together cover 2^24 ticks ahead of curr_tick.  A timeout sits in
+ * the lowest level whose span fits its delay; when the wheel reaches
+ * the start of an upper level slot, the entries there are "cascaded"
+ * by reinserting them relative to the new time, which always lands
+ * them on a lower level.  Delays beyond the wheel range are parked in
+ * the top level's furthest slot and simply cascade again.
+ *
+ * A per-level occupancy bitmap finds the next tick at which anything
+ * happens (a level 0 expiry or an upper level cascade) with one bit
+ * scan per level, so idle spans are skipped in a single step and
+ * tickless idle can program the timer for that tick.  The slot list
+ * heads are (re)initialized whenever their bit goes from clear to
+ * set, so the bitmap is the sole authority on which slots are live.
+ */
+#define WHEEL_BITS 6
+#define WHEEL_SLOTS BIT(WHEEL_BITS)
+#define WHEEL_MASK (WHEEL_SLOTS - 1)
+#define WHEEL_LEVELS 4
+#define WHEEL_RANGE BIT(WHEEL_BITS * WHEEL_LEVELS)
+#define WHEEL_NONE UINT32_MAX
+#define WHEEL_BIT(n) (1ULL << (n))
+
+BUILD_ASSERT(WHEEL_LEVELS * WHEEL_SLOTS <= 256);
+
+static sys_dlist_t wheel[WHEEL_LEVELS][WHEEL_SLOTS];
+static u64_t wheel_map[WHEEL_LEVELS];
+
+static inline u32_t now_tick(void)
+{
+	return (u32_t)curr_tick;
+}
+
+static void wheel_insert(struct _timeout *t)
+{
+	u32_t now = now_tick();
+	s32_t delta = (s32_t)(t->expiry - now);
+	u32_t when = t->expiry;
+	int level = 0, idx;
+	sys_dlist_t *list;
+
+	if (delta >= (s32_t)WHEEL_RANGE) {
+		when = now + WHEEL_RANGE - 1U;
+		delta = WHEEL_RANGE - 1U;
+	}
+
+	while (delta >= (s32_t)BIT(WHEEL_BITS * (level + 1))) {
+		level++;
+	}
+
+	idx = (when >> (WHEEL_BITS * level)) & WHEEL_MASK;
+	list = &wheel[level][idx];
+
+	if ((wheel_map[level] & WHEEL_BIT(idx)) == 0U) {
+		wheel_map[level] |= WHEEL_BIT(idx);
+		sys_dlist_init(list);
+	}
+
+	t->slot = level * WHEEL_SLOTS + idx;
+	sys_dlist_append(list, &t->node);
+}
+
+static void remove_timeout(struct _timeout *t)
+{
+	int level = t->slot / WHEEL_SLOTS, idx = t->slot & WHEEL_MASK;
+
+	sys_dlist_remove(&t->node);
+	if (sys_dlist_is_empty(&wheel[level][idx])) {
+		wheel_map[level] &= ~WHEEL_BIT(idx);
+	}
+}
+
+/* Distance (1..WHEEL_SLOTS) from slot idx to the next occupied slot,
+ * walking forward and wrapping around.
+ */
+static inline u32_t slot_dist(u64_t map, u32_t idx)
+{
+	u32_t s = (idx + 1U) & WHEEL_MASK;
+	u64_t rot = s == 0U ? map : (map >> s) | (map << (WHEEL_SLOTS - s));
+
+	return __builtin_ctzll(rot) + 1U;
+}
+
+/* Ticks from curr_tick to the next expiry or cascade, or WHEEL_NONE */
+static u32_t wheel_next_event(void)
+{
+	u32_t now = now_tick(), ret = WHEEL_NONE;
+
+	for (int level = 0; level < WHEEL_LEVELS; level++) {
+		int shift = WHEEL_BITS * level;
+		u32_t cur = now >> shift, dt;
+
+		if (wheel_map[level] == 0U) {
+			continue;
+		}
+
+		dt = ((cur + slot_dist(wheel_map[level], cur & WHEEL_MASK))
+		      << shift) - now;
+		ret = MIN(ret, dt);
+	}
+
+	return ret;
+}
+
+/* Push every upper level slot that starts at the current tick down
+ * the hierarchy, top level first so entries can fall more than one
+ * level in a single step.
+ */
+static void wheel_cascade(void)
+{
+	u32_t now = now_tick();
+
+	for (int level = WHEEL_LEVELS - 1; level > 0; level--) {
+		int shift = WHEEL_BITS * level;
+		int idx = (now >> shift) & WHEEL_MASK;
+		sys_dnode_t *node;
+
+		if ((now & (BIT(shift) - 1U)) != 0U ||
+		    (wheel_map[level] & WHEEL_BIT(idx)) == 0U) {
+			continue;
+		}
+
+		/* Reinsertion never targets this slot again: entries
+		 * expire within it and so drop a level, and parked
+		 * out-of-range entries go to the slot just behind it.
+		 */
+		wheel_map[level] &= ~WHEEL_BIT(idx);
+		while ((node = sys_dlist_get(&wheel[level][idx])) != NULL) {
+			wheel_insert(CONTAINER_OF(node, struct _timeout, node));
+		}
+	}
+}
+
+static struct _timeout *wheel_expired(void)
+{
+	int idx = now_tick() & WHEEL_MASK;
+	sys_dnode_t *t;
+
+	if ((wheel_map[0] & WHEEL_BIT(idx)) == 0U) {
+		return NULL;
+	}
+
+	t = sys_dlist_peek_head(&wheel[0][idx]);
+	return CONTAINER_OF(t, struct _timeout, node);
+}
+#else
 static struct _timeout *first(void)
 {
 	sys_dnode_t *t = sys_dlist_peek_head(&timeout_list);
@@ -62,6 +213,8 @@ static void remove_timeout(struct _timeout *t)
 	sys_dlist_remove(&t->node);
 }
 
+#endif /* CONFIG_TIMEOUT_WHEEL */
+
 static s32_t elapsed(void)
 {
 	return announce_remaining == 0 ? z_clock_elapsed() : 0;
@@ -69,9 +222,15 @@ static s32_t elapsed(void)
 
 static s32_t next_timeout(void)
 {
-	struct _timeout *to = first();
 	s32_t ticks_elapsed = elapsed();
+#ifdef CONFIG_TIMEOUT_WHEEL
+	u32_t dt = wheel_next_event();
+	s32_t ret = dt == WHEEL_NONE ? MAX_WAIT
+				     : MAX(0, (s32_t)dt - ticks_elapsed);
+#else
+	struct _timeout *to = first();
 	s32_t ret = to == NULL ? MAX_WAIT : MAX(0, to->dticks - ticks_elapsed);
+#endif
 
 #ifdef CONFIG_TIMESLICING
 	if (_current_cpu->slice_ticks && _current_cpu->slice_ticks < ret) {
@@ -88,6 +247,17 @@ void z_add_timeout(struct _timeout *to, _timeout_func_t fn, s32_t ticks)
 	ticks = MAX(1, ticks);
 
 	LOCKED(&timeout_lock) {
+#ifdef CONFIG_TIMEOUT_WHEEL
+		u32_t prev = wheel_next_event();
+
+		to->dticks = ticks + elapsed();
+		to->expiry = now_tick() + to->dticks;
+		wheel_insert(to);
+
+		if (wheel_next_event() < prev) {
+			z_clock_set_timeout(next_timeout(), false);
+		}
+#else
 		struct _timeout *t;
 
 		to->dticks = ticks + elapsed();
@@ -109,6 +279,7 @@ void z_add_timeout(struct _timeout *to, _timeout_func_t fn, s32_t ticks)
 		if (to == first()) {
 			z_clock_set_timeout(next_timeout(), false);
 		}
+#endif
 	}
 }
 
@@ -135,12 +306,16 @@ s32_t z_timeout_remaining(struct _timeout *timeout)
 	}
 
 	LOCKED(&timeout_lock) {
+#ifdef CONFIG_TIMEOUT_WHEEL
+		ticks = (s32_t)(timeout->expiry - now_tick());
+#else
 		for (struct _timeout *t = first(); t != NULL; t = next(t)) {
 			ticks += t->dticks;
 			if (timeout == t) {
 				break;
 			}
 		}
+#endif
 	}
 
 	return ticks - elapsed();
@@ -189,6 +364,29 @@ void z_clock_announce(s32_t ticks)
 
 	announce_remaining = ticks;
 
+#ifdef CONFIG_TIMEOUT_WHEEL
+	for (u32_t dt = wheel_next_event();
+	     dt != WHEEL_NONE && dt <= announce_remaining;
+	     dt = wheel_next_event()) {
+		struct _timeout *t;
+
+		curr_tick += dt;
+		announce_remaining -= dt;
+		wheel_cascade();
+
+		/* Nothing added from a callback can land in the current
+		 * slot, every new timeout is at least one tick out.
+		 */
+		while ((t = wheel_expired()) != NULL) {
+			t->dticks = 0;
+			remove_timeout(t);
+
+			k_spin_unlock(&timeout_lock, key);
+			t->fn(t);
+			key = k_spin_lock(&timeout_lock);
+		}
+	}
+#else
 	while (first() != NULL && first()->dticks <= announce_remaining) {
 		struct _timeout *t = first();
 		int dt = t->dticks;
@@ -206,6 +404,7 @@ void z_clock_announce(s32_t ticks)
 	if (first() != NULL) {
 		first()->dticks -= announce_remaining;
 	}
+#endif
 
 	curr_tick += announce_remaining;
 	announce_remaining = 0;
@@ -23,18 +23,60 @@
 static struct k_spinlock lock;
 #endif
 
+extern void z_work_q_init(struct k_work_q *work_q);
 extern void z_work_q_main(void *work_q_ptr, void *p2, void *p3);
+extern void z_work_q_grant(struct k_work_q *work_q, struct k_thread *thread);
 
 void k_work_q_start(struct k_work_q *work_q, k_thread_stack_t *stack,
 		    size_t stack_size, int prio)
 {
-	k_queue_init(&work_q->queue);
+	z_work_q_init(work_q);
 	(void)k_thread_create(&work_q->thread, stack, stack_size, z_work_q_main,
 			work_q, NULL, NULL, prio, 0, 0);
 
 	k_thread_name_set(&work_q->thread, WORKQUEUE_THREAD_NAME);
 }
 
+int k_work_q_thread_add(struct k_work_q *work_q, struct k_thread *thread,
+			k_thread_stack_t *stack, size_t stack_size,
+			int prio, int cpu)
+{
+	u32_t options = 0U;
+
+	if (cpu >= CONFIG_MP_NUM_CPUS) {
+		return -EINVAL;
+	}
+
+	if (cpu >= 0 && !IS_ENABLED(CONFIG_SCHED_CPU_MASK)) {
+		return -ENOTSUP;
+	}
+
+	/* Threads added to a user mode queue run in user mode too */
+	if ((work_q->thread.base.user_options & K_USER) != 0U) {
+		options = K_USER | K_INHERIT_PERMS;
+	}
+
+	(void)k_thread_create(thread, stack, stack_size, z_work_q_main,
+			work_q, NULL, NULL, prio, options, K_FOREVER);
+
+	if ((options & K_USER) != 0U) {
+		z_work_q_grant(work_q, thread);
+	}
+
+#ifdef CONFIG_SCHED_CPU_MASK
+	/* The mask can only be changed before the thread is started */
+	if (cpu >= 0) {
+		(void)k_thread_cpu_mask_clear(thread);
+		(void)k_thread_cpu_mask_enable(thread, cpu);
+	}
+#endif
+
+	k_thread_name_set(thread, WORKQUEUE_THREAD_NAME);
+	k_thread_start(thread);
+
+	return 0;
+}
+
 #ifdef CONFIG_SYS_CLOCK_EXISTS
 static void work_timeout(struct _timeout *t)
 {
@@ -58,7 +100,8 @@ static int work_cancel(struct k_delayed_work *work)
 
 	if (k_work_pending(&work->work)) {
 		/* Remove from the queue if already submitted */
-		if (!k_queue_remove(&work->work_q->queue, &work->work)) {
+		if (!k_queue_remove(z_work_q_lane(work->work_q, &work->work),
+				    &work->work)) {
 			return -EINVAL;
 		}
 	} else {
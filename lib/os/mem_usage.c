@@ -0,0 +1,39 @@
+/*
+ * Copyright (c) 2019 Wind River Systems, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/types.h>
+#include <stddef.h>
+#include <sys/util.h>
+#include <sys/mem_usage.h>
+
+#define MEM_USAGE_COUNT 3
+
+#ifdef CONFIG_STATS_NAMES
+static const struct stats_name_map mem_usage_names[] = {
+	{ offsetof(struct sys_mem_usage, used), "used" },
+	{ offsetof(struct sys_mem_usage, max_used), "max_used" },
+	{ offsetof(struct sys_mem_usage, failed), "failed" },
+};
+#define MEM_USAGE_NAMES mem_usage_names, ARRAY_SIZE(mem_usage_names)
+#else
+#define MEM_USAGE_NAMES NULL, 0
+#endif
+
+int sys_mem_usage_register(struct sys_mem_usage *usage, const char *name)
+{
+	struct sys_mem_usage saved;
+	int ret;
+
+	/* stats_init() clears the counters, which may already be live */
+	sys_mem_usage_copy(&saved, usage);
+
+	ret = stats_init_and_reg(&usage->s_hdr, STATS_SIZE_32,
+				 MEM_USAGE_COUNT, MEM_USAGE_NAMES, name);
+
+	sys_mem_usage_copy(usage, &saved);
+
+	return ret;
+}
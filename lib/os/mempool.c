@@ -74,6 +74,9 @@ void z_sys_mem_pool_base_init(struct sys_mem_pool_base *p)
 	u32_t *bits = (u32_t *)((u8_t *)p->buf + buflen);
 
 	p->max_inline_level = -1;
+#ifdef CONFIG_MEM_POOL_USAGE
+	sys_mem_usage_reset(&p->usage);
+#endif
 
 	for (i = 0; i < p->n_levels; i++) {
 		int nblocks = buflen / sz;
@@ -182,6 +185,9 @@ static void block_free(struct sys_mem_pool_base *p, int level,
 {
 	unsigned int key = pool_irq_lock(p);
 
+#ifdef CONFIG_MEM_POOL_USAGE
+	sys_mem_usage_free(&p->usage, lsizes[level]);
+#endif
 	key = bfree_recombine(p, level, lsizes, bn, key);
 	pool_irq_unlock(p, key);
 }
@@ -237,6 +243,11 @@ int z_sys_mem_pool_block_alloc(struct sys_mem_pool_base *p, size_t size,
 	}
 
 	if (alloc_l < 0) {
+#ifdef CONFIG_MEM_POOL_USAGE
+		key = pool_irq_lock(p);
+		sys_mem_usage_fail(&p->usage);
+		pool_irq_unlock(p, key);
+#endif
 		*data_p = NULL;
 		return -ENOMEM;
 	}
@@ -270,6 +281,13 @@ int z_sys_mem_pool_block_alloc(struct sys_mem_pool_base *p, size_t size,
 			break;
 		}
 	}
+#ifdef CONFIG_MEM_POOL_USAGE
+	if (data != NULL) {
+		sys_mem_usage_alloc(&p->usage, lsizes[alloc_l]);
+	} else {
+		sys_mem_usage_fail(&p->usage);
+	}
+#endif
 	pool_irq_unlock(p, key);
 
 	*data_p = data;
@@ -304,6 +322,35 @@ void z_sys_mem_pool_block_free(struct sys_mem_pool_base *p, u32_t level,
 	block_free(p, level, lsizes, block);
 }
 
+int z_sys_mem_pool_free_blocks(struct sys_mem_pool_base *p, int level,
+			       size_t *block_size)
+{
+	unsigned int key;
+	sys_dnode_t *node;
+	size_t lsz = p->max_sz;
+	int count = 0;
+
+	if (level < 0 || level >= p->n_levels) {
+		return -EINVAL;
+	}
+
+	for (int i = 0; i < level; i++) {
+		lsz = WB_DN(lsz / 4);
+	}
+	*block_size = lsz;
+
+	/* Meant for diagnostics: the whole free list is walked with the
+	 * lock held
+	 */
+	key = pool_irq_lock(p);
+	SYS_DLIST_FOR_EACH_NODE(&p->levels[level].free_list, node) {
+		count++;
+	}
+	pool_irq_unlock(p, key);
+
+	return count;
+}
+
 /*
  * Functions specific to user-mode blocks
  */
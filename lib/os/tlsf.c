@@ -0,0 +1,353 @@
+/*
+ * Copyright (c) 2019 Wind River Systems, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <kernel.h>
+#include <errno.h>
+#include <string.h>
+#include <sys/__assert.h>
+#include <sys/tlsf.h>
+
+/* Blocks are laid out back to back in the buffer, each one a header
+ * followed by its payload, and the buffer ends with a zero-sized used
+ * block so that the last real block always has a successor.  The
+ * payload size is a multiple of Z_TLSF_ALIGN, which leaves the low
+ * bits of the size word for flags.  Free blocks keep their free list
+ * links in the first two words of the payload.
+ */
+struct z_tlsf_block {
+	struct z_tlsf_block *prev_phys;
+	size_t size;
+	struct z_tlsf_block *next_free;
+	struct z_tlsf_block *prev_free;
+};
+
+#define BLOCK_FREE	BIT(0)
+#define BLOCK_PREV_FREE	BIT(1)
+#define BLOCK_FLAGS	(BLOCK_FREE | BLOCK_PREV_FREE)
+
+#define MIN_PAYLOAD	(2 * sizeof(void *))
+#define SMALL_BLOCK	(1 << Z_TLSF_FL_SHIFT)
+/* Most blocks of the request's own list tried when good fit fails */
+#define FIT_WALK_MAX	4
+
+static inline size_t bsize(struct z_tlsf_block *b)
+{
+	return b->size & ~BLOCK_FLAGS;
+}
+
+static inline void set_bsize(struct z_tlsf_block *b, size_t size)
+{
+	b->size = size | (b->size & BLOCK_FLAGS);
+}
+
+static inline void *payload(struct z_tlsf_block *b)
+{
+	return (u8_t *)b + Z_TLSF_HDR_SIZE;
+}
+
+static inline struct z_tlsf_block *from_payload(void *ptr)
+{
+	return (struct z_tlsf_block *)((u8_t *)ptr - Z_TLSF_HDR_SIZE);
+}
+
+static inline struct z_tlsf_block *next_phys(struct z_tlsf_block *b)
+{
+	return (struct z_tlsf_block *)((u8_t *)payload(b) + bsize(b));
+}
+
+static inline int msb(size_t size)
+{
+	return 31 - __builtin_clz((u32_t)size);
+}
+
+static void mapping(size_t size, int *fl, int *sl)
+{
+	if (size < SMALL_BLOCK) {
+		*fl = 0;
+		*sl = size >> Z_TLSF_ALIGN_SHIFT;
+	} else {
+		int m = msb(size);
+
+		*fl = m - Z_TLSF_FL_SHIFT + 1;
+		*sl = (size >> (m - Z_TLSF_SL_LOG2)) - Z_TLSF_SL_COUNT;
+	}
+}
+
+static void insert_free(struct sys_tlsf *t, struct z_tlsf_block *b)
+{
+	struct sys_tlsf_fl *fl;
+	int f, s;
+
+	mapping(bsize(b), &f, &s);
+	fl = &t->fl[f];
+
+	b->prev_free = NULL;
+	b->next_free = fl->free[s];
+	if (b->next_free != NULL) {
+		b->next_free->prev_free = b;
+	}
+	fl->free[s] = b;
+	fl->sl_bitmap |= BIT(s);
+	t->fl_bitmap |= BIT(f);
+}
+
+static void remove_free(struct sys_tlsf *t, struct z_tlsf_block *b)
+{
+	int f, s;
+
+	if (b->next_free != NULL) {
+		b->next_free->prev_free = b->prev_free;
+	}
+
+	if (b->prev_free != NULL) {
+		b->prev_free->next_free = b->next_free;
+		return;
+	}
+
+	mapping(bsize(b), &f, &s);
+	t->fl[f].free[s] = b->next_free;
+	if (b->next_free == NULL) {
+		t->fl[f].sl_bitmap &= ~BIT(s);
+		if (t->fl[f].sl_bitmap == 0U) {
+			t->fl_bitmap &= ~BIT(f);
+		}
+	}
+}
+
+/* Marks b free, merges it with free physical neighbours and files the
+ * result in its free list
+ */
+static void release(struct sys_tlsf *t, struct z_tlsf_block *b)
+{
+	struct z_tlsf_block *next = next_phys(b);
+
+	if ((b->size & BLOCK_PREV_FREE) != 0U) {
+		struct z_tlsf_block *prev = b->prev_phys;
+
+		remove_free(t, prev);
+		set_bsize(prev, bsize(prev) + Z_TLSF_HDR_SIZE + bsize(b));
+		b = prev;
+	}
+
+	if ((next->size & BLOCK_FREE) != 0U) {
+		remove_free(t, next);
+		set_bsize(b, bsize(b) + Z_TLSF_HDR_SIZE + bsize(next));
+		next = next_phys(b);
+	}
+
+	b->size |= BLOCK_FREE;
+	next->prev_phys = b;
+	next->size |= BLOCK_PREV_FREE;
+	insert_free(t, b);
+}
+
+/* Cuts a used block down to size bytes, releasing the tail if it is
+ * big enough to be a block of its own
+ */
+static void trim(struct sys_tlsf *t, struct z_tlsf_block *b, size_t size)
+{
+	struct z_tlsf_block *rest;
+
+	if (bsize(b) < size + Z_TLSF_HDR_SIZE + MIN_PAYLOAD) {
+		return;
+	}
+
+	rest = (struct z_tlsf_block *)((u8_t *)payload(b) + size);
+	rest->size = bsize(b) - size - Z_TLSF_HDR_SIZE;
+	rest->prev_phys = b;
+	set_bsize(b, size);
+	next_phys(rest)->prev_phys = rest;
+	release(t, rest);
+}
+
+static size_t adjust_size(size_t size)
+{
+	size = ROUND_UP(size, Z_TLSF_ALIGN);
+
+	return MAX(size, MIN_PAYLOAD);
+}
+
+/* Good fit search: rounding the size up to the next list boundary
+ * means any block in a list found through the bitmaps is big enough.
+ * If that comes up empty, try the first FIT_WALK_MAX blocks of the
+ * request's own list, which can hold a block large enough for it
+ * too: a pool sized for n blocks of a size gets the last one from
+ * there.  Bounding the walk keeps allocation constant time, at the
+ * cost of failing when only a block further down that list fits.
+ */
+static struct z_tlsf_block *find_free(struct sys_tlsf *t, size_t size)
+{
+	struct z_tlsf_block *b;
+	u32_t map;
+	int f, s;
+
+	if (size >= SMALL_BLOCK) {
+		mapping(size + BIT(msb(size) - Z_TLSF_SL_LOG2) - 1, &f, &s);
+	} else {
+		mapping(size, &f, &s);
+	}
+
+	if (f < t->n_fl) {
+		map = t->fl[f].sl_bitmap & (~0U << s);
+		if (map == 0U) {
+			map = t->fl_bitmap & (~0U << (f + 1));
+			if (map != 0U) {
+				f = __builtin_ctz(map);
+				map = t->fl[f].sl_bitmap;
+			}
+		}
+
+		if (map != 0U) {
+			return t->fl[f].free[__builtin_ctz(map)];
+		}
+	}
+
+	mapping(size, &f, &s);
+	b = t->fl[f].free[s];
+	for (int i = 0; i < FIT_WALK_MAX && b != NULL; i++) {
+		if (bsize(b) >= size) {
+			return b;
+		}
+		b = b->next_free;
+	}
+
+	return NULL;
+}
+
+void sys_tlsf_init(struct sys_tlsf *t)
+{
+	u8_t *start = (u8_t *)ROUND_UP(t->buf, Z_TLSF_ALIGN);
+	u8_t *end = (u8_t *)ROUND_DOWN((u8_t *)t->buf + t->size,
+				       Z_TLSF_ALIGN);
+	struct z_tlsf_block *b = (struct z_tlsf_block *)start;
+	struct z_tlsf_block *sentinel;
+
+	__ASSERT(t->n_fl >= Z_TLSF_FL_COUNT(t->size), "too few classes");
+	__ASSERT(end - start >= 2 * Z_TLSF_HDR_SIZE + MIN_PAYLOAD,
+		 "buffer too small");
+
+	t->fl_bitmap = 0U;
+	(void)memset(t->fl, 0, t->n_fl * sizeof(t->fl[0]));
+#ifdef CONFIG_MEM_POOL_USAGE
+	sys_mem_usage_reset(&t->usage);
+#endif
+
+	b->prev_phys = NULL;
+	b->size = end - start - 2 * Z_TLSF_HDR_SIZE;
+
+	sentinel = next_phys(b);
+	sentinel->size = 0;
+
+	release(t, b);
+}
+
+void *sys_tlsf_alloc(struct sys_tlsf *t, size_t size)
+{
+	struct z_tlsf_block *b;
+
+	if (size > t->size) {
+#ifdef CONFIG_MEM_POOL_USAGE
+		sys_mem_usage_fail(&t->usage);
+#endif
+		return NULL;
+	}
+
+	size = adjust_size(size);
+	b = find_free(t, size);
+	if (b == NULL) {
+#ifdef CONFIG_MEM_POOL_USAGE
+		sys_mem_usage_fail(&t->usage);
+#endif
+		return NULL;
+	}
+
+	remove_free(t, b);
+	b->size &= ~BLOCK_FREE;
+	next_phys(b)->size &= ~BLOCK_PREV_FREE;
+	trim(t, b, size);
+#ifdef CONFIG_MEM_POOL_USAGE
+	sys_mem_usage_alloc(&t->usage, bsize(b));
+#endif
+
+	return payload(b);
+}
+
+void sys_tlsf_free(struct sys_tlsf *t, void *ptr)
+{
+	if (ptr == NULL) {
+		return;
+	}
+
+	__ASSERT((from_payload(ptr)->size & BLOCK_FREE) == 0U,
+		 "double free of %p", ptr);
+
+#ifdef CONFIG_MEM_POOL_USAGE
+	sys_mem_usage_free(&t->usage, bsize(from_payload(ptr)));
+#endif
+	release(t, from_payload(ptr));
+}
+
+int sys_tlsf_realloc_in_place(struct sys_tlsf *t, void *ptr, size_t size)
+{
+	struct z_tlsf_block *b = from_payload(ptr);
+	struct z_tlsf_block *next = next_phys(b);
+
+	if (size > t->size) {
+		return -ENOMEM;
+	}
+
+	size = adjust_size(size);
+
+	if (size > bsize(b) &&
+	    ((next->size & BLOCK_FREE) == 0U ||
+	     bsize(b) + Z_TLSF_HDR_SIZE + bsize(next) < size)) {
+		return -ENOMEM;
+	}
+
+#ifdef CONFIG_MEM_POOL_USAGE
+	sys_mem_usage_free(&t->usage, bsize(b));
+#endif
+
+	if (size > bsize(b)) {
+		remove_free(t, next);
+		set_bsize(b, bsize(b) + Z_TLSF_HDR_SIZE + bsize(next));
+		next = next_phys(b);
+		next->prev_phys = b;
+		next->size &= ~BLOCK_PREV_FREE;
+	}
+
+	trim(t, b, size);
+#ifdef CONFIG_MEM_POOL_USAGE
+	sys_mem_usage_alloc(&t->usage, bsize(b));
+#endif
+
+	return 0;
+}
+
+size_t sys_tlsf_usable_size(void *ptr)
+{
+	return bsize(from_payload(ptr));
+}
+
+int sys_tlsf_free_blocks(struct sys_tlsf *t, int fl, size_t *min_size)
+{
+	int count = 0;
+
+	if (fl < 0 || fl >= t->n_fl) {
+		return -EINVAL;
+	}
+
+	*min_size = fl == 0 ? 0 : (size_t)1 << (fl + Z_TLSF_FL_SHIFT - 1);
+
+	for (int sl = 0; sl < Z_TLSF_SL_COUNT; sl++) {
+		for (struct z_tlsf_block *b = t->fl[fl].free[sl]; b != NULL;
+		     b = b->next_free) {
+			count++;
+		}
+	}
+
+	return count;
+}
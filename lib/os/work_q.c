@@ -6,8 +6,51 @@
  */
 
 #include <kernel.h>
+#include <limits.h>
 #define WORKQUEUE_THREAD_NAME	"workqueue"
 
+#if CONFIG_WORKQUEUE_LANES > 1
+void z_work_q_ready(struct k_work_q *work_q)
+{
+	k_sem_give(&work_q->ready);
+}
+
+static struct k_work *work_q_get(struct k_work_q *work_q)
+{
+	struct k_work *work;
+
+	(void)k_sem_take(&work_q->ready, K_FOREVER);
+
+	for (int i = ARRAY_SIZE(work_q->lanes) - 1; i >= 0; i--) {
+		work = k_queue_get(&work_q->lanes[i], K_NO_WAIT);
+		if (work != NULL) {
+			return work;
+		}
+	}
+
+	/* Nothing in lane 0 either if the item counted by the semaphore
+	 * was canceled, or taken by a thread woken up for a later item
+	 */
+	return k_queue_get(&work_q->queue, K_NO_WAIT);
+}
+#else
+static struct k_work *work_q_get(struct k_work_q *work_q)
+{
+	return k_queue_get(&work_q->queue, K_FOREVER);
+}
+#endif
+
+void z_work_q_init(struct k_work_q *work_q)
+{
+	k_queue_init(&work_q->queue);
+#if CONFIG_WORKQUEUE_LANES > 1
+	for (int i = 0; i < ARRAY_SIZE(work_q->lanes); i++) {
+		k_queue_init(&work_q->lanes[i]);
+	}
+	k_sem_init(&work_q->ready, 0, UINT_MAX);
+#endif
+}
+
 void z_work_q_main(void *work_q_ptr, void *p2, void *p3)
 {
 	struct k_work_q *work_q = work_q_ptr;
@@ -19,7 +62,7 @@ void z_work_q_main(void *work_q_ptr, void *p2, void *p3)
 		struct k_work *work;
 		k_work_handler_t handler;
 
-		work = k_queue_get(&work_q->queue, K_FOREVER);
+		work = work_q_get(work_q);
 		if (work == NULL) {
 			continue;
 		}
@@ -39,10 +82,21 @@ void z_work_q_main(void *work_q_ptr, void *p2, void *p3)
 	}
 }
 
+void z_work_q_grant(struct k_work_q *work_q, struct k_thread *thread)
+{
+	k_object_access_grant(&work_q->queue, thread);
+#if CONFIG_WORKQUEUE_LANES > 1
+	for (int i = 0; i < ARRAY_SIZE(work_q->lanes); i++) {
+		k_object_access_grant(&work_q->lanes[i], thread);
+	}
+	k_object_access_grant(&work_q->ready, thread);
+#endif
+}
+
 void k_work_q_user_start(struct k_work_q *work_q, k_thread_stack_t *stack,
 			 size_t stack_size, int prio)
 {
-	k_queue_init(&work_q->queue);
+	z_work_q_init(work_q);
 
 	/* Created worker thread will inherit object permissions and memory
 	 * domain configuration of the caller
@@ -50,8 +104,7 @@ void k_work_q_user_start(struct k_work_q *work_q, k_thread_stack_t *stack,
 	k_thread_create(&work_q->thread, stack, stack_size, z_work_q_main,
 			work_q, 0, 0, prio, K_USER | K_INHERIT_PERMS,
 			K_FOREVER);
-	k_object_access_grant(&work_q->queue, &work_q->thread);
+	z_work_q_grant(work_q, &work_q->thread);
 	k_thread_name_set(&work_q->thread, WORKQUEUE_THREAD_NAME);
 	k_thread_start(&work_q->thread);
 }
-
@@ -26,6 +26,128 @@ static inline size_t nvs_al_size(struct nvs_fs *fs, size_t len)
 	}
 	return (len + (fs->write_block_size - 1U)) & ~(fs->write_block_size - 1U);
 }
+
+#ifdef CONFIG_NVS_LOOKUP_CACHE
+/* first position of an id in the lookup cache, the following positions are
+ * probed in turn when it is taken by another id.
+ */
+static inline size_t nvs_lookup_cache_pos(u16_t id)
+{
+	u16_t hash = id;
+
+	/* 16-bit integer hash, so that consecutive ids spread out */
+	hash ^= hash >> 8;
+	hash *= 0x88b5U;
+	hash ^= hash >> 7;
+	hash *= 0xdb2dU;
+	hash ^= hash >> 9;
+
+	return hash % CONFIG_NVS_LOOKUP_CACHE_SIZE;
+}
+
+static inline bool nvs_lookup_cache_used(struct nvs_fs *fs, size_t pos)
+{
+	return (fs->lookup_cache[pos] != NVS_LOOKUP_CACHE_NO_ADDR) &&
+	       (fs->lookup_cache[pos] != NVS_LOOKUP_CACHE_FREED);
+}
+
+/* position of id in the lookup cache. If id is not in the cache, this is the
+ * position to add it at, or CONFIG_NVS_LOOKUP_CACHE_SIZE if the cache is
+ * full.
+ */
+static size_t nvs_lookup_cache_find(struct nvs_fs *fs, u16_t id)
+{
+	size_t pos = nvs_lookup_cache_pos(id);
+	size_t free_pos = CONFIG_NVS_LOOKUP_CACHE_SIZE;
+
+	for (size_t i = 0; i < CONFIG_NVS_LOOKUP_CACHE_SIZE; i++) {
+		if (fs->lookup_cache[pos] == NVS_LOOKUP_CACHE_NO_ADDR) {
+			/* end of the probe sequence, id is not cached */
+			break;
+		}
+
+		if (!nvs_lookup_cache_used(fs, pos)) {
+			if (free_pos == CONFIG_NVS_LOOKUP_CACHE_SIZE) {
+				free_pos = pos;
+			}
+		} else if (fs->lookup_cache_id[pos] == id) {
+			return pos;
+		}
+
+		pos = (pos + 1) % CONFIG_NVS_LOOKUP_CACHE_SIZE;
+	}
+
+	if ((free_pos == CONFIG_NVS_LOOKUP_CACHE_SIZE) &&
+	    (fs->lookup_cache[pos] == NVS_LOOKUP_CACHE_NO_ADDR)) {
+		free_pos = pos;
+	}
+
+	return free_pos;
+}
+
+/* record addr as the address of the latest ate of id */
+static void nvs_lookup_cache_set(struct nvs_fs *fs, u16_t id, u32_t addr)
+{
+	size_t pos;
+
+	pos = nvs_lookup_cache_find(fs, id);
+	if (pos == CONFIG_NVS_LOOKUP_CACHE_SIZE) {
+		/* ids that are not cached have to be searched for in flash */
+		fs->lookup_cache_full = true;
+		return;
+	}
+
+	fs->lookup_cache[pos] = addr;
+	fs->lookup_cache_id[pos] = id;
+}
+
+/* forget the ids whose latest ate is within an erased sector. Garbage
+ * collection has copied the ones that still have data, and updated their
+ * addresses. Returns true if any id was forgotten.
+ */
+static bool nvs_lookup_cache_invalidate(struct nvs_fs *fs, u32_t addr)
+{
+	bool freed = false;
+
+	for (size_t i = 0; i < CONFIG_NVS_LOOKUP_CACHE_SIZE; i++) {
+		if (nvs_lookup_cache_used(fs, i) &&
+		    ((fs->lookup_cache[i] & ADDR_SECT_MASK) ==
+		     (addr & ADDR_SECT_MASK))) {
+			fs->lookup_cache[i] = NVS_LOOKUP_CACHE_FREED;
+			freed = true;
+		}
+	}
+
+	return freed;
+}
+
+static int nvs_lookup_cache_rebuild(struct nvs_fs *fs);
+#endif
+
+/* address of the ate to start searching for the latest ate of id from,
+ * NVS_LOOKUP_CACHE_NO_ADDR if there is no ate for id.
+ */
+static u32_t nvs_lookup_start(struct nvs_fs *fs, u16_t id)
+{
+#ifdef CONFIG_NVS_LOOKUP_CACHE
+	size_t pos;
+
+	/* 0xFFFF is also the id of the sector close ate, it is not cached */
+	if (id != 0xFFFF) {
+		pos = nvs_lookup_cache_find(fs, id);
+		if ((pos < CONFIG_NVS_LOOKUP_CACHE_SIZE) &&
+		    nvs_lookup_cache_used(fs, pos) &&
+		    (fs->lookup_cache_id[pos] == id)) {
+			return fs->lookup_cache[pos];
+		}
+
+		if (!fs->lookup_cache_full) {
+			return NVS_LOOKUP_CACHE_NO_ADDR;
+		}
+	}
+#endif
+	return fs->ate_wra;
+}
 /* end basic routines */
 
 /* flash routines */
@@ -101,6 +223,12 @@ static int nvs_flash_ate_wrt(struct nvs_fs *fs, const struct nvs_ate *entry)
 {
 	int rc;
 
+#ifdef CONFIG_NVS_LOOKUP_CACHE
+	if (entry->id != 0xFFFF) {
+		nvs_lookup_cache_set(fs, entry->id, fs->ate_wra);
+	}
+#endif
+
 	rc = nvs_flash_al_wrt(fs, fs->ate_wra, entry,
 			       sizeof(struct nvs_ate));
 	fs->ate_wra -= nvs_al_size(fs, sizeof(struct nvs_ate));
@@ -219,6 +347,9 @@ static int nvs_flash_erase_sector(struct nvs_fs *fs, u32_t addr)
 {
 	int rc;
 	off_t offset;
+#ifdef CONFIG_NVS_LOOKUP_CACHE
+	bool freed;
+#endif
 
 	addr &= ADDR_SECT_MASK;
 	rc = nvs_flash_cmp_const(fs, addr, 0xff, fs->sector_size);
@@ -230,6 +361,10 @@ static int nvs_flash_erase_sector(struct nvs_fs *fs, u32_t addr)
 	offset = fs->offset;
 	offset += fs->sector_size * (addr >> ADDR_SECT_SHIFT);
 
+#ifdef CONFIG_NVS_LOOKUP_CACHE
+	freed = nvs_lookup_cache_invalidate(fs, addr);
+#endif
+
 	rc = flash_write_protection_set(fs->flash_device, 0);
 	if (rc) {
 		/* flash protection set error */
@@ -243,6 +378,16 @@ static int nvs_flash_erase_sector(struct nvs_fs *fs, u32_t addr)
 		return rc;
 	}
 	(void) flash_write_protection_set(fs->flash_device, 1);
+
+#ifdef CONFIG_NVS_LOOKUP_CACHE
+	if (freed && fs->lookup_cache_full && fs->ready) {
+		/* ids that overflowed the cache may fit in the room
+		 * garbage collection made. Until they are all cached,
+		 * every cache miss is searched for in flash.
+		 */
+		return nvs_lookup_cache_rebuild(fs);
+	}
+#endif
 	return 0;
 }
 
@@ -397,6 +542,39 @@ static int nvs_prev_ate(struct nvs_fs *fs, u32_t *addr, struct nvs_ate *ate)
 	return 0;
 }
 
+#ifdef CONFIG_NVS_LOOKUP_CACHE
+/* fill the lookup cache from the ates in flash, newest first */
+static int nvs_lookup_cache_rebuild(struct nvs_fs *fs)
+{
+	int rc;
+	u32_t addr, ate_addr;
+	struct nvs_ate ate;
+
+	(void)memset(fs->lookup_cache, 0xff, sizeof(fs->lookup_cache));
+	fs->lookup_cache_full = false;
+	addr = fs->ate_wra;
+
+	while (1) {
+		ate_addr = addr;
+		rc = nvs_prev_ate(fs, &addr, &ate);
+		if (rc) {
+			return rc;
+		}
+
+		if ((ate.id != 0xFFFF) && (!nvs_ate_crc8_check(&ate)) &&
+		    (nvs_lookup_start(fs, ate.id) == NVS_LOOKUP_CACHE_NO_ADDR)) {
+			nvs_lookup_cache_set(fs, ate.id, ate_addr);
+		}
+
+		if (addr == fs->ate_wra) {
+			break;
+		}
+	}
+
+	return 0;
+}
+#endif
+
 static void nvs_sector_advance(struct nvs_fs *fs, u32_t *addr)
 {
 	*addr += (1 << ADDR_SECT_SHIFT);
@@ -431,9 +609,104 @@ static int nvs_sector_close(struct nvs_fs *fs)
 
 	fs->data_wra = fs->ate_wra & ADDR_SECT_MASK;
 
+#ifdef CONFIG_NVS_GC_BACKGROUND
+	/* background garbage collection can copy to the new sector */
+	fs->gc_blocked = false;
+#endif
+
+	return 0;
+}
+
+
+/* garbage collect the ate at *gc_addr, in the sector being garbage
+ * collected: copy it with its data to the write sector if it is the latest
+ * ate of its id and has data. *gc_addr is then moved to the previous ate.
+ * When room is checked and the copy does not fit in the write sector,
+ * NVS_STATUS_NOSPACE is returned and *gc_addr is kept.
+ */
+static int nvs_gc_ate(struct nvs_fs *fs, u32_t *gc_addr, bool check_room)
+{
+	int rc;
+	struct nvs_ate gc_ate, wlk_ate;
+	u32_t gc_prev_addr, wlk_addr, wlk_prev_addr, data_addr, next_addr;
+	size_t ate_size;
+
+	ate_size = nvs_al_size(fs, sizeof(struct nvs_ate));
+
+	gc_prev_addr = *gc_addr;
+	next_addr = *gc_addr;
+	rc = nvs_prev_ate(fs, &next_addr, &gc_ate);
+	if (rc) {
+		return rc;
+	}
+	wlk_addr = nvs_lookup_start(fs, gc_ate.id);
+	wlk_prev_addr = wlk_addr;
+	while (wlk_addr != NVS_LOOKUP_CACHE_NO_ADDR) {
+		wlk_prev_addr = wlk_addr;
+		rc = nvs_prev_ate(fs, &wlk_addr, &wlk_ate);
+		if (rc) {
+			return rc;
+		}
+		/* if ate with same id is reached we might need to copy.
+		 * only consider valid wlk_ate's. Something wrong might
+		 * have been written that has the same ate but is
+		 * invalid, don't consider these as a match.
+		 */
+		if ((wlk_ate.id == gc_ate.id) &&
+		    (!nvs_ate_crc8_check(&wlk_ate))) {
+			break;
+		}
+	}
+	/* if walk has reached the same address as gc_addr copy is
+	 * needed unless it is a deleted item.
+	 */
+	if ((wlk_prev_addr == gc_prev_addr) && gc_ate.len) {
+		/* copy needed, leave the space for a delete ate */
+		if (check_room &&
+		    (fs->ate_wra < fs->data_wra + nvs_al_size(fs, gc_ate.len) +
+				   ate_size)) {
+			return NVS_STATUS_NOSPACE;
+		}
+
+		LOG_DBG("Moving %d, len %d", gc_ate.id, gc_ate.len);
+
+		data_addr = (gc_prev_addr & ADDR_SECT_MASK);
+		data_addr += gc_ate.offset;
+
+		gc_ate.offset = (u16_t)(fs->data_wra & ADDR_OFFS_MASK);
+		nvs_ate_crc8_update(&gc_ate);
+
+		rc = nvs_flash_block_move(fs, data_addr, gc_ate.len);
+		if (rc) {
+			return rc;
+		}
+
+		rc = nvs_flash_ate_wrt(fs, &gc_ate);
+		if (rc) {
+			return rc;
+		}
+
+#ifdef CONFIG_NVS_GC_STATS
+		fs->gc_stats.gc_bytes += nvs_al_size(fs, gc_ate.len) + ate_size;
+#endif
+	}
+
+	*gc_addr = next_addr;
 	return 0;
 }
 
+/* erase a sector once garbage collection has copied its live entries */
+static int nvs_gc_erase(struct nvs_fs *fs, u32_t sec_addr)
+{
+#ifdef CONFIG_NVS_GC_BACKGROUND
+	fs->gc_addr = NVS_GC_ADDR_NONE;
+	fs->gc_ates = 0U;
+#endif
+#ifdef CONFIG_NVS_GC_STATS
+	fs->gc_stats.gc_sectors++;
+#endif
+	return nvs_flash_erase_sector(fs, sec_addr);
+}
 
 /* garbage collection: the address ate_wra has been updated to the new sector
  * that has just been started. The data to gc is in the sector after this new
@@ -442,11 +715,18 @@ static int nvs_sector_close(struct nvs_fs *fs)
 static int nvs_gc(struct nvs_fs *fs)
 {
 	int rc;
-	struct nvs_ate close_ate, gc_ate, wlk_ate;
-	u32_t sec_addr, gc_addr, gc_prev_addr, wlk_addr, wlk_prev_addr,
-	      data_addr, stop_addr;
+	struct nvs_ate close_ate;
+	u32_t sec_addr, gc_addr, gc_prev_addr, stop_addr;
 	size_t ate_size;
 
+#ifdef CONFIG_NVS_GC_BACKGROUND
+	if (fs->gc_free) {
+		/* background garbage collection has erased the sector */
+		fs->gc_free--;
+		return 0;
+	}
+#endif
+
 	ate_size = nvs_al_size(fs, sizeof(struct nvs_ate));
 
 	sec_addr = (fs->ate_wra & ADDR_SECT_MASK);
@@ -469,71 +749,217 @@ static int nvs_gc(struct nvs_fs *fs)
 		return 0;
 	}
 
+#ifdef CONFIG_NVS_GC_STATS
+	fs->gc_stats.gc_write_sectors++;
+#endif
+
+#ifdef CONFIG_NVS_GC_BACKGROUND
+	if (fs->gc_addr == gc_addr) {
+		/* background garbage collection is done but for the erase */
+		return nvs_gc_erase(fs, sec_addr);
+	}
+#endif
+
 	stop_addr = gc_addr - ate_size;
 
 	gc_addr &= ADDR_SECT_MASK;
 	gc_addr += close_ate.offset;
 
+#ifdef CONFIG_NVS_GC_BACKGROUND
+	/* carry on where background garbage collection is */
+	if ((fs->gc_addr & ADDR_SECT_MASK) == sec_addr) {
+		gc_addr = fs->gc_addr;
+	}
+#endif
+
 	while (1) {
 		gc_prev_addr = gc_addr;
-		rc = nvs_prev_ate(fs, &gc_addr, &gc_ate);
+		rc = nvs_gc_ate(fs, &gc_addr, false);
 		if (rc) {
 			return rc;
 		}
-		wlk_addr = fs->ate_wra;
-		while (1) {
-			wlk_prev_addr = wlk_addr;
-			rc = nvs_prev_ate(fs, &wlk_addr, &wlk_ate);
-			if (rc) {
-				return rc;
-			}
-			/* if ate with same id is reached we might need to copy.
-			 * only consider valid wlk_ate's. Something wrong might
-			 * have been written that has the same ate but is
-			 * invalid, don't consider these as a match.
-			 */
-			if ((wlk_ate.id == gc_ate.id) &&
-			    (!nvs_ate_crc8_check(&wlk_ate))) {
-				break;
-			}
+
+		/* stop gc at end of the sector */
+		if (gc_prev_addr == stop_addr) {
+			break;
 		}
-		/* if walk has reached the same address as gc_addr copy is
-		 * needed unless it is a deleted item.
-		 */
-		if ((wlk_prev_addr == gc_prev_addr) && gc_ate.len) {
-			/* copy needed */
-			LOG_DBG("Moving %d, len %d", gc_ate.id, gc_ate.len);
+	}
 
-			data_addr = (gc_prev_addr & ADDR_SECT_MASK);
-			data_addr += gc_ate.offset;
+	return nvs_gc_erase(fs, sec_addr);
+}
 
-			gc_ate.offset = (u16_t)(fs->data_wra & ADDR_OFFS_MASK);
-			nvs_ate_crc8_update(&gc_ate);
+#ifdef CONFIG_NVS_GC_BACKGROUND
+static struct k_work_q nvs_gc_workq;
+static K_THREAD_STACK_DEFINE(nvs_gc_workq_stack,
+			     CONFIG_NVS_GC_WORKQ_STACK_SIZE);
+static bool nvs_gc_workq_started;
 
-			rc = nvs_flash_block_move(fs, data_addr, gc_ate.len);
-			if (rc) {
-				return rc;
-			}
+/* number of sectors background garbage collection frees. The sector before
+ * the write sector is always left closed, nvs_startup() finds the write
+ * sector by it.
+ */
+static inline int nvs_gc_free_target(struct nvs_fs *fs)
+{
+	return MIN(CONFIG_NVS_GC_FREE_SECTORS, fs->sector_count - 3);
+}
+
+/* one step of background garbage collection. The sector collected is the
+ * oldest one: it follows the write sector, the sector that is always kept
+ * empty and the sectors already freed. Live entries are copied to the write
+ * sector, at most CONFIG_NVS_GC_STEP_ATES ates per step, and the sector is
+ * erased in a step of its own. Returns 1 if there is more to do, 0 if not,
+ * or until the write sector is closed, errcode on error.
+ */
+static int nvs_gc_step(struct nvs_fs *fs)
+{
+	int rc;
+	struct nvs_ate close_ate;
+	u32_t sec_addr, close_addr, gc_prev_addr;
+	size_t ate_size;
+
+	if (fs->gc_blocked || (fs->gc_free >= nvs_gc_free_target(fs))) {
+		return 0;
+	}
 
-			rc = nvs_flash_ate_wrt(fs, &gc_ate);
+	ate_size = nvs_al_size(fs, sizeof(struct nvs_ate));
+
+	sec_addr = (fs->ate_wra & ADDR_SECT_MASK);
+	for (u16_t i = 0; i < fs->gc_free + 2; i++) {
+		nvs_sector_advance(fs, &sec_addr);
+	}
+	close_addr = sec_addr + fs->sector_size - ate_size;
+
+	if ((fs->gc_addr & ADDR_SECT_MASK) != sec_addr) {
+		rc = nvs_flash_ate_rd(fs, close_addr, &close_ate);
+		if (rc) {
+			return rc;
+		}
+
+		if (!nvs_ate_cmp_const(&close_ate, 0xff)) {
+			/* the sector is not closed, there is nothing to copy */
+			rc = nvs_flash_erase_sector(fs, sec_addr);
 			if (rc) {
 				return rc;
 			}
+			fs->gc_free++;
+			return 1;
 		}
 
-		/* stop gc at end of the sector */
-		if (gc_prev_addr == stop_addr) {
+		fs->gc_addr = sec_addr + close_ate.offset;
+		fs->gc_ates = 0U;
+	}
+
+	if (fs->gc_addr == close_addr) {
+		rc = nvs_gc_erase(fs, sec_addr);
+		if (rc) {
+			return rc;
+		}
+		fs->gc_free++;
+		return 1;
+	}
+
+	for (int i = 0; i < CONFIG_NVS_GC_STEP_ATES; i++) {
+		gc_prev_addr = fs->gc_addr;
+		rc = nvs_gc_ate(fs, &fs->gc_addr, true);
+		if (rc == NVS_STATUS_NOSPACE) {
+			/* the write sector is full, wait for it to be closed */
+			fs->gc_blocked = true;
+			return 0;
+		}
+		if (rc) {
+			return rc;
+		}
+
+		fs->gc_ates++;
+		if (gc_prev_addr == close_addr - ate_size) {
+			/* last ate of the sector, erase it in the next step */
+			fs->gc_addr = close_addr;
 			break;
 		}
 	}
 
-	rc = nvs_flash_erase_sector(fs, sec_addr);
-	if (rc) {
-		return rc;
+	return 1;
+}
+
+static void nvs_gc_work_handler(struct k_work *work)
+{
+	struct nvs_fs *fs = CONTAINER_OF(work, struct nvs_fs, gc_work);
+	int rc = 0;
+
+	k_mutex_lock(&fs->nvs_lock, K_FOREVER);
+	if (fs->ready) {
+		rc = nvs_gc_step(fs);
+	}
+	k_mutex_unlock(&fs->nvs_lock);
+
+	if (rc < 0) {
+		LOG_ERR("Background garbage collection failed: %d", rc);
+	} else if (rc) {
+		/* let other work and threads run between steps */
+		k_work_submit_to_queue(&nvs_gc_workq, work);
 	}
+}
+
+/* start background garbage collection if it has sectors to free */
+static void nvs_gc_schedule(struct nvs_fs *fs)
+{
+	if (!fs->gc_blocked && (fs->gc_free < nvs_gc_free_target(fs))) {
+		k_work_submit_to_queue(&nvs_gc_workq, &fs->gc_work);
+	}
+}
+
+/* forget what background garbage collection knows about the flash */
+static void nvs_gc_reset(struct nvs_fs *fs)
+{
+	fs->gc_addr = NVS_GC_ADDR_NONE;
+	fs->gc_free = 0U;
+	fs->gc_ates = 0U;
+	fs->gc_blocked = false;
+}
+
+/* count the blank sectors ahead of the write sector as already freed, so
+ * that background garbage collection does not go over them again.
+ */
+static int nvs_gc_count_free(struct nvs_fs *fs)
+{
+	int rc;
+	u32_t sec_addr;
+
+	sec_addr = (fs->ate_wra & ADDR_SECT_MASK);
+	nvs_sector_advance(fs, &sec_addr);
+	while (fs->gc_free < nvs_gc_free_target(fs)) {
+		nvs_sector_advance(fs, &sec_addr);
+		rc = nvs_flash_cmp_const(fs, sec_addr, 0xff, fs->sector_size);
+		if (rc) {
+			/* flash error or sector in use */
+			return (rc < 0) ? rc : 0;
+		}
+		fs->gc_free++;
+	}
+
 	return 0;
 }
 
+/* reads walk the ATEs that background garbage collection moves and erases */
+static inline void nvs_read_lock(struct nvs_fs *fs)
+{
+	k_mutex_lock(&fs->nvs_lock, K_FOREVER);
+}
+
+static inline void nvs_read_unlock(struct nvs_fs *fs)
+{
+	k_mutex_unlock(&fs->nvs_lock);
+}
+#else
+static inline void nvs_read_lock(struct nvs_fs *fs)
+{
+}
+
+static inline void nvs_read_unlock(struct nvs_fs *fs)
+{
+}
+#endif
+
 static int nvs_startup(struct nvs_fs *fs)
 {
 	int rc;
@@ -548,6 +974,15 @@ static int nvs_startup(struct nvs_fs *fs)
 
 	k_mutex_lock(&fs->nvs_lock, K_FOREVER);
 
+#ifdef CONFIG_NVS_LOOKUP_CACHE
+	/* search flash for every id until the cache is rebuilt below */
+	(void)memset(fs->lookup_cache, 0xff, sizeof(fs->lookup_cache));
+	fs->lookup_cache_full = true;
+#endif
+#ifdef CONFIG_NVS_GC_BACKGROUND
+	nvs_gc_reset(fs);
+#endif
+
 	ate_size = nvs_al_size(fs, sizeof(struct nvs_ate));
 	/* step through the sectors to find a open sector following
 	 * a closed sector, this is where NVS can to write.
@@ -663,6 +1098,17 @@ static int nvs_startup(struct nvs_fs *fs)
 		}
 	}
 
+#ifdef CONFIG_NVS_GC_BACKGROUND
+	rc = nvs_gc_count_free(fs);
+	if (rc) {
+		goto end;
+	}
+#endif
+
+#ifdef CONFIG_NVS_LOOKUP_CACHE
+	rc = nvs_lookup_cache_rebuild(fs);
+#endif
+
 end:
 	k_mutex_unlock(&fs->nvs_lock);
 	return rc;
@@ -678,14 +1124,26 @@ int nvs_clear(struct nvs_fs *fs)
 		return -EACCES;
 	}
 
+	k_mutex_lock(&fs->nvs_lock, K_FOREVER);
+
+	/* nvs needs to be initialized again after clearing */
+	fs->ready = false;
+
+#ifdef CONFIG_NVS_GC_BACKGROUND
+	nvs_gc_reset(fs);
+#endif
+
+	rc = 0;
 	for (u16_t i = 0; i < fs->sector_count; i++) {
 		addr = i << ADDR_SECT_SHIFT;
 		rc = nvs_flash_erase_sector(fs, addr);
 		if (rc) {
-			return rc;
+			break;
 		}
 	}
-	return 0;
+
+	k_mutex_unlock(&fs->nvs_lock);
+	return rc;
 }
 
 int nvs_init(struct nvs_fs *fs, const char *dev_name)
@@ -694,7 +1152,32 @@ int nvs_init(struct nvs_fs *fs, const char *dev_name)
 	int rc;
 	struct flash_pages_info info;
 
+#ifdef CONFIG_NVS_GC_BACKGROUND
+	if (!nvs_gc_workq_started) {
+		k_work_q_start(&nvs_gc_workq, nvs_gc_workq_stack,
+			       K_THREAD_STACK_SIZEOF(nvs_gc_workq_stack),
+			       K_LOWEST_APPLICATION_THREAD_PRIO);
+		k_thread_name_set(&nvs_gc_workq.thread, "nvs_gc");
+		nvs_gc_workq_started = true;
+	}
+
+	/*
+	 * The work item of a file system initialized before may be queued,
+	 * or running and holding the lock.
+	 */
+	if (!fs->gc_init) {
+		k_mutex_init(&fs->nvs_lock);
+		k_work_init(&fs->gc_work, nvs_gc_work_handler);
+		fs->gc_init = true;
+	}
+
+	/* the work item does nothing until the file system is ready again */
+	k_mutex_lock(&fs->nvs_lock, K_FOREVER);
+	fs->ready = false;
+	k_mutex_unlock(&fs->nvs_lock);
+#else
 	k_mutex_init(&fs->nvs_lock);
+#endif
 
 	fs->flash_device = device_get_binding(dev_name);
 	if (!fs->flash_device) {
@@ -743,6 +1226,10 @@ int nvs_init(struct nvs_fs *fs, const char *dev_name)
 		(fs->data_wra >> ADDR_SECT_SHIFT),
 		(fs->data_wra & ADDR_OFFS_MASK));
 
+#ifdef CONFIG_NVS_GC_BACKGROUND
+	nvs_gc_schedule(fs);
+#endif
+
 	return 0;
 }
 
@@ -773,10 +1260,10 @@ ssize_t nvs_write(struct nvs_fs *fs, u16_t id, const void *data, size_t len)
 	}
 
 	/* find latest entry with same id */
-	wlk_addr = fs->ate_wra;
+	wlk_addr = nvs_lookup_start(fs, id);
 	rd_addr = wlk_addr;
 
-	while (1) {
+	while (wlk_addr != NVS_LOOKUP_CACHE_NO_ADDR) {
 		rd_addr = wlk_addr;
 		rc = nvs_prev_ate(fs, &wlk_addr, &wlk_ate);
 		if (rc) {
@@ -843,6 +1330,9 @@ ssize_t nvs_write(struct nvs_fs *fs, u16_t id, const void *data, size_t len)
 			if (rc) {
 				goto end;
 			}
+#ifdef CONFIG_NVS_GC_STATS
+			fs->gc_stats.write_bytes += data_size + ate_size;
+#endif
 			break;
 		}
 
@@ -859,6 +1349,9 @@ ssize_t nvs_write(struct nvs_fs *fs, u16_t id, const void *data, size_t len)
 		gc_count++;
 	}
 	rc = len;
+#ifdef CONFIG_NVS_GC_BACKGROUND
+	nvs_gc_schedule(fs);
+#endif
 end:
 	k_mutex_unlock(&fs->nvs_lock);
 	return rc;
@@ -889,9 +1382,15 @@ ssize_t nvs_read_hist(struct nvs_fs *fs, u16_t id, void *data, size_t len,
 		return -EINVAL;
 	}
 
+	nvs_read_lock(fs);
+
 	cnt_his = 0U;
 
-	wlk_addr = fs->ate_wra;
+	wlk_addr = nvs_lookup_start(fs, id);
+	if (wlk_addr == NVS_LOOKUP_CACHE_NO_ADDR) {
+		rc = -ENOENT;
+		goto err;
+	}
 	rd_addr = wlk_addr;
 
 	while (cnt_his <= cnt) {
@@ -910,7 +1409,8 @@ ssize_t nvs_read_hist(struct nvs_fs *fs, u16_t id, void *data, size_t len,
 
 	if (((wlk_addr == fs->ate_wra) && (wlk_ate.id != id)) ||
 	    (wlk_ate.len == 0U) || (cnt_his < cnt)) {
-		return -ENOENT;
+		rc = -ENOENT;
+		goto err;
 	}
 
 	rd_addr &= ADDR_SECT_MASK;
@@ -920,9 +1420,10 @@ ssize_t nvs_read_hist(struct nvs_fs *fs, u16_t id, void *data, size_t len,
 		goto err;
 	}
 
-	return wlk_ate.len;
+	rc = wlk_ate.len;
 
 err:
+	nvs_read_unlock(fs);
 	return rc;
 }
 
@@ -954,12 +1455,14 @@ ssize_t nvs_calc_free_space(struct nvs_fs *fs)
 		free_space += (fs->sector_size - ate_size);
 	}
 
+	nvs_read_lock(fs);
+
 	step_addr = fs->ate_wra;
 
 	while (1) {
 		rc = nvs_prev_ate(fs, &step_addr, &step_ate);
 		if (rc) {
-			return rc;
+			goto end;
 		}
 
 		wlk_addr = fs->ate_wra;
@@ -967,7 +1470,7 @@ ssize_t nvs_calc_free_space(struct nvs_fs *fs)
 		while (1) {
 			rc = nvs_prev_ate(fs, &wlk_addr, &wlk_ate);
 			if (rc) {
-				return rc;
+				goto end;
 			}
 			if ((wlk_ate.id == step_ate.id) ||
 			    (wlk_addr == fs->ate_wra)) {
@@ -987,5 +1490,35 @@ ssize_t nvs_calc_free_space(struct nvs_fs *fs)
 		}
 
 	}
+
+end:
+	nvs_read_unlock(fs);
+	if (rc) {
+		return rc;
+	}
 	return free_space;
 }
+
+int nvs_gc_stats_get(struct nvs_fs *fs, struct nvs_gc_stats *stats)
+{
+#ifdef CONFIG_NVS_GC_STATS
+	if (!fs->ready) {
+		LOG_ERR("NVS not initialized");
+		return -EACCES;
+	}
+
+	k_mutex_lock(&fs->nvs_lock, K_FOREVER);
+
+	*stats = fs->gc_stats;
+#ifdef CONFIG_NVS_GC_BACKGROUND
+	stats->free_sectors = fs->gc_free;
+	stats->gc_ates = fs->gc_ates;
+#endif
+
+	k_mutex_unlock(&fs->nvs_lock);
+
+	return 0;
+#else
+	return -ENOTSUP;
+#endif
+}
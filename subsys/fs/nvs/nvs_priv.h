@@ -28,6 +28,13 @@ extern "C" {
 
 #define NVS_BLOCK_SIZE 32
 
+/* Lookup cache entry that was never used, and one that was freed */
+#define NVS_LOOKUP_CACHE_NO_ADDR 0xFFFFFFFF
+#define NVS_LOOKUP_CACHE_FREED 0xFFFFFFFE
+
+/* No sector is being garbage collected in background */
+#define NVS_GC_ADDR_NONE 0xFFFFFFFF
+
 /* Allocation Table Entry */
 struct nvs_ate {
 	u16_t id;	/* data id */
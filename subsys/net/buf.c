@@ -17,6 +17,7 @@ LOG_MODULE_REGISTER(LOG_MODULE_NAME);
 #include <stddef.h>
 #include <string.h>
 #include <sys/byteorder.h>
+#include <init.h>
 
 #include <net/buf.h>
 
@@ -57,6 +58,59 @@ static int pool_id(struct net_buf_pool *pool)
 	return pool - _net_buf_pool_list;
 }
 
+#if defined(CONFIG_NET_BUF_POOL_USAGE)
+static void pool_usage_alloc(struct net_buf_pool *pool)
+{
+	unsigned int key = irq_lock();
+
+	pool->avail_count--;
+	sys_mem_usage_alloc(&pool->usage, 1);
+	irq_unlock(key);
+
+	NET_BUF_ASSERT(pool->avail_count >= 0);
+}
+
+static void pool_usage_free(struct net_buf_pool *pool)
+{
+	unsigned int key = irq_lock();
+
+	pool->avail_count++;
+	sys_mem_usage_free(&pool->usage, 1);
+	irq_unlock(key);
+
+	NET_BUF_ASSERT(pool->avail_count <= pool->buf_count);
+}
+
+static void pool_usage_fail(struct net_buf_pool *pool)
+{
+	unsigned int key = irq_lock();
+
+	sys_mem_usage_fail(&pool->usage);
+	irq_unlock(key);
+}
+
+#if defined(CONFIG_MEM_USAGE_STATS)
+extern struct net_buf_pool _net_buf_pool_list_end[];
+
+static int net_buf_pool_stats_init(struct device *unused)
+{
+	struct net_buf_pool *pool;
+
+	ARG_UNUSED(unused);
+
+	for (pool = _net_buf_pool_list; pool < _net_buf_pool_list_end;
+	     pool++) {
+		(void)sys_mem_usage_register(&pool->usage, pool->name);
+	}
+
+	return 0;
+}
+
+SYS_INIT(net_buf_pool_stats_init, PRE_KERNEL_1,
+	 CONFIG_KERNEL_INIT_PRIORITY_OBJECTS);
+#endif /* CONFIG_MEM_USAGE_STATS */
+#endif /* CONFIG_NET_BUF_POOL_USAGE */
+
 int net_buf_id(struct net_buf *buf)
 {
 	struct net_buf_pool *pool = net_buf_pool_get(buf->pool_id);
@@ -306,6 +360,9 @@ struct net_buf *net_buf_alloc_len(struct net_buf_pool *pool, size_t size,
 #endif
 	if (!buf) {
 		NET_BUF_ERR("%s():%d: Failed to get free buffer", func, line);
+#if defined(CONFIG_NET_BUF_POOL_USAGE)
+		pool_usage_fail(pool);
+#endif
 		return NULL;
 	}
 
@@ -323,6 +380,9 @@ success:
 		if (!buf->__buf) {
 			NET_BUF_ERR("%s():%d: Failed to allocate data",
 				    func, line);
+#if defined(CONFIG_NET_BUF_POOL_USAGE)
+			pool_usage_fail(pool);
+#endif
 			net_buf_destroy(buf);
 			return NULL;
 		}
@@ -337,8 +397,7 @@ success:
 	net_buf_reset(buf);
 
 #if defined(CONFIG_NET_BUF_POOL_USAGE)
-	pool->avail_count--;
-	NET_BUF_ASSERT(pool->avail_count >= 0);
+	pool_usage_alloc(pool);
 #endif
 
 	return buf;
@@ -537,8 +596,7 @@ void net_buf_unref(struct net_buf *buf)
 		pool = net_buf_pool_get(buf->pool_id);
 
 #if defined(CONFIG_NET_BUF_POOL_USAGE)
-		pool->avail_count++;
-		NET_BUF_ASSERT(pool->avail_count <= pool->buf_count);
+		pool_usage_free(pool);
 #endif
 
 		if (pool->destroy) {
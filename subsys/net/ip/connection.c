@@ -59,6 +59,200 @@ static struct net_conn conns[CONFIG_NET_MAX_CONN];
 static sys_slist_t conn_unused;
 static sys_slist_t conn_used;
 
+#if defined(CONFIG_NET_CONN_HASH)
+/* Every used connection is also chained, newest first, in one of:
+ *  - conn_full, when remote address, remote port and local port are
+ *    all specified, hashed on these,
+ *  - conn_port, when only the local port is, hashed on it,
+ *  - conn_wild, otherwise.
+ * A packet can only match connections from one bucket of each, which
+ * are merged back into registration order, so that it gets the same
+ * handler as when walking conn_used.
+ */
+#define NET_CONN_FULL_SPEC (NET_CONN_REMOTE_ADDR_SPEC | \
+			    NET_CONN_REMOTE_PORT_SPEC | \
+			    NET_CONN_LOCAL_PORT_SPEC)
+
+static sys_slist_t conn_full[CONFIG_NET_CONN_HASH_SIZE];
+static sys_slist_t conn_port[CONFIG_NET_CONN_HASH_SIZE];
+static sys_slist_t conn_wild;
+static u32_t conn_seq;
+
+/* Ports in network byte order */
+static u32_t conn_hash(u16_t proto, u16_t local_port, u16_t remote_port,
+		       const u8_t *addr, size_t addr_len)
+{
+	u32_t hash = ((u32_t)local_port << 16) ^ remote_port ^ proto;
+
+	while (addr_len--) {
+		hash = hash * 31U + *addr++;
+	}
+
+	return (hash ^ (hash >> 16)) % CONFIG_NET_CONN_HASH_SIZE;
+}
+
+static const u8_t *conn_addr_bytes(const struct sockaddr *addr,
+				   size_t *len)
+{
+	if (IS_ENABLED(CONFIG_NET_IPV6) && addr->sa_family == AF_INET6) {
+		*len = sizeof(struct in6_addr);
+		return net_sin6(addr)->sin6_addr.s6_addr;
+	}
+
+	*len = sizeof(struct in_addr);
+	return net_sin(addr)->sin_addr.s4_addr;
+}
+
+static sys_slist_t *conn_chain_get(u16_t proto, u8_t flags,
+				   const struct sockaddr *remote_addr,
+				   u16_t remote_port, u16_t local_port)
+{
+	const u8_t *addr;
+	size_t len;
+
+	if ((flags & NET_CONN_FULL_SPEC) == NET_CONN_FULL_SPEC) {
+		addr = conn_addr_bytes(remote_addr, &len);
+		return &conn_full[conn_hash(proto, local_port, remote_port,
+					    addr, len)];
+	}
+
+	if (flags & NET_CONN_LOCAL_PORT_SPEC) {
+		return &conn_port[conn_hash(proto, local_port, 0, NULL, 0)];
+	}
+
+	return &conn_wild;
+}
+
+static sys_slist_t *conn_chain(struct net_conn *conn)
+{
+	return conn_chain_get(conn->proto, conn->flags, &conn->remote_addr,
+			      net_sin(&conn->remote_addr)->sin_port,
+			      net_sin(&conn->local_addr)->sin_port);
+}
+
+/* Flags the chain of a connection being registered depends on */
+static u8_t conn_chain_flags(const struct sockaddr *remote_addr,
+			     u16_t remote_port, u16_t local_port)
+{
+	u8_t flags = 0U;
+
+	if (remote_addr &&
+	    ((IS_ENABLED(CONFIG_NET_IPV6) &&
+	      remote_addr->sa_family == AF_INET6 &&
+	      !net_ipv6_is_addr_unspecified(
+		      &net_sin6(remote_addr)->sin6_addr)) ||
+	     (IS_ENABLED(CONFIG_NET_IPV4) &&
+	      remote_addr->sa_family == AF_INET &&
+	      net_sin(remote_addr)->sin_addr.s_addr))) {
+		flags |= NET_CONN_REMOTE_ADDR_SPEC;
+	}
+
+	if (remote_port) {
+		flags |= NET_CONN_REMOTE_PORT_SPEC;
+	}
+
+	if (local_port) {
+		flags |= NET_CONN_LOCAL_PORT_SPEC;
+	}
+
+	return flags;
+}
+
+#define CONN_CHAIN_NODE hash_node
+#else
+#define CONN_CHAIN_NODE node
+#endif /* CONFIG_NET_CONN_HASH */
+
+/* Walks the connections a packet may match, newest first */
+struct conn_iter {
+#if defined(CONFIG_NET_CONN_HASH)
+	struct net_conn *next[3];
+#else
+	struct net_conn *next;
+#endif
+};
+
+#if defined(CONFIG_NET_CONN_HASH)
+static void conn_iter_init(struct conn_iter *iter, struct net_pkt *pkt,
+			   union net_ip_header *ip_hdr, u16_t proto,
+			   u16_t src_port, u16_t dst_port)
+{
+	const u8_t *addr = NULL;
+	size_t len;
+
+	if (IS_ENABLED(CONFIG_NET_IPV6) && net_pkt_family(pkt) == AF_INET6) {
+		addr = ip_hdr->ipv6->src.s6_addr;
+		len = sizeof(struct in6_addr);
+	} else if (IS_ENABLED(CONFIG_NET_IPV4) &&
+		   net_pkt_family(pkt) == AF_INET) {
+		addr = ip_hdr->ipv4->src.s4_addr;
+		len = sizeof(struct in_addr);
+	}
+
+	/* Only UDP and TCP connections are hashed */
+	if (addr && (proto == IPPROTO_UDP || proto == IPPROTO_TCP)) {
+		iter->next[0] = SYS_SLIST_PEEK_HEAD_CONTAINER(
+			&conn_full[conn_hash(proto, dst_port, src_port,
+					     addr, len)],
+			iter->next[0], hash_node);
+		iter->next[1] = SYS_SLIST_PEEK_HEAD_CONTAINER(
+			&conn_port[conn_hash(proto, dst_port, 0, NULL, 0)],
+			iter->next[1], hash_node);
+	} else {
+		iter->next[0] = NULL;
+		iter->next[1] = NULL;
+	}
+
+	iter->next[2] = SYS_SLIST_PEEK_HEAD_CONTAINER(&conn_wild,
+						      iter->next[2],
+						      hash_node);
+}
+
+static struct net_conn *conn_iter_next(struct conn_iter *iter)
+{
+	struct net_conn *conn = NULL;
+	int i, newest = 0;
+
+	for (i = 0; i < ARRAY_SIZE(iter->next); i++) {
+		if (iter->next[i] == NULL) {
+			continue;
+		}
+
+		if (conn == NULL ||
+		    (s32_t)(iter->next[i]->seq - conn->seq) > 0) {
+			conn = iter->next[i];
+			newest = i;
+		}
+	}
+
+	if (conn) {
+		iter->next[newest] = SYS_SLIST_PEEK_NEXT_CONTAINER(conn,
+								   hash_node);
+	}
+
+	return conn;
+}
+#else
+static void conn_iter_init(struct conn_iter *iter, struct net_pkt *pkt,
+			   union net_ip_header *ip_hdr, u16_t proto,
+			   u16_t src_port, u16_t dst_port)
+{
+	iter->next = SYS_SLIST_PEEK_HEAD_CONTAINER(&conn_used, iter->next,
+						   node);
+}
+
+static struct net_conn *conn_iter_next(struct conn_iter *iter)
+{
+	struct net_conn *conn = iter->next;
+
+	if (conn) {
+		iter->next = SYS_SLIST_PEEK_NEXT_CONTAINER(conn, node);
+	}
+
+	return conn;
+}
+#endif /* CONFIG_NET_CONN_HASH */
+
 #if (CONFIG_NET_CONN_LOG_LEVEL >= LOG_LEVEL_DBG)
 static inline
 void conn_register_debug(struct net_conn *conn,
@@ -132,6 +326,11 @@ static void conn_set_used(struct net_conn *conn)
 	conn->flags |= NET_CONN_IN_USE;
 
 	sys_slist_prepend(&conn_used, &conn->node);
+
+#if defined(CONFIG_NET_CONN_HASH)
+	conn->seq = ++conn_seq;
+	sys_slist_prepend(conn_chain(conn), &conn->hash_node);
+#endif
 }
 
 static void conn_set_unused(struct net_conn *conn)
@@ -148,9 +347,19 @@ static struct net_conn *conn_find_handler(u16_t proto, u8_t family,
 					  u16_t remote_port,
 					  u16_t local_port)
 {
+	sys_slist_t *list = &conn_used;
 	struct net_conn *conn;
 
-	SYS_SLIST_FOR_EACH_CONTAINER(&conn_used, conn, node) {
+#if defined(CONFIG_NET_CONN_HASH)
+	/* An identical handler has the same flags, so is in the same chain */
+	list = conn_chain_get(proto,
+			      conn_chain_flags(remote_addr, remote_port,
+					       local_port),
+			      remote_addr, htons(remote_port),
+			      htons(local_port));
+#endif
+
+	SYS_SLIST_FOR_EACH_CONTAINER(list, conn, CONN_CHAIN_NODE) {
 		if (conn->proto != proto) {
 			continue;
 		}
@@ -374,6 +583,10 @@ int net_conn_unregister(struct net_conn_handle *handle)
 
 	sys_slist_find_and_remove(&conn_used, &conn->node);
 
+#if defined(CONFIG_NET_CONN_HASH)
+	sys_slist_find_and_remove(conn_chain(conn), &conn->hash_node);
+#endif
+
 	conn_set_unused(conn);
 
 	return 0;
@@ -509,6 +722,7 @@ enum net_verdict net_conn_input(struct net_pkt *pkt,
 	struct net_conn *best_match = NULL;
 	bool is_mcast_pkt = false, mcast_pkt_delivered = false;
 	s16_t best_rank = -1;
+	struct conn_iter iter;
 	struct net_conn *conn;
 	u16_t src_port;
 	u16_t dst_port;
@@ -564,7 +778,9 @@ enum net_verdict net_conn_input(struct net_pkt *pkt,
 		}
 	}
 
-	SYS_SLIST_FOR_EACH_CONTAINER(&conn_used, conn, node) {
+	conn_iter_init(&iter, pkt, ip_hdr, proto, src_port, dst_port);
+
+	while ((conn = conn_iter_next(&iter)) != NULL) {
 		if (conn->proto != proto) {
 			continue;
 		}
@@ -729,6 +945,14 @@ void net_conn_init(void)
 	sys_slist_init(&conn_unused);
 	sys_slist_init(&conn_used);
 
+#if defined(CONFIG_NET_CONN_HASH)
+	for (i = 0; i < CONFIG_NET_CONN_HASH_SIZE; i++) {
+		sys_slist_init(&conn_full[i]);
+		sys_slist_init(&conn_port[i]);
+	}
+	sys_slist_init(&conn_wild);
+#endif
+
 	for (i = 0; i < CONFIG_NET_MAX_CONN; i++) {
 		sys_slist_prepend(&conn_unused, &conns[i].node);
 	}
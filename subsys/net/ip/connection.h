@@ -70,6 +70,14 @@ struct net_conn {
 
 	/** Flags for the connection */
 	u8_t flags;
+
+#if defined(CONFIG_NET_CONN_HASH)
+	/** Hash chain node */
+	sys_snode_t hash_node;
+
+	/** Registration order, newest is highest */
+	u32_t seq;
+#endif
 };
 
 /**
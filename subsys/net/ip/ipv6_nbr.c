@@ -786,7 +786,9 @@ enum net_verdict net_ipv6_prepare_for_send(struct net_pkt *pkt)
 		size_t pkt_len = net_pkt_get_len(pkt);
 
 		mtu = MAX(NET_IPV6_MTU, mtu);
-		if (mtu < pkt_len) {
+
+		/* TCP segments are split by the device, not fragmented */
+		if (mtu < pkt_len && !net_pkt_tso_mss(pkt)) {
 			ret = net_ipv6_send_fragmented_pkt(net_pkt_iface(pkt),
 							   pkt, pkt_len);
 			if (ret < 0) {
@@ -1328,9 +1328,66 @@ static void set_pkt_txtime(struct net_pkt *pkt, const struct msghdr *msghdr)
 	}
 }
 
+#if defined(CONFIG_NET_CONTEXT_ZEROCOPY)
+/* Largest payload that fits one packet, as the loaned buffers are sent
+ * as-is and cannot be split.
+ */
+static size_t context_max_payload(struct net_context *context)
+{
+	size_t max_len = net_if_get_mtu(net_context_get_iface(context));
+	size_t hdr_len = 0;
+
+	if (IS_ENABLED(CONFIG_NET_IPV6) &&
+	    net_context_get_family(context) == AF_INET6) {
+		if (IS_ENABLED(CONFIG_NET_IPV6_FRAGMENT) &&
+		    net_context_get_ip_proto(context) == IPPROTO_UDP) {
+			return SIZE_MAX;
+		}
+
+		max_len = MAX(max_len, NET_IPV6_MTU);
+		hdr_len = NET_IPV6H_LEN;
+	} else if (IS_ENABLED(CONFIG_NET_IPV4) &&
+		   net_context_get_family(context) == AF_INET) {
+		max_len = MAX(max_len, NET_IPV4_MTU);
+		hdr_len = NET_IPV4H_LEN;
+	}
+
+#if defined(CONFIG_NET_TCP)
+	if (net_context_get_ip_proto(context) == IPPROTO_TCP) {
+		hdr_len += NET_TCPH_LEN;
+
+#if defined(CONFIG_NET_TCP_TSO)
+		/* The device splits the segment to the MSS */
+		if (!net_if_need_tcp_segmentation(
+			    net_context_get_iface(context))) {
+			return CONFIG_NET_TCP_TSO_MAX_SIZE - hdr_len;
+		}
+#endif
+
+		max_len -= MIN(max_len, hdr_len);
+
+		return MIN(max_len, context->tcp->send_mss);
+	}
+#endif
+
+	hdr_len += NET_UDPH_LEN;
+
+	return max_len - MIN(max_len, hdr_len);
+}
+
+/* Chain the loaned buffers after the headers. The packet holds its own
+ * reference so that the caller can drop theirs at any time.
+ */
+static void context_append_frags(struct net_pkt *pkt, struct net_buf *frags)
+{
+	net_pkt_append_buffer(pkt, net_buf_ref(frags));
+}
+#endif /* CONFIG_NET_CONTEXT_ZEROCOPY */
+
 static int context_sendto(struct net_context *context,
 			  const void *buf,
 			  size_t len,
+			  struct net_buf *frags,
 			  const struct sockaddr *dst_addr,
 			  socklen_t addrlen,
 			  net_context_send_cb_t cb,
@@ -1470,15 +1527,41 @@ static int context_sendto(struct net_context *context,
 		}
 	}
 
-	pkt = context_alloc_pkt(context, len, PKT_WAIT_TIME);
-	if (!pkt) {
-		return -ENOMEM;
-	}
+#if defined(CONFIG_NET_CONTEXT_ZEROCOPY)
+	if (frags) {
+		if (net_context_get_ip_proto(context) != IPPROTO_UDP &&
+		    net_context_get_ip_proto(context) != IPPROTO_TCP) {
+			return -EOPNOTSUPP;
+		}
+
+		if (IS_ENABLED(CONFIG_NET_OFFLOAD) &&
+		    net_if_is_ip_offloaded(net_context_get_iface(context))) {
+			return -EOPNOTSUPP;
+		}
 
-	tmp_len = net_pkt_available_payload_buffer(
+		len = net_buf_frags_len(frags);
+		if (len > context_max_payload(context)) {
+			return -EMSGSIZE;
+		}
+
+		/* Only the headers are allocated, the payload is loaned */
+		pkt = context_alloc_pkt(context, 0, PKT_WAIT_TIME);
+		if (!pkt) {
+			return -ENOMEM;
+		}
+	} else
+#endif /* CONFIG_NET_CONTEXT_ZEROCOPY */
+	{
+		pkt = context_alloc_pkt(context, len, PKT_WAIT_TIME);
+		if (!pkt) {
+			return -ENOMEM;
+		}
+
+		tmp_len = net_pkt_available_payload_buffer(
 				pkt, net_context_get_ip_proto(context));
-	if (tmp_len < len) {
-		len = tmp_len;
+		if (tmp_len < len) {
+			len = tmp_len;
+		}
 	}
 
 	context->send_cb = cb;
@@ -1554,20 +1637,39 @@ static int context_sendto(struct net_context *context,
 		}
 	} else if (IS_ENABLED(CONFIG_NET_UDP) &&
 	    net_context_get_ip_proto(context) == IPPROTO_UDP) {
-		ret = context_setup_udp_packet(context, pkt, buf, len, msghdr,
+		ret = context_setup_udp_packet(context, pkt, buf,
+					       frags ? 0 : len, msghdr,
 					       dst_addr, addrlen);
 		if (ret < 0) {
 			goto fail;
 		}
 
+#if defined(CONFIG_NET_CONTEXT_ZEROCOPY)
+		if (frags) {
+			context_append_frags(pkt, frags);
+		}
+#endif
+
 		context_finalize_packet(context, pkt);
 
 		ret = net_send_data(pkt);
 	} else if (IS_ENABLED(CONFIG_NET_TCP) &&
 		   net_context_get_ip_proto(context) == IPPROTO_TCP) {
-		ret = context_write_data(pkt, buf, len, msghdr);
-		if (ret < 0) {
-			goto fail;
+#if defined(CONFIG_NET_CONTEXT_ZEROCOPY)
+		if (frags) {
+			/* The TCP header goes in front of the data, so
+			 * the (empty) header buffer is not needed.
+			 */
+			net_pkt_frag_unref(pkt->buffer);
+			pkt->buffer = NULL;
+			context_append_frags(pkt, frags);
+		} else
+#endif
+		{
+			ret = context_write_data(pkt, buf, len, msghdr);
+			if (ret < 0) {
+				goto fail;
+			}
 		}
 
 		net_pkt_cursor_init(pkt);
@@ -1650,7 +1752,7 @@ int net_context_send(struct net_context *context,
 		addrlen = 0;
 	}
 
-	ret = context_sendto(context, buf, len, &context->remote,
+	ret = context_sendto(context, buf, len, NULL, &context->remote,
 			     addrlen, cb, timeout, user_data, false);
 unlock:
 	k_mutex_unlock(&context->lock);
@@ -1669,7 +1771,7 @@ int net_context_sendmsg(struct net_context *context,
 
 	k_mutex_lock(&context->lock, K_FOREVER);
 
-	ret = context_sendto(context, msghdr, 0, NULL, 0,
+	ret = context_sendto(context, msghdr, 0, NULL, NULL, 0,
 			     cb, timeout, user_data, true);
 
 	k_mutex_unlock(&context->lock);
@@ -1690,7 +1792,7 @@ int net_context_sendto(struct net_context *context,
 
 	k_mutex_lock(&context->lock, K_FOREVER);
 
-	ret = context_sendto(context, buf, len, dst_addr, addrlen,
+	ret = context_sendto(context, buf, len, NULL, dst_addr, addrlen,
 			     cb, timeout, user_data, true);
 
 	k_mutex_unlock(&context->lock);
@@ -1698,6 +1800,49 @@ int net_context_sendto(struct net_context *context,
 	return ret;
 }
 
+#if defined(CONFIG_NET_CONTEXT_ZEROCOPY)
+int net_context_send_buf(struct net_context *context,
+			 struct net_buf *frags,
+			 const struct sockaddr *dst_addr,
+			 socklen_t addrlen,
+			 net_context_send_cb_t cb,
+			 s32_t timeout,
+			 void *user_data)
+{
+	int ret;
+
+	if (!frags) {
+		return -EINVAL;
+	}
+
+	k_mutex_lock(&context->lock, K_FOREVER);
+
+	if (!dst_addr) {
+		if (!(context->flags & NET_CONTEXT_REMOTE_ADDR_SET) ||
+		    !net_sin(&context->remote)->sin_port) {
+			ret = -EDESTADDRREQ;
+			goto unlock;
+		}
+
+		dst_addr = &context->remote;
+
+		if (IS_ENABLED(CONFIG_NET_IPV6) &&
+		    net_context_get_family(context) == AF_INET6) {
+			addrlen = sizeof(struct sockaddr_in6);
+		} else {
+			addrlen = sizeof(struct sockaddr_in);
+		}
+	}
+
+	ret = context_sendto(context, NULL, 0, frags, dst_addr, addrlen,
+			     cb, timeout, user_data, false);
+unlock:
+	k_mutex_unlock(&context->lock);
+
+	return ret;
+}
+#endif /* CONFIG_NET_CONTEXT_ZEROCOPY */
+
 enum net_verdict net_context_packet_received(struct net_conn *conn,
 					     struct net_pkt *pkt,
 					     union net_ip_header *ip_hdr,
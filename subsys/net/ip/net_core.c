@@ -33,6 +33,10 @@ LOG_MODULE_REGISTER(net_core, CONFIG_NET_CORE_LOG_LEVEL);
 #include <net/lldp.h>
 #endif
 
+#if defined(CONFIG_NET_RX_FLOW_STEERING)
+#include <net/ethernet.h>
+#endif
+
 #include "net_private.h"
 #include "net_shell.h"
 
@@ -69,6 +73,416 @@ void net_analyze_stack(const char *name, const char *stack, size_t size)
 }
 #endif /* CONFIG_INIT_STACKS */
 
+static inline enum net_verdict process_ip_data(struct net_pkt *pkt,
+					       bool is_loopback)
+{
+	/* L2 has modified the buffer starting point, it is easier
+	 * to re-initialize the cursor rather than updating it.
+	 */
+	net_pkt_cursor_init(pkt);
+
+	/* IP version and header length. */
+	switch (NET_IPV6_HDR(pkt)->vtc & 0xf0) {
+#if defined(CONFIG_NET_IPV6)
+	case 0x60:
+		return net_ipv6_input(pkt, is_loopback);
+#endif
+#if defined(CONFIG_NET_IPV4)
+	case 0x40:
+		return net_ipv4_input(pkt);
+#endif
+	}
+
+	NET_DBG("Unknown IP family packet (0x%x)",
+		NET_IPV6_HDR(pkt)->vtc & 0xf0);
+	net_stats_update_ip_errors_protoerr(net_pkt_iface(pkt));
+	net_stats_update_ip_errors_vhlerr(net_pkt_iface(pkt));
+
+	return NET_DROP;
+}
+
+#if defined(CONFIG_NET_GRO)
+/* A TCP segment held back by an Rx queue, with the following segments of
+ * its connection merged into it.
+ */
+struct rx_gro_flow {
+	struct net_pkt *pkt;
+	u32_t next_seq;
+	u16_t ip_len;
+	u16_t hdr_len;
+	u16_t data_len;
+	/* Sum of the payload, as net_chksum_add() gives it */
+	u16_t data_sum;
+	/* Payload of the first segment, a shorter one ends the batch */
+	u16_t mss;
+	u8_t segs;
+};
+
+/* The headers of a received TCP segment, contiguous in its first buffer */
+struct rx_gro_seg {
+	u8_t *ip;
+	struct net_tcp_hdr *tcp;
+	u16_t ip_len;
+	u16_t hdr_len;
+	u16_t data_len;
+	u16_t data_sum;
+};
+
+static struct rx_gro_flow rx_gro[NET_RX_QUEUE_COUNT][CONFIG_NET_GRO_FLOWS];
+static u8_t rx_gro_evict[NET_RX_QUEUE_COUNT];
+static struct net_gro_stats rx_gro_stats;
+
+void net_gro_stats_get(struct net_gro_stats *stats)
+{
+	*stats = rx_gro_stats;
+}
+
+static inline u16_t rx_gro_sum_add(u16_t a, u16_t b)
+{
+	u32_t sum = (u32_t)a + b;
+
+	return (sum & 0xffff) + (sum >> 16);
+}
+
+/* Sum of the pseudo header and the TCP header of a segment, which has
+ * tcp_len bytes of TCP header and payload.
+ */
+static u16_t rx_gro_hdr_sum(u8_t *ip, struct net_tcp_hdr *tcp,
+			    u16_t tcp_len)
+{
+	u16_t sum = tcp_len + IPPROTO_TCP;
+
+	if ((ip[0] & 0xf0) == 0x40) {
+		sum = net_chksum_add(sum, &((struct net_ipv4_hdr *)ip)->src,
+				     2 * sizeof(struct in_addr));
+	} else {
+		sum = net_chksum_add(sum, &((struct net_ipv6_hdr *)ip)->src,
+				     2 * sizeof(struct in6_addr));
+	}
+
+	return net_chksum_add(sum, tcp, NET_TCP_HDR_LEN(tcp));
+}
+
+/* Find the headers of a TCP data segment that could be merged with others:
+ * no IP options, extension headers or fragments, only the ACK and PSH
+ * flags, and some payload.
+ */
+static bool rx_gro_parse(struct net_pkt *pkt, struct rx_gro_seg *seg)
+{
+	struct net_buf *buf = pkt->buffer;
+	size_t len = net_pkt_get_len(pkt);
+
+	if (!buf || !buf->len) {
+		return false;
+	}
+
+	seg->ip = buf->data;
+
+	if (IS_ENABLED(CONFIG_NET_IPV4) && (seg->ip[0] & 0xf0) == 0x40) {
+		struct net_ipv4_hdr *hdr = (struct net_ipv4_hdr *)seg->ip;
+
+		seg->ip_len = sizeof(struct net_ipv4_hdr);
+
+		if (buf->len < seg->ip_len || hdr->vhl != 0x45 ||
+		    hdr->proto != IPPROTO_TCP || ntohs(hdr->len) != len ||
+		    (hdr->offset[0] & 0x3f) || hdr->offset[1]) {
+			return false;
+		}
+
+		/* The header of a merged segment is thrown away, so it is
+		 * checked here.
+		 */
+		if (net_if_need_calc_rx_checksum(net_pkt_iface(pkt)) &&
+		    net_chksum_add(0U, hdr, seg->ip_len) != 0xffff) {
+			return false;
+		}
+	} else if (IS_ENABLED(CONFIG_NET_IPV6) &&
+		   (seg->ip[0] & 0xf0) == 0x60) {
+		struct net_ipv6_hdr *hdr = (struct net_ipv6_hdr *)seg->ip;
+
+		seg->ip_len = sizeof(struct net_ipv6_hdr);
+
+		if (buf->len < seg->ip_len || hdr->nexthdr != IPPROTO_TCP ||
+		    ntohs(hdr->len) + seg->ip_len != len) {
+			return false;
+		}
+	} else {
+		return false;
+	}
+
+	if (buf->len < seg->ip_len + sizeof(struct net_tcp_hdr)) {
+		return false;
+	}
+
+	seg->tcp = (struct net_tcp_hdr *)(seg->ip + seg->ip_len);
+	seg->hdr_len = seg->ip_len + NET_TCP_HDR_LEN(seg->tcp);
+
+	if (NET_TCP_HDR_LEN(seg->tcp) < sizeof(struct net_tcp_hdr) ||
+	    buf->len < seg->hdr_len || len <= seg->hdr_len ||
+	    (NET_TCP_FLAGS(seg->tcp) & ~NET_TCP_PSH) != NET_TCP_ACK) {
+		return false;
+	}
+
+	seg->data_len = len - seg->hdr_len;
+
+	/* The segment sums to 0xffff with its checksum if it is valid, so
+	 * the sum of the payload follows from that of the headers.
+	 */
+	seg->data_sum = ~rx_gro_hdr_sum(seg->ip, seg->tcp,
+					len - seg->ip_len);
+
+	return true;
+}
+
+static bool rx_gro_same_flow(struct rx_gro_flow *flow, struct net_pkt *pkt,
+			     struct rx_gro_seg *seg)
+{
+	u8_t *ip = flow->pkt->buffer->data;
+
+	if (net_pkt_iface(flow->pkt) != net_pkt_iface(pkt) ||
+	    flow->ip_len != seg->ip_len) {
+		return false;
+	}
+
+	/* Addresses, then ports */
+	if ((ip[0] & 0xf0) == 0x40) {
+		if (memcmp(&((struct net_ipv4_hdr *)ip)->src,
+			   &((struct net_ipv4_hdr *)seg->ip)->src,
+			   2 * sizeof(struct in_addr))) {
+			return false;
+		}
+	} else if (memcmp(&((struct net_ipv6_hdr *)ip)->src,
+			  &((struct net_ipv6_hdr *)seg->ip)->src,
+			  2 * sizeof(struct in6_addr))) {
+		return false;
+	}
+
+	return !memcmp(ip + flow->ip_len, seg->tcp, 2 * sizeof(u16_t));
+}
+
+static bool rx_gro_can_merge(struct rx_gro_flow *flow, struct rx_gro_seg *seg)
+{
+	u8_t *ip = flow->pkt->buffer->data;
+	struct net_tcp_hdr *tcp = (struct net_tcp_hdr *)(ip + flow->ip_len);
+
+	if (sys_get_be32(seg->tcp->seq) != flow->next_seq ||
+	    seg->hdr_len != flow->hdr_len || seg->data_len > flow->mss ||
+	    flow->hdr_len + flow->data_len + seg->data_len >
+	    CONFIG_NET_GRO_MAX_SIZE) {
+		return false;
+	}
+
+	/* The ACK number, window and options must be the same */
+	if (memcmp(tcp->ack, seg->tcp->ack, sizeof(tcp->ack)) ||
+	    memcmp(tcp->wnd, seg->tcp->wnd, sizeof(tcp->wnd)) ||
+	    memcmp(tcp->optdata, seg->tcp->optdata,
+		   flow->hdr_len - flow->ip_len -
+		   sizeof(struct net_tcp_hdr))) {
+		return false;
+	}
+
+	/* Type of service or traffic class, and TTL or hop limit */
+	if ((ip[0] & 0xf0) == 0x40) {
+		struct net_ipv4_hdr *hdr = (struct net_ipv4_hdr *)ip;
+		struct net_ipv4_hdr *seg_hdr = (struct net_ipv4_hdr *)seg->ip;
+
+		return hdr->tos == seg_hdr->tos && hdr->ttl == seg_hdr->ttl;
+	} else {
+		struct net_ipv6_hdr *hdr = (struct net_ipv6_hdr *)ip;
+		struct net_ipv6_hdr *seg_hdr = (struct net_ipv6_hdr *)seg->ip;
+
+		return !memcmp(hdr, seg_hdr, 4) &&
+			hdr->hop_limit == seg_hdr->hop_limit;
+	}
+}
+
+/* Keep only the payload of the segment, after that of the flow */
+static void rx_gro_merge(struct rx_gro_flow *flow, struct net_pkt *pkt,
+			 struct rx_gro_seg *seg)
+{
+	u16_t data_sum = seg->data_sum;
+
+	/* After an odd number of bytes, the words of the payload are
+	 * summed one byte off.
+	 */
+	if (flow->data_len & 1) {
+		data_sum = __bswap_16(data_sum);
+	}
+
+	flow->data_sum = rx_gro_sum_add(flow->data_sum, data_sum);
+	flow->data_len += seg->data_len;
+	flow->next_seq += seg->data_len;
+	flow->segs++;
+
+	/* Our own TCP pushes every segment. The batch is passed on once
+	 * the queue is empty anyway, so PSH only needs to be kept.
+	 */
+	if (NET_TCP_FLAGS(seg->tcp) & NET_TCP_PSH) {
+		((struct net_tcp_hdr *)(flow->pkt->buffer->data +
+					flow->ip_len))->flags |= NET_TCP_PSH;
+	}
+
+	net_buf_pull(pkt->buffer, seg->hdr_len);
+	if (!pkt->buffer->len) {
+		pkt->buffer = net_buf_frag_del(NULL, pkt->buffer);
+	}
+
+	net_pkt_frag_add(flow->pkt, pkt->buffer);
+	pkt->buffer = NULL;
+
+	net_pkt_unref(pkt);
+}
+
+/* Give the merged packet the lengths and checksums of a single segment */
+static void rx_gro_finalize(struct rx_gro_flow *flow)
+{
+	u8_t *ip = flow->pkt->buffer->data;
+	struct net_tcp_hdr *tcp = (struct net_tcp_hdr *)(ip + flow->ip_len);
+	u16_t tcp_len = flow->hdr_len - flow->ip_len + flow->data_len;
+	u16_t sum;
+
+	if (flow->segs < 2) {
+		return;
+	}
+
+	if ((ip[0] & 0xf0) == 0x40) {
+		struct net_ipv4_hdr *hdr = (struct net_ipv4_hdr *)ip;
+		u16_t len = htons(flow->hdr_len + flow->data_len);
+
+		hdr->chksum = net_chksum_update(hdr->chksum, &hdr->len, &len,
+						sizeof(len));
+		hdr->len = len;
+	} else {
+		((struct net_ipv6_hdr *)ip)->len = htons(tcp_len);
+	}
+
+	tcp->chksum = 0U;
+	sum = rx_gro_hdr_sum(ip, tcp, tcp_len);
+	sum = rx_gro_sum_add(sum, flow->data_sum);
+	tcp->chksum = ~((sum == 0U) ? 0xffff : htons(sum));
+}
+
+static void rx_gro_deliver(struct rx_gro_flow *flow)
+{
+	struct net_pkt *pkt = flow->pkt;
+
+	NET_DBG("pkt %p %u segments len %zu", pkt, flow->segs,
+		net_pkt_get_len(pkt));
+
+	if (flow->segs > 1) {
+		rx_gro_stats.pkts++;
+		rx_gro_stats.segs += flow->segs;
+	}
+
+	rx_gro_finalize(flow);
+	flow->pkt = NULL;
+
+	if (process_ip_data(pkt, false) != NET_OK) {
+		NET_DBG("Dropping pkt %p", pkt);
+		net_pkt_unref(pkt);
+	}
+}
+
+static void rx_gro_flush(int idx)
+{
+	int i;
+
+	for (i = 0; i < CONFIG_NET_GRO_FLOWS; i++) {
+		if (rx_gro[idx][i].pkt) {
+			rx_gro_deliver(&rx_gro[idx][i]);
+		}
+	}
+}
+
+static void rx_gro_hold(struct rx_gro_flow *flow, struct net_pkt *pkt,
+			struct rx_gro_seg *seg)
+{
+	flow->pkt = pkt;
+	flow->next_seq = sys_get_be32(seg->tcp->seq) + seg->data_len;
+	flow->ip_len = seg->ip_len;
+	flow->hdr_len = seg->hdr_len;
+	flow->data_len = seg->data_len;
+	flow->data_sum = seg->data_sum;
+	flow->mss = seg->data_len;
+	flow->segs = 1U;
+}
+
+/* Hold back or merge a TCP data segment received by an Rx queue. The held
+ * packets go on when the queue runs out of packets, see rx_gro_flush().
+ */
+static enum net_verdict rx_gro_receive(struct net_pkt *pkt)
+{
+	int idx = net_tc_rx_queue_current();
+	struct rx_gro_flow *flow = NULL;
+	struct rx_gro_seg seg;
+	int i;
+
+	if (idx < 0) {
+		return NET_CONTINUE;
+	}
+
+	/* Anything else may belong to a held connection, which must see
+	 * its packets in order.
+	 */
+	if (!rx_gro_parse(pkt, &seg)) {
+		rx_gro_flush(idx);
+		return NET_CONTINUE;
+	}
+
+	for (i = 0; i < CONFIG_NET_GRO_FLOWS; i++) {
+		if (rx_gro[idx][i].pkt &&
+		    rx_gro_same_flow(&rx_gro[idx][i], pkt, &seg)) {
+			flow = &rx_gro[idx][i];
+			break;
+		}
+	}
+
+	if (flow && rx_gro_can_merge(flow, &seg)) {
+		bool last = seg.data_len < flow->mss;
+
+		rx_gro_merge(flow, pkt, &seg);
+
+		if (last) {
+			rx_gro_deliver(flow);
+		}
+
+		return NET_OK;
+	}
+
+	if (flow) {
+		rx_gro_deliver(flow);
+	} else {
+		for (i = 0; i < CONFIG_NET_GRO_FLOWS; i++) {
+			if (!rx_gro[idx][i].pkt) {
+				flow = &rx_gro[idx][i];
+				break;
+			}
+		}
+	}
+
+	if (!flow) {
+		flow = &rx_gro[idx][rx_gro_evict[idx]];
+		rx_gro_evict[idx] = (rx_gro_evict[idx] + 1) %
+			CONFIG_NET_GRO_FLOWS;
+
+		rx_gro_deliver(flow);
+	}
+
+	rx_gro_hold(flow, pkt, &seg);
+
+	return NET_OK;
+}
+
+static void rx_gro_flush_if_idle(void)
+{
+	int idx = net_tc_rx_queue_current();
+
+	if (idx >= 0 && net_tc_rx_queue_is_empty(idx)) {
+		rx_gro_flush(idx);
+	}
+}
+#endif /* CONFIG_NET_GRO */
+
 static inline enum net_verdict process_data(struct net_pkt *pkt,
 					    bool is_loopback)
 {
@@ -116,29 +530,16 @@ static inline enum net_verdict process_data(struct net_pkt *pkt,
 		return ret;
 	}
 
-	/* L2 has modified the buffer starting point, it is easier
-	 * to re-initialize the cursor rather than updating it.
-	 */
-	net_pkt_cursor_init(pkt);
-
-	/* IP version and header length. */
-	switch (NET_IPV6_HDR(pkt)->vtc & 0xf0) {
-#if defined(CONFIG_NET_IPV6)
-	case 0x60:
-		return net_ipv6_input(pkt, is_loopback);
-#endif
-#if defined(CONFIG_NET_IPV4)
-	case 0x40:
-		return net_ipv4_input(pkt);
-#endif
+#if defined(CONFIG_NET_GRO)
+	if (!is_loopback) {
+		ret = rx_gro_receive(pkt);
+		if (ret != NET_CONTINUE) {
+			return ret;
+		}
 	}
+#endif
 
-	NET_DBG("Unknown IP family packet (0x%x)",
-		NET_IPV6_HDR(pkt)->vtc & 0xf0);
-	net_stats_update_ip_errors_protoerr(net_pkt_iface(pkt));
-	net_stats_update_ip_errors_vhlerr(net_pkt_iface(pkt));
-
-	return NET_DROP;
+	return process_ip_data(pkt, is_loopback);
 }
 
 static void processing_data(struct net_pkt *pkt, bool is_loopback)
@@ -365,8 +766,137 @@ static void process_rx_packet(struct k_work *work)
 	pkt = CONTAINER_OF(work, struct net_pkt, work);
 
 	net_rx(net_pkt_iface(pkt), pkt);
+
+#if defined(CONFIG_NET_GRO)
+	rx_gro_flush_if_idle();
+#endif
 }
 
+#if defined(CONFIG_NET_RX_FLOW_STEERING)
+/* Skip the L2 header of a received packet so that the cursor points to
+ * the IP header. Returns a negative value if the packet is not IP, or if
+ * the L2 header cannot be parsed before the L2 itself has seen it.
+ */
+static int rx_flow_skip_l2(struct net_if *iface, struct net_pkt *pkt)
+{
+#if defined(CONFIG_NET_L2_ETHERNET)
+	if (net_if_l2(iface) == &NET_L2_GET_NAME(ETHERNET)) {
+		struct net_eth_hdr hdr;
+		u16_t type;
+
+		if (net_pkt_read(pkt, &hdr, sizeof(hdr))) {
+			return -ENODATA;
+		}
+
+		type = ntohs(hdr.type);
+
+		/* The real type follows the tag control information */
+		if (type == NET_ETH_PTYPE_VLAN &&
+		    (net_pkt_skip(pkt, sizeof(u16_t)) ||
+		     net_pkt_read_be16(pkt, &type))) {
+			return -ENODATA;
+		}
+
+		if (type != NET_ETH_PTYPE_IP && type != NET_ETH_PTYPE_IPV6) {
+			return -ENOTSUP;
+		}
+
+		return 0;
+	}
+#endif
+
+#if defined(CONFIG_NET_L2_DUMMY)
+	/* No L2 header, the IP version is checked by the caller */
+	if (net_if_l2(iface) == &NET_L2_GET_NAME(DUMMY)) {
+		return 0;
+	}
+#endif
+
+	return -ENOTSUP;
+}
+
+static u32_t rx_flow_hash_add(u32_t hash, const void *data, size_t len)
+{
+	const u8_t *ptr = data;
+
+	while (len--) {
+		hash = hash * 31U + *ptr++;
+	}
+
+	return hash;
+}
+
+/* Hash the source and destination address, protocol and, for unfragmented
+ * TCP and UDP packets, the ports of a received packet. All the fragments of
+ * a datagram hash alike, as none of them are hashed with the ports. Returns
+ * 0 if the packet is not IP.
+ */
+static u32_t rx_flow_hash(struct net_if *iface, struct net_pkt *pkt)
+{
+	struct net_pkt_cursor backup;
+	u8_t ports[2 * sizeof(u16_t)];
+	bool has_ports = false;
+	u32_t hash = 0U;
+	u8_t vtc;
+
+	net_pkt_cursor_backup(pkt, &backup);
+
+	if (rx_flow_skip_l2(iface, pkt) || net_pkt_read_u8(pkt, &vtc)) {
+		goto out;
+	}
+
+	if (IS_ENABLED(CONFIG_NET_IPV4) && (vtc & 0xf0) == 0x40) {
+		struct net_ipv4_hdr hdr;
+
+		hdr.vhl = vtc;
+
+		if (net_pkt_read(pkt, (u8_t *)&hdr + 1, sizeof(hdr) - 1)) {
+			goto out;
+		}
+
+		hash = rx_flow_hash_add(hdr.proto, &hdr.src,
+					2 * sizeof(struct in_addr));
+
+		/* The MF flag and the fragment offset */
+		if ((hdr.proto == IPPROTO_TCP || hdr.proto == IPPROTO_UDP) &&
+		    !(hdr.offset[0] & 0x3f) && !hdr.offset[1]) {
+			has_ports = !net_pkt_skip(pkt, (hdr.vhl & 0x0f) * 4U -
+						  sizeof(hdr));
+		}
+	} else if (IS_ENABLED(CONFIG_NET_IPV6) && (vtc & 0xf0) == 0x60) {
+		struct net_ipv6_hdr hdr;
+
+		hdr.vtc = vtc;
+
+		if (net_pkt_read(pkt, (u8_t *)&hdr + 1, sizeof(hdr) - 1)) {
+			goto out;
+		}
+
+		hash = rx_flow_hash_add(hdr.nexthdr, &hdr.src,
+					2 * sizeof(struct in6_addr));
+
+		/* Extension headers are not walked, such packets are hashed
+		 * without the ports.
+		 */
+		has_ports = hdr.nexthdr == IPPROTO_TCP ||
+			    hdr.nexthdr == IPPROTO_UDP;
+	} else {
+		goto out;
+	}
+
+	if (has_ports && !net_pkt_read(pkt, ports, sizeof(ports))) {
+		hash = rx_flow_hash_add(hash, ports, sizeof(ports));
+	}
+
+	hash ^= hash >> 16;
+
+out:
+	net_pkt_cursor_restore(pkt, &backup);
+
+	return hash;
+}
+#endif /* CONFIG_NET_RX_FLOW_STEERING */
+
 static void net_queue_rx(struct net_if *iface, struct net_pkt *pkt)
 {
 	u8_t prio = net_pkt_priority(pkt);
@@ -384,7 +914,11 @@ static void net_queue_rx(struct net_if *iface, struct net_pkt *pkt)
 	NET_DBG("TC %d with prio %d pkt %p", tc, prio, pkt);
 #endif
 
+#if defined(CONFIG_NET_RX_FLOW_STEERING)
+	net_tc_submit_to_rx_worker(tc, rx_flow_hash(iface, pkt), pkt);
+#else
 	net_tc_submit_to_rx_queue(tc, pkt);
+#endif
 }
 
 /* Called by driver when an IP packet has been received */
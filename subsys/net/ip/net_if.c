@@ -3366,6 +3366,19 @@ bool net_if_need_calc_rx_checksum(struct net_if *iface)
 	return need_calc_checksum(iface, ETHERNET_HW_RX_CHKSUM_OFFLOAD);
 }
 
+bool net_if_need_tcp_segmentation(struct net_if *iface)
+{
+#if defined(CONFIG_NET_TCP_TSO)
+	/* The device must also calculate the checksums of the segments */
+	return need_calc_checksum(iface, ETHERNET_HW_TX_TSO) ||
+		need_calc_checksum(iface, ETHERNET_HW_TX_CHKSUM_OFFLOAD);
+#else
+	ARG_UNUSED(iface);
+
+	return true;
+#endif
+}
+
 struct net_if *net_if_get_by_index(int index)
 {
 	if (index <= 0) {
@@ -979,6 +979,14 @@ static size_t pkt_buffer_length(struct net_pkt *pkt,
 		}
 	}
 
+#if defined(CONFIG_NET_TCP_TSO)
+	/* The network device splits larger TCP segments itself */
+	if (proto == IPPROTO_TCP && net_pkt_iface(pkt) &&
+	    !net_if_need_tcp_segmentation(net_pkt_iface(pkt))) {
+		max_len = MAX(max_len, CONFIG_NET_TCP_TSO_MAX_SIZE);
+	}
+#endif
+
 	max_len -= existing;
 
 	return MIN(size, max_len);
@@ -1681,6 +1689,7 @@ static void clone_pkt_attributes(struct net_pkt *pkt, struct net_pkt *clone_pkt)
 	net_pkt_set_timestamp(clone_pkt, net_pkt_timestamp(pkt));
 	net_pkt_set_priority(clone_pkt, net_pkt_priority(pkt));
 	net_pkt_set_orig_iface(clone_pkt, net_pkt_orig_iface(pkt));
+	net_pkt_set_tso_mss(clone_pkt, net_pkt_tso_mss(pkt));
 
 	if (IS_ENABLED(CONFIG_NET_IPV4) && net_pkt_family(pkt) == AF_INET) {
 		net_pkt_set_ipv4_ttl(clone_pkt, net_pkt_ipv4_ttl(pkt));
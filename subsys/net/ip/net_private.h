@@ -76,6 +76,42 @@ static inline enum net_verdict net_ipv6_input(struct net_pkt *pkt,
 #endif
 extern void net_tc_submit_to_tx_queue(u8_t tc, struct net_pkt *pkt);
 extern void net_tc_submit_to_rx_queue(u8_t tc, struct net_pkt *pkt);
+
+#if defined(CONFIG_NET_RX_FLOW_STEERING)
+#define NET_TC_RX_WORKERS CONFIG_NET_RX_WORKERS
+
+/* Packets handed to one Rx worker thread of a traffic class */
+struct net_tc_rx_worker_stats {
+	u32_t pkts;
+	u32_t bytes;
+};
+
+extern void net_tc_submit_to_rx_worker(u8_t tc, u32_t flow_hash,
+				       struct net_pkt *pkt);
+extern void net_tc_rx_worker_stats_get(u8_t tc, u8_t worker,
+				       struct net_tc_rx_worker_stats *stats);
+#else
+#define NET_TC_RX_WORKERS 1
+#endif
+
+/* With flow steering, each traffic class has NET_TC_RX_WORKERS consecutive
+ * Rx queues, one per worker thread.
+ */
+#define NET_RX_QUEUE_COUNT (NET_TC_RX_COUNT * NET_TC_RX_WORKERS)
+
+#if defined(CONFIG_NET_GRO)
+/* Index of the Rx queue whose worker thread calls this, or -1 */
+extern int net_tc_rx_queue_current(void);
+extern bool net_tc_rx_queue_is_empty(int idx);
+
+/* Packets merged from several TCP segments, and the segments they hold */
+struct net_gro_stats {
+	u32_t pkts;
+	u32_t segs;
+};
+
+extern void net_gro_stats_get(struct net_gro_stats *stats);
+#endif
 extern enum net_verdict net_promisc_mode_input(struct net_pkt *pkt);
 
 char *net_sprint_addr(sa_family_t af, const void *addr);
@@ -146,6 +182,32 @@ enum net_verdict net_context_packet_received(struct net_conn *conn,
 extern u16_t net_calc_chksum_ipv4(struct net_pkt *pkt);
 #endif /* CONFIG_NET_IPV4 */
 
+/**
+ * @brief Update a checksum after some of the data it covers changed,
+ * without summing all the data again.
+ *
+ * @param chksum Checksum, as stored in the header
+ * @param old_data Previous content of the changed field
+ * @param new_data New content of the changed field
+ * @param len Length of the field. It must be even and start at an even
+ * offset of the checksummed data.
+ *
+ * @return Updated checksum, to be stored in the header
+ */
+extern u16_t net_chksum_update(u16_t chksum, const void *old_data,
+			       const void *new_data, size_t len);
+
+/**
+ * @brief Add data to a 16-bit one's complement sum.
+ *
+ * @param sum Sum so far, in host byte order
+ * @param data Data to add
+ * @param len Length of the data
+ *
+ * @return Sum in host byte order
+ */
+extern u16_t net_chksum_add(u16_t sum, const void *data, size_t len);
+
 static inline u16_t net_calc_chksum_icmpv6(struct net_pkt *pkt)
 {
 	return net_calc_chksum(pkt, IPPROTO_ICMPV6);
@@ -798,6 +798,28 @@ static void print_tc_rx_stats(const struct shell *shell, struct net_if *iface)
 #endif /* NET_TC_RX_COUNT > 1 */
 }
 
+static void print_rx_worker_stats(const struct shell *shell)
+{
+#if defined(CONFIG_NET_RX_FLOW_STEERING)
+	struct net_tc_rx_worker_stats stats;
+	int i, j;
+
+	PR("\nRX flow steering statistics:\n");
+	PR("TC  Worker\tRecv pkts\tbytes\n");
+
+	for (i = 0; i < NET_TC_RX_COUNT; i++) {
+		for (j = 0; j < NET_TC_RX_WORKERS; j++) {
+			net_tc_rx_worker_stats_get(i, j, &stats);
+
+			PR("[%d] %d\t\t%u\t\t%u\n", i, j, stats.pkts,
+			   stats.bytes);
+		}
+	}
+#else
+	ARG_UNUSED(shell);
+#endif /* CONFIG_NET_RX_FLOW_STEERING */
+}
+
 static void net_shell_print_statistics(struct net_if *iface, void *user_data)
 {
 	struct net_shell_user_data *data = user_data;
@@ -2613,6 +2635,12 @@ static int cmd_net_mem(const struct shell *shell, size_t argc, char *argv[])
 	PR("%p\t%d\t%d\tTX DATA (%s)\n",
 	       tx_data, tx_data->buf_count,
 	       tx_data->avail_count, tx_data->name);
+
+	PR("\nPeak\tFailed\tName\n");
+	PR("%u\t%u\tRX DATA (%s)\n", rx_data->usage.max_used,
+	   rx_data->usage.failed, rx_data->name);
+	PR("%u\t%u\tTX DATA (%s)\n", tx_data->usage.max_used,
+	   tx_data->usage.failed, tx_data->name);
 #else
 	PR("(CONFIG_NET_BUF_POOL_USAGE to see free #s)\n");
 	PR("Address\t\tTotal\tName\n");
@@ -3235,6 +3263,9 @@ static int cmd_net_route(const struct shell *shell, size_t argc, char *argv[])
 #if defined(CONFIG_NET_ROUTE) || defined(CONFIG_NET_ROUTE_MCAST)
 	struct net_shell_user_data user_data;
 #endif
+#if defined(CONFIG_NET_ROUTE)
+	struct net_route_stats stats;
+#endif
 
 #if defined(CONFIG_NET_ROUTE) || defined(CONFIG_NET_ROUTE_MCAST)
 	user_data.shell = shell;
@@ -3242,6 +3273,12 @@ static int cmd_net_route(const struct shell *shell, size_t argc, char *argv[])
 
 #if defined(CONFIG_NET_ROUTE)
 	net_if_foreach(iface_per_route_cb, &user_data);
+
+	net_route_stats_get(&stats);
+
+	PR("\nRoute lookups %u, cache hits %u, no route %u, "
+	   "compares %u\n", stats.lookups, stats.cache_hits, stats.misses,
+	   stats.compares);
 #else
 	PR_INFO("Network route support not enabled. "
 		"Set CONFIG_NET_ROUTE to enable it.\n");
@@ -3351,6 +3388,8 @@ static int cmd_net_stats_all(const struct shell *shell, size_t argc,
 
 	/* Print global network statistics */
 	net_shell_print_statistics_all(&user_data);
+
+	print_rx_worker_stats(shell);
 #else
 	ARG_UNUSED(argc);
 	ARG_UNUSED(argv);
@@ -3735,6 +3774,55 @@ static int cmd_net_tcp_close(const struct shell *shell, size_t argc,
 	return 0;
 }
 
+#if defined(CONFIG_NET_TCP_RTT_ESTIMATION)
+static void tcp_stat_cb(struct net_tcp *tcp, void *user_data)
+{
+	struct net_shell_user_data *data = user_data;
+	const struct shell *shell = data->shell;
+	int *count = data->user_data;
+
+#if defined(CONFIG_NET_TCP_CONGESTION_CONTROL)
+	PR("%p %-8s %10u %10u ", tcp, tcp->cc->name, tcp->cwnd,
+	   tcp->ssthresh);
+#else
+	PR("%p %-8s %10s %10s ", tcp, "-", "-", "-");
+#endif
+	PR("%6u %6u %6u\n", tcp->srtt >> 3, tcp->rttvar >> 2, tcp->rto);
+
+	(*count)++;
+}
+#endif /* CONFIG_NET_TCP_RTT_ESTIMATION */
+
+static int cmd_net_tcp_stat(const struct shell *shell, size_t argc,
+			    char *argv[])
+{
+#if defined(CONFIG_NET_TCP_RTT_ESTIMATION)
+	struct net_shell_user_data user_data;
+	int count = 0;
+
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	user_data.shell = shell;
+	user_data.user_data = &count;
+
+	PR("TCP        CC       Cwnd       Ssthresh   "
+	   "SRTT   RTTVar RTO (ms)\n");
+
+	net_tcp_foreach(tcp_stat_cb, &user_data);
+
+	if (count == 0) {
+		PR("No TCP connections\n");
+	}
+#else
+	PR_INFO("Set CONFIG_NET_TCP_RTT_ESTIMATION or "
+		"CONFIG_NET_TCP_CONGESTION_CONTROL to enable TCP "
+		"statistics.\n");
+#endif /* CONFIG_NET_TCP_RTT_ESTIMATION */
+
+	return 0;
+}
+
 static int cmd_net_tcp(const struct shell *shell, size_t argc, char *argv[])
 {
 	ARG_UNUSED(argc);
@@ -4266,6 +4354,9 @@ SHELL_STATIC_SUBCMD_SET_CREATE(net_cmd_tcp,
 		  cmd_net_tcp_send),
 	SHELL_CMD(close, NULL,
 		  "'net tcp close' closes TCP connection.", cmd_net_tcp_close),
+	SHELL_CMD(stat, NULL,
+		  "'net tcp stat' shows congestion window and RTT "
+		  "estimates of TCP connections.", cmd_net_tcp_stat),
 	SHELL_SUBCMD_SET_END
 );
 
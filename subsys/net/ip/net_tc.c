@@ -28,10 +28,14 @@ NET_STACK_ARRAY_DEFINE(TX, tx_stack,
 NET_STACK_ARRAY_DEFINE(RX, rx_stack,
 		       CONFIG_NET_RX_STACK_SIZE,
 		       CONFIG_NET_RX_STACK_SIZE,
-		       NET_TC_RX_COUNT);
+		       NET_RX_QUEUE_COUNT);
 
 static struct net_traffic_class tx_classes[NET_TC_TX_COUNT];
-static struct net_traffic_class rx_classes[NET_TC_RX_COUNT];
+static struct net_traffic_class rx_classes[NET_RX_QUEUE_COUNT];
+
+#if defined(CONFIG_NET_RX_FLOW_STEERING)
+static struct net_tc_rx_worker_stats rx_worker_stats[NET_RX_QUEUE_COUNT];
+#endif
 
 void net_tc_submit_to_tx_queue(u8_t tc, struct net_pkt *pkt)
 {
@@ -40,8 +44,51 @@ void net_tc_submit_to_tx_queue(u8_t tc, struct net_pkt *pkt)
 
 void net_tc_submit_to_rx_queue(u8_t tc, struct net_pkt *pkt)
 {
-	k_work_submit_to_queue(&rx_classes[tc].work_q, net_pkt_work(pkt));
+	k_work_submit_to_queue(&rx_classes[tc * NET_TC_RX_WORKERS].work_q,
+			       net_pkt_work(pkt));
+}
+
+#if defined(CONFIG_NET_RX_FLOW_STEERING)
+void net_tc_submit_to_rx_worker(u8_t tc, u32_t flow_hash,
+				struct net_pkt *pkt)
+{
+	int idx = tc * NET_TC_RX_WORKERS + flow_hash % NET_TC_RX_WORKERS;
+
+	rx_worker_stats[idx].pkts++;
+	rx_worker_stats[idx].bytes += net_pkt_get_len(pkt);
+
+	k_work_submit_to_queue(&rx_classes[idx].work_q, net_pkt_work(pkt));
+}
+
+void net_tc_rx_worker_stats_get(u8_t tc, u8_t worker,
+				struct net_tc_rx_worker_stats *stats)
+{
+	NET_ASSERT(tc < NET_TC_RX_COUNT && worker < NET_TC_RX_WORKERS);
+
+	*stats = rx_worker_stats[tc * NET_TC_RX_WORKERS + worker];
+}
+#endif /* CONFIG_NET_RX_FLOW_STEERING */
+
+#if defined(CONFIG_NET_GRO)
+int net_tc_rx_queue_current(void)
+{
+	k_tid_t current = k_current_get();
+	int i;
+
+	for (i = 0; i < NET_RX_QUEUE_COUNT; i++) {
+		if (&rx_classes[i].work_q.thread == current) {
+			return i;
+		}
+	}
+
+	return -1;
+}
+
+bool net_tc_rx_queue_is_empty(int idx)
+{
+	return k_queue_is_empty(&rx_classes[idx].work_q.queue);
 }
+#endif /* CONFIG_NET_GRO */
 
 int net_tx_priority2tc(enum net_priority prio)
 {
@@ -271,10 +318,11 @@ void net_tc_rx_init(void)
 	net_if_foreach(net_tc_rx_stats_priority_setup, NULL);
 #endif
 
-	for (i = 0; i < NET_TC_RX_COUNT; i++) {
+	for (i = 0; i < NET_RX_QUEUE_COUNT; i++) {
 		u8_t thread_priority;
 
-		thread_priority = rx_tc2thread(i);
+		/* All the workers of a traffic class share its priority */
+		thread_priority = rx_tc2thread(i / NET_TC_RX_WORKERS);
 		rx_classes[i].tc = thread_priority;
 
 #if defined(CONFIG_NET_SHELL)
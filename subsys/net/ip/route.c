@@ -250,6 +250,13 @@ static int nbr_nexthop_put(struct net_nbr *nbr)
 			route->iface);					\
 	} } while (0)
 
+static struct net_route_stats route_stats;
+
+void net_route_stats_get(struct net_route_stats *stats)
+{
+	*stats = route_stats;
+}
+
 /* Route was accessed, so place it in front of the routes list */
 static inline void update_route_access(struct net_route_entry *route)
 {
@@ -257,8 +264,212 @@ static inline void update_route_access(struct net_route_entry *route)
 	sys_slist_prepend(&routes, &route->node);
 }
 
-struct net_route_entry *net_route_lookup(struct net_if *iface,
-					 struct in6_addr *dst)
+#if defined(CONFIG_NET_ROUTE_LPM)
+/* A node of the binary trie indexing the routes by prefix. Nodes are only
+ * kept if they hold routes or branch in two, so that the trie never needs
+ * more than two nodes per route. The routes of a node have the same
+ * prefix on different interfaces.
+ */
+struct route_lpm_node {
+	struct route_lpm_node *child[2];
+	struct net_route_entry *routes;
+	struct in6_addr prefix;
+	u8_t len;
+	bool in_use;
+};
+
+static struct route_lpm_node route_lpm_nodes[2 * CONFIG_NET_MAX_ROUTES];
+static struct route_lpm_node *route_lpm_root;
+
+static inline int lpm_bit(const struct in6_addr *addr, u8_t pos)
+{
+	return (addr->s6_addr[pos / 8U] >> (7 - pos % 8U)) & 1;
+}
+
+/* Number of leading bits, up to max, that a and b have in common */
+static u8_t lpm_common_len(const struct in6_addr *a,
+			   const struct in6_addr *b, u8_t max)
+{
+	u8_t len = 0U;
+	int i;
+
+	for (i = 0; i < sizeof(struct in6_addr) && len < max; i++) {
+		u8_t diff = a->s6_addr[i] ^ b->s6_addr[i];
+
+		if (diff) {
+			len += 8U - find_msb_set(diff);
+			break;
+		}
+
+		len += 8U;
+	}
+
+	return MIN(len, max);
+}
+
+static struct route_lpm_node *lpm_node_new(const struct in6_addr *prefix,
+					   u8_t len)
+{
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(route_lpm_nodes); i++) {
+		struct route_lpm_node *node = &route_lpm_nodes[i];
+
+		if (!node->in_use) {
+			(void)memset(node, 0, sizeof(*node));
+			net_ipaddr_copy(&node->prefix, prefix);
+			node->len = len;
+			node->in_use = true;
+
+			return node;
+		}
+	}
+
+	return NULL;
+}
+
+static int lpm_insert(struct net_route_entry *route)
+{
+	struct route_lpm_node **link = &route_lpm_root;
+	struct route_lpm_node *node, *new;
+	u8_t len = route->prefix_len;
+	u8_t common = 0U;
+
+	while ((node = *link) != NULL) {
+		common = lpm_common_len(&node->prefix, &route->addr,
+					MIN(node->len, len));
+		if (common < node->len) {
+			break;
+		}
+
+		if (node->len == len) {
+			route->lpm_next = node->routes;
+			node->routes = route;
+
+			return 0;
+		}
+
+		link = &node->child[lpm_bit(&route->addr, node->len)];
+	}
+
+	new = lpm_node_new(&route->addr, len);
+	if (!new) {
+		return -ENOMEM;
+	}
+
+	route->lpm_next = NULL;
+	new->routes = route;
+
+	if (!node) {
+		*link = new;
+	} else if (common == len) {
+		/* The new prefix covers the node */
+		new->child[lpm_bit(&node->prefix, len)] = node;
+		*link = new;
+	} else {
+		/* The prefixes part after common bits */
+		struct route_lpm_node *branch;
+
+		branch = lpm_node_new(&route->addr, common);
+		if (!branch) {
+			new->in_use = false;
+			return -ENOMEM;
+		}
+
+		branch->child[lpm_bit(&node->prefix, common)] = node;
+		branch->child[lpm_bit(&route->addr, common)] = new;
+		*link = branch;
+	}
+
+	return 0;
+}
+
+/* Replace a node left with less than two children and no routes by its
+ * child, if any.
+ */
+static void lpm_collapse(struct route_lpm_node **link)
+{
+	struct route_lpm_node *node = *link;
+
+	if (node->routes || (node->child[0] && node->child[1])) {
+		return;
+	}
+
+	*link = node->child[0] ? node->child[0] : node->child[1];
+	node->in_use = false;
+}
+
+static void lpm_remove(struct net_route_entry *route)
+{
+	struct route_lpm_node **link = &route_lpm_root, **parent = NULL;
+	struct net_route_entry **entry;
+	struct route_lpm_node *node;
+
+	while ((node = *link) != NULL && node->len < route->prefix_len) {
+		parent = link;
+		link = &node->child[lpm_bit(&route->addr, node->len)];
+	}
+
+	if (!node || node->len != route->prefix_len) {
+		return;
+	}
+
+	for (entry = &node->routes; *entry; entry = &(*entry)->lpm_next) {
+		if (*entry == route) {
+			*entry = route->lpm_next;
+			break;
+		}
+	}
+
+	lpm_collapse(link);
+
+	if (parent && *link == NULL) {
+		lpm_collapse(parent);
+	}
+}
+
+static struct net_route_entry *route_find(struct net_if *iface,
+					  struct in6_addr *dst)
+{
+	struct route_lpm_node *node = route_lpm_root;
+	struct net_route_entry *route, *found = NULL;
+
+	while (node) {
+		route_stats.compares++;
+
+		if (!net_ipv6_is_prefix((u8_t *)dst, (u8_t *)&node->prefix,
+					node->len)) {
+			break;
+		}
+
+		for (route = node->routes; route; route = route->lpm_next) {
+			if (!iface || route->iface == iface) {
+				found = route;
+				break;
+			}
+		}
+
+		if (node->len == 128U) {
+			break;
+		}
+
+		node = node->child[lpm_bit(dst, node->len)];
+	}
+
+	return found;
+}
+#else
+static inline int lpm_insert(struct net_route_entry *route)
+{
+	return 0;
+}
+
+static inline void lpm_remove(struct net_route_entry *route)
+{
+}
+
+static struct net_route_entry *route_find(struct net_if *iface,
+					  struct in6_addr *dst)
 {
 	struct net_route_entry *route, *found = NULL;
 	u8_t longest_match = 0U;
@@ -276,6 +487,7 @@ struct net_route_entry *net_route_lookup(struct net_if *iface,
 		}
 
 		route = net_route_data(nbr);
+		route_stats.compares++;
 
 		if (route->prefix_len >= longest_match &&
 		    net_ipv6_is_prefix((u8_t *)dst,
@@ -286,10 +498,92 @@ struct net_route_entry *net_route_lookup(struct net_if *iface,
 		}
 	}
 
+	return found;
+}
+#endif /* CONFIG_NET_ROUTE_LPM */
+
+#if CONFIG_NET_ROUTE_CACHE_SIZE > 0
+/* Recent lookups, including those that found no route. The cache is
+ * emptied whenever the routing table changes.
+ */
+static struct route_cache_entry {
+	struct in6_addr dst;
+	struct net_if *iface;
+	struct net_route_entry *route;
+	bool valid;
+} route_cache[CONFIG_NET_ROUTE_CACHE_SIZE];
+
+static u8_t route_cache_next;
+
+static struct route_cache_entry *route_cache_get(struct net_if *iface,
+						 struct in6_addr *dst)
+{
+	int i;
+
+	for (i = 0; i < CONFIG_NET_ROUTE_CACHE_SIZE; i++) {
+		if (route_cache[i].valid && route_cache[i].iface == iface &&
+		    net_ipv6_addr_cmp(&route_cache[i].dst, dst)) {
+			return &route_cache[i];
+		}
+	}
+
+	return NULL;
+}
+
+static void route_cache_add(struct net_if *iface, struct in6_addr *dst,
+			    struct net_route_entry *route)
+{
+	struct route_cache_entry *entry = &route_cache[route_cache_next];
+
+	route_cache_next = (route_cache_next + 1) % CONFIG_NET_ROUTE_CACHE_SIZE;
+
+	net_ipaddr_copy(&entry->dst, dst);
+	entry->iface = iface;
+	entry->route = route;
+	entry->valid = true;
+}
+
+static void route_cache_flush(void)
+{
+	int i;
+
+	for (i = 0; i < CONFIG_NET_ROUTE_CACHE_SIZE; i++) {
+		route_cache[i].valid = false;
+	}
+}
+#else
+#define route_cache_flush(...)
+#endif /* CONFIG_NET_ROUTE_CACHE_SIZE > 0 */
+
+struct net_route_entry *net_route_lookup(struct net_if *iface,
+					 struct in6_addr *dst)
+{
+	struct net_route_entry *found;
+#if CONFIG_NET_ROUTE_CACHE_SIZE > 0
+	struct route_cache_entry *cached;
+#endif
+
+	route_stats.lookups++;
+
+#if CONFIG_NET_ROUTE_CACHE_SIZE > 0
+	cached = route_cache_get(iface, dst);
+	if (cached) {
+		route_stats.cache_hits++;
+		found = cached->route;
+	} else {
+		found = route_find(iface, dst);
+		route_cache_add(iface, dst, found);
+	}
+#else
+	found = route_find(iface, dst);
+#endif
+
 	if (found) {
 		net_route_info("Found", found, dst);
 
 		update_route_access(found);
+	} else {
+		route_stats.misses++;
 	}
 
 	return found;
@@ -401,6 +695,15 @@ struct net_route_entry *net_route_add(struct net_if *iface,
 	route = net_route_data(nbr);
 	route->iface = iface;
 
+	if (lpm_insert(route) < 0) {
+		NET_ERR("No route trie node available!");
+		net_nbr_unref(tmp);
+		nbr_free(nbr);
+		return NULL;
+	}
+
+	route_cache_flush();
+
 	sys_slist_prepend(&routes, &route->node);
 
 	tmp = nbr_nexthop_get(iface, nexthop);
@@ -463,12 +766,19 @@ int net_route_del(struct net_route_entry *route)
 
 	net_route_info("Deleted", route, &route->addr);
 
+	lpm_remove(route);
+	route_cache_flush();
+
 	SYS_SLIST_FOR_EACH_CONTAINER(&route->nexthop, nexthop_route, node) {
 		if (!nexthop_route->nbr) {
 			continue;
 		}
 
 		nbr_nexthop_put(nexthop_route->nbr);
+
+		/* Give back the entry taken by get_nexthop_route() */
+		net_nbr_unref(CONTAINER_OF(nexthop_route, struct net_nbr,
+					   __nbr));
 	}
 
 	nbr_free(nbr);
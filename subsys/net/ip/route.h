@@ -59,6 +59,28 @@ struct net_route_entry {
 
 	/** IPv6 address/prefix length. */
 	u8_t prefix_len;
+
+#if defined(CONFIG_NET_ROUTE_LPM)
+	/** Next route with the same prefix in the route trie. */
+	struct net_route_entry *lpm_next;
+#endif
+};
+
+/**
+ * @brief Route lookup counters.
+ */
+struct net_route_stats {
+	/** Number of route lookups. */
+	u32_t lookups;
+
+	/** Lookups answered by the route cache. */
+	u32_t cache_hits;
+
+	/** Lookups that did not find any route. */
+	u32_t misses;
+
+	/** Routing entries, or trie nodes, compared to a destination. */
+	u32_t compares;
 };
 
 /**
@@ -170,6 +192,13 @@ typedef void (*net_route_cb_t)(struct net_route_entry *entry,
  */
 int net_route_foreach(net_route_cb_t cb, void *user_data);
 
+/**
+ * @brief Get the route lookup counters.
+ *
+ * @param stats Filled with the counters since boot.
+ */
+void net_route_stats_get(struct net_route_stats *stats);
+
 /**
  * @brief Multicast route entry.
  */
@@ -52,6 +52,9 @@ static struct tcp_backlog_entry {
 	struct k_delayed_work ack_timer;
 	struct sockaddr remote;
 	u16_t send_mss;
+#if defined(CONFIG_NET_TCP_SACK)
+	bool sack_perm;
+#endif
 } tcp_backlog[CONFIG_NET_TCP_BACKLOG_SIZE];
 
 #if defined(CONFIG_NET_TCP_ACK_TIMEOUT)
@@ -163,10 +166,58 @@ static void net_tcp_trace(struct net_pkt *pkt,
 
 static inline u32_t retry_timeout(const struct net_tcp *tcp)
 {
+#if defined(CONFIG_NET_TCP_RTT_ESTIMATION)
+	return ((u32_t)1 << tcp->retry_timeout_shift) * tcp->rto;
+#else
 	return ((u32_t)1 << tcp->retry_timeout_shift) *
 				CONFIG_NET_TCP_INIT_RETRANSMISSION_TIMEOUT;
+#endif
 }
 
+#if defined(CONFIG_NET_TCP_RTT_ESTIMATION)
+/* Bounds of the computed RTO, in ms. RFC 6298 asks for a 1 s floor,
+ * which is far too conservative for the local links this stack mostly
+ * runs on; use the lowest NET_TCP_INIT_RETRANSMISSION_TIMEOUT instead.
+ */
+#define RTO_MIN 100U
+#define RTO_MAX 60000U
+
+/* RFC 6298 section 2, with srtt kept in 1/8 ms and rttvar in 1/4 ms so
+ * that the gains of 1/8 and 1/4 are plain shifts.
+ */
+static void tcp_rtt_sample(struct net_tcp *tcp, u32_t rtt)
+{
+	s32_t err;
+
+	if (!tcp->srtt) {
+		tcp->srtt = rtt << 3;
+		tcp->rttvar = rtt << 1;
+	} else {
+		err = (s32_t)rtt - (s32_t)(tcp->srtt >> 3);
+		tcp->srtt += err;
+
+		if (err < 0) {
+			err = -err;
+		}
+
+		tcp->rttvar += err - (s32_t)(tcp->rttvar >> 2);
+	}
+
+	tcp->rto = MIN(MAX((tcp->srtt >> 3) + MAX(1U, tcp->rttvar), RTO_MIN),
+		       RTO_MAX);
+
+	NET_DBG("[%p] RTT %u ms, srtt %u rttvar %u rto %u", tcp, rtt,
+		tcp->srtt >> 3, tcp->rttvar >> 2, tcp->rto);
+}
+
+#if defined(CONFIG_NET_TEST)
+void net_tcp_rtt_sample(struct net_tcp *tcp, u32_t rtt)
+{
+	tcp_rtt_sample(tcp, rtt);
+}
+#endif
+#endif /* CONFIG_NET_TCP_RTT_ESTIMATION */
+
 #define is_6lo_technology(pkt)						\
 	(IS_ENABLED(CONFIG_NET_IPV6) &&	net_pkt_family(pkt) == AF_INET6 &&  \
 	 ((IS_ENABLED(CONFIG_NET_L2_BT) &&				\
@@ -210,6 +261,239 @@ static void abort_connection(struct net_tcp *tcp)
 	net_context_unref(ctx);
 }
 
+/* Resend a packet from the sent_list. */
+static int tcp_retransmit(struct net_tcp *tcp, struct net_pkt *pkt)
+{
+	if (net_pkt_sent(pkt)) {
+		do_ref_if_needed(tcp, pkt);
+		net_pkt_set_sent(pkt, false);
+	}
+
+	net_pkt_set_queued(pkt, true);
+
+#if defined(CONFIG_NET_TCP_RTT_ESTIMATION)
+	/* Karn's algorithm: no sample from an ambiguous ACK */
+	tcp->flags &= ~NET_TCP_RTT_TIMING;
+#endif
+
+	if (net_tcp_send_pkt(pkt) < 0 && !is_6lo_technology(pkt)) {
+		net_pkt_unref(pkt);
+		return -EIO;
+	}
+
+	if (IS_ENABLED(CONFIG_NET_STATISTICS_TCP) &&
+	    !is_6lo_technology(pkt)) {
+		net_stats_update_tcp_seg_rexmit(net_pkt_iface(pkt));
+	}
+
+	return 0;
+}
+
+#if defined(CONFIG_NET_TCP_OOO_QUEUE) || defined(CONFIG_NET_TCP_SACK) || \
+	defined(CONFIG_NET_TCP_RTT_ESTIMATION)
+/* Get the sequence space [*seq, *seq + *len) covered by the payload of
+ * a segment, SYN and FIN excluded. On success the cursor is left at the
+ * start of the payload.
+ */
+static struct net_tcp_hdr *tcp_seq_range(struct net_pkt *pkt,
+					 struct net_pkt_data_access *access,
+					 u32_t *seq, u32_t *len)
+{
+	struct net_tcp_hdr *tcp_hdr;
+
+	net_pkt_cursor_init(pkt);
+	net_pkt_set_overwrite(pkt, true);
+
+	if (net_pkt_skip(pkt, net_pkt_ip_hdr_len(pkt) +
+			 net_pkt_ipv6_ext_len(pkt))) {
+		return NULL;
+	}
+
+	tcp_hdr = (struct net_tcp_hdr *)net_pkt_get_data(pkt, access);
+	if (!tcp_hdr || net_pkt_skip(pkt, NET_TCP_HDR_LEN(tcp_hdr))) {
+		return NULL;
+	}
+
+	*seq = sys_get_be32(tcp_hdr->seq);
+	*len = net_pkt_remaining_data(pkt);
+
+	return tcp_hdr;
+}
+#endif
+
+#if defined(CONFIG_NET_TCP_CONGESTION_CONTROL)
+/* Duplicate ACKs that trigger a fast retransmit */
+#define DUPACK_THRESHOLD 3U
+
+static void tcp_cc_init(struct net_tcp *tcp)
+{
+	u32_t mss = tcp->send_mss;
+
+#if defined(CONFIG_NET_TCP_CC_CUBIC)
+	tcp->cc = &net_tcp_cc_cubic;
+#else
+	tcp->cc = &net_tcp_cc_newreno;
+#endif
+
+	/* Initial window, RFC 5681 section 3.1 */
+	if (mss > 2190U) {
+		tcp->cwnd = 2U * mss;
+	} else if (mss > 1095U) {
+		tcp->cwnd = 3U * mss;
+	} else {
+		tcp->cwnd = 4U * mss;
+	}
+
+	tcp->ssthresh = UINT_MAX;
+	tcp->snd_una = tcp->send_seq;
+	tcp->snd_nxt = tcp->send_seq;
+	tcp->recover = tcp->send_seq - 1;
+	tcp->dupacks = 0U;
+	tcp->flags &= ~NET_TCP_FAST_RECOVERY;
+
+	tcp->cc->init(tcp);
+}
+
+static inline u32_t tcp_flight_size(struct net_tcp *tcp)
+{
+	return tcp->snd_nxt - tcp->snd_una;
+}
+
+static void tcp_cc_retransmit_head(struct net_tcp *tcp)
+{
+#if defined(CONFIG_NET_TCP_SACK)
+	/* Holes are repaired from the SACK information instead */
+	if (tcp->flags & NET_TCP_SACK_PERM) {
+		return;
+	}
+#endif
+
+	if (!sys_slist_is_empty(&tcp->sent_list)) {
+		tcp_retransmit(tcp, CONTAINER_OF(
+				       sys_slist_peek_head(&tcp->sent_list),
+				       struct net_pkt, sent_list));
+	}
+}
+
+static void tcp_cc_dupack(struct net_tcp *tcp)
+{
+	if (tcp->flags & NET_TCP_FAST_RECOVERY) {
+		/* Each duplicate ACK means a segment has left the network */
+		tcp->cwnd += tcp->send_mss;
+		return;
+	}
+
+	if (++tcp->dupacks < DUPACK_THRESHOLD) {
+		return;
+	}
+
+	/* Losses from the window that was already recovered from do not
+	 * count again (RFC 6582 section 3.2 step 2).
+	 */
+	if (!net_tcp_seq_greater(tcp->snd_una, tcp->recover)) {
+		return;
+	}
+
+	tcp->ssthresh = tcp->cc->ssthresh(tcp, tcp_flight_size(tcp));
+	tcp->cwnd = tcp->ssthresh + DUPACK_THRESHOLD * tcp->send_mss;
+	tcp->recover = tcp->snd_nxt;
+	tcp->flags |= NET_TCP_FAST_RECOVERY;
+
+	NET_DBG("[%p] fast retransmit, cwnd %u ssthresh %u", tcp, tcp->cwnd,
+		tcp->ssthresh);
+
+	tcp_cc_retransmit_head(tcp);
+}
+
+/* Account for an ACK that passed net_tcp_ack_received(). A duplicate is
+ * only counted if the segment carried neither data nor SYN/FIN.
+ */
+static void tcp_cc_ack(struct net_tcp *tcp, u32_t ack, bool pure_ack)
+{
+	u32_t mss = tcp->send_mss;
+	u32_t acked;
+
+	if (net_tcp_seq_greater(ack, tcp->snd_nxt)) {
+		tcp->snd_nxt = ack;
+	}
+
+	if (!net_tcp_seq_greater(ack, tcp->snd_una)) {
+		if (pure_ack && ack == tcp->snd_una &&
+		    tcp->snd_nxt != tcp->snd_una) {
+			tcp_cc_dupack(tcp);
+		}
+
+		return;
+	}
+
+	acked = ack - tcp->snd_una;
+	tcp->snd_una = ack;
+	tcp->dupacks = 0U;
+
+	if (tcp->flags & NET_TCP_FAST_RECOVERY) {
+		if (net_tcp_seq_cmp(ack, tcp->recover) >= 0) {
+			/* Full acknowledgment, RFC 6582 section 3.2 step 3 */
+			tcp->flags &= ~NET_TCP_FAST_RECOVERY;
+			tcp->cwnd = MIN(tcp->ssthresh,
+					MAX(tcp_flight_size(tcp), mss) + mss);
+		} else {
+			/* Partial acknowledgment: the next segment was lost
+			 * too. Deflate by what left the network.
+			 */
+			tcp_cc_retransmit_head(tcp);
+
+			tcp->cwnd = tcp->cwnd > acked ? tcp->cwnd - acked : 0U;
+			if (acked >= mss) {
+				tcp->cwnd += mss;
+			}
+
+			tcp->cwnd = MAX(tcp->cwnd, mss);
+		}
+
+		return;
+	}
+
+	if (tcp->cwnd < tcp->ssthresh) {
+		/* Slow start */
+		tcp->cwnd += MIN(acked, mss);
+	} else {
+		tcp->cc->cong_avoid(tcp, acked);
+	}
+}
+
+static void tcp_cc_timeout(struct net_tcp *tcp)
+{
+	/* Only the first timeout of a series lowers ssthresh (RFC 5681
+	 * section 3.1, eq. 4), later ones have a window of one already.
+	 */
+	if (tcp->retry_timeout_shift == 1U) {
+		tcp->ssthresh = tcp->cc->ssthresh(tcp, tcp_flight_size(tcp));
+	}
+
+	tcp->cwnd = tcp->send_mss;
+	tcp->recover = tcp->snd_nxt;
+	tcp->dupacks = 0U;
+	tcp->flags &= ~NET_TCP_FAST_RECOVERY;
+}
+
+#if defined(CONFIG_NET_TEST)
+void net_tcp_cc_init(struct net_tcp *tcp)
+{
+	tcp_cc_init(tcp);
+}
+
+void net_tcp_cc_ack(struct net_tcp *tcp, u32_t ack, bool pure_ack)
+{
+	tcp_cc_ack(tcp, ack, pure_ack);
+}
+
+void net_tcp_cc_timeout(struct net_tcp *tcp)
+{
+	tcp_cc_timeout(tcp);
+}
+#endif
+#endif /* CONFIG_NET_TCP_CONGESTION_CONTROL */
+
 static void tcp_retry_expired(struct k_work *work)
 {
 	struct net_tcp *tcp = CONTAINER_OF(work, struct net_tcp, retry_timer);
@@ -226,30 +510,21 @@ static void tcp_retry_expired(struct k_work *work)
 			return;
 		}
 
+#if defined(CONFIG_NET_TCP_CONGESTION_CONTROL)
+		tcp_cc_timeout(tcp);
+#endif
+
 		k_delayed_work_submit(&tcp->retry_timer, retry_timeout(tcp));
 
 		pkt = CONTAINER_OF(sys_slist_peek_head(&tcp->sent_list),
 				   struct net_pkt, sent_list);
 
-		if (net_pkt_sent(pkt)) {
-			do_ref_if_needed(tcp, pkt);
-			net_pkt_set_sent(pkt, false);
-		}
-
-		net_pkt_set_queued(pkt, true);
-
-		if (net_tcp_send_pkt(pkt) < 0 && !is_6lo_technology(pkt)) {
+		if (tcp_retransmit(tcp, pkt) < 0) {
 			NET_DBG("retry %u: [%p] pkt %p send failed",
 				tcp->retry_timeout_shift, tcp, pkt);
-			net_pkt_unref(pkt);
 		} else {
 			NET_DBG("retry %u: [%p] sent pkt %p",
 				tcp->retry_timeout_shift, tcp, pkt);
-			if (IS_ENABLED(CONFIG_NET_STATISTICS_TCP) &&
-			    !is_6lo_technology(pkt)) {
-				net_stats_update_tcp_seg_rexmit(
-							net_pkt_iface(pkt));
-			}
 		}
 	} else if (CONFIG_NET_TCP_TIME_WAIT_DELAY != 0) {
 		if (tcp->fin_sent && tcp->fin_rcvd) {
@@ -289,6 +564,14 @@ struct net_tcp *net_tcp_alloc(struct net_context *context)
 
 	tcp_context[i].accept_cb = NULL;
 
+#if defined(CONFIG_NET_TCP_RTT_ESTIMATION)
+	tcp_context[i].rto = CONFIG_NET_TCP_INIT_RETRANSMISSION_TIMEOUT;
+#endif
+
+#if defined(CONFIG_NET_TCP_CONGESTION_CONTROL)
+	tcp_cc_init(&tcp_context[i]);
+#endif
+
 	k_delayed_work_init(&tcp_context[i].retry_timer, tcp_retry_expired);
 	k_sem_init(&tcp_context[i].connect_wait, 0, UINT_MAX);
 
@@ -315,6 +598,137 @@ static void timewait_timer_cancel(struct net_tcp *tcp)
 	k_delayed_work_cancel(&tcp->timewait_timer);
 }
 
+#if defined(CONFIG_NET_TCP_OOO_QUEUE)
+static u16_t tcp_ooo_buf_count(struct net_pkt *pkt)
+{
+	struct net_buf *buf;
+	u16_t count = 0U;
+
+	for (buf = pkt->buffer; buf; buf = buf->frags) {
+		count++;
+	}
+
+	return count;
+}
+
+static void tcp_ooo_flush(struct net_tcp *tcp)
+{
+	sys_snode_t *node;
+
+	while ((node = sys_slist_get(&tcp->ooo_list))) {
+		net_pkt_unref(CONTAINER_OF(node, struct net_pkt, sent_list));
+	}
+
+	tcp->ooo_bufs = 0U;
+}
+
+/* Keep a segment that arrived ahead of send_ack. The ooo_list is sorted
+ * by sequence number; segments already covered by a queued one, or that
+ * do not fit in the receive window or buffer budget, are refused.
+ */
+static bool tcp_ooo_queue(struct net_tcp *tcp, struct net_pkt *pkt)
+{
+	NET_PKT_DATA_ACCESS_DEFINE(tcp_access, struct net_tcp_hdr);
+	struct net_pkt *prev = NULL;
+	struct net_pkt *cur;
+	u32_t seq, len;
+	u16_t bufs;
+
+	if (!tcp_seq_range(pkt, &tcp_access, &seq, &len) || !len) {
+		return false;
+	}
+
+	if (net_tcp_seq_greater(seq + len,
+				tcp->send_ack + net_tcp_get_recv_wnd(tcp))) {
+		return false;
+	}
+
+	bufs = tcp_ooo_buf_count(pkt);
+	if (tcp->ooo_bufs + bufs > CONFIG_NET_TCP_OOO_QUEUE_BUFS) {
+		NET_DBG("[%p] out-of-order queue full, drop seq %u", tcp, seq);
+		return false;
+	}
+
+	SYS_SLIST_FOR_EACH_CONTAINER(&tcp->ooo_list, cur, sent_list) {
+		NET_PKT_DATA_ACCESS_DEFINE(cur_access, struct net_tcp_hdr);
+		u32_t cur_seq, cur_len;
+
+		if (!tcp_seq_range(cur, &cur_access, &cur_seq, &cur_len)) {
+			continue;
+		}
+
+		if (net_tcp_seq_cmp(seq, cur_seq) < 0) {
+			break;
+		}
+
+		if (net_tcp_seq_cmp(seq + len, cur_seq + cur_len) <= 0) {
+			/* Nothing new in this one */
+			return false;
+		}
+
+		prev = cur;
+	}
+
+	sys_slist_insert(&tcp->ooo_list, prev ? &prev->sent_list : NULL,
+			 &pkt->sent_list);
+	tcp->ooo_bufs += bufs;
+	tcp->ooo_last_seq = seq;
+
+	NET_DBG("[%p] queued out-of-order seq %u len %u (expect %u)", tcp,
+		seq, len, tcp->send_ack);
+
+	return true;
+}
+
+/* Pass queued segments that became in-order to the application and
+ * advance send_ack over them.
+ */
+static void tcp_ooo_deliver(struct net_conn *conn, struct net_context *context)
+{
+	struct net_tcp *tcp = context->tcp;
+	sys_snode_t *node;
+
+	while ((node = sys_slist_peek_head(&tcp->ooo_list))) {
+		NET_PKT_DATA_ACCESS_DEFINE(tcp_access, struct net_tcp_hdr);
+		struct net_pkt *pkt = CONTAINER_OF(node, struct net_pkt,
+						   sent_list);
+		union net_proto_header proto_hdr;
+		union net_ip_header ip_hdr;
+		u32_t seq, len;
+
+		proto_hdr.tcp = tcp_seq_range(pkt, &tcp_access, &seq, &len);
+		if (proto_hdr.tcp && net_tcp_seq_greater(seq, tcp->send_ack)) {
+			break;
+		}
+
+		sys_slist_get(&tcp->ooo_list);
+		tcp->ooo_bufs -= tcp_ooo_buf_count(pkt);
+
+		if (!proto_hdr.tcp ||
+		    net_tcp_seq_cmp(seq + len, tcp->send_ack) <= 0) {
+			net_pkt_unref(pkt);
+			continue;
+		}
+
+		/* Skip the part that an earlier segment already delivered */
+		net_pkt_skip(pkt, tcp->send_ack - seq);
+		tcp->send_ack = seq + len;
+
+		if (IS_ENABLED(CONFIG_NET_IPV4) &&
+		    net_pkt_family(pkt) == AF_INET) {
+			ip_hdr.ipv4 = NET_IPV4_HDR(pkt);
+		} else {
+			ip_hdr.ipv6 = NET_IPV6_HDR(pkt);
+		}
+
+		if (net_context_packet_received(conn, pkt, &ip_hdr, &proto_hdr,
+						tcp->recv_user_data) != NET_OK) {
+			net_pkt_unref(pkt);
+		}
+	}
+}
+#endif /* CONFIG_NET_TCP_OOO_QUEUE */
+
 int net_tcp_release(struct net_tcp *tcp)
 {
 	struct net_pkt *pkt;
@@ -331,6 +745,10 @@ int net_tcp_release(struct net_tcp *tcp)
 		net_pkt_unref(pkt);
 	}
 
+#if defined(CONFIG_NET_TCP_OOO_QUEUE)
+	tcp_ooo_flush(tcp);
+#endif
+
 	retry_timer_cancel(tcp);
 	k_sem_reset(&tcp->connect_wait);
 
@@ -342,7 +760,9 @@ int net_tcp_release(struct net_tcp *tcp)
 	tcp->context = NULL;
 
 	key = irq_lock();
-	tcp->flags &= ~(NET_TCP_IN_USE | NET_TCP_RECV_MSS_SET);
+	tcp->flags &= ~(NET_TCP_IN_USE | NET_TCP_RECV_MSS_SET |
+			NET_TCP_SACK_PERM | NET_TCP_RTT_TIMING |
+			NET_TCP_FAST_RECOVERY);
 	irq_unlock(key);
 
 	NET_DBG("[%p] Disposed of TCP connection state", tcp);
@@ -657,6 +1077,31 @@ u16_t net_tcp_get_recv_mss(const struct net_tcp *tcp)
 	return 0;
 }
 
+static void net_tcp_set_sack_perm_opt(struct net_tcp *tcp, u8_t *options,
+				      u8_t *optionlen)
+{
+#if defined(CONFIG_NET_TCP_SACK)
+	/* Always offer SACK on an active open. When answering a SYN, only
+	 * do so if the peer offered it.
+	 */
+	if (net_tcp_get_state(tcp) == NET_TCP_SYN_RCVD &&
+	    !(tcp->flags & NET_TCP_SACK_PERM)) {
+		return;
+	}
+
+	UNALIGNED_PUT(htonl((NET_TCP_NOP_OPT << 24) | (NET_TCP_NOP_OPT << 16) |
+			    (NET_TCP_SACK_PERM_OPT << 8) |
+			    NET_TCP_SACK_PERM_SIZE),
+		      (u32_t *)(options + *optionlen));
+
+	*optionlen += 2 * NET_TCP_NOP_SIZE + NET_TCP_SACK_PERM_SIZE;
+#else
+	ARG_UNUSED(tcp);
+	ARG_UNUSED(options);
+	ARG_UNUSED(optionlen);
+#endif
+}
+
 static void net_tcp_set_syn_opt(struct net_tcp *tcp, u8_t *options,
 				u8_t *optionlen)
 {
@@ -676,12 +1121,95 @@ static void net_tcp_set_syn_opt(struct net_tcp *tcp, u8_t *options,
 		      (u32_t *)(options + *optionlen));
 
 	*optionlen += NET_TCP_MSS_SIZE;
+
+	net_tcp_set_sack_perm_opt(tcp, options, optionlen);
 }
 
+#if defined(CONFIG_NET_TCP_SACK)
+/* Describe the contents of the out-of-order queue as SACK blocks, the
+ * block holding the most recently received segment first (RFC 2018).
+ */
+static u8_t net_tcp_set_sack_opt(struct net_tcp *tcp, u8_t *options)
+{
+	struct net_tcp_sack_block blocks[NET_TCP_SACK_BLOCKS];
+	struct net_pkt *pkt;
+	int recent = -1;
+	int count = 0;
+	int i;
+
+	if (!(tcp->flags & NET_TCP_SACK_PERM)) {
+		return 0;
+	}
+
+	SYS_SLIST_FOR_EACH_CONTAINER(&tcp->ooo_list, pkt, sent_list) {
+		NET_PKT_DATA_ACCESS_DEFINE(tcp_access, struct net_tcp_hdr);
+		u32_t seq, len;
+
+		if (!tcp_seq_range(pkt, &tcp_access, &seq, &len)) {
+			continue;
+		}
+
+		if (count &&
+		    net_tcp_seq_cmp(seq, blocks[count - 1].right) <= 0) {
+			if (net_tcp_seq_greater(seq + len,
+						blocks[count - 1].right)) {
+				blocks[count - 1].right = seq + len;
+			}
+		} else {
+			if (count == NET_TCP_SACK_BLOCKS) {
+				if (recent >= 0) {
+					break;
+				}
+
+				/* Keep looking for the most recent block in
+				 * the last slot.
+				 */
+				count--;
+			}
+
+			blocks[count].left = seq;
+			blocks[count].right = seq + len;
+			count++;
+		}
+
+		if (seq == tcp->ooo_last_seq) {
+			recent = count - 1;
+		}
+	}
+
+	if (!count) {
+		return 0;
+	}
+
+	if (recent > 0) {
+		struct net_tcp_sack_block tmp = blocks[0];
+
+		blocks[0] = blocks[recent];
+		blocks[recent] = tmp;
+	}
+
+	options[0] = NET_TCP_NOP_OPT;
+	options[1] = NET_TCP_NOP_OPT;
+	options[2] = NET_TCP_SACK_OPT;
+	options[3] = 2 + 8 * count;
+
+	for (i = 0; i < count; i++) {
+		sys_put_be32(blocks[i].left, options + 4 + 8 * i);
+		sys_put_be32(blocks[i].right, options + 8 + 8 * i);
+	}
+
+	return NET_TCP_SACK_SIZE(count);
+}
+
+#define NET_TCP_MAX_ACK_OPT_SIZE NET_TCP_SACK_SIZE(NET_TCP_SACK_BLOCKS)
+#else
+#define NET_TCP_MAX_ACK_OPT_SIZE NET_TCP_MAX_OPT_SIZE
+#endif /* CONFIG_NET_TCP_SACK */
+
 int net_tcp_prepare_ack(struct net_tcp *tcp, const struct sockaddr *remote,
 			struct net_pkt **pkt)
 {
-	u8_t options[NET_TCP_MAX_OPT_SIZE];
+	u8_t options[NET_TCP_MAX_ACK_OPT_SIZE];
 	u8_t optionlen;
 
 	switch (net_tcp_get_state(tcp)) {
@@ -702,6 +1230,14 @@ int net_tcp_prepare_ack(struct net_tcp *tcp, const struct sockaddr *remote,
 		return net_tcp_prepare_segment(tcp, NET_TCP_FIN | NET_TCP_ACK,
 					       0, 0, NULL, remote, pkt);
 	default:
+#if defined(CONFIG_NET_TCP_SACK)
+		optionlen = net_tcp_set_sack_opt(tcp, options);
+		if (optionlen) {
+			return net_tcp_prepare_segment(tcp, NET_TCP_ACK,
+						       options, optionlen,
+						       NULL, remote, pkt);
+		}
+#endif
 		return net_tcp_prepare_segment(tcp, NET_TCP_ACK, 0, 0, NULL,
 					       remote, pkt);
 	}
@@ -831,6 +1367,17 @@ int net_tcp_queue_data(struct net_context *context, struct net_pkt *pkt)
 
 	context->tcp->send_seq += data_len;
 
+	/* A segment larger than the MTU allows is split by the device */
+	if (!net_if_need_tcp_segmentation(net_pkt_iface(pkt))) {
+		size_t mss = net_if_get_mtu(net_pkt_iface(pkt)) -
+			(net_pkt_get_len(pkt) - data_len);
+
+		mss = MIN(mss, context->tcp->send_mss);
+		if (data_len > mss) {
+			net_pkt_set_tso_mss(pkt, mss);
+		}
+	}
+
 	net_stats_update_tcp_sent(net_pkt_iface(pkt), data_len);
 
 	return net_tcp_queue_pkt(context, pkt);
@@ -881,10 +1428,23 @@ int net_tcp_send_pkt(struct net_pkt *pkt)
 		return -EMSGSIZE;
 	}
 
+	/* The checksum was set when the segment was finalized, so it is
+	 * updated for the changed header fields only.
+	 */
+	calc_chksum = net_if_need_calc_tx_checksum(net_pkt_iface(pkt));
+
 	if (sys_get_be32(tcp_hdr->ack) != ctx->tcp->send_ack) {
+		u8_t old_ack[sizeof(tcp_hdr->ack)];
+
+		memcpy(old_ack, tcp_hdr->ack, sizeof(old_ack));
 		sys_put_be32(ctx->tcp->send_ack, tcp_hdr->ack);
-		tcp_hdr->chksum = 0U;
-		calc_chksum = true;
+
+		if (calc_chksum) {
+			tcp_hdr->chksum = net_chksum_update(tcp_hdr->chksum,
+							    old_ack,
+							    tcp_hdr->ack,
+							    sizeof(old_ack));
+		}
 	}
 
 	/* The data stream code always sets this flag, because
@@ -894,26 +1454,23 @@ int net_tcp_send_pkt(struct net_pkt *pkt)
 	 */
 	if (ctx->tcp->sent_ack != ctx->tcp->send_ack &&
 		(tcp_hdr->flags & NET_TCP_ACK) == 0U) {
+		/* The flags share a word with the data offset */
+		u8_t old_word[2] = { tcp_hdr->offset, tcp_hdr->flags };
+
 		tcp_hdr->flags |= NET_TCP_ACK;
-		tcp_hdr->chksum = 0U;
-		calc_chksum = true;
+
+		if (calc_chksum) {
+			tcp_hdr->chksum = net_chksum_update(tcp_hdr->chksum,
+							    old_word,
+							    &tcp_hdr->offset,
+							    sizeof(old_word));
+		}
 	}
 
 	/* As we modified the header, we need to write it back.
 	 */
 	net_pkt_set_data(pkt, &tcp_access);
 
-	if (calc_chksum) {
-		net_pkt_cursor_init(pkt);
-		net_pkt_skip(pkt, net_pkt_ip_hdr_len(pkt) +
-			     net_pkt_ipv6_ext_len(pkt));
-
-		/* No need to get tcp_hdr again */
-		tcp_hdr->chksum = net_calc_chksum_tcp(pkt);
-
-		net_pkt_set_data(pkt, &tcp_access);
-	}
-
 	if (tcp_hdr->flags & NET_TCP_FIN) {
 		ctx->tcp->fin_sent = 1U;
 	}
@@ -992,38 +1549,91 @@ static void restart_timer(struct net_tcp *tcp)
 	}
 }
 
-int net_tcp_send_data(struct net_context *context, net_context_send_cb_t cb,
-		      void *user_data)
+#if defined(CONFIG_NET_TCP_RTT_ESTIMATION)
+/* Called for a packet of the sent_list about to go out for the first
+ * time. Returns false if the congestion window does not allow it yet.
+ */
+static bool tcp_send_check(struct net_tcp *tcp, struct net_pkt *pkt)
+{
+	NET_PKT_DATA_ACCESS_DEFINE(tcp_access, struct net_tcp_hdr);
+	struct net_tcp_hdr *tcp_hdr;
+	u32_t seq, len;
+
+	tcp_hdr = tcp_seq_range(pkt, &tcp_access, &seq, &len);
+	if (!tcp_hdr) {
+		return true;
+	}
+
+	if (tcp_hdr->flags & (NET_TCP_SYN | NET_TCP_FIN)) {
+		len++;
+	}
+
+#if defined(CONFIG_NET_TCP_CONGESTION_CONTROL)
+	/* Always allow one segment in flight, however small cwnd is */
+	if (tcp_flight_size(tcp) &&
+	    tcp_flight_size(tcp) + len > tcp->cwnd) {
+		return false;
+	}
+
+	if (net_tcp_seq_greater(seq + len, tcp->snd_nxt)) {
+		tcp->snd_nxt = seq + len;
+	}
+#endif
+
+	if (len && !(tcp->flags & NET_TCP_RTT_TIMING)) {
+		tcp->flags |= NET_TCP_RTT_TIMING;
+		tcp->rtt_seq = seq + len;
+		tcp->rtt_time = k_uptime_get_32();
+	}
+
+	return true;
+}
+#endif /* CONFIG_NET_TCP_RTT_ESTIMATION */
+
+static void tcp_send_queued(struct net_tcp *tcp)
 {
 	struct net_pkt *pkt;
 
-	/* For now, just send all queued data synchronously.  Need to
-	 * add window handling and retry/ACK logic.
-	 */
-	SYS_SLIST_FOR_EACH_CONTAINER(&context->tcp->sent_list, pkt, sent_list) {
+	SYS_SLIST_FOR_EACH_CONTAINER(&tcp->sent_list, pkt, sent_list) {
 		/* Do not resend packets that were sent by expire timer */
 		if (net_pkt_queued(pkt)) {
 			NET_DBG("[%p] Skipping pkt %p because it was already "
-				"sent.", context->tcp, pkt);
+				"sent.", tcp, pkt);
 			continue;
 		}
 
 		if (!net_pkt_sent(pkt)) {
 			int ret;
 
-			NET_DBG("[%p] Sending pkt %p (%zd bytes)", context->tcp,
+#if defined(CONFIG_NET_TCP_RTT_ESTIMATION)
+			if (!tcp_send_check(tcp, pkt)) {
+				NET_DBG("[%p] cwnd %u full", tcp, tcp->cwnd);
+				break;
+			}
+#endif
+
+			NET_DBG("[%p] Sending pkt %p (%zd bytes)", tcp,
 				pkt, net_pkt_get_len(pkt));
 
 			ret = net_tcp_send_pkt(pkt);
 			if (ret < 0 && !is_6lo_technology(pkt)) {
 				NET_DBG("[%p] pkt %p not sent (%d)",
-					context->tcp, pkt, ret);
+					tcp, pkt, ret);
 				net_pkt_unref(pkt);
 			}
 
 			net_pkt_set_queued(pkt, true);
 		}
 	}
+}
+
+int net_tcp_send_data(struct net_context *context, net_context_send_cb_t cb,
+		      void *user_data)
+{
+	/* Send what the congestion window allows, if enabled, or all
+	 * queued data otherwise. The rest goes out as ACKs come in.
+	 */
+	tcp_send_queued(context->tcp);
 
 	/* Just make the callback synchronously even if it didn't
 	 * go over the wire.  In theory it would be nice to track
@@ -1133,12 +1743,97 @@ bool net_tcp_ack_received(struct net_context *ctx, u32_t ack)
 	 * sent times.
 	 */
 	if (valid_ack) {
+#if defined(CONFIG_NET_TCP_RTT_ESTIMATION)
+		if ((tcp->flags & NET_TCP_RTT_TIMING) &&
+		    !net_tcp_seq_greater(tcp->rtt_seq, ack)) {
+			tcp->flags &= ~NET_TCP_RTT_TIMING;
+			tcp_rtt_sample(tcp, k_uptime_get_32() - tcp->rtt_time);
+		}
+#endif
+
 		restart_timer(ctx->tcp);
 	}
 
 	return true;
 }
 
+#if defined(CONFIG_NET_TCP_SACK)
+static bool tcp_sack_covers(const struct net_tcp_options *opts,
+			    u32_t seq, u32_t end)
+{
+	int i;
+
+	for (i = 0; i < opts->sack_cnt; i++) {
+		if (net_tcp_seq_cmp(seq, opts->sack[i].left) >= 0 &&
+		    net_tcp_seq_cmp(end, opts->sack[i].right) <= 0) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/* The peer has reported data above ack as received. Every unacknowledged
+ * segment below the highest SACKed sequence number that is not covered
+ * by a block is considered lost and resent right away, once.
+ */
+static void tcp_sack_received(struct net_tcp *tcp, u32_t ack,
+			      const struct net_tcp_options *opts)
+{
+	struct net_pkt *pkt;
+	u32_t high;
+	int i;
+
+	if (!opts->sack_cnt) {
+		return;
+	}
+
+	high = opts->sack[0].right;
+	for (i = 1; i < opts->sack_cnt; i++) {
+		if (net_tcp_seq_greater(opts->sack[i].right, high)) {
+			high = opts->sack[i].right;
+		}
+	}
+
+	if (net_tcp_seq_greater(high, tcp->send_seq)) {
+		return;
+	}
+
+	if (!net_tcp_seq_greater(tcp->sack_rexmit, ack) ||
+	    net_tcp_seq_greater(tcp->sack_rexmit, tcp->send_seq)) {
+		tcp->sack_rexmit = ack;
+	}
+
+	SYS_SLIST_FOR_EACH_CONTAINER(&tcp->sent_list, pkt, sent_list) {
+		NET_PKT_DATA_ACCESS_DEFINE(tcp_access, struct net_tcp_hdr);
+		u32_t seq, len;
+
+		if (!tcp_seq_range(pkt, &tcp_access, &seq, &len) || !len) {
+			continue;
+		}
+
+		if (net_tcp_seq_greater(seq + len, high)) {
+			break;
+		}
+
+		/* Still in the TX queue, or already resent */
+		if (!net_pkt_sent(pkt) ||
+		    net_tcp_seq_cmp(seq, tcp->sack_rexmit) < 0 ||
+		    tcp_sack_covers(opts, seq, seq + len)) {
+			continue;
+		}
+
+		if (tcp_retransmit(tcp, pkt) < 0) {
+			NET_DBG("[%p] SACK resend of seq %u failed", tcp, seq);
+			break;
+		}
+
+		NET_DBG("[%p] SACK resent seq %u len %u", tcp, seq, len);
+		tcp->sack_rexmit = seq + len;
+	}
+}
+#endif /* CONFIG_NET_TCP_SACK */
+
 void net_tcp_init(void)
 {
 }
@@ -1288,6 +1983,9 @@ int net_tcp_parse_opts(struct net_pkt *pkt, int opt_totlen,
 		       struct net_tcp_options *opts)
 {
 	u8_t opt, optlen;
+#if defined(CONFIG_NET_TCP_SACK)
+	int i;
+#endif
 
 	while (opt_totlen) {
 		if (net_pkt_read_u8(pkt, &opt)) {
@@ -1339,6 +2037,35 @@ int net_tcp_parse_opts(struct net_pkt *pkt, int opt_totlen,
 			}
 
 			break;
+#if defined(CONFIG_NET_TCP_SACK)
+		case NET_TCP_SACK_PERM_OPT:
+			if (optlen != 0U) {
+				goto error;
+			}
+
+			opts->sack_perm = true;
+
+			break;
+		case NET_TCP_SACK_OPT:
+			if (optlen == 0U || (optlen % 8U) != 0U) {
+				goto error;
+			}
+
+			for (i = 0; i < optlen / 8U; i++) {
+				struct net_tcp_sack_block block;
+
+				if (net_pkt_read_be32(pkt, &block.left) ||
+				    net_pkt_read_be32(pkt, &block.right)) {
+					goto error;
+				}
+
+				if (opts->sack_cnt < NET_TCP_SACK_BLOCKS) {
+					opts->sack[opts->sack_cnt++] = block;
+				}
+			}
+
+			break;
+#endif
 		default:
 			if (net_pkt_skip(pkt, optlen)) {
 				goto error;
@@ -1562,7 +2289,7 @@ static int tcp_backlog_syn(struct net_pkt *pkt,
 			   union net_ip_header *ip_hdr,
 			   struct net_tcp_hdr *tcp_hdr,
 			   struct net_context *context,
-			   u16_t send_mss)
+			   const struct net_tcp_options *opts)
 {
 	int empty_slot = -1;
 
@@ -1581,7 +2308,10 @@ static int tcp_backlog_syn(struct net_pkt *pkt,
 
 	tcp_backlog[empty_slot].send_seq = context->tcp->send_seq;
 	tcp_backlog[empty_slot].send_ack = context->tcp->send_ack;
-	tcp_backlog[empty_slot].send_mss = send_mss;
+	tcp_backlog[empty_slot].send_mss = opts->mss;
+#if defined(CONFIG_NET_TCP_SACK)
+	tcp_backlog[empty_slot].sack_perm = opts->sack_perm;
+#endif
 
 	k_delayed_work_init(&tcp_backlog[empty_slot].ack_timer,
 			    backlog_ack_timeout);
@@ -1612,6 +2342,14 @@ static int tcp_backlog_ack(struct net_pkt *pkt,
 	context->tcp->send_seq = tcp_backlog[r].send_seq + 1;
 	context->tcp->send_ack = tcp_backlog[r].send_ack;
 	context->tcp->send_mss = tcp_backlog[r].send_mss;
+#if defined(CONFIG_NET_TCP_CONGESTION_CONTROL)
+	tcp_cc_init(context->tcp);
+#endif
+#if defined(CONFIG_NET_TCP_SACK)
+	if (tcp_backlog[r].sack_perm) {
+		context->tcp->flags |= NET_TCP_SACK_PERM;
+	}
+#endif
 
 	k_delayed_work_cancel(&tcp_backlog[r].ack_timer);
 	(void)memset(&tcp_backlog[r], 0, sizeof(struct tcp_backlog_entry));
@@ -1803,6 +2541,8 @@ static inline int send_syn_segment(struct net_context *context,
 
 	if (flags == NET_TCP_SYN) {
 		net_tcp_set_syn_opt(context->tcp, options, &optionlen);
+	} else {
+		net_tcp_set_sack_perm_opt(context->tcp, options, &optionlen);
 	}
 
 	ret = net_tcp_prepare_segment(context->tcp, flags, options, optionlen,
@@ -1924,6 +2664,9 @@ NET_CONN_CB(tcp_established)
 	struct net_context *context = (struct net_context *)user_data;
 	struct net_tcp_hdr *tcp_hdr = proto_hdr->tcp;
 	enum net_verdict ret = NET_OK;
+#if defined(CONFIG_NET_TCP_SACK)
+	struct net_tcp_options tcp_opts = { 0 };
+#endif
 	u8_t tcp_flags;
 	u16_t data_len;
 
@@ -1959,6 +2702,16 @@ resend_ack:
 
 	if (net_tcp_seq_cmp(sys_get_be32(tcp_hdr->seq),
 			    context->tcp->send_ack) > 0) {
+#if defined(CONFIG_NET_TCP_OOO_QUEUE)
+		/* Hold on to plain data segments until the hole before
+		 * them is filled, and tell the peer where the hole is.
+		 */
+		if (!(tcp_flags & (NET_TCP_SYN | NET_TCP_FIN | NET_TCP_RST)) &&
+		    tcp_ooo_queue(context->tcp, pkt)) {
+			send_ack(context, &conn->remote_addr, true);
+			goto unlock;
+		}
+#endif
 		/* Don't try to reorder packets.  If it doesn't
 		 * match the next segment exactly, drop and wait for
 		 * retransmit
@@ -1994,6 +2747,24 @@ resend_ack:
 		goto unlock;
 	}
 
+#if defined(CONFIG_NET_TCP_SACK)
+	if ((context->tcp->flags & NET_TCP_SACK_PERM) &&
+	    NET_TCP_HDR_LEN(tcp_hdr) > sizeof(struct net_tcp_hdr)) {
+		struct net_pkt_cursor backup;
+		int r;
+
+		net_pkt_cursor_backup(pkt, &backup);
+		r = net_tcp_parse_opts(pkt, NET_TCP_HDR_LEN(tcp_hdr) -
+				       sizeof(struct net_tcp_hdr), &tcp_opts);
+		net_pkt_cursor_restore(pkt, &backup);
+
+		if (r < 0) {
+			ret = NET_DROP;
+			goto unlock;
+		}
+	}
+#endif
+
 	/* Handle TCP state transition */
 	if (tcp_flags & NET_TCP_ACK) {
 		if (!net_tcp_ack_received(context,
@@ -2002,6 +2773,22 @@ resend_ack:
 			goto unlock;
 		}
 
+#if defined(CONFIG_NET_TCP_SACK)
+		tcp_sack_received(context->tcp, sys_get_be32(tcp_hdr->ack),
+				  &tcp_opts);
+#endif
+
+#if defined(CONFIG_NET_TCP_CONGESTION_CONTROL)
+		tcp_cc_ack(context->tcp, sys_get_be32(tcp_hdr->ack),
+			   !(tcp_flags & (NET_TCP_SYN | NET_TCP_FIN)) &&
+			   net_pkt_remaining_data(pkt) ==
+			   NET_TCP_HDR_LEN(tcp_hdr) -
+			   sizeof(struct net_tcp_hdr));
+
+		/* The window may have opened */
+		tcp_send_queued(context->tcp);
+#endif
+
 		/* TCP state might be changed after maintaining the sent pkt
 		 * list, e.g., an ack of FIN is received.
 		 */
@@ -2069,10 +2856,15 @@ resend_ack:
 	 */
 	if (data_len > 0) {
 		data_len = adjust_data_len(pkt, tcp_hdr, data_len);
+	}
 
+	/* A segment carrying options only (e.g. SACK in a pure ACK) has
+	 * nothing for the application either.
+	 */
+	if (data_len > 0) {
 		ret = net_context_packet_received(conn, pkt, ip_hdr, proto_hdr,
 						  context->tcp->recv_user_data);
-	} else if (data_len == 0U) {
+	} else {
 		net_pkt_unref(pkt);
 	}
 
@@ -2082,6 +2874,15 @@ resend_ack:
 		context->tcp->send_ack += 1U;
 	}
 
+#if defined(CONFIG_NET_TCP_OOO_QUEUE)
+	if (tcp_flags & NET_TCP_FIN) {
+		/* Nothing can follow the FIN */
+		tcp_ooo_flush(context->tcp);
+	} else if (data_len > 0) {
+		tcp_ooo_deliver(conn, context);
+	}
+#endif
+
 	send_ack(context, &conn->remote_addr, false);
 
 clean_up:
@@ -2155,6 +2956,21 @@ NET_CONN_CB(tcp_synack_received)
 	}
 
 	if (NET_TCP_FLAGS(tcp_hdr) & NET_TCP_SYN) {
+#if defined(CONFIG_NET_TCP_SACK)
+		struct net_tcp_options tcp_opts = {
+			.mss = NET_TCP_DEFAULT_MSS,
+		};
+
+		if (net_tcp_parse_opts(pkt, NET_TCP_HDR_LEN(tcp_hdr) -
+				       sizeof(struct net_tcp_hdr),
+				       &tcp_opts) < 0) {
+			return NET_DROP;
+		}
+
+		if (tcp_opts.sack_perm) {
+			context->tcp->flags |= NET_TCP_SACK_PERM;
+		}
+#endif
 		context->tcp->send_ack =
 			sys_get_be32(tcp_hdr->seq) + 1;
 	}
@@ -2192,6 +3008,10 @@ NET_CONN_CB(tcp_synack_received)
 		net_tcp_change_state(context->tcp, NET_TCP_ESTABLISHED);
 		net_context_set_state(context, NET_CONTEXT_CONNECTED);
 
+#if defined(CONFIG_NET_TCP_CONGESTION_CONTROL)
+		tcp_cc_init(context->tcp);
+#endif
+
 		send_ack(context, &remote_addr, false);
 
 		k_sem_give(&context->tcp->connect_wait);
@@ -2316,6 +3136,15 @@ NET_CONN_CB(tcp_syn_rcvd)
 
 		net_tcp_change_state(tcp, NET_TCP_SYN_RCVD);
 
+#if defined(CONFIG_NET_TCP_SACK)
+		/* Decides whether the SYN-ACK offers SACK */
+		if (tcp_opts.sack_perm) {
+			tcp->flags |= NET_TCP_SACK_PERM;
+		} else {
+			tcp->flags &= ~NET_TCP_SACK_PERM;
+		}
+#endif
+
 		/* Set TCP seq and ack which are then stored in the backlog */
 		context->tcp->send_seq = tcp_init_isn();
 		context->tcp->send_ack =
@@ -2324,7 +3153,7 @@ NET_CONN_CB(tcp_syn_rcvd)
 		/* Get MSS from TCP options here*/
 
 		r = tcp_backlog_syn(pkt, ip_hdr, tcp_hdr,
-				    context, tcp_opts.mss);
+				    context, &tcp_opts);
 		if (r < 0) {
 			if (r == -EADDRINUSE) {
 				NET_DBG("TCP connection already exists");
@@ -0,0 +1,177 @@
+/** @file
+ * @brief TCP congestion control algorithms
+ *
+ * The generic part (slow start, fast retransmit and fast recovery) lives
+ * in tcp.c, these only decide how the window backs off and grows.
+ */
+
+/*
+ * Copyright (c) 2019 Linaro Limited
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <logging/log.h>
+LOG_MODULE_DECLARE(net_tcp, CONFIG_NET_TCP_LOG_LEVEL);
+
+#include <kernel.h>
+#include <string.h>
+#include <sys/util.h>
+
+#include <net/net_pkt.h>
+#include <net/net_context.h>
+
+#include "tcp_internal.h"
+
+/* NewReno, RFC 5681 and RFC 6582 */
+
+static void newreno_init(struct net_tcp *tcp)
+{
+	tcp->cc_data.newreno.bytes_acked = 0U;
+}
+
+static u32_t newreno_ssthresh(struct net_tcp *tcp, u32_t flight)
+{
+	tcp->cc_data.newreno.bytes_acked = 0U;
+
+	return MAX(flight / 2U, 2U * tcp->send_mss);
+}
+
+/* Appropriate byte counting (RFC 3465): one segment per window of data
+ * acknowledged, however the peer spreads its ACKs.
+ */
+static void newreno_cong_avoid(struct net_tcp *tcp, u32_t acked)
+{
+	tcp->cc_data.newreno.bytes_acked += acked;
+
+	if (tcp->cc_data.newreno.bytes_acked >= tcp->cwnd) {
+		tcp->cc_data.newreno.bytes_acked -= tcp->cwnd;
+		tcp->cwnd += tcp->send_mss;
+	}
+}
+
+const struct net_tcp_cc net_tcp_cc_newreno = {
+	.name = "newreno",
+	.init = newreno_init,
+	.ssthresh = newreno_ssthresh,
+	.cong_avoid = newreno_cong_avoid,
+};
+
+#if defined(CONFIG_NET_TCP_CC_CUBIC)
+/* CUBIC, RFC 8312. Windows are kept in bytes and times in ms, so the
+ * constants below are scaled accordingly.
+ */
+
+/* Multiplicative decrease factor, 0.7 in 1/1024 */
+#define CUBIC_BETA 717U
+
+/* Cubic scaling constant C = 0.4 segments/s^3, in 1/1024 */
+#define CUBIC_C 410U
+
+/* Beyond this distance (ms) from k the cubic term only overflows */
+#define CUBIC_MAX_T 100000
+
+static u32_t cubic_cbrt(u64_t x)
+{
+	u32_t lo = 0U, hi = 1U << 21;
+
+	while (lo < hi) {
+		u32_t mid = (lo + hi + 1U) / 2U;
+
+		if ((u64_t)mid * mid * mid <= x) {
+			lo = mid;
+		} else {
+			hi = mid - 1U;
+		}
+	}
+
+	return lo;
+}
+
+static void cubic_init(struct net_tcp *tcp)
+{
+	(void)memset(&tcp->cc_data.cubic, 0, sizeof(tcp->cc_data.cubic));
+}
+
+static u32_t cubic_ssthresh(struct net_tcp *tcp, u32_t flight)
+{
+	ARG_UNUSED(flight);
+
+	tcp->cc_data.cubic.epoch = 0U;
+
+	/* Fast convergence: release bandwidth to newer flows when the
+	 * window did not get back to its previous maximum.
+	 */
+	if (tcp->cwnd < tcp->cc_data.cubic.w_max) {
+		tcp->cc_data.cubic.w_max =
+			tcp->cwnd * (1024U + CUBIC_BETA) / 2048U;
+	} else {
+		tcp->cc_data.cubic.w_max = tcp->cwnd;
+	}
+
+	return MAX(tcp->cwnd * CUBIC_BETA / 1024U, 2U * tcp->send_mss);
+}
+
+static void cubic_cong_avoid(struct net_tcp *tcp, u32_t acked)
+{
+	u32_t now = k_uptime_get_32();
+	u32_t target;
+	s64_t delta;
+	s64_t t;
+
+	if (!tcp->cc_data.cubic.epoch) {
+		tcp->cc_data.cubic.epoch = now ? now : 1U;
+		tcp->cc_data.cubic.w_est = tcp->cwnd;
+
+		if (tcp->cwnd < tcp->cc_data.cubic.w_max) {
+			/* k = cbrt((w_max - cwnd) / C), with windows in
+			 * segments and k in ms.
+			 */
+			tcp->cc_data.cubic.k = cubic_cbrt(
+				(u64_t)(tcp->cc_data.cubic.w_max - tcp->cwnd) *
+				1000000000U / tcp->send_mss * 1024U / CUBIC_C);
+			tcp->cc_data.cubic.origin = tcp->cc_data.cubic.w_max;
+		} else {
+			tcp->cc_data.cubic.k = 0U;
+			tcp->cc_data.cubic.origin = tcp->cwnd;
+		}
+	}
+
+	/* Aim for where the curve will be one round trip from now */
+	t = (s64_t)(now - tcp->cc_data.cubic.epoch) + (tcp->srtt >> 3) -
+		tcp->cc_data.cubic.k;
+	t = MIN(MAX(t, -CUBIC_MAX_T), CUBIC_MAX_T);
+
+	/* C * t^3 segments, t in ms */
+	delta = t * t * t * CUBIC_C / 1024;
+	delta = delta / 1000 * tcp->send_mss / 1000000;
+
+	if (delta < -(s64_t)tcp->cc_data.cubic.origin) {
+		target = 0U;
+	} else {
+		target = tcp->cc_data.cubic.origin + delta;
+	}
+
+	/* TCP-friendly region: never grow slower than Reno would, which
+	 * gains 3 * (1 - beta) / (1 + beta) ~= 9/17 segment per round trip.
+	 */
+	tcp->cc_data.cubic.w_est += (u64_t)acked * tcp->send_mss * 9U /
+				    (17U * tcp->cwnd);
+	if (target < tcp->cc_data.cubic.w_est) {
+		target = tcp->cc_data.cubic.w_est;
+	}
+
+	if (target > tcp->cwnd) {
+		/* At most 1.5 times the window per round trip */
+		tcp->cwnd += MIN((u64_t)(target - tcp->cwnd) * acked /
+				 tcp->cwnd, acked / 2U);
+	}
+}
+
+const struct net_tcp_cc net_tcp_cc_cubic = {
+	.name = "cubic",
+	.init = cubic_init,
+	.ssthresh = cubic_ssthresh,
+	.cong_avoid = cubic_cong_avoid,
+};
+#endif /* CONFIG_NET_TCP_CC_CUBIC */
@@ -29,7 +29,11 @@ extern "C" {
 /** Is this TCP context/socket used or not */
 #define NET_TCP_IN_USE BIT(0)
 
-/* BIT(1), BIT(2) are unused and available */
+/** Peer has sent the SACK-permitted option in its SYN */
+#define NET_TCP_SACK_PERM BIT(1)
+
+/** A segment is being timed for an RTT sample */
+#define NET_TCP_RTT_TIMING BIT(2)
 
 /** Is the socket shutdown for read/write */
 #define NET_TCP_IS_SHUTDOWN BIT(3)
@@ -40,6 +44,9 @@ extern "C" {
 /** MSS option has been set already */
 #define NET_TCP_RECV_MSS_SET BIT(5)
 
+/** Congestion control is in fast recovery */
+#define NET_TCP_FAST_RECOVERY BIT(6)
+
 /*
  * TCP connection states
  */
@@ -90,16 +97,43 @@ enum net_tcp_state {
 #define NET_TCP_NOP_OPT          1
 #define NET_TCP_MSS_OPT          2
 #define NET_TCP_WINDOW_SCALE_OPT 3
+#define NET_TCP_SACK_PERM_OPT    4
+#define NET_TCP_SACK_OPT         5
 
 /* TCP Option sizes */
 #define NET_TCP_END_SIZE          1
 #define NET_TCP_NOP_SIZE          1
 #define NET_TCP_MSS_SIZE          4
 #define NET_TCP_WINDOW_SCALE_SIZE 3
+#define NET_TCP_SACK_PERM_SIZE    2
+
+/* Max number of SACK blocks sent or processed per segment. Three blocks
+ * plus two NOPs for alignment fill 28 of the 40 option bytes.
+ */
+#define NET_TCP_SACK_BLOCKS       3
+
+/* Size of a SACK option carrying n blocks, including the two NOP
+ * bytes used to align it.
+ */
+#define NET_TCP_SACK_SIZE(n)      (2 * NET_TCP_NOP_SIZE + 2 + 8 * (n))
+
+/** SACK block, edges in host byte order */
+struct net_tcp_sack_block {
+	u32_t left;
+	u32_t right;
+};
 
 /** Parsed TCP option values for net_tcp_parse_opts()  */
 struct net_tcp_options {
 	u16_t mss;
+#if defined(CONFIG_NET_TCP_SACK)
+	/** SACK-permitted option was present */
+	bool sack_perm;
+	/** Number of valid entries in sack */
+	u8_t sack_cnt;
+	/** SACK blocks in the order they appeared in the segment */
+	struct net_tcp_sack_block sack[NET_TCP_SACK_BLOCKS];
+#endif
 };
 
 /* Max received bytes to buffer internally */
@@ -109,6 +143,38 @@ struct net_tcp_options {
 #define NET_TCP_MAX_SEG_LIFETIME 60
 
 struct net_context;
+struct net_tcp;
+
+/**
+ * Congestion control algorithm. The generic code in tcp.c does slow
+ * start, fast retransmit and NewReno fast recovery; the algorithm
+ * decides how much cwnd backs off on a loss and how it grows in
+ * congestion avoidance.
+ */
+struct net_tcp_cc {
+	/** Name shown by the net shell */
+	const char *name;
+
+	/** Reset the algorithm state of a new connection */
+	void (*init)(struct net_tcp *tcp);
+
+	/** Return the slow start threshold to use after a loss, given the
+	 * amount of data in flight when the loss was detected.
+	 */
+	u32_t (*ssthresh)(struct net_tcp *tcp, u32_t flight);
+
+	/** Grow cwnd once above ssthresh, acked bytes having just been
+	 * acknowledged.
+	 */
+	void (*cong_avoid)(struct net_tcp *tcp, u32_t acked);
+};
+
+#if defined(CONFIG_NET_TCP_CONGESTION_CONTROL)
+extern const struct net_tcp_cc net_tcp_cc_newreno;
+#if defined(CONFIG_NET_TCP_CC_CUBIC)
+extern const struct net_tcp_cc net_tcp_cc_cubic;
+#endif
+#endif
 
 struct net_tcp {
 	/** Network context back pointer. */
@@ -161,6 +227,86 @@ struct net_tcp {
 	 */
 	u16_t send_mss;
 
+#if defined(CONFIG_NET_TCP_OOO_QUEUE)
+	/** Received segments waiting for a hole before them to be filled,
+	 * sorted by sequence number.
+	 */
+	sys_slist_t ooo_list;
+
+	/** Sequence number of the most recently queued segment */
+	u32_t ooo_last_seq;
+
+	/** Number of net_buf fragments held in ooo_list */
+	u16_t ooo_bufs;
+#endif
+
+#if defined(CONFIG_NET_TCP_SACK)
+	/** Highest sequence number retransmitted because of SACK info */
+	u32_t sack_rexmit;
+#endif
+
+#if defined(CONFIG_NET_TCP_RTT_ESTIMATION)
+	/** End of the segment being timed, valid with NET_TCP_RTT_TIMING */
+	u32_t rtt_seq;
+
+	/** Uptime (ms) when the timed segment was sent */
+	u32_t rtt_time;
+
+	/** Smoothed round-trip time, in 1/8 ms (0 until the first sample) */
+	u32_t srtt;
+
+	/** Round-trip time variation, in 1/4 ms */
+	u32_t rttvar;
+
+	/** Retransmission timeout derived from srtt and rttvar, in ms */
+	u32_t rto;
+#endif
+
+#if defined(CONFIG_NET_TCP_CONGESTION_CONTROL)
+	/** Congestion control algorithm of this connection */
+	const struct net_tcp_cc *cc;
+
+	/** Congestion window, in bytes */
+	u32_t cwnd;
+
+	/** Slow start threshold, in bytes */
+	u32_t ssthresh;
+
+	/** Oldest unacknowledged sequence number */
+	u32_t snd_una;
+
+	/** Next sequence number to be sent for the first time */
+	u32_t snd_nxt;
+
+	/** snd_nxt when fast recovery was entered */
+	u32_t recover;
+
+	/** Number of duplicate ACKs in a row */
+	u8_t dupacks;
+
+	/** Per-algorithm state */
+	union {
+		struct {
+			/** Bytes acked since cwnd last grew */
+			u32_t bytes_acked;
+		} newreno;
+#if defined(CONFIG_NET_TCP_CC_CUBIC)
+		struct {
+			/** cwnd before the last reduction, in bytes */
+			u32_t w_max;
+			/** Window of the cubic function at time k */
+			u32_t origin;
+			/** Time (ms) to get back to origin */
+			u32_t k;
+			/** Uptime (ms) the current epoch started, 0 if none */
+			u32_t epoch;
+			/** Estimated Reno window, for the TCP-friendly region */
+			u32_t w_est;
+		} cubic;
+#endif
+	} cc_data;
+#endif
+
 	/** Current retransmit period */
 	u32_t retry_timeout_shift : 5;
 	/** Flags for the TCP */
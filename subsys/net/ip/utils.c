@@ -489,37 +489,143 @@ int z_vrfy_net_addr_pton(sa_family_t family, const char *src,
 #include <syscalls/net_addr_pton_mrsh.c>
 #endif /* CONFIG_USERSPACE */
 
-static u16_t calc_chksum(u16_t sum, const u8_t *data, size_t len)
+/* Checksums are summed a word at a time in native byte order, then
+ * converted to network byte order. Summing the 16-bit words of a buffer
+ * in the other byte order, or one byte off, only swaps the bytes of the
+ * result (RFC 1071, 2.B), so this is done once per buffer.
+ */
+typedef u32_t __may_alias chksum_word_t;
+typedef u16_t __may_alias chksum_half_t;
+
+static inline u16_t chksum_fold(u64_t acc)
 {
-	const u8_t *end;
-	u16_t tmp;
+	acc = (acc & 0xffffffffULL) + (acc >> 32);
+	acc = (acc & 0xffffffffULL) + (acc >> 32);
+	acc = (acc & 0xffff) + (acc >> 16);
+	acc = (acc & 0xffff) + (acc >> 16);
+	acc = (acc & 0xffff) + (acc >> 16);
+
+	return acc;
+}
 
-	end = data + len - 1;
+#if defined(CONFIG_NET_CHKSUM_SIMD) && defined(__SSE2__)
+#include <emmintrin.h>
+
+/* Each 32-bit lane takes two words per block, so it cannot overflow
+ * before this many blocks.
+ */
+#define CHKSUM_SIMD_BLOCKS 0x8000
+
+static u64_t chksum_words_simd(const u8_t **data, size_t *len)
+{
+	const __m128i zero = _mm_setzero_si128();
+	u64_t acc = 0U;
+	u32_t lanes[4];
 
-	while (data < end) {
-		tmp = (data[0] << 8) + data[1];
-		sum += tmp;
-		if (sum < tmp) {
-			sum++;
+	while (*len >= sizeof(__m128i)) {
+		size_t blocks = MIN(*len / sizeof(__m128i), CHKSUM_SIMD_BLOCKS);
+		__m128i sum = zero;
+
+		*len -= blocks * sizeof(__m128i);
+
+		while (blocks--) {
+			__m128i v = _mm_loadu_si128((const __m128i *)*data);
+
+			sum = _mm_add_epi32(sum, _mm_unpacklo_epi16(v, zero));
+			sum = _mm_add_epi32(sum, _mm_unpackhi_epi16(v, zero));
+			*data += sizeof(__m128i);
 		}
 
-		data += 2;
+		_mm_storeu_si128((__m128i *)lanes, sum);
+		acc += (u64_t)lanes[0] + lanes[1] + lanes[2] + lanes[3];
 	}
 
-	if (data == end) {
-		tmp = data[0] << 8;
-		sum += tmp;
-		if (sum < tmp) {
-			sum++;
-		}
+	return acc;
+}
+#endif /* CONFIG_NET_CHKSUM_SIMD && __SSE2__ */
+
+/* Sum the native 16-bit words of an even aligned buffer. An odd last byte
+ * is the first byte of a zero padded word.
+ */
+static u64_t chksum_words(const u8_t *data, size_t len)
+{
+	u64_t acc = 0U;
+
+	if (len >= sizeof(u16_t) && ((uintptr_t)data & 2)) {
+		acc += *(const chksum_half_t *)data;
+		data += sizeof(u16_t);
+		len -= sizeof(u16_t);
 	}
 
-	return sum;
+#if defined(CONFIG_NET_CHKSUM_SIMD) && defined(__SSE2__)
+	acc += chksum_words_simd(&data, &len);
+#endif
+
+	while (len >= 4 * sizeof(u32_t)) {
+		const chksum_word_t *words = (const chksum_word_t *)data;
+
+		acc += (u64_t)words[0] + words[1] + words[2] + words[3];
+		data += 4 * sizeof(u32_t);
+		len -= 4 * sizeof(u32_t);
+	}
+
+	while (len >= sizeof(u32_t)) {
+		acc += *(const chksum_word_t *)data;
+		data += sizeof(u32_t);
+		len -= sizeof(u32_t);
+	}
+
+	if (len >= sizeof(u16_t)) {
+		acc += *(const chksum_half_t *)data;
+		data += sizeof(u16_t);
+		len -= sizeof(u16_t);
+	}
+
+	if (len) {
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+		acc += *data;
+#else
+		acc += *data << 8;
+#endif
+	}
+
+	return acc;
+}
+
+static u16_t calc_chksum(u16_t sum, const u8_t *data, size_t len)
+{
+	u32_t total = sum;
+	u16_t words;
+
+	if (!len) {
+		return sum;
+	}
+
+	if ((uintptr_t)data & 1) {
+		/* The first byte is the high byte of a word, the words
+		 * summed after it are one byte off.
+		 */
+		total += data[0] << 8;
+		words = chksum_fold(chksum_words(data + 1, len - 1));
+
+#if __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+		words = __bswap_16(words);
+#endif
+	} else {
+		words = chksum_fold(chksum_words(data, len));
+
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+		words = __bswap_16(words);
+#endif
+	}
+
+	return chksum_fold(total + words);
 }
 
 static inline u16_t pkt_calc_chksum(struct net_pkt *pkt, u16_t sum)
 {
 	struct net_pkt_cursor *cur = &pkt->cursor;
+	bool odd = false;
 	size_t len;
 
 	if (!cur->buf || !cur->pos) {
@@ -529,7 +635,16 @@ static inline u16_t pkt_calc_chksum(struct net_pkt *pkt, u16_t sum)
 	len = cur->buf->len - (cur->pos - cur->buf->data);
 
 	while (cur->buf) {
-		sum = calc_chksum(sum, cur->pos, len);
+		if (odd) {
+			/* The fragment starts with the low byte of a word */
+			u16_t frag_sum = calc_chksum(0U, cur->pos, len);
+
+			sum = chksum_fold((u32_t)sum + __bswap_16(frag_sum));
+		} else {
+			sum = calc_chksum(sum, cur->pos, len);
+		}
+
+		odd ^= len & 1;
 
 		cur->buf = cur->buf->frags;
 		if (!cur->buf || !cur->buf->len) {
@@ -537,18 +652,7 @@ static inline u16_t pkt_calc_chksum(struct net_pkt *pkt, u16_t sum)
 		}
 
 		cur->pos = cur->buf->data;
-
-		if (len % 2) {
-			sum += *cur->pos;
-			if (sum < *cur->pos) {
-				sum++;
-			}
-
-			cur->pos++;
-			len = cur->buf->len - 1;
-		} else {
-			len = cur->buf->len;
-		}
+		len = cur->buf->len;
 	}
 
 	return sum;
@@ -615,6 +719,24 @@ u16_t net_calc_chksum_ipv4(struct net_pkt *pkt)
 }
 #endif /* CONFIG_NET_IPV4 */
 
+u16_t net_chksum_update(u16_t chksum, const void *old_data,
+			const void *new_data, size_t len)
+{
+	u32_t sum;
+
+	/* RFC 1624, eqn. 3: HC' = ~(~HC + ~m + m') */
+	sum = (u16_t)~ntohs(chksum);
+	sum += (u16_t)~calc_chksum(0U, old_data, len);
+	sum += calc_chksum(0U, new_data, len);
+
+	return htons((u16_t)~chksum_fold(sum));
+}
+
+u16_t net_chksum_add(u16_t sum, const void *data, size_t len)
+{
+	return calc_chksum(sum, data, len);
+}
+
 #if defined(CONFIG_NET_IPV6) || defined(CONFIG_NET_IPV4)
 static bool convert_port(const char *buf, u16_t *port)
 {
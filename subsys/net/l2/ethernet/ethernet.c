@@ -27,7 +27,9 @@ LOG_MODULE_REGISTER(net_ethernet, CONFIG_NET_L2_ETHERNET_LOG_LEVEL);
 #include "arp.h"
 #include "eth_stats.h"
 #include "net_private.h"
+#include "ipv4.h"
 #include "ipv6.h"
+#include "tcp_internal.h"
 #include "ipv4_autoconf_internal.h"
 
 #define NET_BUF_TIMEOUT K_MSEC(100)
@@ -1057,6 +1059,211 @@ int net_eth_promisc_mode(struct net_if *iface, bool enable)
 			&params, sizeof(struct ethernet_req_params));
 }
 
+/* Find the IP and transport headers of a frame, ip_off is set to 0 if it
+ * is not an IP packet. Returns the transport protocol, or 0 if the frame
+ * has no TCP or UDP header to complete.
+ */
+static u8_t tx_offload_parse(u8_t *frame, size_t len, size_t *ip_off,
+			     size_t *l4_off)
+{
+	struct net_eth_hdr *hdr = (struct net_eth_hdr *)frame;
+	u16_t type = ntohs(hdr->type);
+	size_t off = sizeof(struct net_eth_hdr);
+	u8_t proto;
+
+	if (type == NET_ETH_PTYPE_VLAN) {
+		type = ntohs(((struct net_eth_vlan_hdr *)frame)->type);
+		off = sizeof(struct net_eth_vlan_hdr);
+	}
+
+	*ip_off = off;
+
+	if (IS_ENABLED(CONFIG_NET_IPV4) && type == NET_ETH_PTYPE_IP &&
+	    len >= off + sizeof(struct net_ipv4_hdr)) {
+		struct net_ipv4_hdr *ipv4 = (struct net_ipv4_hdr *)(frame + off);
+
+		*l4_off = off + (ipv4->vhl & NET_IPV4_IHL_MASK) * 4U;
+		proto = ipv4->proto;
+
+		/* MF flag or fragment offset set */
+		if ((ipv4->offset[0] & 0x3f) || ipv4->offset[1]) {
+			return 0;
+		}
+	} else if (IS_ENABLED(CONFIG_NET_IPV6) &&
+		   type == NET_ETH_PTYPE_IPV6 &&
+		   len >= off + sizeof(struct net_ipv6_hdr)) {
+		struct net_ipv6_hdr *ipv6 = (struct net_ipv6_hdr *)(frame + off);
+
+		/* Extension headers are not looked into */
+		*l4_off = off + sizeof(struct net_ipv6_hdr);
+		proto = ipv6->nexthdr;
+	} else {
+		*ip_off = 0;
+		return 0;
+	}
+
+	if ((proto == IPPROTO_TCP &&
+	     len >= *l4_off + sizeof(struct net_tcp_hdr)) ||
+	    (proto == IPPROTO_UDP &&
+	     len >= *l4_off + sizeof(struct net_udp_hdr))) {
+		return proto;
+	}
+
+	return 0;
+}
+
+static void tx_offload_chksum(u8_t *frame, size_t len)
+{
+	size_t ip_off, l4_off, addr_len;
+	u8_t proto;
+	u16_t *chksum;
+	u16_t sum;
+
+	proto = tx_offload_parse(frame, len, &ip_off, &l4_off);
+	if (!ip_off) {
+		return;
+	}
+
+	if ((frame[ip_off] >> 4) == 4) {
+		struct net_ipv4_hdr *ipv4 =
+			(struct net_ipv4_hdr *)(frame + ip_off);
+
+		ipv4->chksum = 0U;
+		sum = net_chksum_add(0U, ipv4, l4_off - ip_off);
+		ipv4->chksum = ~((sum == 0U) ? 0xffff : htons(sum));
+
+		addr_len = 2 * sizeof(struct in_addr);
+	} else {
+		addr_len = 2 * sizeof(struct in6_addr);
+	}
+
+	if (proto == IPPROTO_TCP) {
+		chksum = &((struct net_tcp_hdr *)(frame + l4_off))->chksum;
+	} else if (proto == IPPROTO_UDP) {
+		chksum = &((struct net_udp_hdr *)(frame + l4_off))->chksum;
+	} else {
+		return;
+	}
+
+	/* The addresses are the last fields of both IP headers */
+	*chksum = 0U;
+	sum = net_chksum_add(len - l4_off + proto,
+			     frame + l4_off - addr_len, addr_len);
+	sum = net_chksum_add(sum, frame + l4_off, len - l4_off);
+	sum = ~((sum == 0U) ? 0xffff : htons(sum));
+
+	if (proto == IPPROTO_UDP && sum == 0U) {
+		sum = 0xffff;
+	}
+
+	*chksum = sum;
+}
+
+static int tx_offload_tso(struct net_pkt *pkt, u8_t *buf, size_t buf_len,
+			  net_eth_tx_frame_cb_t cb, void *user_data)
+{
+	size_t ip_off, l4_off, hdr_len, data_len, seg_len;
+	u16_t mss = net_pkt_tso_mss(pkt);
+	struct net_tcp_hdr *tcp_hdr;
+	u16_t id = 0U;
+	u8_t flags;
+	u32_t seq;
+	int ret;
+
+	/* The headers are read once and reused for every segment */
+	hdr_len = MIN(buf_len, net_pkt_get_len(pkt));
+	if (net_pkt_read(pkt, buf, hdr_len) ||
+	    tx_offload_parse(buf, hdr_len, &ip_off, &l4_off) != IPPROTO_TCP ||
+	    !ip_off) {
+		return -EINVAL;
+	}
+
+	tcp_hdr = (struct net_tcp_hdr *)(buf + l4_off);
+	hdr_len = l4_off + (tcp_hdr->offset >> 4) * 4U;
+	if (hdr_len + mss > buf_len) {
+		return -EMSGSIZE;
+	}
+
+	data_len = net_pkt_get_len(pkt) - hdr_len;
+	seq = sys_get_be32(tcp_hdr->seq);
+	flags = tcp_hdr->flags;
+
+	if ((buf[ip_off] >> 4) == 4) {
+		id = sys_get_be16(((struct net_ipv4_hdr *)(buf + ip_off))->id);
+	}
+
+	net_pkt_cursor_init(pkt);
+	net_pkt_skip(pkt, hdr_len);
+
+	while (data_len) {
+		seg_len = MIN(data_len, mss);
+		data_len -= seg_len;
+
+		if (net_pkt_read(pkt, buf + hdr_len, seg_len)) {
+			return -EINVAL;
+		}
+
+		if ((buf[ip_off] >> 4) == 4) {
+			struct net_ipv4_hdr *ipv4 =
+				(struct net_ipv4_hdr *)(buf + ip_off);
+
+			ipv4->len = htons(hdr_len + seg_len - ip_off);
+			sys_put_be16(id++, ipv4->id);
+		} else {
+			struct net_ipv6_hdr *ipv6 =
+				(struct net_ipv6_hdr *)(buf + ip_off);
+
+			ipv6->len = htons(hdr_len + seg_len - l4_off);
+		}
+
+		/* Only the last segment gets PSH and FIN */
+		sys_put_be32(seq, tcp_hdr->seq);
+		tcp_hdr->flags = data_len ?
+			flags & ~(NET_TCP_PSH | NET_TCP_FIN) : flags;
+		seq += seg_len;
+
+		tx_offload_chksum(buf, hdr_len + seg_len);
+
+		ret = cb(buf, hdr_len + seg_len, user_data);
+		if (ret < 0) {
+			return ret;
+		}
+	}
+
+	return 0;
+}
+
+int net_eth_tx_offload(struct net_pkt *pkt, u8_t *buf, size_t buf_len,
+		       net_eth_tx_frame_cb_t cb, void *user_data)
+{
+	size_t len = net_pkt_get_len(pkt);
+	struct net_pkt_cursor backup;
+	bool ow;
+	int ret;
+
+	net_pkt_cursor_backup(pkt, &backup);
+	net_pkt_cursor_init(pkt);
+
+	ow = net_pkt_is_being_overwritten(pkt);
+	net_pkt_set_overwrite(pkt, true);
+
+	if (net_pkt_tso_mss(pkt)) {
+		ret = tx_offload_tso(pkt, buf, buf_len, cb, user_data);
+	} else if (len > buf_len) {
+		ret = -EMSGSIZE;
+	} else if (net_pkt_read(pkt, buf, len)) {
+		ret = -EINVAL;
+	} else {
+		tx_offload_chksum(buf, len);
+		ret = cb(buf, len, user_data);
+	}
+
+	net_pkt_cursor_restore(pkt, &backup);
+	net_pkt_set_overwrite(pkt, ow);
+
+	return ret;
+}
+
 void ethernet_init(struct net_if *iface)
 {
 	struct ethernet_context *ctx = net_if_l2_data(iface);
@@ -694,6 +694,31 @@ error:
 	return ret;
 }
 
+static int sock_get_pkt_src(struct net_context *ctx, struct net_pkt *pkt,
+			    struct sockaddr *src_addr, socklen_t *addrlen)
+{
+	int rv;
+
+	rv = sock_get_pkt_src_addr(pkt, net_context_get_ip_proto(ctx),
+				   src_addr, *addrlen);
+	if (rv < 0) {
+		return rv;
+	}
+
+	/* addrlen is a value-result argument, set to actual
+	 * size of source address
+	 */
+	if (src_addr->sa_family == AF_INET) {
+		*addrlen = sizeof(struct sockaddr_in);
+	} else if (src_addr->sa_family == AF_INET6) {
+		*addrlen = sizeof(struct sockaddr_in6);
+	} else {
+		return -ENOTSUP;
+	}
+
+	return 0;
+}
+
 static inline ssize_t zsock_recv_dgram(struct net_context *ctx,
 				       void *buf,
 				       size_t max_len,
@@ -735,24 +760,11 @@ static inline ssize_t zsock_recv_dgram(struct net_context *ctx,
 	if (src_addr && addrlen) {
 		int rv;
 
-		rv = sock_get_pkt_src_addr(pkt, net_context_get_ip_proto(ctx),
-					   src_addr, *addrlen);
+		rv = sock_get_pkt_src(ctx, pkt, src_addr, addrlen);
 		if (rv < 0) {
 			errno = -rv;
 			return -1;
 		}
-
-		/* addrlen is a value-result argument, set to actual
-		 * size of source address
-		 */
-		if (src_addr->sa_family == AF_INET) {
-			*addrlen = sizeof(struct sockaddr_in);
-		} else if (src_addr->sa_family == AF_INET6) {
-			*addrlen = sizeof(struct sockaddr_in6);
-		} else {
-			errno = ENOTSUP;
-			return -1;
-		}
 	}
 
 	recv_len = net_pkt_remaining_data(pkt);
@@ -919,6 +931,447 @@ ssize_t z_vrfy_zsock_recvfrom(int sock, void *buf, size_t max_len, int flags,
 #include <syscalls/zsock_recvfrom_mrsh.c>
 #endif /* CONFIG_USERSPACE */
 
+/* Receive one datagram, scattered over the iovec of msg */
+static ssize_t zsock_recvmsg_dgram(struct net_context *ctx,
+				   struct msghdr *msg, int flags)
+{
+	s32_t timeout = K_FOREVER;
+	size_t recv_len = 0;
+	struct net_pkt *pkt;
+	size_t data_len;
+	int i;
+
+	if ((flags & ZSOCK_MSG_DONTWAIT) || sock_is_nonblock(ctx)) {
+		timeout = K_NO_WAIT;
+	}
+
+	pkt = k_fifo_get(&ctx->recv_q, timeout);
+	if (!pkt) {
+		errno = EAGAIN;
+		return -1;
+	}
+
+	if (msg->msg_name) {
+		int rv;
+
+		rv = sock_get_pkt_src(ctx, pkt, msg->msg_name,
+				      &msg->msg_namelen);
+		if (rv < 0) {
+			net_pkt_unref(pkt);
+			errno = -rv;
+			return -1;
+		}
+	}
+
+	data_len = net_pkt_remaining_data(pkt);
+
+	for (i = 0; i < msg->msg_iovlen && recv_len < data_len; i++) {
+		size_t len = MIN(msg->msg_iov[i].iov_len,
+				 data_len - recv_len);
+
+		if (net_pkt_read(pkt, msg->msg_iov[i].iov_base, len)) {
+			net_pkt_unref(pkt);
+			errno = ENOBUFS;
+			return -1;
+		}
+
+		recv_len += len;
+	}
+
+	msg->msg_flags = recv_len < data_len ? ZSOCK_MSG_TRUNC : 0;
+	msg->msg_controllen = 0;
+
+	net_pkt_unref(pkt);
+
+	return recv_len;
+}
+
+static ssize_t sock_recvmsg(void *ctx, const struct socket_op_vtable *vtable,
+			    struct msghdr *msg, int flags)
+{
+	if (vtable == &sock_fd_op_vtable &&
+	    net_context_get_type(ctx) == SOCK_DGRAM) {
+		return zsock_recvmsg_dgram(ctx, msg, flags);
+	}
+
+	if (vtable->recvfrom == NULL || msg->msg_iovlen != 1) {
+		errno = EOPNOTSUPP;
+		return -1;
+	}
+
+	msg->msg_flags = 0;
+	msg->msg_controllen = 0;
+
+	return vtable->recvfrom(ctx, msg->msg_iov[0].iov_base,
+				msg->msg_iov[0].iov_len, flags,
+				msg->msg_name,
+				msg->msg_name ? &msg->msg_namelen : NULL);
+}
+
+int z_impl_zsock_sendmmsg(int sock, struct mmsghdr *msgvec,
+			  unsigned int vlen, int flags)
+{
+	const struct socket_op_vtable *vtable;
+	unsigned int i;
+	ssize_t ret;
+	void *ctx;
+
+	ctx = get_sock_vtable(sock, &vtable);
+	if (ctx == NULL) {
+		return -1;
+	}
+
+	if (vtable->sendmsg == NULL) {
+		errno = EOPNOTSUPP;
+		return -1;
+	}
+
+	for (i = 0; i < vlen; i++) {
+		ret = vtable->sendmsg(ctx, &msgvec[i].msg_hdr, flags);
+		if (ret < 0) {
+			break;
+		}
+
+		msgvec[i].msg_len = ret;
+	}
+
+	return (i == 0 && vlen) ? -1 : i;
+}
+
+int z_impl_zsock_recvmmsg(int sock, struct mmsghdr *msgvec,
+			  unsigned int vlen, int flags)
+{
+	const struct socket_op_vtable *vtable;
+	unsigned int i;
+	ssize_t ret;
+	void *ctx;
+
+	ctx = get_sock_vtable(sock, &vtable);
+	if (ctx == NULL) {
+		return -1;
+	}
+
+	if (flags & ZSOCK_MSG_PEEK) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	for (i = 0; i < vlen; i++) {
+		ret = sock_recvmsg(ctx, vtable, &msgvec[i].msg_hdr, flags);
+		if (ret < 0) {
+			break;
+		}
+
+		msgvec[i].msg_len = ret;
+
+		/* Only the first datagram is waited for */
+		flags |= ZSOCK_MSG_DONTWAIT;
+	}
+
+	return (i == 0 && vlen) ? -1 : i;
+}
+
+#ifdef CONFIG_USERSPACE
+/* Most iovec entries per message accepted from user mode, as they are
+ * copied to the privileged stack.
+ */
+#define MMSG_USER_IOV_MAX 8
+
+/* Kernel copy of one user mode message header and what it points to */
+struct mmsg_user_copy {
+	struct msghdr msg;
+	struct iovec iov[MMSG_USER_IOV_MAX];
+	struct sockaddr_storage name;
+	void *user_name;
+	u64_t control[8];
+};
+
+static void mmsg_user_copy(struct mmsg_user_copy *copy,
+			   const struct msghdr *umsg, bool out)
+{
+	int i;
+
+	Z_OOPS(z_user_from_copy(&copy->msg, (void *)umsg, sizeof(copy->msg)));
+
+	Z_OOPS(Z_SYSCALL_VERIFY(copy->msg.msg_iovlen <= MMSG_USER_IOV_MAX));
+	Z_OOPS(z_user_from_copy(copy->iov, copy->msg.msg_iov,
+				copy->msg.msg_iovlen * sizeof(struct iovec)));
+	copy->msg.msg_iov = copy->iov;
+
+	for (i = 0; i < copy->msg.msg_iovlen; i++) {
+		Z_OOPS(Z_SYSCALL_MEMORY(copy->iov[i].iov_base,
+					copy->iov[i].iov_len, out));
+	}
+
+	copy->user_name = copy->msg.msg_name;
+
+	if (copy->msg.msg_name) {
+		Z_OOPS(Z_SYSCALL_VERIFY(copy->msg.msg_namelen <=
+					sizeof(copy->name)));
+		if (!out) {
+			Z_OOPS(z_user_from_copy(&copy->name,
+						copy->msg.msg_name,
+						copy->msg.msg_namelen));
+		}
+
+		copy->msg.msg_name = &copy->name;
+	}
+
+	if (!out && copy->msg.msg_control && copy->msg.msg_controllen) {
+		Z_OOPS(Z_SYSCALL_VERIFY(copy->msg.msg_controllen <=
+					sizeof(copy->control)));
+		Z_OOPS(z_user_from_copy(copy->control, copy->msg.msg_control,
+					copy->msg.msg_controllen));
+		copy->msg.msg_control = copy->control;
+	} else {
+		copy->msg.msg_control = NULL;
+		copy->msg.msg_controllen = 0;
+	}
+}
+
+static inline int z_vrfy_zsock_sendmmsg(int sock, struct mmsghdr *msgvec,
+					unsigned int vlen, int flags)
+{
+	const struct socket_op_vtable *vtable;
+	struct mmsg_user_copy copy;
+	unsigned int i;
+	void *ctx;
+	int ret;
+
+	ctx = get_sock_vtable(sock, &vtable);
+	if (ctx == NULL) {
+		return -1;
+	}
+
+	if (vtable->sendmsg == NULL) {
+		errno = EOPNOTSUPP;
+		return -1;
+	}
+
+	for (i = 0; i < vlen; i++) {
+		mmsg_user_copy(&copy, &msgvec[i].msg_hdr, false);
+
+		ret = vtable->sendmsg(ctx, &copy.msg, flags);
+		if (ret < 0) {
+			break;
+		}
+
+		Z_OOPS(z_user_to_copy(&msgvec[i].msg_len, &ret,
+				      sizeof(msgvec[i].msg_len)));
+	}
+
+	return (i == 0 && vlen) ? -1 : i;
+}
+#include <syscalls/zsock_sendmmsg_mrsh.c>
+
+static inline int z_vrfy_zsock_recvmmsg(int sock, struct mmsghdr *msgvec,
+					unsigned int vlen, int flags)
+{
+	const struct socket_op_vtable *vtable;
+	struct mmsg_user_copy copy;
+	struct msghdr *umsg;
+	socklen_t namelen;
+	unsigned int i;
+	void *ctx;
+	int ret;
+
+	ctx = get_sock_vtable(sock, &vtable);
+	if (ctx == NULL) {
+		return -1;
+	}
+
+	if (flags & ZSOCK_MSG_PEEK) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	for (i = 0; i < vlen; i++) {
+		umsg = &msgvec[i].msg_hdr;
+		mmsg_user_copy(&copy, umsg, true);
+		namelen = copy.msg.msg_namelen;
+
+		ret = sock_recvmsg(ctx, vtable, &copy.msg, flags);
+		if (ret < 0) {
+			break;
+		}
+
+		if (copy.msg.msg_name) {
+			Z_OOPS(z_user_to_copy(copy.user_name, &copy.name,
+					      MIN(namelen,
+						  copy.msg.msg_namelen)));
+			Z_OOPS(z_user_to_copy(&umsg->msg_namelen,
+					      &copy.msg.msg_namelen,
+					      sizeof(umsg->msg_namelen)));
+		}
+
+		Z_OOPS(z_user_to_copy(&umsg->msg_flags, &copy.msg.msg_flags,
+				      sizeof(umsg->msg_flags)));
+		Z_OOPS(z_user_to_copy(&umsg->msg_controllen,
+				      &copy.msg.msg_controllen,
+				      sizeof(umsg->msg_controllen)));
+		Z_OOPS(z_user_to_copy(&msgvec[i].msg_len, &ret,
+				      sizeof(msgvec[i].msg_len)));
+
+		flags |= ZSOCK_MSG_DONTWAIT;
+	}
+
+	return (i == 0 && vlen) ? -1 : i;
+}
+#include <syscalls/zsock_recvmmsg_mrsh.c>
+#endif /* CONFIG_USERSPACE */
+
+#if defined(CONFIG_NET_SOCKETS_ZEROCOPY)
+/* Take the buffers of a received packet from the cursor on, i.e. the
+ * unread payload. The buffers holding only headers are released, and
+ * the headers are pulled from the one the cursor is in.
+ */
+static struct net_buf *sock_pkt_detach_payload(struct net_pkt *pkt)
+{
+	struct net_buf *buf = pkt->buffer;
+
+	while (buf && buf != pkt->cursor.buf) {
+		buf = net_buf_frag_del(NULL, buf);
+	}
+
+	if (buf) {
+		net_buf_pull(buf, pkt->cursor.pos - buf->data);
+		if (!buf->len) {
+			buf = net_buf_frag_del(NULL, buf);
+		}
+	}
+
+	pkt->buffer = NULL;
+	net_pkt_cursor_init(pkt);
+
+	return buf;
+}
+
+ssize_t zsock_recvbuf(int sock, struct net_buf **frags, int flags,
+		      struct sockaddr *src_addr, socklen_t *addrlen)
+{
+	s32_t timeout = K_FOREVER;
+	enum net_sock_type sock_type;
+	struct net_context *ctx;
+	struct net_pkt *pkt;
+	size_t recv_len;
+
+	ctx = z_get_fd_obj(sock, (const struct fd_op_vtable *)
+				 &sock_fd_op_vtable, EOPNOTSUPP);
+	if (ctx == NULL) {
+		return -1;
+	}
+
+	if (!frags || (flags & ZSOCK_MSG_PEEK)) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	*frags = NULL;
+
+	sock_type = net_context_get_type(ctx);
+	if (sock_type != SOCK_DGRAM && sock_type != SOCK_STREAM) {
+		errno = EOPNOTSUPP;
+		return -1;
+	}
+
+	if (!net_context_is_used(ctx)) {
+		errno = EBADF;
+		return -1;
+	}
+
+	if ((flags & ZSOCK_MSG_DONTWAIT) || sock_is_nonblock(ctx)) {
+		timeout = K_NO_WAIT;
+	}
+
+	do {
+		if (sock_type == SOCK_STREAM && sock_is_eof(ctx)) {
+			return 0;
+		}
+
+		/* A stream packet partially read by zsock_recv() is taken
+		 * as well, its cursor is past the data already returned.
+		 */
+		pkt = k_fifo_get(&ctx->recv_q, timeout);
+		if (!pkt) {
+			/* Either timeout expired, or wait was cancelled
+			 * due to connection closure by peer.
+			 */
+			if (sock_type == SOCK_STREAM && sock_is_eof(ctx)) {
+				return 0;
+			}
+
+			errno = EAGAIN;
+			return -1;
+		}
+
+		if (sock_type == SOCK_DGRAM && src_addr && addrlen) {
+			int rv;
+
+			rv = sock_get_pkt_src(ctx, pkt, src_addr, addrlen);
+			if (rv < 0) {
+				net_pkt_unref(pkt);
+				errno = -rv;
+				return -1;
+			}
+		}
+
+		if (sock_type == SOCK_STREAM && net_pkt_eof(pkt)) {
+			sock_set_eof(ctx);
+		}
+
+		recv_len = net_pkt_remaining_data(pkt);
+		if (recv_len) {
+			*frags = sock_pkt_detach_payload(pkt);
+		}
+
+		net_pkt_unref(pkt);
+	} while (recv_len == 0 && sock_type == SOCK_STREAM);
+
+	if (sock_type == SOCK_STREAM) {
+		net_context_update_recv_wnd(ctx, recv_len);
+	}
+
+	return recv_len;
+}
+
+ssize_t zsock_sendbuf(int sock, struct net_buf *frags, int flags,
+		      const struct sockaddr *dest_addr, socklen_t addrlen)
+{
+	s32_t timeout = K_FOREVER;
+	struct net_context *ctx;
+	int status;
+
+	ctx = z_get_fd_obj(sock, (const struct fd_op_vtable *)
+				 &sock_fd_op_vtable, EOPNOTSUPP);
+	if (ctx == NULL) {
+		return -1;
+	}
+
+	if ((flags & ZSOCK_MSG_DONTWAIT) || sock_is_nonblock(ctx)) {
+		timeout = K_NO_WAIT;
+	}
+
+	/* Register the callback before sending in order to receive the response
+	 * from the peer.
+	 */
+	status = net_context_recv(ctx, zsock_received_cb,
+				  K_NO_WAIT, ctx->user_data);
+	if (status < 0) {
+		errno = -status;
+		return -1;
+	}
+
+	status = net_context_send_buf(ctx, frags, dest_addr, addrlen, NULL,
+				      timeout, ctx->user_data);
+	if (status < 0) {
+		errno = -status;
+		return -1;
+	}
+
+	return status;
+}
+#endif /* CONFIG_NET_SOCKETS_ZEROCOPY */
+
 /* As this is limited function, we don't follow POSIX signature, with
  * "..." instead of last arg.
  */
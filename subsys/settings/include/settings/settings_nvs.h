@@ -27,17 +27,37 @@ extern "C" {
  * Setting's name entries start from NVS_NAMECNT_ID + 1. The entry at
  * NVS_NAMECNT_ID is used to store the largest name ID in use.
  *
+ * The entry at NVS_JOURNAL_ID, which no setting's value uses, holds the names
+ * and values of a batch while they are written.
+ *
  * Deleted records will not be found, only the last record will be
  * read.
  */
 #define NVS_NAMECNT_ID 0x8000
 #define NVS_NAME_ID_OFFSET 0x4000
+#define NVS_JOURNAL_ID (NVS_NAMECNT_ID + NVS_NAME_ID_OFFSET)
+
+#if defined(CONFIG_SETTINGS_NVS_NAME_CACHE)
+/* Name cache entry, the hash of a setting's name and its name ID */
+struct settings_nvs_cache_entry {
+	u16_t name_hash;
+	u16_t name_id;
+};
+#endif
 
 struct settings_nvs {
 	struct settings_store cf_store;
 	struct nvs_fs cf_nvs;
 	u16_t last_name_id;
 	const char *flash_dev_name;
+#if defined(CONFIG_SETTINGS_NVS_NAME_CACHE)
+	/* Hash table of the stored names, used once it holds all of them */
+	struct settings_nvs_cache_entry
+		cache[CONFIG_SETTINGS_NVS_NAME_CACHE_SIZE];
+	bool cache_complete;
+	/* No name ID below this one is free */
+	u16_t free_name_id;
+#endif
 };
 
 /* register nvs to be a source of settings */
@@ -8,6 +8,7 @@
 #include <errno.h>
 #include <fs/fcb.h>
 #include <string.h>
+#include <sys/crc.h>
 
 #include "settings/settings.h"
 #include "settings/settings_fcb.h"
@@ -21,16 +22,27 @@ LOG_MODULE_DECLARE(settings, CONFIG_SETTINGS_LOG_LEVEL);
 struct settings_fcb_load_cb_arg {
 	line_load_cb cb;
 	void *cb_arg;
+	struct fcb *fcb;
+	struct fcb_entry batch; /* last batch marker */
+	bool pending; /* batch records read after it */
 };
 
 static int settings_fcb_load(struct settings_store *cs,
 			     const struct settings_load_arg *arg);
 static int settings_fcb_save(struct settings_store *cs, const char *name,
 			     const char *value, size_t val_len);
+#if defined(CONFIG_SETTINGS_BATCH)
+static int settings_fcb_save_batch(struct settings_store *cs,
+				   const struct settings_batch_entry *entries,
+				   int count);
+#endif
 
 static const struct settings_store_itf settings_fcb_itf = {
 	.csi_load = settings_fcb_load,
 	.csi_save = settings_fcb_save,
+#if defined(CONFIG_SETTINGS_BATCH)
+	.csi_save_batch = settings_fcb_save_batch,
+#endif
 };
 
 int settings_fcb_src(struct settings_fcb *cf)
@@ -79,6 +91,39 @@ int settings_fcb_dst(struct settings_fcb *cf)
 	return 0;
 }
 
+/*
+ * Apply the batch records that follow the last batch marker, once the commit
+ * marker at loc is read.
+ */
+static void settings_fcb_load_batch(struct settings_fcb_load_cb_arg *argp,
+				    const struct fcb_entry_ctx *loc)
+{
+	struct fcb_entry_ctx loc2;
+	char buf[SETTINGS_MAX_NAME_LEN + SETTINGS_EXTRA_LEN + 1];
+	size_t len_read;
+	int rc;
+
+	loc2.fap = loc->fap;
+	loc2.loc = argp->batch;
+
+	while (fcb_getnext(argp->fcb, &loc2.loc) == 0) {
+		if (loc2.loc.fe_sector == loc->loc.fe_sector &&
+		    loc2.loc.fe_elem_off == loc->loc.fe_elem_off) {
+			break;
+		}
+
+		rc = settings_line_name_read(buf, sizeof(buf), &len_read,
+					     &loc2);
+		if (rc || settings_line_kind(buf, len_read) !=
+			  SETTINGS_LINE_BATCH) {
+			continue;
+		}
+		buf[len_read] = '\0';
+
+		argp->cb(buf + 1, &loc2, len_read + 1, argp->cb_arg);
+	}
+}
+
 static int settings_fcb_load_cb(struct fcb_entry_ctx *entry_ctx, void *arg)
 {
 	struct settings_fcb_load_cb_arg *argp;
@@ -96,9 +141,26 @@ static int settings_fcb_load_cb(struct fcb_entry_ctx *entry_ctx, void *arg)
 	}
 	buf[len_read] = '\0';
 
-	/*name, val-read_cb-ctx, val-off*/
-	/* take into account '=' separator after the name */
-	argp->cb(buf, (void *)&entry_ctx->loc, len_read + 1, argp->cb_arg);
+	switch (settings_line_kind(buf, len_read)) {
+	case SETTINGS_LINE_BATCH:
+		argp->pending = true;
+		break;
+	case SETTINGS_LINE_COMMIT:
+		if (argp->pending) {
+			settings_fcb_load_batch(argp, entry_ctx);
+		}
+		/* fall through */
+	case SETTINGS_LINE_BEGIN:
+		argp->batch = entry_ctx->loc;
+		argp->pending = false;
+		break;
+	default:
+		/*name, val-read_cb-ctx, val-off*/
+		/* take into account '=' separator after the name */
+		argp->cb(buf, (void *)&entry_ctx->loc, len_read + 1,
+			 argp->cb_arg);
+		break;
+	}
 	return 0;
 }
 
@@ -111,6 +173,10 @@ static int settings_fcb_load_priv(struct settings_store *cs, line_load_cb cb,
 
 	arg.cb = cb;
 	arg.cb_arg = cb_arg;
+	arg.fcb = &cf->cf_fcb;
+	arg.batch.fe_sector = NULL;
+	arg.batch.fe_elem_off = 0U;
+	arg.pending = false;
 	rc = fcb_walk(&cf->cf_fcb, 0, settings_fcb_load_cb, &arg);
 	if (rc) {
 		return -EINVAL;
@@ -143,15 +209,191 @@ static int read_handler(void *ctx, off_t off, char *buf, size_t *len)
 			       *len);
 }
 
+/*
+ * Check if a record of the oldest sector is the newest one of its name, by
+ * reading all the records following it. Deletion records and batch markers
+ * are not live. Once live, live tells whether it is a committed batch record.
+ */
+static bool settings_fcb_is_live(struct settings_fcb *cf,
+				 const struct fcb_entry_ctx *loc1,
+				 struct settings_line_live *live)
+{
+	struct fcb_entry_ctx loc2;
+	char name1[SETTINGS_MAX_NAME_LEN + SETTINGS_EXTRA_LEN];
+	char name2[SETTINGS_MAX_NAME_LEN + SETTINGS_EXTRA_LEN];
+	enum settings_line_kind kind1;
+	enum settings_line_kind kind2;
+	size_t val1_off;
+	size_t val2_off;
+	size_t skip1;
+	size_t skip2;
+	int rc;
+
+	rc = settings_line_name_read(name1, sizeof(name1), &val1_off,
+				     (void *)loc1);
+	if (rc) {
+		return false;
+	}
+
+	kind1 = settings_line_kind(name1, val1_off);
+	if (kind1 == SETTINGS_LINE_BEGIN || kind1 == SETTINGS_LINE_COMMIT) {
+		return false;
+	}
+
+	if (kind1 == SETTINGS_LINE_PLAIN &&
+	    val1_off + 1 == loc1->loc.fe_data_len) {
+		/* Lack of a value so the record is a deletion-record */
+		/* No sense to copy empty entry from */
+		/* the oldest sector */
+		return false;
+	}
+
+	settings_line_live_init(live, kind1);
+	skip1 = (kind1 == SETTINGS_LINE_BATCH);
+	loc2 = *loc1;
+
+	while (fcb_getnext(&cf->cf_fcb, &loc2.loc) == 0) {
+		rc = settings_line_name_read(name2, sizeof(name2), &val2_off,
+					     &loc2);
+		if (rc) {
+			continue;
+		}
+
+		kind2 = settings_line_kind(name2, val2_off);
+		skip2 = (kind2 == SETTINGS_LINE_BATCH);
+		if (!settings_line_live_next(live, kind2,
+				val1_off - skip1 == val2_off - skip2 &&
+				!memcmp(name1 + skip1, name2 + skip2,
+					val1_off - skip1))) {
+			return false;
+		}
+	}
+
+	if (!settings_line_live_end(live)) {
+		return false;
+	}
+
+	/* Nor are committed deletion batch records */
+	return !live->committed || val1_off + 1 != loc1->loc.fe_data_len;
+}
+
+#if CONFIG_SETTINGS_FCB_COMPRESS_RECORDS > 0
+/* Records of the oldest sector, data_len is 0 once they are not live */
+static struct settings_fcb_live {
+	u32_t data_off;
+	u16_t data_len;
+	u16_t hash;
+} settings_fcb_live[CONFIG_SETTINGS_FCB_COMPRESS_RECORDS];
+
+static u16_t settings_fcb_name_hash(const char *name, size_t len)
+{
+	return crc16_ccitt(0xffff, (const u8_t *)name, len);
+}
+
+/*
+ * Clear the live record of the oldest sector with the same name as a later
+ * record, if any. Only the names with the same hash are read.
+ */
+static void settings_fcb_live_clear(struct settings_fcb *cf, int count,
+				    const char *name, size_t name_len,
+				    u16_t hash)
+{
+	struct fcb_entry_ctx loc;
+	char name2[SETTINGS_MAX_NAME_LEN + SETTINGS_EXTRA_LEN];
+	size_t name2_len;
+	int rc;
+
+	loc.fap = cf->cf_fcb.fap;
+	loc.loc.fe_sector = cf->cf_fcb.f_oldest;
+
+	for (int i = 0; i < count; i++) {
+		if (!settings_fcb_live[i].data_len ||
+		    settings_fcb_live[i].hash != hash) {
+			continue;
+		}
+
+		loc.loc.fe_data_off = settings_fcb_live[i].data_off;
+		loc.loc.fe_data_len = settings_fcb_live[i].data_len;
+
+		rc = settings_line_name_read(name2, sizeof(name2), &name2_len,
+					     &loc);
+		if (rc || name2_len != name_len ||
+		    memcmp(name, name2, name_len)) {
+			continue;
+		}
+
+		/* There is at most one live record per name */
+		settings_fcb_live[i].data_len = 0U;
+		break;
+	}
+}
+
+/*
+ * Find the live records of the oldest sector with one pass over all the
+ * records. Returns the number of records of the oldest sector tracked.
+ */
+static int settings_fcb_live_fill(struct settings_fcb *cf)
+{
+	struct fcb_entry_ctx loc;
+	char name[SETTINGS_MAX_NAME_LEN + SETTINGS_EXTRA_LEN];
+	size_t val_off;
+	u16_t hash = 0U;
+	int count = 0;
+	int rc;
+
+	loc.fap = cf->cf_fcb.fap;
+	loc.loc.fe_sector = NULL;
+	loc.loc.fe_elem_off = 0U;
+
+	while (fcb_getnext(&cf->cf_fcb, &loc.loc) == 0) {
+		rc = settings_line_name_read(name, sizeof(name), &val_off,
+					     &loc);
+		if (!rc && settings_line_kind(name, val_off) !=
+			   SETTINGS_LINE_PLAIN) {
+			/* Left to settings_fcb_is_live(), batch aware */
+			return 0;
+		}
+
+		if (!rc) {
+			hash = settings_fcb_name_hash(name, val_off);
+			settings_fcb_live_clear(cf, count, name, val_off,
+						hash);
+		}
+
+		if (loc.loc.fe_sector != cf->cf_fcb.f_oldest ||
+		    count == ARRAY_SIZE(settings_fcb_live)) {
+			continue;
+		}
+
+		settings_fcb_live[count].data_off = loc.loc.fe_data_off;
+		settings_fcb_live[count].hash = hash;
+		if (rc || val_off + 1 == loc.loc.fe_data_len) {
+			/* Unreadable or deletion record */
+			settings_fcb_live[count].data_len = 0U;
+		} else {
+			settings_fcb_live[count].data_len =
+				loc.loc.fe_data_len;
+		}
+		count++;
+	}
+
+	return count;
+}
+#endif
+
 static void settings_fcb_compress(struct settings_fcb *cf)
 {
 	int rc;
 	struct fcb_entry_ctx loc1;
 	struct fcb_entry_ctx loc2;
-	char name1[SETTINGS_MAX_NAME_LEN + SETTINGS_EXTRA_LEN];
-	char name2[SETTINGS_MAX_NAME_LEN + SETTINGS_EXTRA_LEN];
-	int copy;
+	struct settings_line_live state;
+	size_t skip;
+	bool live;
 	u8_t rbs;
+#if CONFIG_SETTINGS_FCB_COMPRESS_RECORDS > 0
+	int live_count;
+	int i = 0;
+#endif
 
 	rc = fcb_append_to_scratch(&cf->cf_fcb);
 	if (rc) {
@@ -160,6 +402,10 @@ static void settings_fcb_compress(struct settings_fcb *cf)
 
 	rbs = flash_area_align(cf->cf_fcb.fap);
 
+#if CONFIG_SETTINGS_FCB_COMPRESS_RECORDS > 0
+	live_count = settings_fcb_live_fill(cf);
+#endif
+
 	loc1.fap = cf->cf_fcb.fap;
 
 	loc1.loc.fe_sector = NULL;
@@ -170,53 +416,35 @@ static void settings_fcb_compress(struct settings_fcb *cf)
 			break;
 		}
 
-		size_t val1_off;
-
-		rc = settings_line_name_read(name1, sizeof(name1), &val1_off,
-					     &loc1);
-		if (rc) {
-			continue;
-		}
-
-		if (val1_off + 1 == loc1.loc.fe_data_len) {
-			/* Lack of a value so the record is a deletion-record */
-			/* No sense to copy empty entry from */
-			/* the oldest sector */
-			continue;
-		}
-
-		loc2 = loc1;
-		copy = 1;
-
-		while (fcb_getnext(&cf->cf_fcb, &loc2.loc) == 0) {
-			size_t val2_off;
-
-			rc = settings_line_name_read(name2, sizeof(name2),
-						     &val2_off, &loc2);
-			if (rc) {
-				continue;
-			}
-
-			if ((val1_off == val2_off) &&
-			    !memcmp(name1, name2, val1_off)) {
-				copy = 0;
-				break;
-			}
+		skip = 0;
+#if CONFIG_SETTINGS_FCB_COMPRESS_RECORDS > 0
+		if (i < live_count) {
+			live = settings_fcb_live[i++].data_len != 0U;
+		} else {
+			live = settings_fcb_is_live(cf, &loc1, &state);
+			skip = live && state.committed;
 		}
-		if (!copy) {
+#else
+		live = settings_fcb_is_live(cf, &loc1, &state);
+		skip = live && state.committed;
+#endif
+		if (!live) {
 			continue;
 		}
 
 		/*
-		 * Can't find one. Must copy.
+		 * Can't find one. Must copy. A committed batch record is
+		 * copied without the batch prefix.
 		 */
-		rc = fcb_append(&cf->cf_fcb, loc1.loc.fe_data_len, &loc2.loc);
+		rc = fcb_append(&cf->cf_fcb, loc1.loc.fe_data_len - skip,
+				&loc2.loc);
 		if (rc) {
 			continue;
 		}
 
-		rc = settings_line_entry_copy(&loc2, 0, &loc1, 0,
-					      loc1.loc.fe_data_len);
+		loc2.fap = cf->cf_fcb.fap;
+		rc = settings_line_entry_copy(&loc2, 0, &loc1, skip,
+					      loc1.loc.fe_data_len - skip);
 		if (rc) {
 			continue;
 		}
@@ -314,6 +542,26 @@ static int settings_fcb_save(struct settings_store *cs, const char *name,
 	return settings_fcb_save_priv(cs, name, (char *)value, val_len);
 }
 
+#if defined(CONFIG_SETTINGS_BATCH)
+/* ::csi_save_batch implementation */
+static int settings_fcb_save_batch(struct settings_store *cs,
+				   const struct settings_batch_entry *entries,
+				   int count)
+{
+	struct settings_line_batch_dup_check_arg cdca;
+
+	/*
+	 * Check which values we're writing again, all in one pass.
+	 */
+	cdca.entries = entries;
+	cdca.count = count;
+	(void)memset(cdca.is_dup, 0, sizeof(cdca.is_dup));
+	settings_fcb_load_priv(cs, settings_line_batch_dup_check_cb, &cdca);
+
+	return settings_line_batch_save(cs, &cdca, settings_fcb_save_priv);
+}
+#endif
+
 void settings_mount_fcb_backend(struct settings_fcb *cf)
 {
 	u8_t rbs;
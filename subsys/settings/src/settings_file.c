@@ -18,10 +18,19 @@ static int settings_file_load(struct settings_store *cs,
 			      const struct settings_load_arg *arg);
 static int settings_file_save(struct settings_store *cs, const char *name,
 			      const char *value, size_t val_len);
+static int write_handler(void *ctx, off_t off, char const *buf, size_t len);
+#if defined(CONFIG_SETTINGS_BATCH)
+static int settings_file_save_batch(struct settings_store *cs,
+				    const struct settings_batch_entry *entries,
+				    int count);
+#endif
 
 static const struct settings_store_itf settings_file_itf = {
 	.csi_load = settings_file_load,
 	.csi_save = settings_file_save,
+#if defined(CONFIG_SETTINGS_BATCH)
+	.csi_save_batch = settings_file_save_batch,
+#endif
 };
 
 /*
@@ -50,6 +59,33 @@ int settings_file_dst(struct settings_file *cf)
 }
 
 
+/*
+ * Apply the batch lines that follow the last batch marker, once the commit
+ * marker at commit is read.
+ */
+static void settings_file_load_batch(const struct line_entry_ctx *batch,
+				     const struct line_entry_ctx *commit,
+				     line_load_cb cb, void *cb_arg)
+{
+	struct line_entry_ctx loc = *batch;
+	char buf[SETTINGS_MAX_NAME_LEN + SETTINGS_EXTRA_LEN + 1];
+	size_t len_read;
+	int rc;
+
+	while (settings_next_line_ctx(&loc) == 0 && loc.len != 0 &&
+	       loc.seek != commit->seek) {
+		rc = settings_line_name_read(buf, sizeof(buf), &len_read,
+					     &loc);
+		if (rc || settings_line_kind(buf, len_read) !=
+			  SETTINGS_LINE_BATCH) {
+			continue;
+		}
+		buf[len_read] = '\0';
+
+		cb(buf + 1, (void *)&loc, len_read + 1, cb_arg);
+	}
+}
+
 static int settings_file_load_priv(struct settings_store *cs, line_load_cb cb,
 				   void *cb_arg)
 {
@@ -67,6 +103,8 @@ static int settings_file_load_priv(struct settings_store *cs, line_load_cb cb,
 		.seek = 0,
 		.len = 0 /* unknown length */
 	};
+	struct line_entry_ctx batch = entry_ctx; /* last batch marker */
+	bool pending = false; /* batch lines read after it */
 
 	lines = 0;
 
@@ -95,9 +133,26 @@ static int settings_file_load_priv(struct settings_store *cs, line_load_cb cb,
 		}
 		buf[len_read] = '\0';
 
-		/*name, val-read_cb-ctx, val-off*/
-		/* take into account '=' separator after the name */
-		cb(buf, (void *)&entry_ctx, len_read + 1, cb_arg);
+		switch (settings_line_kind(buf, len_read)) {
+		case SETTINGS_LINE_BATCH:
+			pending = true;
+			break;
+		case SETTINGS_LINE_COMMIT:
+			if (pending) {
+				settings_file_load_batch(&batch, &entry_ctx, cb,
+							 cb_arg);
+			}
+			/* fall through */
+		case SETTINGS_LINE_BEGIN:
+			batch = entry_ctx;
+			pending = false;
+			break;
+		default:
+			/*name, val-read_cb-ctx, val-off*/
+			/* take into account '=' separator after the name */
+			cb(buf, (void *)&entry_ctx, len_read + 1, cb_arg);
+			break;
+		}
 		lines++;
 	}
 
@@ -173,10 +228,16 @@ int settings_file_save_and_compress(struct settings_file *cf, const char *name,
 		.stor_ctx = &wf
 	};
 
+	struct settings_line_live live;
+	enum settings_line_kind kind1;
+	enum settings_line_kind kind2;
+	u16_t len_field;
 	int copy;
 	int lines;
 	size_t new_name_len;
 	size_t val1_off;
+	size_t skip1;
+	size_t skip2;
 
 	if (fs_open(&rf, cf->cf_name) != 0) {
 		return -ENOEXEC;
@@ -207,19 +268,21 @@ int settings_file_save_and_compress(struct settings_file *cf, const char *name,
 			continue;
 		}
 
-		if (val1_off + 1 == loc1.len) {
-			/* Lack of a value so the record is a deletion-record */
-			/* No sense to copy empty entry from */
-			/* the oldest sector */
+		kind1 = settings_line_kind(name1, val1_off);
+		if (kind1 == SETTINGS_LINE_BEGIN ||
+		    kind1 == SETTINGS_LINE_COMMIT) {
 			continue;
 		}
 
-		/* avoid copping value which will be overwritten by new value*/
-		if ((val1_off == new_name_len) &&
-		    !memcmp(name1, name, val1_off)) {
+		if (kind1 == SETTINGS_LINE_PLAIN && val1_off + 1 == loc1.len) {
+			/* Lack of a value so the record is a deletion-record */
+			/* No sense to copy empty entry from */
+			/* the oldest sector */
 			continue;
 		}
 
+		settings_line_live_init(&live, kind1);
+		skip1 = (kind1 == SETTINGS_LINE_BATCH);
 		loc2 = loc1;
 
 		copy = 1;
@@ -240,8 +303,13 @@ int settings_file_save_and_compress(struct settings_file *cf, const char *name,
 				/* try to process next line */
 				continue;
 			}
-			if ((val1_off == val2_off) &&
-			    !memcmp(name1, name2, val1_off)) {
+
+			kind2 = settings_line_kind(name2, val2_off);
+			skip2 = (kind2 == SETTINGS_LINE_BATCH);
+			if (!settings_line_live_next(&live, kind2,
+				val1_off - skip1 == val2_off - skip2 &&
+				!memcmp(name1 + skip1, name2 + skip2,
+					val1_off - skip1))) {
 				copy = 0; /* newer version doesn't exist */
 				break;
 			}
@@ -250,10 +318,38 @@ int settings_file_save_and_compress(struct settings_file *cf, const char *name,
 			continue;
 		}
 
-		loc2 = loc1;
-		loc2.len += 2;
-		loc2.seek -= 2;
-		rc = settings_line_entry_copy(&loc3, 0, &loc2, 0, loc2.len);
+		/* avoid copping value which will be overwritten by new value*/
+		kind2 = settings_line_kind(name, new_name_len);
+		skip2 = (kind2 == SETTINGS_LINE_BATCH);
+		if (!settings_line_live_next(&live, kind2,
+				val1_off - skip1 == new_name_len - skip2 &&
+				!memcmp(name1 + skip1, name + skip2,
+					val1_off - skip1)) ||
+		    !settings_line_live_end(&live)) {
+			continue;
+		}
+
+		if (live.committed) {
+			if (val1_off + 1 == loc1.len) {
+				/* Committed batch deletion-record */
+				continue;
+			}
+
+			/* Copied without the batch prefix */
+			len_field = loc1.len - 1;
+			rc = write_handler(&loc3, 0, (char *)&len_field,
+					   sizeof(len_field));
+			if (!rc) {
+				rc = settings_line_entry_copy(&loc3, 0, &loc1,
+							      1, len_field);
+			}
+		} else {
+			loc2 = loc1;
+			loc2.len += 2;
+			loc2.seek -= 2;
+			rc = settings_line_entry_copy(&loc3, 0, &loc2, 0,
+						      loc2.len);
+		}
 		if (rc) {
 			/* compressed file might be corrupted */
 			goto end_rolback;
@@ -366,6 +462,26 @@ static int settings_file_save(struct settings_store *cs, const char *name,
 	return settings_file_save_priv(cs, name, (char *)value, val_len);
 }
 
+#if defined(CONFIG_SETTINGS_BATCH)
+/* ::csi_save_batch implementation */
+static int settings_file_save_batch(struct settings_store *cs,
+				    const struct settings_batch_entry *entries,
+				    int count)
+{
+	struct settings_line_batch_dup_check_arg cdca;
+
+	/*
+	 * Check which values we're writing again, all in one pass.
+	 */
+	cdca.entries = entries;
+	cdca.count = count;
+	(void)memset(cdca.is_dup, 0, sizeof(cdca.is_dup));
+	settings_file_load_priv(cs, settings_line_batch_dup_check_cb, &cdca);
+
+	return settings_line_batch_save(cs, &cdca, settings_file_save_priv);
+}
+#endif
+
 static int read_handler(void *ctx, off_t off, char *buf, size_t *len)
 {
 	struct line_entry_ctx *entry_ctx = ctx;
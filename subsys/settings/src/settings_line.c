@@ -449,6 +449,72 @@ int settings_line_entry_copy(void *dst_ctx, off_t dst_off, void *src_ctx,
 	return rc;
 }
 
+enum settings_line_kind settings_line_kind(const char *name, size_t len)
+{
+	if (len == 1 && name[0] == SETTINGS_BATCH_BEGIN) {
+		return SETTINGS_LINE_BEGIN;
+	}
+
+	if (len == 1 && name[0] == SETTINGS_BATCH_COMMIT) {
+		return SETTINGS_LINE_COMMIT;
+	}
+
+	if (len > 1 && name[0] == SETTINGS_BATCH_PREFIX) {
+		return SETTINGS_LINE_BATCH;
+	}
+
+	return SETTINGS_LINE_PLAIN;
+}
+
+void settings_line_live_init(struct settings_line_live *live,
+			     enum settings_line_kind kind)
+{
+	live->kind = kind;
+	live->committed = false;
+	live->pending = false;
+}
+
+bool settings_line_live_next(struct settings_line_live *live,
+			     enum settings_line_kind kind, bool same_name)
+{
+	switch (kind) {
+	case SETTINGS_LINE_BEGIN:
+		/* The batch the record belongs to was never committed */
+		if (live->kind == SETTINGS_LINE_BATCH && !live->committed) {
+			return false;
+		}
+
+		live->pending = false;
+		return true;
+	case SETTINGS_LINE_COMMIT:
+		if (live->kind == SETTINGS_LINE_BATCH) {
+			live->committed = true;
+		}
+
+		return !live->pending;
+	case SETTINGS_LINE_BATCH:
+		if (same_name) {
+			live->pending = true;
+		}
+
+		return true;
+	default:
+		/*
+		 * Applied when read, which is before a batch record not
+		 * committed yet.
+		 */
+		return !same_name || (live->kind == SETTINGS_LINE_BATCH &&
+				      !live->committed);
+	}
+}
+
+bool settings_line_live_end(const struct settings_line_live *live)
+{
+	/* A later record of the same batch replaces it */
+	return !live->pending || live->kind != SETTINGS_LINE_BATCH ||
+	       live->committed;
+}
+
 void settings_line_io_init(int (*read_cb)(void *ctx, off_t off, char *buf,
 					  size_t *len),
 			  int (*write_cb)(void *ctx, off_t off, char const *buf,
@@ -497,33 +563,114 @@ static int settings_line_cmp(char const *val, size_t val_len,
 	return rc;
 }
 
+/* Check whether the value at off is val, returns 1 if it is, 0 if not */
+static int settings_line_is_dup(const char *val, size_t val_len,
+				void *val_read_cb_ctx, off_t off)
+{
+	size_t len_read;
+
+	len_read = settings_line_val_get_len(off, val_read_cb_ctx);
+	if (len_read != val_len) {
+		return 0;
+	} else if (len_read == 0) {
+		return 1;
+	}
+
+	return !settings_line_cmp(val, val_len, val_read_cb_ctx, off);
+}
+
 int settings_line_dup_check_cb(const char *name, void *val_read_cb_ctx,
 				off_t off, void *cb_arg)
 {
 	struct settings_line_dup_check_arg *cdca;
-	size_t len_read;
 
 	cdca = (struct settings_line_dup_check_arg *)cb_arg;
 	if (strcmp(name, cdca->name)) {
 		return 0;
 	}
 
-	len_read = settings_line_val_get_len(off, val_read_cb_ctx);
-	if (len_read != cdca->val_len) {
-		cdca->is_dup = 0;
-	} else if (len_read == 0) {
-		cdca->is_dup = 1;
-	} else {
-		if (!settings_line_cmp(cdca->val, cdca->val_len,
-				       val_read_cb_ctx, off)) {
-			cdca->is_dup = 1;
-		} else {
-			cdca->is_dup = 0;
+	cdca->is_dup = settings_line_is_dup(cdca->val, cdca->val_len,
+					    val_read_cb_ctx, off);
+	return 0;
+}
+
+#if defined(CONFIG_SETTINGS_BATCH)
+int settings_line_batch_dup_check_cb(const char *name, void *val_read_cb_ctx,
+				      off_t off, void *cb_arg)
+{
+	struct settings_line_batch_dup_check_arg *cdca;
+	const struct settings_batch_entry *e;
+
+	cdca = (struct settings_line_batch_dup_check_arg *)cb_arg;
+	for (int i = 0; i < cdca->count; i++) {
+		e = &cdca->entries[i];
+		if (!strcmp(name, e->name)) {
+			cdca->is_dup[i] = settings_line_is_dup(e->value,
+							       e->val_len,
+							       val_read_cb_ctx,
+							       off);
+			break;
 		}
 	}
 	return 0;
 }
 
+int settings_line_batch_save(struct settings_store *cs,
+		const struct settings_line_batch_dup_check_arg *cdca,
+		settings_line_save_fn save)
+{
+	const char begin[] = { SETTINGS_BATCH_BEGIN, '\0' };
+	const char commit[] = { SETTINGS_BATCH_COMMIT, '\0' };
+	char name[SETTINGS_MAX_NAME_LEN + SETTINGS_EXTRA_LEN + 1];
+	const struct settings_batch_entry *e;
+	int count = 0;
+	int last = 0;
+	int rc;
+
+	for (int i = 0; i < cdca->count; i++) {
+		if (cdca->is_dup[i]) {
+			continue;
+		}
+
+		if (strlen(cdca->entries[i].name) + 1 >= sizeof(name)) {
+			return -EINVAL;
+		}
+
+		last = i;
+		count++;
+	}
+
+	if (count == 0) {
+		return 0;
+	}
+
+	if (count == 1) {
+		/* A single record needs no markers */
+		e = &cdca->entries[last];
+		return save(cs, e->name, (const char *)e->value, e->val_len);
+	}
+
+	rc = save(cs, begin, NULL, 0);
+
+	for (int i = 0; i < cdca->count && !rc; i++) {
+		if (cdca->is_dup[i]) {
+			continue;
+		}
+
+		e = &cdca->entries[i];
+		name[0] = SETTINGS_BATCH_PREFIX;
+		strcpy(&name[1], e->name);
+		rc = save(cs, name, (const char *)e->value, e->val_len);
+	}
+
+	if (rc) {
+		return rc;
+	}
+
+	return save(cs, commit, NULL, 0);
+}
+#endif
+
 static ssize_t settings_line_read_cb(void *cb_arg, void *data, size_t len)
 {
 	struct settings_line_read_value_cb_ctx *value_context = cb_arg;
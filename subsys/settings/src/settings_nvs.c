@@ -7,6 +7,7 @@
 
 #include <errno.h>
 #include <string.h>
+#include <sys/crc.h>
 
 #include "settings/settings.h"
 #include "settings/settings_nvs.h"
@@ -24,12 +25,119 @@ static int settings_nvs_load(struct settings_store *cs,
 			     const struct settings_load_arg *arg);
 static int settings_nvs_save(struct settings_store *cs, const char *name,
 			     const char *value, size_t val_len);
+#if defined(CONFIG_SETTINGS_BATCH)
+static int settings_nvs_save_batch(struct settings_store *cs,
+				   const struct settings_batch_entry *entries,
+				   int count);
+#endif
 
 static struct settings_store_itf settings_nvs_itf = {
 	.csi_load = settings_nvs_load,
 	.csi_save = settings_nvs_save,
+#if defined(CONFIG_SETTINGS_BATCH)
+	.csi_save_batch = settings_nvs_save_batch,
+#endif
 };
 
+#if defined(CONFIG_SETTINGS_NVS_NAME_CACHE)
+/* Name IDs start above NVS_NAMECNT_ID, which marks a freed cache entry */
+#define SETTINGS_NVS_CACHE_EMPTY 0
+#define SETTINGS_NVS_CACHE_FREED NVS_NAMECNT_ID
+
+static u16_t settings_nvs_cache_hash(const char *name)
+{
+	return crc16_ccitt(0xffff, (const u8_t *)name, strlen(name));
+}
+
+/* Add a name to the cache, the cache entries following the one the hash
+ * points to are used in turn when it is taken.
+ */
+static int settings_nvs_cache_add(struct settings_nvs *cf, const char *name,
+				  u16_t name_id)
+{
+	struct settings_nvs_cache_entry *entry;
+	u16_t name_hash = settings_nvs_cache_hash(name);
+	size_t pos = name_hash % CONFIG_SETTINGS_NVS_NAME_CACHE_SIZE;
+
+	for (size_t i = 0; i < CONFIG_SETTINGS_NVS_NAME_CACHE_SIZE; i++) {
+		entry = &cf->cache[pos];
+		if ((entry->name_id == SETTINGS_NVS_CACHE_EMPTY) ||
+		    (entry->name_id == SETTINGS_NVS_CACHE_FREED)) {
+			entry->name_hash = name_hash;
+			entry->name_id = name_id;
+			return 0;
+		}
+
+		pos = (pos + 1) % CONFIG_SETTINGS_NVS_NAME_CACHE_SIZE;
+	}
+
+	return -ENOMEM;
+}
+
+/* Find the cache entry of a name, reading the names with the same hash */
+static struct settings_nvs_cache_entry *
+settings_nvs_cache_find(struct settings_nvs *cf, const char *name,
+			char *rdname, size_t len)
+{
+	struct settings_nvs_cache_entry *entry;
+	u16_t name_hash = settings_nvs_cache_hash(name);
+	size_t pos = name_hash % CONFIG_SETTINGS_NVS_NAME_CACHE_SIZE;
+	ssize_t rc;
+
+	for (size_t i = 0; i < CONFIG_SETTINGS_NVS_NAME_CACHE_SIZE; i++) {
+		entry = &cf->cache[pos];
+		pos = (pos + 1) % CONFIG_SETTINGS_NVS_NAME_CACHE_SIZE;
+
+		if (entry->name_id == SETTINGS_NVS_CACHE_EMPTY) {
+			break;
+		}
+
+		if ((entry->name_id == SETTINGS_NVS_CACHE_FREED) ||
+		    (entry->name_hash != name_hash)) {
+			continue;
+		}
+
+		rc = nvs_read(&cf->cf_nvs, entry->name_id, rdname, len - 1);
+		if (rc < 0) {
+			continue;
+		}
+
+		rdname[MIN(rc, len - 1)] = '\0';
+		if (!strcmp(name, rdname)) {
+			return entry;
+		}
+	}
+
+	return NULL;
+}
+
+/* Lowest name ID no cached name uses, or 0 if all IDs up to last_name_id
+ * are in use. Only valid while the cache is complete.
+ */
+static u16_t settings_nvs_cache_free_id(struct settings_nvs *cf)
+{
+	u16_t name_id;
+	size_t i;
+
+	for (name_id = cf->free_name_id; name_id <= cf->last_name_id;
+	     name_id++) {
+		for (i = 0; i < CONFIG_SETTINGS_NVS_NAME_CACHE_SIZE; i++) {
+			if (cf->cache[i].name_id == name_id) {
+				break;
+			}
+		}
+
+		if (i == CONFIG_SETTINGS_NVS_NAME_CACHE_SIZE) {
+			break;
+		}
+	}
+
+	cf->free_name_id = name_id;
+
+	return name_id <= cf->last_name_id ? name_id : 0;
+}
+#endif
+
 static ssize_t settings_nvs_read_fn(void *back_end, void *data, size_t len)
 {
 	struct settings_nvs_read_fn_arg *rd_fn_arg;
@@ -73,6 +181,13 @@ static int settings_nvs_load(struct settings_store *cs,
 	char buf;
 	ssize_t rc1, rc2;
 	u16_t name_id = NVS_NAMECNT_ID;
+#if defined(CONFIG_SETTINGS_NVS_NAME_CACHE)
+	bool cache_full = false;
+
+	(void)memset(cf->cache, 0, sizeof(cf->cache));
+	cf->cache_complete = false;
+	cf->free_name_id = cf->last_name_id + 1;
+#endif
 
 	name_id = cf->last_name_id + 1;
 
@@ -92,6 +207,9 @@ static int settings_nvs_load(struct settings_store *cs,
 			       &buf, sizeof(buf));
 
 		if ((rc1 <= 0) && (rc2 <= 0)) {
+#if defined(CONFIG_SETTINGS_NVS_NAME_CACHE)
+			cf->free_name_id = name_id;
+#endif
 			continue;
 		}
 
@@ -108,11 +226,20 @@ static int settings_nvs_load(struct settings_store *cs,
 			}
 			nvs_delete(&cf->cf_nvs, name_id);
 			nvs_delete(&cf->cf_nvs, name_id + NVS_NAME_ID_OFFSET);
+#if defined(CONFIG_SETTINGS_NVS_NAME_CACHE)
+			cf->free_name_id = name_id;
+#endif
 			continue;
 		}
 
 		/* Found a name, this might not include a trailing \0 */
 		name[rc1] = '\0';
+
+#if defined(CONFIG_SETTINGS_NVS_NAME_CACHE)
+		if (settings_nvs_cache_add(cf, name, name_id)) {
+			cache_full = true;
+		}
+#endif
 		read_fn_arg.fs = &cf->cf_nvs;
 		read_fn_arg.id = name_id + NVS_NAME_ID_OFFSET;
 
@@ -124,6 +251,12 @@ static int settings_nvs_load(struct settings_store *cs,
 			break;
 		}
 	}
+
+#if defined(CONFIG_SETTINGS_NVS_NAME_CACHE)
+	/* Saves only rely on the cache if it holds every stored name */
+	cf->cache_complete = !ret && !cache_full;
+#endif
+
 	return ret;
 }
 
@@ -133,8 +266,11 @@ static int settings_nvs_save(struct settings_store *cs, const char *name,
 	struct settings_nvs *cf = (struct settings_nvs *)cs;
 	char rdname[SETTINGS_MAX_NAME_LEN + SETTINGS_EXTRA_LEN + 1];
 	u16_t name_id, write_name_id;
-	bool delete, write_name;
+	bool delete, write_name, found = false;
 	int rc = 0;
+#if defined(CONFIG_SETTINGS_NVS_NAME_CACHE)
+	struct settings_nvs_cache_entry *entry = NULL;
+#endif
 
 	if (!name) {
 		return -EINVAL;
@@ -147,7 +283,29 @@ static int settings_nvs_save(struct settings_store *cs, const char *name,
 	write_name_id = cf->last_name_id + 1;
 	write_name = true;
 
-	while (1) {
+#if defined(CONFIG_SETTINGS_NVS_NAME_CACHE)
+	if (cf->cache_complete) {
+		entry = settings_nvs_cache_find(cf, name, rdname,
+						sizeof(rdname));
+		if (entry) {
+			name_id = entry->name_id;
+			found = true;
+		} else {
+			/* Not stored, no need to search for the name. The
+			 * cache also tells which IDs are free, reuse the
+			 * lowest one before going past the last one.
+			 */
+			u16_t free_id = settings_nvs_cache_free_id(cf);
+
+			if (free_id) {
+				write_name_id = free_id;
+			}
+			name_id = NVS_NAMECNT_ID + 1;
+		}
+	}
+#endif
+
+	while (!found) {
 		name_id--;
 		if (name_id == NVS_NAMECNT_ID) {
 			break;
@@ -169,22 +327,35 @@ static int settings_nvs_save(struct settings_store *cs, const char *name,
 			continue;
 		}
 
-		if ((delete) && (name_id == cf->last_name_id)) {
+		found = true;
+	}
+
+	if (found && delete) {
+		if (name_id == cf->last_name_id) {
 			cf->last_name_id--;
 			rc = nvs_write(&cf->cf_nvs, NVS_NAMECNT_ID,
 				       &cf->last_name_id, sizeof(u16_t));
 		}
 
-		if (delete) {
-			rc = nvs_delete(&cf->cf_nvs, name_id);
-			rc = nvs_delete(&cf->cf_nvs, name_id +
-					NVS_NAME_ID_OFFSET);
+		rc = nvs_delete(&cf->cf_nvs, name_id);
+		rc = nvs_delete(&cf->cf_nvs, name_id + NVS_NAME_ID_OFFSET);
 
-			return 0;
+#if defined(CONFIG_SETTINGS_NVS_NAME_CACHE)
+		if (entry) {
+			entry->name_id = SETTINGS_NVS_CACHE_FREED;
+		}
+
+		if (name_id < cf->free_name_id) {
+			cf->free_name_id = name_id;
 		}
+#endif
+
+		return 0;
+	}
+
+	if (found) {
 		write_name_id = name_id;
 		write_name = false;
-		break;
 	}
 
 	if (delete) {
@@ -203,6 +374,12 @@ static int settings_nvs_save(struct settings_store *cs, const char *name,
 	/* write the name if required */
 	if (write_name) {
 		rc = nvs_write(&cf->cf_nvs, write_name_id, name, strlen(name));
+
+#if defined(CONFIG_SETTINGS_NVS_NAME_CACHE)
+		if (settings_nvs_cache_add(cf, name, write_name_id)) {
+			cf->cache_complete = false;
+		}
+#endif
 	}
 
 	/* update the last_name_id and write to flash if required*/
@@ -219,6 +396,92 @@ static int settings_nvs_save(struct settings_store *cs, const char *name,
 	return 0;
 }
 
+#if defined(CONFIG_SETTINGS_BATCH)
+/*
+ * Batch journal, each name with its terminating null character, followed by
+ * the length of its value and the value.
+ */
+static u8_t settings_nvs_journal[CONFIG_SETTINGS_BATCH_BUF_SIZE +
+				 CONFIG_SETTINGS_BATCH_COUNT * sizeof(u16_t)];
+
+/* Write the values of the journal, then delete it */
+static int settings_nvs_journal_apply(struct settings_nvs *cf, size_t len)
+{
+	const char *name;
+	u16_t val_len;
+	size_t off = 0;
+	int rc = 0;
+	int rc2;
+
+	while (off < len) {
+		name = (const char *)&settings_nvs_journal[off];
+		off += strlen(name) + 1;
+		memcpy(&val_len, &settings_nvs_journal[off], sizeof(val_len));
+		off += sizeof(val_len);
+
+		rc2 = settings_nvs_save(&cf->cf_store, name,
+					(const char *)&settings_nvs_journal[off],
+					val_len);
+		off += val_len;
+
+		/* Deleting a value that is not stored is fine */
+		if (rc2 && rc2 != -ENOENT && !rc) {
+			rc = rc2;
+		}
+	}
+
+	rc2 = nvs_delete(&cf->cf_nvs, NVS_JOURNAL_ID);
+
+	return rc ? rc : rc2;
+}
+
+/* ::csi_save_batch implementation */
+static int settings_nvs_save_batch(struct settings_store *cs,
+				   const struct settings_batch_entry *entries,
+				   int count)
+{
+	struct settings_nvs *cf = (struct settings_nvs *)cs;
+	u16_t val_len;
+	size_t name_len;
+	size_t len = 0;
+	ssize_t rc;
+
+	if (count == 1) {
+		/* A single value needs no journal */
+		return settings_nvs_save(cs, entries[0].name,
+					 (const char *)entries[0].value,
+					 entries[0].val_len);
+	}
+
+	for (int i = 0; i < count; i++) {
+		name_len = strlen(entries[i].name) + 1;
+		val_len = entries[i].val_len;
+
+		memcpy(&settings_nvs_journal[len], entries[i].name, name_len);
+		len += name_len;
+		memcpy(&settings_nvs_journal[len], &val_len, sizeof(val_len));
+		len += sizeof(val_len);
+		if (val_len) {
+			memcpy(&settings_nvs_journal[len], entries[i].value,
+			       val_len);
+			len += val_len;
+		}
+	}
+
+	/*
+	 * Nothing is written when the journal does not fit in a sector, once
+	 * it is written the values are written at the latest on next init.
+	 */
+	rc = nvs_write(&cf->cf_nvs, NVS_JOURNAL_ID, settings_nvs_journal,
+		       len);
+	if (rc < 0) {
+		return rc;
+	}
+
+	return settings_nvs_journal_apply(cf, len);
+}
+#endif
+
 /* Initialize the nvs backend. */
 int settings_nvs_backend_init(struct settings_nvs *cf)
 {
@@ -238,6 +501,25 @@ int settings_nvs_backend_init(struct settings_nvs *cf)
 		cf->last_name_id = last_name_id;
 	}
 
+#if defined(CONFIG_SETTINGS_NVS_NAME_CACHE)
+	/* Filled when the settings are loaded, unless none are stored */
+	(void)memset(cf->cache, 0, sizeof(cf->cache));
+	cf->cache_complete = (cf->last_name_id == NVS_NAMECNT_ID);
+	cf->free_name_id = NVS_NAMECNT_ID + 1;
+#endif
+
+#if defined(CONFIG_SETTINGS_BATCH)
+	/* Finish writing the batch a reset interrupted */
+	rc = nvs_read(&cf->cf_nvs, NVS_JOURNAL_ID, settings_nvs_journal,
+		      sizeof(settings_nvs_journal));
+	if (rc > 0 && rc <= sizeof(settings_nvs_journal)) {
+		rc = settings_nvs_journal_apply(cf, rc);
+		if (rc) {
+			return rc;
+		}
+	}
+#endif
+
 	LOG_DBG("Initialized");
 	return 0;
 }
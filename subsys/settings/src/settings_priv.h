@@ -40,6 +40,12 @@ int settings_line_len_calc(const char *name, size_t val_len);
 int settings_line_dup_check_cb(const char *name, void *val_read_cb_ctx,
 				off_t off, void *cb_arg);
 
+#if defined(CONFIG_SETTINGS_BATCH)
+/* Duplicate check of all the values of a batch, in one pass */
+int settings_line_batch_dup_check_cb(const char *name, void *val_read_cb_ctx,
+				      off_t off, void *cb_arg);
+#endif
+
 int settings_line_load_cb(const char *name, void *val_read_cb_ctx,
 			   off_t off, void *cb_arg);
 
@@ -58,6 +64,67 @@ struct settings_line_dup_check_arg {
 	int is_dup;
 };
 
+#if defined(CONFIG_SETTINGS_BATCH)
+struct settings_line_batch_dup_check_arg {
+	const struct settings_batch_entry *entries;
+	int count;
+	u8_t is_dup[CONFIG_SETTINGS_BATCH_COUNT];
+};
+
+typedef int (*settings_line_save_fn)(struct settings_store *cs,
+				     const char *name, const char *value,
+				     size_t val_len);
+
+/*
+ * Write the values of a batch that changed with save, between a begin and a
+ * commit marker record when there are more than one.
+ */
+int settings_line_batch_save(struct settings_store *cs,
+		const struct settings_line_batch_dup_check_arg *cdca,
+		settings_line_save_fn save);
+#endif
+
+/*
+ * The line back-ends write a batch as a begin marker record, the records of
+ * the batch with their names prefixed by SETTINGS_BATCH_PREFIX, and a commit
+ * marker record. The records of a batch are applied once its commit marker
+ * is read, the next begin marker drops them when the commit marker is
+ * missing.
+ */
+#define SETTINGS_BATCH_PREFIX	'\x01'
+#define SETTINGS_BATCH_BEGIN	'\x02'
+#define SETTINGS_BATCH_COMMIT	'\x03'
+
+enum settings_line_kind {
+	SETTINGS_LINE_PLAIN,
+	SETTINGS_LINE_BATCH,
+	SETTINGS_LINE_BEGIN,
+	SETTINGS_LINE_COMMIT,
+};
+
+/* Kind of a record, given its name */
+enum settings_line_kind settings_line_kind(const char *name, size_t len);
+
+/*
+ * Check whether a record is live when compressing, that is whether it is
+ * applied after all the later records of the same name.
+ */
+struct settings_line_live {
+	enum settings_line_kind kind;
+	bool committed; /* batch record, commit marker read after it */
+	bool pending; /* later batch record of the name, not committed yet */
+};
+
+void settings_line_live_init(struct settings_line_live *live,
+			     enum settings_line_kind kind);
+
+/* Account for a later record, returns false once the record is not live */
+bool settings_line_live_next(struct settings_line_live *live,
+			     enum settings_line_kind kind, bool same_name);
+
+/* Returns whether the record is live once all later records are accounted */
+bool settings_line_live_end(const struct settings_line_live *live);
+
 #ifdef CONFIG_SETTINGS_ENCODE_LEN
 /* in storage line contex */
 struct line_entry_ctx {
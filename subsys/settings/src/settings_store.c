@@ -24,6 +24,163 @@ sys_slist_t settings_load_srcs;
 struct settings_store *settings_save_dst;
 extern struct k_mutex settings_lock;
 
+#if defined(CONFIG_SETTINGS_BATCH)
+/*
+ * Values saved since settings_batch_begin(). Names and values are appended to
+ * buf in the order of the entries.
+ */
+static struct {
+	k_tid_t owner; /* thread with the batch open, NULL when none */
+	int count;
+	size_t used;
+	struct settings_batch_entry entries[CONFIG_SETTINGS_BATCH_COUNT];
+	char buf[CONFIG_SETTINGS_BATCH_BUF_SIZE];
+} settings_batch;
+
+static size_t settings_batch_entry_size(const struct settings_batch_entry *e)
+{
+	return strlen(e->name) + 1 + e->val_len;
+}
+
+static void settings_batch_remove(int idx)
+{
+	struct settings_batch_entry *e = &settings_batch.entries[idx];
+	size_t size = settings_batch_entry_size(e);
+	char *start = (char *)e->name;
+	int i;
+
+	memmove(start, start + size,
+		settings_batch.used - (start - settings_batch.buf) - size);
+	settings_batch.used -= size;
+
+	for (i = idx + 1; i < settings_batch.count; i++) {
+		e = &settings_batch.entries[i];
+		e->name -= size;
+		if (e->value) {
+			e->value = (const char *)e->value - size;
+		}
+		settings_batch.entries[i - 1] = *e;
+	}
+
+	settings_batch.count--;
+}
+
+/*
+ * Record a value in the batch, replacing the one saved before under the same
+ * name. The batch is left as is when the value does not fit.
+ */
+static int settings_batch_add(const char *name, const void *value,
+			      size_t val_len)
+{
+	size_t name_len = strlen(name) + 1;
+	size_t freed = 0;
+	int count = settings_batch.count;
+	struct settings_batch_entry *e;
+	char *p;
+	int i;
+
+	if (val_len > 0 && value == NULL) {
+		return -EINVAL;
+	}
+
+	for (i = 0; i < settings_batch.count; i++) {
+		if (!strcmp(settings_batch.entries[i].name, name)) {
+			freed = settings_batch_entry_size(
+				&settings_batch.entries[i]);
+			count--;
+			break;
+		}
+	}
+
+	if (count == CONFIG_SETTINGS_BATCH_COUNT ||
+	    settings_batch.used - freed + name_len + val_len >
+	    sizeof(settings_batch.buf)) {
+		return -ENOMEM;
+	}
+
+	if (i < settings_batch.count) {
+		settings_batch_remove(i);
+	}
+
+	p = settings_batch.buf + settings_batch.used;
+	memcpy(p, name, name_len);
+	if (val_len) {
+		memcpy(p + name_len, value, val_len);
+	}
+
+	e = &settings_batch.entries[settings_batch.count++];
+	e->name = p;
+	e->value = val_len ? p + name_len : NULL;
+	e->val_len = val_len;
+	settings_batch.used += name_len + val_len;
+
+	return 0;
+}
+
+static void settings_batch_end(void)
+{
+	settings_batch.owner = NULL;
+	settings_batch.count = 0;
+	settings_batch.used = 0;
+
+	/* taken by settings_batch_begin() */
+	k_mutex_unlock(&settings_lock);
+}
+
+int settings_batch_begin(void)
+{
+	k_mutex_lock(&settings_lock, K_FOREVER);
+
+	if (settings_batch.owner) {
+		k_mutex_unlock(&settings_lock);
+		return -EBUSY;
+	}
+
+	/* settings_lock stays taken until the batch ends */
+	settings_batch.owner = k_current_get();
+
+	return 0;
+}
+
+int settings_batch_commit(void)
+{
+	struct settings_store *cs;
+	int rc;
+	int i;
+
+	if (settings_batch.owner != k_current_get()) {
+		return -EINVAL;
+	}
+
+	cs = settings_save_dst;
+	if (!cs) {
+		rc = -ENOENT;
+	} else if (cs->cs_itf->csi_save_batch) {
+		rc = cs->cs_itf->csi_save_batch(cs, settings_batch.entries,
+						settings_batch.count);
+	} else {
+		rc = 0;
+		for (i = 0; i < settings_batch.count && !rc; i++) {
+			rc = cs->cs_itf->csi_save(cs,
+					settings_batch.entries[i].name,
+					settings_batch.entries[i].value,
+					settings_batch.entries[i].val_len);
+		}
+	}
+
+	settings_batch_end();
+
+	return rc;
+}
+
+void settings_batch_abort(void)
+{
+	if (settings_batch.owner == k_current_get()) {
+		settings_batch_end();
+	}
+}
+#endif /* CONFIG_SETTINGS_BATCH */
+
 void settings_src_register(struct settings_store *cs)
 {
 	sys_snode_t *prev, *cur;
@@ -111,6 +268,15 @@ int settings_save_one(const char *name, const void *value, size_t val_len)
 
 	k_mutex_lock(&settings_lock, K_FOREVER);
 
+#if defined(CONFIG_SETTINGS_BATCH)
+	/* only the batch owner gets here while the batch is open */
+	if (settings_batch.owner) {
+		rc = settings_batch_add(name, value, val_len);
+		k_mutex_unlock(&settings_lock);
+		return rc;
+	}
+#endif
+
 	rc = cs->cs_itf->csi_save(cs, name, (char *)value, val_len);
 
 	k_mutex_unlock(&settings_lock);
@@ -122,6 +122,79 @@ static int cmd_kernel_stacks(const struct shell *shell,
 }
 #endif
 
+#if defined(CONFIG_MEM_POOL_USAGE) || defined(CONFIG_MEM_SLAB_USAGE)
+static void shell_print_usage(const struct shell *shell,
+			      struct sys_mem_usage *usage, const char *unit)
+{
+	shell_print(shell, "\tused %u %s, peak %u, failed allocations %u",
+		    usage->used, unit, usage->max_used, usage->failed);
+}
+#endif
+
+static int cmd_kernel_pools(const struct shell *shell,
+			    size_t argc, char **argv)
+{
+#if defined(CONFIG_MEM_POOL_USAGE)
+	struct sys_mem_usage usage;
+#endif
+	size_t block_size;
+	int count;
+
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	Z_STRUCT_SECTION_FOREACH(k_mem_pool, pool) {
+		shell_print(shell, "%p:", pool);
+#if defined(CONFIG_MEM_POOL_USAGE)
+		k_mem_pool_usage_get(pool, &usage);
+		shell_print_usage(shell, &usage, "bytes");
+#endif
+		for (int l = 0; ; l++) {
+			count = k_mem_pool_free_blocks_get(pool, l,
+							   &block_size);
+			if (count < 0) {
+				break;
+			}
+			shell_print(shell, "\tlevel %d (%u bytes): %d free",
+				    l, (u32_t)block_size, count);
+		}
+	}
+
+	return 0;
+}
+
+static int cmd_kernel_slabs(const struct shell *shell,
+			    size_t argc, char **argv)
+{
+#if defined(CONFIG_MEM_SLAB_MAGAZINE)
+	struct k_mem_slab_cache_stats stats;
+#endif
+#if defined(CONFIG_MEM_SLAB_USAGE)
+	struct sys_mem_usage usage;
+#endif
+
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	Z_STRUCT_SECTION_FOREACH(k_mem_slab, slab) {
+		shell_print(shell, "%p: %u blocks of %u bytes, %u used",
+			    slab, slab->num_blocks, (u32_t)slab->block_size,
+			    k_mem_slab_num_used_get(slab));
+#if defined(CONFIG_MEM_SLAB_USAGE)
+		k_mem_slab_usage_get(slab, &usage);
+		shell_print_usage(shell, &usage, "blocks");
+#endif
+#if defined(CONFIG_MEM_SLAB_MAGAZINE)
+		k_mem_slab_cache_stats_get(slab, &stats);
+		shell_print(shell, "\tcache: hits %u, misses %u, refills %u, "
+			    "flushes %u, cached %u", stats.hits, stats.misses,
+			    stats.refills, stats.flushes, stats.cached);
+#endif
+	}
+
+	return 0;
+}
+
 #if defined(CONFIG_REBOOT)
 static int cmd_kernel_reboot_warm(const struct shell *shell,
 				  size_t argc, char **argv)
@@ -150,9 +223,11 @@ SHELL_STATIC_SUBCMD_SET_CREATE(sub_kernel_reboot,
 
 SHELL_STATIC_SUBCMD_SET_CREATE(sub_kernel,
 	SHELL_CMD(cycles, NULL, "Kernel cycles.", cmd_kernel_cycles),
+	SHELL_CMD(pools, NULL, "List memory pools.", cmd_kernel_pools),
 #if defined(CONFIG_REBOOT)
 	SHELL_CMD(reboot, &sub_kernel_reboot, "Reboot.", NULL),
 #endif
+	SHELL_CMD(slabs, NULL, "List memory slabs.", cmd_kernel_slabs),
 #if defined(CONFIG_INIT_STACKS) && defined(CONFIG_THREAD_MONITOR) \
 				&& defined(CONFIG_THREAD_STACK_INFO)
 	SHELL_CMD(stacks, NULL, "List threads stack usage.", cmd_kernel_stacks),
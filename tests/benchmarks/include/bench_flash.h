@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2019 Laczen
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef ZEPHYR_TESTS_BENCHMARKS_INCLUDE_BENCH_FLASH_H_
+#define ZEPHYR_TESTS_BENCHMARKS_INCLUDE_BENCH_FLASH_H_
+
+/* Count the flash operations of the storage benchmarks, by interposing
+ * a copy of the API of the flash device that counts them.
+ */
+
+#include <zephyr/types.h>
+#include <string.h>
+#include <device.h>
+#include <drivers/flash.h>
+
+struct bench_flash_counts {
+	u32_t reads;
+	u32_t read_bytes;
+	u32_t written;
+	u32_t erases;
+};
+
+static struct bench_flash_counts bench_flash;
+
+static const struct flash_driver_api *bench_flash_api;
+static struct flash_driver_api bench_flash_counting_api;
+
+static int bench_flash_read(struct device *dev, off_t offset, void *data,
+			    size_t len)
+{
+	bench_flash.reads++;
+	bench_flash.read_bytes += len;
+
+	return bench_flash_api->read(dev, offset, data, len);
+}
+
+static int bench_flash_write(struct device *dev, off_t offset,
+			     const void *data, size_t len)
+{
+	bench_flash.written += len;
+
+	return bench_flash_api->write(dev, offset, data, len);
+}
+
+static int bench_flash_erase(struct device *dev, off_t offset, size_t size)
+{
+	bench_flash.erases++;
+
+	return bench_flash_api->erase(dev, offset, size);
+}
+
+static inline void bench_flash_reset(void)
+{
+	(void)memset(&bench_flash, 0, sizeof(bench_flash));
+}
+
+/* Count the operations on dev until bench_flash_stop() */
+static inline void bench_flash_start(struct device *dev)
+{
+	bench_flash_api = dev->driver_api;
+	/* write_block_size is const, the whole API cannot be assigned */
+	memcpy(&bench_flash_counting_api, bench_flash_api,
+	       sizeof(bench_flash_counting_api));
+	bench_flash_counting_api.read = bench_flash_read;
+	bench_flash_counting_api.write = bench_flash_write;
+	bench_flash_counting_api.erase = bench_flash_erase;
+	dev->driver_api = &bench_flash_counting_api;
+
+	bench_flash_reset();
+}
+
+static inline void bench_flash_stop(struct device *dev)
+{
+	dev->driver_api = bench_flash_api;
+}
+
+#endif /* ZEPHYR_TESTS_BENCHMARKS_INCLUDE_BENCH_FLASH_H_ */
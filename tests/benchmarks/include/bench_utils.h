@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2019 Wind River Systems, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef ZEPHYR_TESTS_BENCHMARKS_INCLUDE_BENCH_UTILS_H_
+#define ZEPHYR_TESTS_BENCHMARKS_INCLUDE_BENCH_UTILS_H_
+
+/* Helpers shared by the benchmarks that compare backends */
+
+#include <zephyr/types.h>
+#include <kernel.h>
+
+static u32_t bench_rand_state;
+
+/* Deterministic LCG, so that every backend a benchmark compares sees
+ * the same input for the same seed.
+ */
+static inline void bench_rand_seed(u32_t seed)
+{
+	bench_rand_state = seed;
+}
+
+static inline u32_t bench_rand(void)
+{
+	bench_rand_state = bench_rand_state * 1103515245U + 12345U;
+	return bench_rand_state >> 8;
+}
+
+/* As with the scheduler microbenchmark, measurements that involve no
+ * timer interaction (except, on some architectures, k_cycle_get_32())
+ * give deterministic numbers when run in QEMU with the -icount argument:
+ *
+ * export QEMU_EXTRA_FLAGS="-icount shift=0,align=off,sleep=off"
+ */
+static inline u32_t bench_cycles(void)
+{
+	u32_t t;
+
+	/* The TSC is cheap, but only trustworthy on x86 */
+#ifdef CONFIG_X86
+	__asm__ volatile("rdtsc" : "=a"(t) : : "edx");
+#else
+	t = k_cycle_get_32();
+#endif
+	return t;
+}
+
+#if defined(CONFIG_ARCH_POSIX)
+/* Simulated time does not advance while code runs, use the host's */
+#include <time.h>
+
+static inline u64_t bench_now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (u64_t)ts.tv_sec * NSEC_PER_SEC + ts.tv_nsec;
+}
+#else
+static inline u64_t bench_now_ns(void)
+{
+	return SYS_CLOCK_HW_CYCLES_TO_NS64(k_cycle_get_32());
+}
+#endif
+
+#endif /* ZEPHYR_TESTS_BENCHMARKS_INCLUDE_BENCH_UTILS_H_ */
@@ -0,0 +1,211 @@
+/*
+ * Copyright (c) 2019 Wind River Systems, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <bench_utils.h>
+
+/* Memory pool trace replay benchmark.  Each trace is a sequence of
+ * allocate, free and resize operations on a set of slots, generated
+ * once from a fixed seed and a size profile modelled on a kind of
+ * workload, then replayed against a memory pool through the
+ * k_mem_pool_malloc()/k_mem_pool_realloc()/k_free() interface.  The
+ * traces ask for more memory than the pool holds at their peak, so
+ * allocations start failing once the pool is full or fragmented.
+ *
+ * For each trace we report the average and worst cycle cost of each
+ * operation, how many requests failed, and the live (requested) bytes
+ * when the first request failed, as a percentage of the pool buffer.
+ * The latter is the fragmentation figure: the closer to 100% the less
+ * memory was lost to rounding, headers and holes.
+ */
+
+#define NUM_SLOTS 255
+#define NUM_OPS 4000
+
+K_MEM_POOL_DEFINE(bench_pool, 64, 4096, 4, 8);
+
+enum trace_op_type {
+	OP_ALLOC,
+	OP_FREE,
+	OP_RESIZE,
+};
+
+struct trace_op {
+	u8_t type;
+	u8_t slot;
+	u16_t size;
+};
+
+struct trace {
+	const char *name;
+	int slots;
+	u16_t (*size)(void);
+	bool resize;
+};
+
+struct op_stats {
+	u32_t count;
+	u32_t total;
+	u32_t max;
+};
+
+static struct trace_op ops[NUM_OPS];
+static void *slot_ptr[NUM_SLOTS];
+static u16_t slot_size[NUM_SLOTS];
+
+/* Small control blocks and strings */
+static u16_t size_small(void)
+{
+	return 8 + bench_rand() % 504;
+}
+
+/* Network packets: mostly small, some MTU sized */
+static u16_t size_net(void)
+{
+	static const u16_t sizes[] = { 60, 60, 60, 128, 128, 576, 1280, 1514 };
+
+	return sizes[bench_rand() % ARRAY_SIZE(sizes)];
+}
+
+/* Roughly log-uniform between 16 and 2048 bytes */
+static u16_t size_mixed(void)
+{
+	u32_t r = bench_rand();
+
+	return (16 << (r % 7)) + (r >> 3) % (16 << (r % 7));
+}
+
+/* Growth step for buffers built up piecewise */
+static u16_t size_step(void)
+{
+	return 16 + bench_rand() % 112;
+}
+
+static const struct trace traces[] = {
+	{ "small", 255, size_small, false },
+	{ "net", 96, size_net, false },
+	{ "mixed", 80, size_mixed, false },
+	{ "resize", 48, size_step, true },
+};
+
+static void generate(const struct trace *t)
+{
+	bool used[NUM_SLOTS] = { false };
+	u16_t size[NUM_SLOTS];
+
+	bench_rand_seed(1U);
+
+	for (int i = 0; i < NUM_OPS; i++) {
+		int s = bench_rand() % t->slots;
+
+		ops[i].slot = s;
+		if (!used[s]) {
+			ops[i].type = OP_ALLOC;
+			size[s] = t->size();
+			used[s] = true;
+		} else if (t->resize && size[s] < 2048 &&
+			   bench_rand() % 4 != 0U) {
+			ops[i].type = OP_RESIZE;
+			size[s] += t->size();
+		} else {
+			ops[i].type = OP_FREE;
+			used[s] = false;
+		}
+		ops[i].size = size[s];
+	}
+}
+
+static void account(struct op_stats *st, u32_t dt)
+{
+	st->count++;
+	st->total += dt;
+	st->max = MAX(st->max, dt);
+}
+
+static void print_stats(const char *name, struct op_stats *st)
+{
+	printk(" %s %5u/%6u", name, st->count ? st->total / st->count : 0,
+	       st->max);
+}
+
+static void replay(const struct trace *t)
+{
+	struct op_stats st[3] = { 0 };
+	u32_t live = 0U, fill = 0U, failed = 0U;
+
+	generate(t);
+
+	for (int i = 0; i < NUM_OPS; i++) {
+		struct trace_op *op = &ops[i];
+		void *p = slot_ptr[op->slot];
+		u32_t t0, t1;
+
+		/* A slot whose allocation failed stays empty, so its
+		 * later frees and resizes are dropped
+		 */
+		if (p == NULL && op->type != OP_ALLOC) {
+			continue;
+		}
+
+		t0 = bench_cycles();
+		switch (op->type) {
+		case OP_ALLOC:
+			p = k_mem_pool_malloc(&bench_pool, op->size);
+			break;
+		case OP_RESIZE:
+			p = k_mem_pool_realloc(&bench_pool, p, op->size);
+			break;
+		default:
+			k_free(p);
+			p = NULL;
+			break;
+		}
+		t1 = bench_cycles();
+
+		if (p == NULL && op->type != OP_FREE) {
+			if (failed++ == 0U) {
+				fill = live;
+			}
+			if (op->type == OP_RESIZE) {
+				/* Keep the block at its old size */
+				continue;
+			}
+		}
+
+		account(&st[op->type], t1 - t0);
+		live -= slot_size[op->slot];
+		slot_ptr[op->slot] = p;
+		slot_size[op->slot] = p != NULL ? op->size : 0;
+		live += slot_size[op->slot];
+	}
+
+	for (int i = 0; i < NUM_SLOTS; i++) {
+		k_free(slot_ptr[i]);
+		slot_ptr[i] = NULL;
+		slot_size[i] = 0U;
+	}
+
+	printk("%-5s trace %-6s", IS_ENABLED(CONFIG_MEM_POOL_TLSF) ?
+	       "tlsf" : "buddy", t->name);
+	print_stats("alloc", &st[OP_ALLOC]);
+	print_stats("free", &st[OP_FREE]);
+	print_stats("resize", &st[OP_RESIZE]);
+	printk(" fill %3u%% failed %4u\n",
+	       failed ? (u32_t)(fill * 100U / sizeof(_mpool_buf_bench_pool)) :
+	       100U,
+	       failed);
+}
+
+void main(void)
+{
+	printk("pool buffer %u bytes\n", (u32_t)sizeof(_mpool_buf_bench_pool));
+
+	for (int i = 0; i < ARRAY_SIZE(traces); i++) {
+		replay(&traces[i]);
+	}
+	printk("fin\n");
+}
@@ -0,0 +1,225 @@
+/*
+ * Copyright (c) 2019 Linaro Limited
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <logging/log.h>
+LOG_MODULE_REGISTER(net_test, CONFIG_NET_UTILS_LOG_LEVEL);
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <bench_utils.h>
+#include <net/net_core.h>
+#include <net/net_pkt.h>
+#include <net/net_ip.h>
+#include <net/dummy.h>
+
+#include "net_private.h"
+#include "ipv4.h"
+#include "udp_internal.h"
+
+/* Checksum benchmark.  It builds IPv4 UDP packets from 64 to 1500 bytes
+ * and reports the time per packet of net_calc_chksum_udp(), and of the
+ * previous implementation summing one 16-bit word at a time, which is
+ * kept here as the reference.  Both must give the same checksum.
+ */
+
+#define ROUNDS 20000
+
+static u8_t dummy_mac[] = { 0x00, 0x00, 0x5E, 0x00, 0x53, 0x01 };
+
+static void dummy_iface_init(struct net_if *iface)
+{
+	net_if_set_link_addr(iface, dummy_mac, sizeof(dummy_mac),
+			     NET_LINK_ETHERNET);
+}
+
+static int dummy_send(struct device *dev, struct net_pkt *pkt)
+{
+	return 0;
+}
+
+static int dummy_init(struct device *dev)
+{
+	return 0;
+}
+
+static struct dummy_api dummy_api = {
+	.iface_api.init = dummy_iface_init,
+	.send = dummy_send,
+};
+
+NET_DEVICE_INIT(bench_dummy, "bench_dummy", dummy_init, NULL, NULL,
+		CONFIG_KERNEL_INIT_PRIORITY_DEFAULT, &dummy_api,
+		DUMMY_L2, NET_L2_GET_CTX_TYPE(DUMMY_L2), 1500);
+
+static struct in_addr src = { { { 192, 0, 2, 2 } } };
+static struct in_addr dst = { { { 192, 0, 2, 1 } } };
+
+static u16_t ref_calc_chksum(u16_t sum, const u8_t *data, size_t len)
+{
+	const u8_t *end;
+	u16_t tmp;
+
+	end = data + len - 1;
+
+	while (data < end) {
+		tmp = (data[0] << 8) + data[1];
+		sum += tmp;
+		if (sum < tmp) {
+			sum++;
+		}
+
+		data += 2;
+	}
+
+	if (data == end) {
+		tmp = data[0] << 8;
+		sum += tmp;
+		if (sum < tmp) {
+			sum++;
+		}
+	}
+
+	return sum;
+}
+
+static u16_t ref_pkt_calc_chksum(struct net_pkt *pkt, u16_t sum)
+{
+	struct net_pkt_cursor *cur = &pkt->cursor;
+	size_t len;
+
+	if (!cur->buf || !cur->pos) {
+		return sum;
+	}
+
+	len = cur->buf->len - (cur->pos - cur->buf->data);
+
+	while (cur->buf) {
+		sum = ref_calc_chksum(sum, cur->pos, len);
+
+		cur->buf = cur->buf->frags;
+		if (!cur->buf || !cur->buf->len) {
+			break;
+		}
+
+		cur->pos = cur->buf->data;
+
+		if (len % 2) {
+			sum += *cur->pos;
+			if (sum < *cur->pos) {
+				sum++;
+			}
+
+			cur->pos++;
+			len = cur->buf->len - 1;
+		} else {
+			len = cur->buf->len;
+		}
+	}
+
+	return sum;
+}
+
+/* The previous net_calc_chksum_udp() for IPv4 packets */
+static u16_t ref_chksum_udp(struct net_pkt *pkt)
+{
+	size_t len = 2 * sizeof(struct in_addr);
+	struct net_pkt_cursor backup;
+	u16_t sum;
+	bool ow;
+
+	sum = net_pkt_get_len(pkt) - net_pkt_ip_hdr_len(pkt) + IPPROTO_UDP;
+
+	net_pkt_cursor_backup(pkt, &backup);
+	net_pkt_cursor_init(pkt);
+
+	ow = net_pkt_is_being_overwritten(pkt);
+	net_pkt_set_overwrite(pkt, true);
+
+	net_pkt_skip(pkt, net_pkt_ip_hdr_len(pkt) - len);
+
+	sum = ref_calc_chksum(sum, pkt->cursor.pos, len);
+
+	net_pkt_skip(pkt, len);
+
+	sum = ref_pkt_calc_chksum(pkt, sum);
+
+	sum = (sum == 0U) ? 0xffff : htons(sum);
+
+	net_pkt_cursor_restore(pkt, &backup);
+
+	net_pkt_set_overwrite(pkt, ow);
+
+	sum = ~sum;
+
+	return sum == 0U ? 0xffff : sum;
+}
+
+static void run(size_t size)
+{
+	struct net_if *iface = net_if_get_default();
+	size_t payload = size - sizeof(struct net_ipv4_hdr) -
+		sizeof(struct net_udp_hdr);
+	u16_t ref = 0U, chksum = 0U;
+	u64_t ref_time, time;
+	struct net_pkt *pkt;
+	struct net_buf *buf;
+	int frags = 0;
+	size_t i;
+
+	pkt = net_pkt_alloc_with_buffer(iface, payload, AF_INET, IPPROTO_UDP,
+					K_NO_WAIT);
+	if (!pkt || net_ipv4_create(pkt, &src, &dst) ||
+	    net_udp_create(pkt, htons(4242), htons(4242))) {
+		printk("cannot create packet\n");
+		return;
+	}
+
+	for (i = 0; i < payload; i++) {
+		net_pkt_write_u8(pkt, i * 7U);
+	}
+
+	net_pkt_cursor_init(pkt);
+	net_ipv4_finalize(pkt, IPPROTO_UDP);
+
+	for (buf = pkt->buffer; buf; buf = buf->frags) {
+		frags++;
+	}
+
+	ref_time = bench_now_ns();
+	for (i = 0; i < ROUNDS; i++) {
+		ref += ref_chksum_udp(pkt);
+	}
+	ref_time = bench_now_ns() - ref_time;
+
+	time = bench_now_ns();
+	for (i = 0; i < ROUNDS; i++) {
+		chksum += net_calc_chksum_udp(pkt);
+	}
+	time = bench_now_ns() - time;
+
+	if (ref != chksum) {
+		printk("size %zu checksum %04x, expected %04x\n", size,
+		       net_calc_chksum_udp(pkt), ref_chksum_udp(pkt));
+	}
+
+	net_pkt_unref(pkt);
+
+	printk("size %4zu frags %2d ref %6u ns %s %6u ns\n", size, frags,
+	       (u32_t)(ref_time / ROUNDS),
+	       IS_ENABLED(CONFIG_NET_CHKSUM_SIMD) ? "simd" : "word",
+	       (u32_t)(time / ROUNDS));
+}
+
+void main(void)
+{
+	static const size_t sizes[] = { 64, 128, 256, 512, 1024, 1500 };
+
+	for (int i = 0; i < ARRAY_SIZE(sizes); i++) {
+		run(sizes[i]);
+	}
+
+	printk("fin\n");
+}
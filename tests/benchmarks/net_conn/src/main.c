@@ -0,0 +1,179 @@
+/*
+ * Copyright (c) 2019 Linaro Limited
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <bench_utils.h>
+#include <net/net_core.h>
+#include <net/net_pkt.h>
+#include <net/net_ip.h>
+#include <net/dummy.h>
+#include <net/udp.h>
+
+#include "ipv4.h"
+#include "udp_internal.h"
+#include "connection.h"
+
+/* Connection demultiplexing benchmark.  Like a server with many
+ * clients, it registers one UDP handler listening on a port and many
+ * handlers each connected to a different client on that port, plus a
+ * few listeners on other ports.  It then feeds packets straight to
+ * net_conn_input() and reports the time per packet for the handler
+ * registered first, which a linear lookup finds last, the one
+ * registered last, and the listener.
+ */
+
+#define NUM_CLIENTS (CONFIG_NET_MAX_CONN - NUM_LISTENERS)
+#define NUM_LISTENERS 16
+#define SERVER_PORT 4242
+#define CLIENT_PORT 30000
+#define ROUNDS 20000
+
+static u8_t dummy_mac[] = { 0x00, 0x00, 0x5E, 0x00, 0x53, 0x01 };
+
+static void dummy_iface_init(struct net_if *iface)
+{
+	net_if_set_link_addr(iface, dummy_mac, sizeof(dummy_mac),
+			     NET_LINK_ETHERNET);
+}
+
+static int dummy_send(struct device *dev, struct net_pkt *pkt)
+{
+	return 0;
+}
+
+static int dummy_init(struct device *dev)
+{
+	return 0;
+}
+
+static struct dummy_api dummy_api = {
+	.iface_api.init = dummy_iface_init,
+	.send = dummy_send,
+};
+
+NET_DEVICE_INIT(bench_dummy, "bench_dummy", dummy_init, NULL, NULL,
+		CONFIG_KERNEL_INIT_PRIORITY_DEFAULT, &dummy_api,
+		DUMMY_L2, NET_L2_GET_CTX_TYPE(DUMMY_L2), 127);
+
+static struct in_addr local = { { { 192, 0, 2, 1 } } };
+
+static u32_t hits;
+static void *hit_data;
+
+static enum net_verdict bench_cb(struct net_conn *conn, struct net_pkt *pkt,
+				 union net_ip_header *ip_hdr,
+				 union net_proto_header *proto_hdr,
+				 void *user_data)
+{
+	/* Keep the packet, it is fed in again */
+	hits++;
+	hit_data = user_data;
+
+	return NET_OK;
+}
+
+static void client_addr(int client, struct sockaddr_in *addr)
+{
+	addr->sin_family = AF_INET;
+	addr->sin_port = 0U;
+	addr->sin_addr.s4_addr[0] = 198;
+	addr->sin_addr.s4_addr[1] = 51;
+	addr->sin_addr.s4_addr[2] = 100 + client / 250;
+	addr->sin_addr.s4_addr[3] = 1 + client % 250;
+}
+
+static u32_t run(int client, u16_t local_port, void *expected)
+{
+	struct net_if *iface = net_if_get_default();
+	union net_proto_header proto_hdr;
+	union net_ip_header ip_hdr;
+	struct sockaddr_in remote;
+	struct net_pkt *pkt;
+	u64_t start;
+
+	client_addr(client, &remote);
+
+	pkt = net_pkt_alloc_with_buffer(iface, 0, AF_INET, IPPROTO_UDP,
+					K_NO_WAIT);
+	if (!pkt || net_ipv4_create(pkt, &remote.sin_addr, &local) ||
+	    net_udp_create(pkt, htons(CLIENT_PORT + client),
+			   htons(local_port))) {
+		printk("cannot create packet\n");
+		return 0;
+	}
+
+	net_pkt_cursor_init(pkt);
+	net_ipv4_finalize(pkt, IPPROTO_UDP);
+
+	ip_hdr.ipv4 = (struct net_ipv4_hdr *)pkt->buffer->data;
+	proto_hdr.udp = (struct net_udp_hdr *)(pkt->buffer->data +
+					       sizeof(struct net_ipv4_hdr));
+
+	hits = 0U;
+	start = bench_now_ns();
+	for (int i = 0; i < ROUNDS; i++) {
+		net_conn_input(pkt, &ip_hdr, IPPROTO_UDP, &proto_hdr);
+	}
+	start = bench_now_ns() - start;
+
+	net_pkt_unref(pkt);
+
+	if (hits != ROUNDS || hit_data != expected) {
+		printk("wrong handler %p, expected %p\n", hit_data, expected);
+		return 0;
+	}
+
+	return (u32_t)(start / ROUNDS);
+}
+
+void main(void)
+{
+	static int ids[CONFIG_NET_MAX_CONN];
+	struct sockaddr_in laddr = { .sin_family = AF_INET };
+	struct sockaddr_in raddr;
+	u32_t oldest, newest, listener;
+	int ret;
+
+	laddr.sin_addr = local;
+
+	for (int i = 0; i < NUM_LISTENERS; i++) {
+		ret = net_conn_register(IPPROTO_UDP, AF_INET, NULL,
+					(struct sockaddr *)&laddr, 0,
+					SERVER_PORT + i, bench_cb, &ids[i],
+					NULL);
+		if (ret < 0) {
+			printk("cannot register listener %d (%d)\n", i, ret);
+			return;
+		}
+	}
+
+	for (int i = 0; i < NUM_CLIENTS; i++) {
+		client_addr(i, &raddr);
+		ret = net_conn_register(IPPROTO_UDP, AF_INET,
+					(struct sockaddr *)&raddr,
+					(struct sockaddr *)&laddr,
+					CLIENT_PORT + i, SERVER_PORT,
+					bench_cb, &ids[NUM_LISTENERS + i],
+					NULL);
+		if (ret < 0) {
+			printk("cannot register client %d (%d)\n", i, ret);
+			return;
+		}
+	}
+
+	oldest = run(0, SERVER_PORT, &ids[NUM_LISTENERS]);
+	newest = run(NUM_CLIENTS - 1, SERVER_PORT,
+		     &ids[CONFIG_NET_MAX_CONN - 1]);
+	/* An unknown client only matches the listener */
+	listener = run(NUM_CLIENTS, SERVER_PORT, &ids[0]);
+
+	printk("conns %d lookup %s oldest %6u ns newest %6u ns "
+	       "listener %6u ns\n", CONFIG_NET_MAX_CONN,
+	       IS_ENABLED(CONFIG_NET_CONN_HASH) ? "hash" : "linear",
+	       oldest, newest, listener);
+	printk("fin\n");
+}
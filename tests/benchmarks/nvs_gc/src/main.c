@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2019 Laczen
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <string.h>
+#include <sys/printk.h>
+#include <bench_utils.h>
+#include <bench_flash.h>
+#include <drivers/flash.h>
+#include <storage/flash_map.h>
+#include <fs/nvs.h>
+
+/* NVS garbage collection benchmark.  It overwrites ID_COUNT ids of
+ * DATA_LEN bytes in a pseudo random order, with some idle time after each
+ * write, and reports the worst flash erases, bytes programmed and time of a
+ * single write, and the write amplification.  Flash operations are counted
+ * by wrappers around the driver's functions.
+ */
+
+#define SECTOR_COUNT 4
+#define ID_COUNT 150
+#define DATA_LEN 64
+#define WRITE_COUNT 5000
+
+static struct nvs_fs fs;
+
+void main(void)
+{
+	const struct flash_area *fa;
+	struct flash_pages_info info;
+	struct nvs_gc_stats stats;
+	struct device *dev;
+	u8_t data[DATA_LEN];
+	u32_t max_erases = 0U, max_written = 0U;
+	u64_t time, max_time = 0U;
+	ssize_t len;
+	int err;
+
+	err = flash_area_open(DT_FLASH_AREA_STORAGE_ID, &fa);
+	if (err) {
+		printk("cannot open storage area: %d\n", err);
+		return;
+	}
+
+	dev = flash_area_get_device(fa);
+
+	/* The simulated flash is not erased when it is first created */
+	flash_write_protection_set(dev, false);
+	err = flash_area_erase(fa, 0, fa->fa_size);
+	flash_write_protection_set(dev, true);
+	if (err) {
+		printk("cannot erase storage area: %d\n", err);
+		return;
+	}
+
+	flash_get_page_info_by_offs(dev, fa->fa_off, &info);
+
+	fs.offset = fa->fa_off;
+	fs.sector_size = info.size;
+	fs.sector_count = SECTOR_COUNT;
+
+	err = nvs_init(&fs, DT_FLASH_AREA_STORAGE_DEV);
+	if (err) {
+		printk("cannot mount file system: %d\n", err);
+		return;
+	}
+
+	bench_flash_start(dev);
+
+	printk("%u writes of %u ids of %u bytes, %u sectors of %u bytes\n",
+	       WRITE_COUNT, ID_COUNT, DATA_LEN, fs.sector_count,
+	       fs.sector_size);
+
+	bench_rand_seed(1U);
+	for (u32_t i = 0U; i < WRITE_COUNT; i++) {
+		/* Never the same data, NVS would skip the write */
+		(void)memset(data, 0, sizeof(data));
+		memcpy(data, &i, sizeof(i));
+
+		bench_flash_reset();
+		time = bench_now_ns();
+		len = nvs_write(&fs, (bench_rand() >> 8) % ID_COUNT, data,
+				sizeof(data));
+		time = bench_now_ns() - time;
+
+		if (len != sizeof(data)) {
+			printk("cannot write: %d\n", (int)len);
+			return;
+		}
+
+		max_erases = MAX(max_erases, bench_flash.erases);
+		max_written = MAX(max_written, bench_flash.written);
+		max_time = MAX(max_time, time);
+
+		/* Idle time, for background garbage collection */
+		k_sleep(K_MSEC(1));
+	}
+
+	bench_flash_stop(dev);
+
+	printk("write max %u erases %6u bytes %8u ns\n", max_erases,
+	       max_written, (u32_t)max_time);
+
+	err = nvs_gc_stats_get(&fs, &stats);
+	if (err) {
+		printk("cannot get garbage collection counters: %d\n", err);
+		return;
+	}
+
+	printk("gc %u sectors, %u in writes, amplification %u%%\n",
+	       stats.gc_sectors, stats.gc_write_sectors,
+	       (u32_t)(((u64_t)stats.write_bytes + stats.gc_bytes) * 100U /
+		       stats.write_bytes));
+
+	printk("fin\n");
+}
@@ -0,0 +1,138 @@
+/*
+ * Copyright (c) 2019 Laczen
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <string.h>
+#include <sys/printk.h>
+#include <bench_utils.h>
+#include <bench_flash.h>
+#include <drivers/flash.h>
+#include <storage/flash_map.h>
+#include <fs/nvs.h>
+
+/* NVS lookup benchmark.  It writes two generations of ID_COUNT ids and
+ * reports the flash reads and the time it takes to mount the file system,
+ * to read back each id and to look up ids that were never written.  Flash
+ * reads are counted by a wrapper around the driver's read function.
+ */
+
+#define ID_COUNT 1000
+#define MISS_COUNT 100
+
+#if defined(CONFIG_NVS_LOOKUP_CACHE)
+#define CACHE_SIZE CONFIG_NVS_LOOKUP_CACHE_SIZE
+#else
+#define CACHE_SIZE 0
+#endif
+
+static struct nvs_fs fs;
+
+static void report(const char *name, u32_t reads, u64_t time, u32_t count)
+{
+	printk("%-4s %6u reads %8u ns\n", name, reads / count,
+	       (u32_t)(time / count));
+}
+
+static int mount(void)
+{
+	u64_t time;
+	int err;
+
+	bench_flash_reset();
+	time = bench_now_ns();
+	err = nvs_init(&fs, DT_FLASH_AREA_STORAGE_DEV);
+	time = bench_now_ns() - time;
+
+	report("init", bench_flash.reads, time, 1);
+
+	return err;
+}
+
+void main(void)
+{
+	const struct flash_area *fa;
+	struct flash_pages_info info;
+	struct device *dev;
+	u32_t id, data;
+	u64_t time;
+	ssize_t len;
+	int err;
+
+	err = flash_area_open(DT_FLASH_AREA_STORAGE_ID, &fa);
+	if (err) {
+		printk("cannot open storage area: %d\n", err);
+		return;
+	}
+
+	dev = flash_area_get_device(fa);
+
+	/* The simulated flash is not erased when it is first created */
+	flash_write_protection_set(dev, false);
+	err = flash_area_erase(fa, 0, fa->fa_size);
+	flash_write_protection_set(dev, true);
+	if (err) {
+		printk("cannot erase storage area: %d\n", err);
+		return;
+	}
+
+	flash_get_page_info_by_offs(dev, fa->fa_off, &info);
+
+	fs.offset = fa->fa_off;
+	fs.sector_size = info.size;
+	fs.sector_count = fa->fa_size / info.size;
+
+	bench_flash_start(dev);
+
+	printk("cache %u entries, %u ids, %u sectors of %u bytes\n",
+	       CACHE_SIZE, ID_COUNT, fs.sector_count, fs.sector_size);
+
+	if (mount()) {
+		printk("cannot mount file system\n");
+		return;
+	}
+
+	for (id = 0U; id < 2 * ID_COUNT; id++) {
+		data = id;
+		len = nvs_write(&fs, id % ID_COUNT, &data, sizeof(data));
+		if (len != sizeof(data)) {
+			printk("cannot write id %u: %d\n", id, (int)len);
+			return;
+		}
+	}
+
+	if (mount()) {
+		printk("cannot mount file system\n");
+		return;
+	}
+
+	bench_flash_reset();
+	time = bench_now_ns();
+	for (id = 0U; id < ID_COUNT; id++) {
+		len = nvs_read(&fs, id, &data, sizeof(data));
+		if (len != sizeof(data) || data != id + ID_COUNT) {
+			printk("id %u read %d bytes, %u\n", id, (int)len, data);
+		}
+	}
+	time = bench_now_ns() - time;
+
+	report("hit", bench_flash.reads, time, ID_COUNT);
+
+	bench_flash_reset();
+	time = bench_now_ns();
+	for (id = ID_COUNT; id < ID_COUNT + MISS_COUNT; id++) {
+		len = nvs_read(&fs, id, &data, sizeof(data));
+		if (len != -ENOENT) {
+			printk("id %u found\n", id);
+		}
+	}
+	time = bench_now_ns() - time;
+
+	report("miss", bench_flash.reads, time, MISS_COUNT);
+
+	bench_flash_stop(dev);
+
+	printk("fin\n");
+}
@@ -0,0 +1,192 @@
+/*
+ * Copyright (c) 2019 Wind River Systems, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <bench_utils.h>
+#include <ksched.h>
+#include <sched_priq.h>
+
+/* This is a scaling benchmark for the scheduler priority queue
+ * backends.  Unlike the scheduler microbenchmark it does not switch
+ * threads at all: it builds private queues of each type out of
+ * never-started thread objects and measures the cost of the
+ * best/remove/add cycle the scheduler performs on every context
+ * switch, for increasing numbers of queued threads.
+ */
+
+#define MAX_THREADS 512
+#define N_RUNS 1000
+
+#define MIN_PRIO K_HIGHEST_APPLICATION_THREAD_PRIO
+#define NUM_PRIOS (K_LOWEST_APPLICATION_THREAD_PRIO - MIN_PRIO + 1)
+
+static struct k_thread threads[MAX_THREADS];
+
+static sys_dlist_t dumb_q;
+static struct _priq_rb rbt_q;
+static struct _priq_mq mq_q;
+static struct _priq_bmq bmq_q;
+
+struct queue_ops {
+	const char *name;
+	void (*init)(void);
+	void (*add)(struct k_thread *thread);
+	void (*remove)(struct k_thread *thread);
+	struct k_thread *(*best)(void);
+};
+
+static void dumb_init(void)
+{
+	sys_dlist_init(&dumb_q);
+}
+
+static void dumb_add(struct k_thread *thread)
+{
+	z_priq_dumb_add(&dumb_q, thread);
+}
+
+static void dumb_remove(struct k_thread *thread)
+{
+	z_priq_dumb_remove(&dumb_q, thread);
+}
+
+static struct k_thread *dumb_best(void)
+{
+	return z_priq_dumb_best(&dumb_q);
+}
+
+static void rbt_init(void)
+{
+	rbt_q = (struct _priq_rb) {
+		.tree = {
+			.lessthan_fn = z_priq_rb_lessthan,
+		}
+	};
+}
+
+static void rbt_add(struct k_thread *thread)
+{
+	z_priq_rb_add(&rbt_q, thread);
+}
+
+static void rbt_remove(struct k_thread *thread)
+{
+	z_priq_rb_remove(&rbt_q, thread);
+}
+
+static struct k_thread *rbt_best(void)
+{
+	return z_priq_rb_best(&rbt_q);
+}
+
+static void mq_init(void)
+{
+	for (int i = 0; i < ARRAY_SIZE(mq_q.queues); i++) {
+		sys_dlist_init(&mq_q.queues[i]);
+	}
+	mq_q.bitmask = 0U;
+}
+
+static void mq_add(struct k_thread *thread)
+{
+	z_priq_mq_add(&mq_q, thread);
+}
+
+static void mq_remove(struct k_thread *thread)
+{
+	z_priq_mq_remove(&mq_q, thread);
+}
+
+static struct k_thread *mq_best(void)
+{
+	return z_priq_mq_best(&mq_q);
+}
+
+static void bmq_init(void)
+{
+	z_priq_bmq_init(&bmq_q);
+}
+
+static void bmq_add(struct k_thread *thread)
+{
+	z_priq_bmq_add(&bmq_q, thread);
+}
+
+static void bmq_remove(struct k_thread *thread)
+{
+	z_priq_bmq_remove(&bmq_q, thread);
+}
+
+static struct k_thread *bmq_best(void)
+{
+	return z_priq_bmq_best(&bmq_q);
+}
+
+static const struct queue_ops backends[] = {
+	{ "dumb", dumb_init, dumb_add, dumb_remove, dumb_best },
+	{ "rb", rbt_init, rbt_add, rbt_remove, rbt_best },
+	{ "mq", mq_init, mq_add, mq_remove, mq_best },
+	{ "bmq", bmq_init, bmq_add, bmq_remove, bmq_best },
+};
+
+static const int queue_sizes[] = { 8, 16, 32, 64, 128, 256, 512 };
+
+static int next_prio(void)
+{
+	return MIN_PRIO + (int)((bench_rand() >> 8) % NUM_PRIOS);
+}
+
+static void run_backend(const struct queue_ops *ops, int nthreads)
+{
+	u32_t t_best = 0U, t_remove = 0U, t_add = 0U;
+	unsigned int key;
+
+	bench_rand_seed(nthreads);
+	ops->init();
+	for (int i = 0; i < nthreads; i++) {
+		threads[i].base.prio = next_prio();
+		ops->add(&threads[i]);
+	}
+
+	key = irq_lock();
+	for (int i = 0; i < N_RUNS; i++) {
+		u32_t t0, t1, t2, t3;
+		struct k_thread *th;
+
+		t0 = bench_cycles();
+		th = ops->best();
+		t1 = bench_cycles();
+		ops->remove(th);
+		t2 = bench_cycles();
+		th->base.prio = next_prio();
+		ops->add(th);
+		t3 = bench_cycles();
+
+		t_best += t1 - t0;
+		t_remove += t2 - t1;
+		t_add += t3 - t2;
+	}
+	irq_unlock(key);
+
+	for (int i = 0; i < nthreads; i++) {
+		ops->remove(&threads[i]);
+	}
+
+	printk("%-4s threads %4d best %5u remove %5u add %5u tot %5u\n",
+	       ops->name, nthreads, t_best / N_RUNS, t_remove / N_RUNS,
+	       t_add / N_RUNS, (t_best + t_remove + t_add) / N_RUNS);
+}
+
+void main(void)
+{
+	for (int i = 0; i < ARRAY_SIZE(queue_sizes); i++) {
+		for (int j = 0; j < ARRAY_SIZE(backends); j++) {
+			run_backend(&backends[j], queue_sizes[i]);
+		}
+	}
+	printk("fin\n");
+}
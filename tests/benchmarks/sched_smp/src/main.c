@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2019 Wind River Systems, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+
+/* SMP scheduler throughput benchmark.  Each CPU gets PAIRS_PER_CPU
+ * pairs of threads that ping-pong through two semaphores.  Every
+ * handoff makes one thread ready and blocks another, so the run is
+ * dominated by ready queue insertion and next-thread selection,
+ * which is where the global ready queue and its lock contend.
+ */
+
+#define PAIRS_PER_CPU 2
+#define NUM_PAIRS (PAIRS_PER_CPU * CONFIG_MP_NUM_CPUS)
+#define STACK_SIZE (1024 + CONFIG_TEST_EXTRA_STACKSIZE)
+#define RUN_MS 2000
+#define WORKER_PRIO K_PRIO_PREEMPT(1)
+
+struct pair {
+	struct k_sem ping;
+	struct k_sem pong;
+	u32_t handoffs;
+};
+
+static struct pair pairs[NUM_PAIRS];
+static struct k_thread threads[NUM_PAIRS][2];
+static K_THREAD_STACK_ARRAY_DEFINE(stacks, NUM_PAIRS * 2, STACK_SIZE);
+
+static volatile bool running;
+
+static void pinger(void *p1, void *p2, void *p3)
+{
+	struct pair *pair = p1;
+
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	while (running) {
+		k_sem_give(&pair->ping);
+		k_sem_take(&pair->pong, K_FOREVER);
+		pair->handoffs++;
+	}
+}
+
+static void ponger(void *p1, void *p2, void *p3)
+{
+	struct pair *pair = p1;
+
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	while (true) {
+		k_sem_take(&pair->ping, K_FOREVER);
+		k_sem_give(&pair->pong);
+	}
+}
+
+void main(void)
+{
+	u32_t total = 0U;
+	s64_t start;
+
+	running = true;
+
+	for (int i = 0; i < NUM_PAIRS; i++) {
+		k_sem_init(&pairs[i].ping, 0, 1);
+		k_sem_init(&pairs[i].pong, 0, 1);
+
+		k_thread_create(&threads[i][1], stacks[2 * i + 1], STACK_SIZE,
+				ponger, &pairs[i], NULL, NULL,
+				WORKER_PRIO, 0, K_NO_WAIT);
+		k_thread_create(&threads[i][0], stacks[2 * i], STACK_SIZE,
+				pinger, &pairs[i], NULL, NULL,
+				WORKER_PRIO, 0, K_NO_WAIT);
+	}
+
+	/* main() runs at a higher priority than the workers, so it
+	 * wakes up on time even with every CPU saturated.
+	 */
+	start = k_uptime_get();
+	k_sleep(RUN_MS);
+	running = false;
+
+	for (int i = 0; i < NUM_PAIRS; i++) {
+		total += pairs[i].handoffs;
+	}
+
+	printk("cpus %d runq %s pairs %2d handoffs %8u per sec %8u\n",
+	       CONFIG_MP_NUM_CPUS,
+	       IS_ENABLED(CONFIG_SCHED_CPU_RUNQ) ? "percpu" : "global",
+	       NUM_PAIRS, total,
+	       (u32_t)(total * 1000U / (k_uptime_get() - start)));
+	printk("fin\n");
+}
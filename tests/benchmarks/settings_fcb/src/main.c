@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2019 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <string.h>
+#include <sys/printk.h>
+#include <bench_utils.h>
+#include <bench_flash.h>
+#include <drivers/flash.h>
+#include <storage/flash_map.h>
+#include <settings/settings.h>
+
+/* Settings FCB compression benchmark.  It saves NAME_COUNT settings of
+ * VAL_LEN bytes in a pseudo random order, and reports the worst flash reads,
+ * bytes read and time of a save, for the saves which compressed the oldest
+ * FCB sector and for the others.  Flash operations are counted by wrappers
+ * around the driver's functions, a save compresses when it erases.
+ */
+
+#define NAME_COUNT 100
+#define VAL_LEN 64
+#define SAVE_COUNT 2000
+
+struct save_stats {
+	u32_t count;
+	u32_t max_reads;
+	u32_t max_read_bytes;
+	u64_t max_time;
+};
+
+void main(void)
+{
+	const struct flash_area *fa;
+	struct device *dev;
+	u8_t val[VAL_LEN];
+	char name[16];
+	struct save_stats compress = { 0 }, other = { 0 }, *stats;
+	u64_t time;
+	int err;
+
+	err = flash_area_open(DT_FLASH_AREA_STORAGE_ID, &fa);
+	if (err) {
+		printk("cannot open storage area: %d\n", err);
+		return;
+	}
+
+	dev = flash_area_get_device(fa);
+
+	/* The simulated flash is not erased when it is first created */
+	flash_write_protection_set(dev, false);
+	err = flash_area_erase(fa, 0, fa->fa_size);
+	flash_write_protection_set(dev, true);
+	if (err) {
+		printk("cannot erase storage area: %d\n", err);
+		return;
+	}
+
+	err = settings_subsys_init();
+	if (err) {
+		printk("cannot initialize settings: %d\n", err);
+		return;
+	}
+
+	bench_flash_start(dev);
+
+	printk("%u saves of %u settings of %u bytes, %u FCB sectors\n",
+	       SAVE_COUNT, NAME_COUNT, VAL_LEN,
+	       CONFIG_SETTINGS_FCB_NUM_AREAS + 1);
+
+	bench_rand_seed(1U);
+	for (u32_t i = 0U; i < SAVE_COUNT; i++) {
+		snprintk(name, sizeof(name), "bench/%u",
+			 (bench_rand() >> 8) % NAME_COUNT);
+		/* Never the same value, the save would be skipped */
+		(void)memset(val, 0, sizeof(val));
+		memcpy(val, &i, sizeof(i));
+
+		bench_flash_reset();
+		time = bench_now_ns();
+		err = settings_save_one(name, val, sizeof(val));
+		time = bench_now_ns() - time;
+
+		if (err) {
+			printk("cannot save: %d\n", err);
+			return;
+		}
+
+		stats = bench_flash.erases ? &compress : &other;
+		stats->count++;
+		stats->max_reads = MAX(stats->max_reads, bench_flash.reads);
+		stats->max_read_bytes = MAX(stats->max_read_bytes,
+					    bench_flash.read_bytes);
+		stats->max_time = MAX(stats->max_time, time);
+	}
+
+	bench_flash_stop(dev);
+
+	printk("compress %4u saves, max %8u reads %8u bytes %10u ns\n",
+	       compress.count, compress.max_reads, compress.max_read_bytes,
+	       (u32_t)compress.max_time);
+	printk("other    %4u saves, max %8u reads %8u bytes %10u ns\n",
+	       other.count, other.max_reads, other.max_read_bytes,
+	       (u32_t)other.max_time);
+
+	printk("fin\n");
+}
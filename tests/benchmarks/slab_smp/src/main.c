@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2019 Wind River Systems, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+
+/* SMP memory slab throughput benchmark.  One worker per CPU allocates
+ * a burst of blocks from a shared slab, touches them and frees them
+ * again, as fast as it can.  Without per-CPU caches every call takes
+ * the slab's lock, so the workers contend on it and on the cache line
+ * holding the free list.
+ */
+
+#define NUM_WORKERS CONFIG_MP_NUM_CPUS
+#define BURST 6
+#define BLK_SIZE 64
+#define STACK_SIZE (1024 + CONFIG_TEST_EXTRA_STACKSIZE)
+#define RUN_MS 2000
+#define WORKER_PRIO K_PRIO_PREEMPT(1)
+
+K_MEM_SLAB_DEFINE(bench_slab, BLK_SIZE, NUM_WORKERS * BURST * 4, 8);
+
+static struct k_thread threads[NUM_WORKERS];
+static K_THREAD_STACK_ARRAY_DEFINE(stacks, NUM_WORKERS, STACK_SIZE);
+static u32_t ops[NUM_WORKERS];
+
+static volatile bool running;
+
+static void worker(void *p1, void *p2, void *p3)
+{
+	u32_t *count = p1;
+	void *blocks[BURST];
+
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	while (running) {
+		for (int i = 0; i < BURST; i++) {
+			if (k_mem_slab_alloc(&bench_slab, &blocks[i],
+					     K_FOREVER) != 0) {
+				printk("allocation failed\n");
+				return;
+			}
+			*(u32_t *)blocks[i] = i;
+		}
+		for (int i = 0; i < BURST; i++) {
+			k_mem_slab_free(&bench_slab, &blocks[i]);
+		}
+		*count += BURST;
+	}
+}
+
+void main(void)
+{
+	u32_t total = 0U;
+	s64_t start;
+
+	running = true;
+
+	for (int i = 0; i < NUM_WORKERS; i++) {
+		k_thread_create(&threads[i], stacks[i], STACK_SIZE,
+				worker, &ops[i], NULL, NULL,
+				WORKER_PRIO, 0, K_NO_WAIT);
+	}
+
+	/* main() runs at a higher priority than the workers, so it
+	 * wakes up on time even with every CPU saturated.
+	 */
+	start = k_uptime_get();
+	k_sleep(RUN_MS);
+	running = false;
+
+	for (int i = 0; i < NUM_WORKERS; i++) {
+		total += ops[i];
+	}
+
+	printk("cpus %d slab %s ops %9u per sec %9u\n",
+	       CONFIG_MP_NUM_CPUS,
+	       IS_ENABLED(CONFIG_MEM_SLAB_MAGAZINE) ? "magazine" : "locked",
+	       total, (u32_t)(total * 1000ULL / (k_uptime_get() - start)));
+
+#ifdef CONFIG_MEM_SLAB_MAGAZINE
+	struct k_mem_slab_cache_stats stats;
+
+	k_mem_slab_cache_stats_get(&bench_slab, &stats);
+	printk("cache hits %u misses %u refills %u flushes %u\n",
+	       stats.hits, stats.misses, stats.refills, stats.flushes);
+#endif
+	printk("fin\n");
+}
@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2019 Wind River Systems, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <bench_utils.h>
+#include <timeout_q.h>
+
+/* Scaling benchmark for the kernel timeout queue.  The queue is
+ * filled with a number of pending timeouts far in the future, then
+ * random entries are repeatedly aborted and re-added with a new delay,
+ * the same churn a system with many blocking waits or k_timers puts
+ * on it.  Interrupts stay locked while measuring so nothing expires
+ * and no tick is announced underneath us.
+ */
+
+#define MAX_TIMEOUTS 10000
+#define N_RUNS 1000
+
+/* Measured delays never land ahead of the sentinel, so the timer
+ * driver is never reprogrammed while measuring.
+ */
+#define SENTINEL_DELAY 100
+#define MIN_DELAY 1000
+#define DELAY_SPAN 100000
+
+static struct _timeout timeouts[MAX_TIMEOUTS];
+static struct _timeout sentinel;
+
+static const int queue_sizes[] = { 10, 1000, 10000 };
+
+static void expired(struct _timeout *t)
+{
+	ARG_UNUSED(t);
+
+	printk("timeout expired during benchmark\n");
+}
+
+static void run(int ntimeouts)
+{
+	u32_t t_add = 0U, t_abort = 0U, t_remaining = 0U;
+	unsigned int key;
+
+	bench_rand_seed(ntimeouts);
+
+	key = irq_lock();
+
+	z_add_timeout(&sentinel, expired, SENTINEL_DELAY);
+	for (int i = 0; i < ntimeouts; i++) {
+		z_add_timeout(&timeouts[i], expired,
+			      MIN_DELAY + bench_rand() % DELAY_SPAN);
+	}
+
+	for (int i = 0; i < N_RUNS; i++) {
+		struct _timeout *to = &timeouts[bench_rand() % ntimeouts];
+		s32_t delay = MIN_DELAY + bench_rand() % DELAY_SPAN;
+		u32_t t0, t1, t2, t3;
+
+		t0 = bench_cycles();
+		(void)z_timeout_remaining(to);
+		t1 = bench_cycles();
+		z_abort_timeout(to);
+		t2 = bench_cycles();
+		z_add_timeout(to, expired, delay);
+		t3 = bench_cycles();
+
+		t_remaining += t1 - t0;
+		t_abort += t2 - t1;
+		t_add += t3 - t2;
+	}
+
+	for (int i = 0; i < ntimeouts; i++) {
+		z_abort_timeout(&timeouts[i]);
+	}
+	z_abort_timeout(&sentinel);
+
+	irq_unlock(key);
+
+	printk("%-5s timeouts %5d add %6u abort %5u remaining %6u\n",
+	       IS_ENABLED(CONFIG_TIMEOUT_WHEEL) ? "wheel" : "dlist",
+	       ntimeouts, t_add / N_RUNS, t_abort / N_RUNS,
+	       t_remaining / N_RUNS);
+}
+
+void main(void)
+{
+	for (int i = 0; i < ARRAY_SIZE(queue_sizes); i++) {
+		run(queue_sizes[i]);
+	}
+	printk("fin\n");
+}
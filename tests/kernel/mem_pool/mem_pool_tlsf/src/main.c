@@ -0,0 +1,235 @@
+/*
+ * Copyright (c) 2019 Wind River Systems, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+
+#define BLK_SIZE_MIN 32
+#define BLK_SIZE_MAX 1024
+#define BLK_NUM_MAX 2
+#define NUM_RAND 64
+#define RAND_ROUNDS 2000
+
+K_MEM_POOL_DEFINE(tpool, BLK_SIZE_MIN, BLK_SIZE_MAX, BLK_NUM_MAX, 4);
+
+/* Maximum size in the middle of a second level class */
+#define ODD_SIZE_MIN 256
+#define ODD_SIZE_MAX 1000
+#define ODD_NUM_MAX 3
+
+K_MEM_POOL_DEFINE(opool, ODD_SIZE_MIN, ODD_SIZE_MAX, ODD_NUM_MAX, 4);
+
+/* Deterministic LCG so failures reproduce */
+static u32_t rand_state = 1U;
+
+static u32_t next_rand(void)
+{
+	rand_state = rand_state * 1103515245U + 12345U;
+	return rand_state >> 8;
+}
+
+static void check_pool_empty(void)
+{
+	struct k_mem_block block[BLK_NUM_MAX];
+
+	/* Everything merged back: the buffer holds BLK_NUM_MAX maximum
+	 * sized blocks again
+	 */
+	for (int i = 0; i < BLK_NUM_MAX; i++) {
+		zassert_equal(k_mem_pool_alloc(&tpool, &block[i], BLK_SIZE_MAX,
+					       K_NO_WAIT), 0, NULL);
+	}
+	for (int i = 0; i < BLK_NUM_MAX; i++) {
+		k_mem_pool_free(&block[i]);
+	}
+}
+
+/**
+ * @addtogroup kernel_memory_pool_tests
+ * @{
+ */
+
+/**
+ * @brief Allocate exact sizes until the pool runs out
+ *
+ * @details Blocks are not rounded to powers of two, so many more odd
+ * sized blocks fit than in a buddy pool, and all of them can be freed
+ * through their block id.
+ */
+void test_tlsf_alloc_sizes(void)
+{
+	struct k_mem_block block[BLK_SIZE_MAX * BLK_NUM_MAX / BLK_SIZE_MIN];
+	int n;
+
+	for (n = 0; n < ARRAY_SIZE(block); n++) {
+		if (k_mem_pool_alloc(&tpool, &block[n], BLK_SIZE_MIN + 1,
+				     K_NO_WAIT) != 0) {
+			break;
+		}
+		/**TESTPOINT: 8 byte alignment, ids resolve to the block*/
+		zassert_false((uintptr_t)block[n].data % 8, NULL);
+		zassert_equal(block[n].id.pool, block[0].id.pool, NULL);
+		(void)memset(block[n].data, n, BLK_SIZE_MIN + 1);
+	}
+
+	/**TESTPOINT: 33 byte blocks take 40 bytes plus the header*/
+	zassert_true(n > BLK_SIZE_MAX * BLK_NUM_MAX / (BLK_SIZE_MIN * 2),
+		     "only %d blocks", n);
+
+	for (int i = 0; i < n; i++) {
+		zassert_equal(((u8_t *)block[i].data)[BLK_SIZE_MIN], (u8_t)i,
+			      NULL);
+		k_mem_pool_free_id(&block[i].id);
+	}
+
+	check_pool_empty();
+}
+
+/**
+ * @brief Free neighbours are merged
+ */
+void test_tlsf_merge(void)
+{
+	struct k_mem_block block[4], big;
+
+	for (int i = 0; i < ARRAY_SIZE(block); i++) {
+		zassert_equal(k_mem_pool_alloc(&tpool, &block[i],
+					       BLK_SIZE_MAX / 2, K_NO_WAIT),
+			      0, NULL);
+	}
+	zassert_equal(k_mem_pool_alloc(&tpool, &big, BLK_SIZE_MAX, K_NO_WAIT),
+		      -ENOMEM, NULL);
+
+	/**TESTPOINT: a block freed between two free blocks merges both*/
+	k_mem_pool_free(&block[0]);
+	k_mem_pool_free(&block[2]);
+	zassert_equal(k_mem_pool_alloc(&tpool, &big, BLK_SIZE_MAX, K_NO_WAIT),
+		      -ENOMEM, NULL);
+	k_mem_pool_free(&block[1]);
+	zassert_equal(k_mem_pool_alloc(&tpool, &big, BLK_SIZE_MAX, K_NO_WAIT),
+		      0, NULL);
+
+	k_mem_pool_free(&big);
+	k_mem_pool_free(&block[3]);
+	check_pool_empty();
+}
+
+/**
+ * @brief Resize blocks in place when possible
+ * @see k_mem_pool_realloc()
+ */
+void test_tlsf_realloc(void)
+{
+	u8_t *a, *b, *c;
+
+	a = k_mem_pool_realloc(&tpool, NULL, 100);
+	zassert_not_null(a, NULL);
+	for (int i = 0; i < 100; i++) {
+		a[i] = i;
+	}
+
+	/**TESTPOINT: grow into the free space that follows*/
+	zassert_equal(k_mem_pool_realloc(&tpool, a, 500), a, NULL);
+
+	/**TESTPOINT: shrink in place, the tail is usable again*/
+	zassert_equal(k_mem_pool_realloc(&tpool, a, 200), a, NULL);
+	b = k_mem_pool_malloc(&tpool, 200);
+	zassert_true(b > a && b < a + 500, NULL);
+
+	/**TESTPOINT: move when blocked, keeping the contents*/
+	c = k_mem_pool_realloc(&tpool, a, 300);
+	zassert_not_null(c, NULL);
+	zassert_not_equal(c, a, NULL);
+	for (int i = 0; i < 100; i++) {
+		zassert_equal(c[i], i, NULL);
+	}
+
+	/**TESTPOINT: failure leaves the block alone*/
+	zassert_is_null(k_mem_pool_realloc(&tpool, b,
+					   BLK_SIZE_MAX * 8), NULL);
+
+	/**TESTPOINT: size zero frees*/
+	zassert_is_null(k_mem_pool_realloc(&tpool, b, 0), NULL);
+	k_free(c);
+
+	check_pool_empty();
+}
+
+/**
+ * @brief Random allocations, frees and resizes keep blocks intact
+ */
+void test_tlsf_random(void)
+{
+	u8_t *ptr[NUM_RAND] = { NULL };
+	size_t len[NUM_RAND];
+
+	for (int r = 0; r < RAND_ROUNDS; r++) {
+		int i = next_rand() % NUM_RAND;
+		size_t sz = next_rand() % (BLK_SIZE_MAX / 4);
+
+		if (ptr[i] != NULL) {
+			for (size_t j = 0; j < len[i]; j++) {
+				zassert_equal(ptr[i][j], (u8_t)i, NULL);
+			}
+		}
+
+		if (ptr[i] == NULL || (next_rand() & 1) != 0U) {
+			void *p = k_mem_pool_realloc(&tpool, ptr[i], sz);
+
+			if (p == NULL && sz != 0) {
+				continue;
+			}
+			ptr[i] = p;
+			len[i] = ptr[i] != NULL ? sz : 0;
+			if (ptr[i] != NULL) {
+				(void)memset(ptr[i], i, sz);
+			}
+		} else {
+			k_free(ptr[i]);
+			ptr[i] = NULL;
+		}
+	}
+
+	for (int i = 0; i < NUM_RAND; i++) {
+		k_free(ptr[i]);
+	}
+
+	check_pool_empty();
+}
+
+/**
+ * @brief A pool holds its maximum sized blocks whatever their size
+ *
+ * @details The last of these blocks comes from a free block in the
+ * list of the request's own size, which good fit search only reaches
+ * by walking the head of that list.
+ */
+void test_tlsf_odd_max(void)
+{
+	struct k_mem_block block[ODD_NUM_MAX];
+
+	for (int i = 0; i < ODD_NUM_MAX; i++) {
+		zassert_equal(k_mem_pool_alloc(&opool, &block[i], ODD_SIZE_MAX,
+					       K_NO_WAIT), 0, NULL);
+	}
+	for (int i = 0; i < ODD_NUM_MAX; i++) {
+		k_mem_pool_free(&block[i]);
+	}
+}
+
+/**
+ * @}
+ */
+
+void test_main(void)
+{
+	ztest_test_suite(mpool_tlsf,
+			 ztest_unit_test(test_tlsf_alloc_sizes),
+			 ztest_unit_test(test_tlsf_merge),
+			 ztest_unit_test(test_tlsf_realloc),
+			 ztest_unit_test(test_tlsf_random),
+			 ztest_unit_test(test_tlsf_odd_max));
+	ztest_run_test_suite(mpool_tlsf);
+}
@@ -0,0 +1,177 @@
+/*
+ * Copyright (c) 2019 Wind River Systems, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+#include <stats/stats.h>
+
+#define BLK_SIZE_MIN 64
+#define BLK_SIZE_MAX 1024
+#define BLK_NUM_MAX 2
+
+K_MEM_POOL_DEFINE(upool, BLK_SIZE_MIN, BLK_SIZE_MAX, BLK_NUM_MAX, 4);
+
+static int count_free(size_t size)
+{
+	size_t block_size;
+	int count, total = 0;
+
+	for (int l = 0; ; l++) {
+		count = k_mem_pool_free_blocks_get(&upool, l, &block_size);
+		if (count < 0) {
+			break;
+		}
+		if (size == 0 || block_size == size) {
+			total += count;
+		}
+	}
+
+	return total;
+}
+
+/**
+ * @addtogroup kernel_memory_pool_tests
+ * @{
+ */
+
+/**
+ * @brief Track bytes in use, their peak and failed allocations
+ * @see k_mem_pool_usage_get()
+ */
+void test_mpool_usage(void)
+{
+	struct k_mem_block block[3], big[BLK_NUM_MAX * 2];
+	struct sys_mem_usage usage;
+	int n;
+
+	k_mem_pool_usage_get(&upool, &usage);
+	zassert_equal(usage.used, 0, NULL);
+	zassert_equal(usage.failed, 0, NULL);
+
+	for (int i = 0; i < ARRAY_SIZE(block); i++) {
+		zassert_equal(k_mem_pool_alloc(&upool, &block[i], BLK_SIZE_MIN,
+					       K_NO_WAIT), 0, NULL);
+	}
+	k_mem_pool_free(&block[1]);
+
+	/**TESTPOINT: both backends hand out exactly 64 byte blocks here*/
+	k_mem_pool_usage_get(&upool, &usage);
+	zassert_equal(usage.used, 2 * BLK_SIZE_MIN, NULL);
+	zassert_equal(usage.max_used, 3 * BLK_SIZE_MIN, NULL);
+
+	/**TESTPOINT: oversized and exhausting requests both fail*/
+	zassert_equal(k_mem_pool_alloc(&upool, &big[0], BLK_SIZE_MAX * 4,
+				       K_NO_WAIT), -ENOMEM, NULL);
+	for (n = 0; n < ARRAY_SIZE(big); n++) {
+		if (k_mem_pool_alloc(&upool, &big[n], BLK_SIZE_MAX,
+				     K_NO_WAIT) != 0) {
+			break;
+		}
+	}
+	zassert_true(n > 0 && n < ARRAY_SIZE(big), NULL);
+	k_mem_pool_usage_get(&upool, &usage);
+	zassert_equal(usage.failed, 2, NULL);
+	zassert_true(usage.max_used >= 2 * BLK_SIZE_MIN + n * BLK_SIZE_MAX,
+		     NULL);
+
+	while (n-- > 0) {
+		k_mem_pool_free(&big[n]);
+	}
+
+	k_mem_pool_free(&block[0]);
+	k_mem_pool_free(&block[2]);
+	k_mem_pool_usage_get(&upool, &usage);
+	zassert_equal(usage.used, 0, NULL);
+}
+
+/**
+ * @brief Count free blocks per size
+ * @see k_mem_pool_free_blocks_get()
+ */
+void test_mpool_free_blocks(void)
+{
+	struct k_mem_block block[2];
+	size_t block_size;
+
+	zassert_equal(k_mem_pool_free_blocks_get(&upool, -1, &block_size),
+		      -EINVAL, NULL);
+
+	for (int i = 0; i < ARRAY_SIZE(block); i++) {
+		zassert_equal(k_mem_pool_alloc(&upool, &block[i], BLK_SIZE_MIN,
+					       K_NO_WAIT), 0, NULL);
+	}
+	k_mem_pool_free(&block[0]);
+
+	/**TESTPOINT: the freed block is a hole of its own*/
+	if (IS_ENABLED(CONFIG_MEM_POOL_TLSF)) {
+		/* It, and what's left after the second block */
+		zassert_equal(count_free(0), 2, NULL);
+		zassert_equal(count_free(BLK_SIZE_MIN), 1, NULL);
+	} else {
+		zassert_equal(count_free(BLK_SIZE_MAX), BLK_NUM_MAX - 1, NULL);
+		zassert_equal(count_free(BLK_SIZE_MAX / 4), 3, NULL);
+		zassert_equal(count_free(BLK_SIZE_MIN), 3, NULL);
+	}
+
+	k_mem_pool_free(&block[1]);
+
+	/**TESTPOINT: everything merged back*/
+	if (IS_ENABLED(CONFIG_MEM_POOL_TLSF)) {
+		zassert_equal(count_free(0), 1, NULL);
+	} else {
+		zassert_equal(count_free(0), BLK_NUM_MAX, NULL);
+		zassert_equal(count_free(BLK_SIZE_MAX), BLK_NUM_MAX, NULL);
+	}
+}
+
+static int check_stat(struct stats_hdr *hdr, void *arg, const char *name,
+		      u16_t off)
+{
+	struct sys_mem_usage *usage = arg;
+	u32_t val = *(u32_t *)((u8_t *)hdr + off);
+
+	if (strcmp(name, "used") == 0) {
+		zassert_equal(val, usage->used, NULL);
+	} else if (strcmp(name, "max_used") == 0) {
+		zassert_equal(val, usage->max_used, NULL);
+	} else {
+		zassert_equal(strcmp(name, "failed"), 0, "stat %s", name);
+		zassert_equal(val, usage->failed, NULL);
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Read the counters through the statistics subsystem
+ */
+void test_mpool_usage_stats(void)
+{
+	struct stats_hdr *hdr = stats_group_find("upool");
+	struct sys_mem_usage usage;
+	struct k_mem_block block;
+
+	zassert_not_null(hdr, "pool not registered");
+	zassert_equal(hdr->s_cnt, 3, NULL);
+
+	zassert_equal(k_mem_pool_alloc(&upool, &block, BLK_SIZE_MIN,
+				       K_NO_WAIT), 0, NULL);
+	k_mem_pool_usage_get(&upool, &usage);
+	zassert_equal(stats_walk(hdr, check_stat, &usage), 0, NULL);
+	k_mem_pool_free(&block);
+}
+
+/**
+ * @}
+ */
+
+void test_main(void)
+{
+	ztest_test_suite(mpool_usage,
+			 ztest_unit_test(test_mpool_usage),
+			 ztest_unit_test(test_mpool_free_blocks),
+			 ztest_unit_test(test_mpool_usage_stats));
+	ztest_run_test_suite(mpool_usage);
+}
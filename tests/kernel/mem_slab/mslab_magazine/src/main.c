@@ -0,0 +1,135 @@
+/*
+ * Copyright (c) 2019 Wind River Systems, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+
+#define STACK_SIZE (512 + CONFIG_TEST_EXTRA_STACKSIZE)
+#define BLK_NUM 16
+#define BLK_SIZE 16
+#define MAG_SIZE CONFIG_MEM_SLAB_MAGAZINE_SIZE
+#define TIMEOUT 100
+
+K_MEM_SLAB_DEFINE(mslab, BLK_SIZE, BLK_NUM, 4);
+
+K_THREAD_STACK_DEFINE(tstack, STACK_SIZE);
+static struct k_thread tdata;
+
+static void *waiter_block;
+
+static void alloc_all(void **blocks)
+{
+	for (int i = 0; i < BLK_NUM; i++) {
+		zassert_equal(k_mem_slab_alloc(&mslab, &blocks[i], K_NO_WAIT),
+			      0, NULL);
+		zassert_equal(k_mem_slab_num_used_get(&mslab), i + 1, NULL);
+		/* Scribble over the whole block, link word included */
+		(void)memset(blocks[i], i, BLK_SIZE);
+	}
+}
+
+static void free_all(void **blocks)
+{
+	for (int i = 0; i < BLK_NUM; i++) {
+		zassert_equal(*(u8_t *)blocks[i], (u8_t)i, NULL);
+		k_mem_slab_free(&mslab, &blocks[i]);
+		zassert_equal(k_mem_slab_num_free_get(&mslab), i + 1, NULL);
+	}
+}
+
+/**
+ * @addtogroup kernel_memory_slab_tests
+ * @{
+ */
+
+/**
+ * @brief Check which calls the magazines serve
+ *
+ * @details With magazines of 4 blocks, every fifth allocation misses and
+ * loads a magazine from the slab, until the slab runs dry.  Frees fill
+ * the loaded and previous magazines, then return every further full
+ * magazine to the slab.
+ * @see k_mem_slab_cache_stats_get()
+ */
+void test_mslab_magazine_stats(void)
+{
+	void *blocks[BLK_NUM], *block;
+	struct k_mem_slab_cache_stats stats;
+
+	zassert_equal(MAG_SIZE, 4, "test assumes 4 block magazines");
+
+	alloc_all(blocks);
+	k_mem_slab_cache_stats_get(&mslab, &stats);
+	zassert_equal(stats.hits, 12, NULL);
+	zassert_equal(stats.misses, 4, NULL);
+	zassert_equal(stats.refills, 3, NULL);
+	zassert_equal(stats.cached, 0, NULL);
+
+	/**TESTPOINT: cached blocks all handed out, the slab is empty*/
+	zassert_equal(k_mem_slab_alloc(&mslab, &block, K_NO_WAIT), -ENOMEM,
+		      NULL);
+
+	free_all(blocks);
+	k_mem_slab_cache_stats_get(&mslab, &stats);
+	zassert_equal(stats.misses, 5, NULL);
+	zassert_equal(stats.flushes, 2, NULL);
+	zassert_equal(stats.cached, 7, NULL);
+	zassert_equal(k_mem_slab_num_used_get(&mslab), 0, NULL);
+
+	/**TESTPOINT: cached and depot blocks are all usable again*/
+	alloc_all(blocks);
+	free_all(blocks);
+}
+
+static void waiter(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	zassert_equal(k_mem_slab_alloc(&mslab, &waiter_block, K_FOREVER), 0,
+		      NULL);
+}
+
+/**
+ * @brief A freed block goes to a waiting thread, not to a magazine
+ */
+void test_mslab_magazine_waiter(void)
+{
+	void *blocks[BLK_NUM];
+	struct k_mem_slab_cache_stats before, after;
+
+	alloc_all(blocks);
+
+	k_thread_create(&tdata, tstack, STACK_SIZE, waiter, NULL, NULL, NULL,
+			K_PRIO_PREEMPT(0), 0, K_NO_WAIT);
+	k_sleep(TIMEOUT);
+
+	k_mem_slab_cache_stats_get(&mslab, &before);
+	k_mem_slab_free(&mslab, &blocks[0]);
+	k_sleep(TIMEOUT);
+
+	/**TESTPOINT: the waiter got the block, no magazine did*/
+	zassert_equal(waiter_block, blocks[0], NULL);
+	k_mem_slab_cache_stats_get(&mslab, &after);
+	zassert_equal(after.cached, before.cached, NULL);
+	zassert_equal(k_mem_slab_num_used_get(&mslab), BLK_NUM, NULL);
+
+	blocks[0] = waiter_block;
+	free_all(blocks);
+	k_thread_abort(&tdata);
+}
+
+/**
+ * @}
+ */
+
+void test_main(void)
+{
+	ztest_test_suite(mslab_magazine,
+			 ztest_unit_test(test_mslab_magazine_stats),
+			 ztest_unit_test(test_mslab_magazine_waiter));
+	ztest_run_test_suite(mslab_magazine);
+}
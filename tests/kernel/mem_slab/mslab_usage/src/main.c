@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2019 Wind River Systems, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+#include <stats/stats.h>
+
+#define BLK_NUM 4
+#define BLK_SIZE 16
+#define TIMEOUT 10
+
+K_MEM_SLAB_DEFINE(uslab, BLK_SIZE, BLK_NUM, 4);
+
+/**
+ * @addtogroup kernel_memory_slab_tests
+ * @{
+ */
+
+/**
+ * @brief Track blocks in use, their peak and failed allocations
+ * @see k_mem_slab_usage_get()
+ */
+void test_mslab_usage(void)
+{
+	void *blocks[BLK_NUM], *block;
+	struct sys_mem_usage usage;
+
+	for (int i = 0; i < BLK_NUM; i++) {
+		zassert_equal(k_mem_slab_alloc(&uslab, &blocks[i], K_NO_WAIT),
+			      0, NULL);
+	}
+
+	/**TESTPOINT: failures with and without a timeout both count*/
+	zassert_equal(k_mem_slab_alloc(&uslab, &block, K_NO_WAIT), -ENOMEM,
+		      NULL);
+	zassert_equal(k_mem_slab_alloc(&uslab, &block, TIMEOUT), -EAGAIN,
+		      NULL);
+
+	k_mem_slab_free(&uslab, &blocks[0]);
+	k_mem_slab_free(&uslab, &blocks[1]);
+
+	k_mem_slab_usage_get(&uslab, &usage);
+	zassert_equal(usage.used, BLK_NUM - 2, NULL);
+	zassert_equal(usage.max_used, BLK_NUM, NULL);
+	zassert_equal(usage.failed, 2, NULL);
+
+	k_mem_slab_free(&uslab, &blocks[2]);
+	k_mem_slab_free(&uslab, &blocks[3]);
+
+	k_mem_slab_usage_get(&uslab, &usage);
+	zassert_equal(usage.used, 0, NULL);
+	zassert_equal(usage.max_used, BLK_NUM, NULL);
+}
+
+/**
+ * @brief Read the counters through the statistics subsystem
+ */
+void test_mslab_usage_stats(void)
+{
+	struct stats_hdr *hdr = stats_group_find("uslab");
+	struct sys_mem_usage usage;
+
+	zassert_not_null(hdr, "slab not registered");
+	zassert_equal(hdr->s_cnt, 3, NULL);
+
+	/* k_mem_slab_usage_get() also refreshes the group */
+	k_mem_slab_usage_get(&uslab, &usage);
+	zassert_equal(memcmp((u8_t *)hdr + sizeof(*hdr), &usage.used,
+			     3 * sizeof(u32_t)), 0, NULL);
+}
+
+/**
+ * @}
+ */
+
+void test_main(void)
+{
+	ztest_test_suite(mslab_usage,
+			 ztest_unit_test(test_mslab_usage),
+			 ztest_unit_test(test_mslab_usage_stats));
+	ztest_run_test_suite(mslab_usage);
+}
@@ -21,6 +21,8 @@ extern void test_msgq_purge_when_put(void);
 extern void test_msgq_attrs_get(void);
 extern void test_msgq_alloc(void);
 extern void test_msgq_pend_thread(void);
+extern void test_msgq_put_many(void);
+extern void test_msgq_get_many(void);
 #ifdef CONFIG_USERSPACE
 extern void test_msgq_user_thread(void);
 extern void test_msgq_user_thread_overflow(void);
@@ -74,6 +76,8 @@ void test_main(void)
 			 ztest_1cpu_unit_test(test_msgq_purge_when_put),
 			 ztest_user_unit_test(test_msgq_user_purge_when_put),
 			 ztest_1cpu_unit_test(test_msgq_pend_thread),
-			 ztest_unit_test(test_msgq_alloc));
+			 ztest_unit_test(test_msgq_alloc),
+			 ztest_1cpu_unit_test(test_msgq_put_many),
+			 ztest_1cpu_unit_test(test_msgq_get_many));
 	ztest_run_test_suite(msgq_api);
 }
@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2019 Wind River Systems, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "test_msgq.h"
+
+#define NUM_READERS 2
+
+K_THREAD_STACK_EXTERN(tstack);
+K_THREAD_STACK_EXTERN(tstack1);
+extern struct k_thread tdata;
+extern struct k_thread tdata1;
+extern struct k_msgq msgq;
+static ZTEST_BMEM char __aligned(4) tbuffer[MSG_SIZE * MSGQ_LEN];
+static ZTEST_DMEM u32_t data[] = { MSG0, MSG1, MSG0 + 1, MSG1 + 1 };
+static ZTEST_BMEM u32_t rx_data[NUM_READERS];
+
+static void reader_entry(void *p1, void *p2, void *p3)
+{
+	int idx = POINTER_TO_INT(p1);
+
+	zassert_equal(k_msgq_get(&msgq, &rx_data[idx], K_FOREVER), 0, NULL);
+}
+
+static void writer_entry(void *p1, void *p2, void *p3)
+{
+	zassert_equal(k_msgq_put(&msgq, p1, K_FOREVER), 0, NULL);
+}
+
+/**
+ * @addtogroup kernel_message_queue_tests
+ * @{
+ */
+
+/**
+ * @brief Batch send to a queue with waiting readers
+ *
+ * @details Waiting readers get the first messages of the batch directly,
+ * the rest go to the ring buffer until it is full.
+ * @see k_msgq_put_many()
+ */
+void test_msgq_put_many(void)
+{
+	u32_t rx[MSGQ_LEN];
+
+	k_msgq_init(&msgq, tbuffer, MSG_SIZE, MSGQ_LEN);
+
+	k_thread_create(&tdata, tstack, STACK_SIZE, reader_entry,
+			INT_TO_POINTER(0), NULL, NULL,
+			K_PRIO_PREEMPT(0), 0, K_NO_WAIT);
+	k_thread_create(&tdata1, tstack1, STACK_SIZE, reader_entry,
+			INT_TO_POINTER(1), NULL, NULL,
+			K_PRIO_PREEMPT(0), 0, K_NO_WAIT);
+	k_sleep(TIMEOUT >> 1);
+
+	/**TESTPOINT: two messages to readers, two to the ring buffer*/
+	zassert_equal(k_msgq_put_many(&msgq, data, ARRAY_SIZE(data),
+				      K_NO_WAIT), ARRAY_SIZE(data), NULL);
+	k_sleep(TIMEOUT >> 1);
+
+	zassert_equal(rx_data[0], data[0], NULL);
+	zassert_equal(rx_data[1], data[1], NULL);
+	zassert_equal(k_msgq_num_used_get(&msgq), MSGQ_LEN, NULL);
+
+	/**TESTPOINT: a full queue takes nothing*/
+	zassert_equal(k_msgq_put_many(&msgq, data, 1, K_NO_WAIT), -ENOMSG,
+		      NULL);
+	zassert_equal(k_msgq_put_many(&msgq, data, 1, TIMEOUT), -EAGAIN,
+		      NULL);
+
+	zassert_equal(k_msgq_get_many(&msgq, rx, MSGQ_LEN, K_NO_WAIT),
+		      MSGQ_LEN, NULL);
+	zassert_equal(rx[0], data[2], NULL);
+	zassert_equal(rx[1], data[3], NULL);
+
+	k_thread_abort(&tdata);
+	k_thread_abort(&tdata1);
+}
+
+/**
+ * @brief Batch receive from a queue with a waiting writer
+ *
+ * @details The writer refills the slot freed by the first message, so a
+ * single call returns the ring buffer contents followed by its message.
+ * @see k_msgq_get_many()
+ */
+void test_msgq_get_many(void)
+{
+	u32_t rx[ARRAY_SIZE(data)];
+
+	k_msgq_init(&msgq, tbuffer, MSG_SIZE, MSGQ_LEN);
+	zassert_equal(k_msgq_put_many(&msgq, data, MSGQ_LEN, K_NO_WAIT),
+		      MSGQ_LEN, NULL);
+
+	k_thread_create(&tdata, tstack, STACK_SIZE, writer_entry,
+			&data[2], NULL, NULL,
+			K_PRIO_PREEMPT(0), 0, K_NO_WAIT);
+	k_sleep(TIMEOUT >> 1);
+
+	/**TESTPOINT: ring buffer then the writer's message, in order*/
+	zassert_equal(k_msgq_get_many(&msgq, rx, ARRAY_SIZE(rx), K_NO_WAIT),
+		      MSGQ_LEN + 1, NULL);
+	for (int i = 0; i < MSGQ_LEN + 1; i++) {
+		zassert_equal(rx[i], data[i], NULL);
+	}
+
+	/**TESTPOINT: an empty queue gives nothing*/
+	zassert_equal(k_msgq_get_many(&msgq, rx, 1, K_NO_WAIT), -ENOMSG,
+		      NULL);
+	zassert_equal(k_msgq_get_many(&msgq, rx, 1, TIMEOUT), -EAGAIN,
+		      NULL);
+	zassert_equal(k_msgq_get_many(&msgq, rx, 0, K_NO_WAIT), -EINVAL,
+		      NULL);
+
+	k_thread_abort(&tdata);
+}
+
+/**
+ * @}
+ */
@@ -0,0 +1,321 @@
+/*
+ * Copyright (c) 2019 Wind River Systems, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+#include <irq_offload.h>
+
+#define STACK_SIZE (512 + CONFIG_TEST_EXTRA_STACKSIZE)
+#define MSGQ_LEN 8
+#define NUM_PRODUCERS 3
+#define NUM_MSGS 500
+#define TIMEOUT 100
+
+K_MSGQ_DEFINE_SPSC(spsc_q, sizeof(u32_t), MSGQ_LEN, 4);
+K_MSGQ_DEFINE_MPSC(mpsc_q, sizeof(u32_t), MSGQ_LEN, 4);
+
+static struct k_msgq msgq;
+static char __aligned(4) msgq_buf[MSGQ_LEN * sizeof(u32_t)];
+static atomic_t msgq_seq[MSGQ_LEN];
+
+K_THREAD_STACK_ARRAY_DEFINE(stacks, NUM_PRODUCERS, STACK_SIZE);
+static struct k_thread threads[NUM_PRODUCERS];
+
+static void producer(void *p1, void *p2, void *p3)
+{
+	struct k_msgq *q = p1;
+	u32_t id = POINTER_TO_UINT(p2);
+	u32_t batch[4];
+
+	ARG_UNUSED(p3);
+
+	for (u32_t i = 0; i < NUM_MSGS; ) {
+		int n;
+
+		/* Mix single and batched sends */
+		if (i % 3 == 0) {
+			u32_t msg = (id << 16) | i;
+
+			zassert_equal(k_msgq_put(q, &msg, K_FOREVER), 0, NULL);
+			i++;
+			continue;
+		}
+
+		for (n = 0; n < ARRAY_SIZE(batch) && i + n < NUM_MSGS; n++) {
+			batch[n] = (id << 16) | (i + n);
+		}
+		n = k_msgq_put_many(q, batch, n, K_FOREVER);
+		zassert_true(n > 0, NULL);
+		i += n;
+	}
+}
+
+static void consume(struct k_msgq *q, int nproducers)
+{
+	u32_t next[NUM_PRODUCERS] = { 0 };
+	u32_t msgs[MSGQ_LEN];
+	int total = 0;
+
+	while (total < nproducers * NUM_MSGS) {
+		int n = k_msgq_get_many(q, msgs, ARRAY_SIZE(msgs), K_FOREVER);
+
+		zassert_true(n > 0, NULL);
+		for (int i = 0; i < n; i++) {
+			u32_t id = msgs[i] >> 16;
+
+			/**TESTPOINT: each producer's messages arrive
+			 * complete and in order
+			 */
+			zassert_true(id < nproducers, NULL);
+			zassert_equal(msgs[i] & 0xffff, next[id], NULL);
+			next[id]++;
+		}
+		total += n;
+	}
+
+	zassert_equal(k_msgq_num_used_get(q), 0, NULL);
+}
+
+static void start_producers(struct k_msgq *q, int nproducers, int prio)
+{
+	for (int i = 0; i < nproducers; i++) {
+		k_thread_create(&threads[i], stacks[i], STACK_SIZE,
+				producer, q, UINT_TO_POINTER(i), NULL,
+				prio, 0, K_NO_WAIT);
+	}
+}
+
+static void join_producers(int nproducers)
+{
+	for (int i = 0; i < nproducers; i++) {
+		k_thread_abort(&threads[i]);
+	}
+}
+
+/**
+ * @addtogroup kernel_message_queue_tests
+ * @{
+ */
+
+/**
+ * @brief Stream messages through a single producer queue
+ *
+ * @details Run the producer both above and below the consumer's
+ * priority, so that each side has to block on the other.
+ */
+void test_msgq_lf_spsc(void)
+{
+	start_producers(&spsc_q, 1, K_PRIO_PREEMPT(0));
+	consume(&spsc_q, 1);
+	join_producers(1);
+
+	start_producers(&spsc_q, 1, K_PRIO_PREEMPT(10));
+	consume(&spsc_q, 1);
+	join_producers(1);
+}
+
+/**
+ * @brief Stream messages from several producers
+ */
+void test_msgq_lf_mpsc(void)
+{
+	start_producers(&mpsc_q, NUM_PRODUCERS, K_PRIO_PREEMPT(0));
+	consume(&mpsc_q, NUM_PRODUCERS);
+	join_producers(NUM_PRODUCERS);
+
+	start_producers(&mpsc_q, NUM_PRODUCERS, K_PRIO_PREEMPT(10));
+	consume(&mpsc_q, NUM_PRODUCERS);
+	join_producers(NUM_PRODUCERS);
+}
+
+/**
+ * @brief Check partial batches, wraparound and the counters
+ */
+void test_msgq_lf_batch(void)
+{
+	u32_t tx[MSGQ_LEN + 2], rx[MSGQ_LEN + 2];
+	struct k_msgq_attrs attrs;
+
+	for (int i = 0; i < ARRAY_SIZE(tx); i++) {
+		tx[i] = i;
+	}
+
+	zassert_equal(k_msgq_lockfree_init(&msgq, msgq_buf, sizeof(u32_t),
+					   MSGQ_LEN, msgq_seq), 0, NULL);
+
+	/* Offset the indices so the batches below wrap */
+	zassert_equal(k_msgq_put_many(&msgq, tx, 5, K_NO_WAIT), 5, NULL);
+	zassert_equal(k_msgq_get_many(&msgq, rx, 5, K_NO_WAIT), 5, NULL);
+
+	zassert_equal(k_msgq_put_many(&msgq, tx, 6, K_NO_WAIT), 6, NULL);
+	/**TESTPOINT: a batch larger than the free space is cut short*/
+	zassert_equal(k_msgq_put_many(&msgq, &tx[6], 4, K_NO_WAIT), 2, NULL);
+	zassert_equal(k_msgq_put_many(&msgq, tx, 1, K_NO_WAIT), -ENOMSG,
+		      NULL);
+
+	zassert_equal(k_msgq_num_used_get(&msgq), MSGQ_LEN, NULL);
+	zassert_equal(k_msgq_num_free_get(&msgq), 0, NULL);
+	k_msgq_get_attrs(&msgq, &attrs);
+	zassert_equal(attrs.used_msgs, MSGQ_LEN, NULL);
+
+	zassert_equal(k_msgq_peek(&msgq, &rx[0]), 0, NULL);
+	zassert_equal(rx[0], 0, NULL);
+
+	/**TESTPOINT: get everything back in order across the wrap*/
+	zassert_equal(k_msgq_get_many(&msgq, rx, ARRAY_SIZE(rx), K_NO_WAIT),
+		      MSGQ_LEN, NULL);
+	for (int i = 0; i < MSGQ_LEN; i++) {
+		zassert_equal(rx[i], i, NULL);
+	}
+
+	zassert_equal(k_msgq_get_many(&msgq, rx, 1, K_NO_WAIT), -ENOMSG,
+		      NULL);
+	zassert_equal(k_msgq_put_many(&msgq, tx, 0, K_NO_WAIT), -EINVAL,
+		      NULL);
+}
+
+/**
+ * @brief Check that blocking calls time out
+ */
+void test_msgq_lf_timeout(void)
+{
+	u32_t msg = 0;
+	s64_t start;
+
+	zassert_equal(k_msgq_lockfree_init(&msgq, msgq_buf, sizeof(u32_t),
+					   MSGQ_LEN, NULL), 0, NULL);
+
+	start = k_uptime_get();
+	zassert_equal(k_msgq_get(&msgq, &msg, TIMEOUT), -EAGAIN, NULL);
+	zassert_true(k_uptime_get() - start >= TIMEOUT, NULL);
+
+	for (int i = 0; i < MSGQ_LEN; i++) {
+		zassert_equal(k_msgq_put(&msgq, &msg, K_NO_WAIT), 0, NULL);
+	}
+	zassert_equal(k_msgq_put(&msgq, &msg, K_NO_WAIT), -ENOMSG, NULL);
+	zassert_equal(k_msgq_put(&msgq, &msg, TIMEOUT), -EAGAIN, NULL);
+}
+
+static void purge_entry(void *p1, void *p2, void *p3)
+{
+	u32_t msg = 0;
+
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	zassert_equal(k_msgq_put(p1, &msg, K_FOREVER), -ENOMSG, NULL);
+}
+
+/**
+ * @brief Purge a full queue with a blocked producer
+ */
+void test_msgq_lf_purge(void)
+{
+	u32_t msg = 0;
+
+	zassert_equal(k_msgq_lockfree_init(&msgq, msgq_buf, sizeof(u32_t),
+					   MSGQ_LEN, msgq_seq), 0, NULL);
+
+	for (int i = 0; i < MSGQ_LEN; i++) {
+		zassert_equal(k_msgq_put(&msgq, &msg, K_NO_WAIT), 0, NULL);
+	}
+
+	k_thread_create(&threads[0], stacks[0], STACK_SIZE,
+			purge_entry, &msgq, NULL, NULL,
+			K_PRIO_PREEMPT(0), 0, K_NO_WAIT);
+	k_sleep(TIMEOUT >> 1);
+
+	/**TESTPOINT: purge empties the queue and fails blocked senders*/
+	k_msgq_purge(&msgq);
+	zassert_equal(k_msgq_num_used_get(&msgq), 0, NULL);
+	zassert_equal(k_msgq_peek(&msgq, &msg), -ENOMSG, NULL);
+
+	k_sleep(TIMEOUT >> 1);
+	zassert_equal(k_msgq_num_used_get(&msgq), 0, NULL);
+	k_thread_abort(&threads[0]);
+}
+
+static void isr_put(void *param)
+{
+	u32_t msg = POINTER_TO_UINT(param);
+
+	zassert_equal(k_msgq_put(&mpsc_q, &msg, K_NO_WAIT), 0, NULL);
+}
+
+static void isr_get(void *param)
+{
+	u32_t msg;
+
+	zassert_equal(k_msgq_get(&mpsc_q, &msg, K_NO_WAIT), 0, NULL);
+	zassert_equal(msg, POINTER_TO_UINT(param), NULL);
+}
+
+/**
+ * @brief Send and receive from ISR context
+ */
+void test_msgq_lf_isr(void)
+{
+	u32_t msg;
+
+	irq_offload(isr_put, UINT_TO_POINTER(0x1234));
+	zassert_equal(k_msgq_get(&mpsc_q, &msg, K_NO_WAIT), 0, NULL);
+	zassert_equal(msg, 0x1234, NULL);
+
+	msg = 0x5678;
+	zassert_equal(k_msgq_put(&mpsc_q, &msg, K_NO_WAIT), 0, NULL);
+	irq_offload(isr_get, UINT_TO_POINTER(0x5678));
+}
+
+/**
+ * @brief Reject sizes that are not a power of 2
+ */
+void test_msgq_lf_init(void)
+{
+	zassert_equal(k_msgq_lockfree_init(&msgq, msgq_buf, sizeof(u32_t),
+					   MSGQ_LEN - 1, NULL), -EINVAL, NULL);
+	zassert_equal(k_msgq_lockfree_init(&msgq, msgq_buf, sizeof(u32_t),
+					   0, NULL), -EINVAL, NULL);
+}
+
+/**
+ * @brief Batch calls on a regular, locked message queue
+ */
+void test_msgq_batch_locked(void)
+{
+	u32_t tx[MSGQ_LEN + 2], rx[MSGQ_LEN + 2];
+
+	for (int i = 0; i < ARRAY_SIZE(tx); i++) {
+		tx[i] = i;
+	}
+
+	k_msgq_init(&msgq, msgq_buf, sizeof(u32_t), MSGQ_LEN);
+
+	zassert_equal(k_msgq_put_many(&msgq, tx, ARRAY_SIZE(tx), K_NO_WAIT),
+		      MSGQ_LEN, NULL);
+	zassert_equal(k_msgq_get_many(&msgq, rx, ARRAY_SIZE(rx), K_NO_WAIT),
+		      MSGQ_LEN, NULL);
+	for (int i = 0; i < MSGQ_LEN; i++) {
+		zassert_equal(rx[i], i, NULL);
+	}
+	zassert_equal(k_msgq_get_many(&msgq, rx, 1, TIMEOUT), -EAGAIN, NULL);
+}
+
+/**
+ * @}
+ */
+
+void test_main(void)
+{
+	ztest_test_suite(msgq_lockfree,
+			 ztest_unit_test(test_msgq_lf_init),
+			 ztest_unit_test(test_msgq_lf_batch),
+			 ztest_unit_test(test_msgq_lf_timeout),
+			 ztest_unit_test(test_msgq_lf_isr),
+			 ztest_1cpu_unit_test(test_msgq_lf_purge),
+			 ztest_unit_test(test_msgq_lf_spsc),
+			 ztest_unit_test(test_msgq_lf_mpsc),
+			 ztest_unit_test(test_msgq_batch_locked));
+	ztest_run_test_suite(msgq_lockfree);
+}
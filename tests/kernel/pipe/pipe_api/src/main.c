@@ -24,6 +24,10 @@ extern void test_half_pipe_block_put_sema(void);
 extern void test_pipe_alloc(void);
 extern void test_pipe_reader_wait(void);
 extern void test_pipe_block_writer_wait(void);
+extern void test_pipe_claim_commit(void);
+extern void test_pipe_put_commit_wakes_reader(void);
+extern void test_pipe_get_commit_wakes_writer(void);
+extern void test_pipe_get_commit_block_put(void);
 #ifdef CONFIG_USERSPACE
 extern void test_pipe_user_thread2thread(void);
 extern void test_pipe_user_put_fail(void);
@@ -75,6 +79,10 @@ void test_main(void)
 			 ztest_unit_test(test_half_pipe_get_put),
 			 ztest_1cpu_unit_test(test_pipe_alloc),
 			 ztest_unit_test(test_pipe_reader_wait),
-			 ztest_1cpu_unit_test(test_pipe_block_writer_wait));
+			 ztest_1cpu_unit_test(test_pipe_block_writer_wait),
+			 ztest_unit_test(test_pipe_claim_commit),
+			 ztest_1cpu_unit_test(test_pipe_put_commit_wakes_reader),
+			 ztest_1cpu_unit_test(test_pipe_get_commit_wakes_writer),
+			 ztest_unit_test(test_pipe_get_commit_block_put));
 	ztest_run_test_suite(pipe_api);
 }
@@ -0,0 +1,192 @@
+/*
+ * Copyright (c) 2019 Wind River Systems, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+
+#define STACK_SIZE	(1024 + CONFIG_TEST_EXTRA_STACKSIZE)
+#define PIPE_LEN	16
+#define CHUNK		6
+
+K_PIPE_DEFINE(claim_pipe, PIPE_LEN, 4);
+K_MEM_POOL_DEFINE(claim_pool, 16, 16, 1, 4);
+
+K_THREAD_STACK_EXTERN(tstack);
+extern struct k_thread tdata;
+
+static const unsigned char data[] = "abcdefghijklmnopqrstuvwxyz";
+static unsigned char rx_data[PIPE_LEN];
+static size_t rx_bytes;
+
+static void claim_fill(struct k_pipe *pipe, const unsigned char *src,
+		       size_t len)
+{
+	while (len > 0) {
+		u8_t *buf;
+		size_t n = k_pipe_put_claim(pipe, &buf, len);
+
+		zassert_true(n > 0, NULL);
+		memcpy(buf, src, n);
+		zassert_equal(k_pipe_put_commit(pipe, n), 0, NULL);
+		src += n;
+		len -= n;
+	}
+}
+
+static void reader_entry(void *p1, void *p2, void *p3)
+{
+	zassert_equal(k_pipe_get(&claim_pipe, rx_data, CHUNK, &rx_bytes,
+				 CHUNK, K_FOREVER), 0, NULL);
+}
+
+static void writer_entry(void *p1, void *p2, void *p3)
+{
+	size_t written;
+
+	zassert_equal(k_pipe_put(&claim_pipe, (void *)data, CHUNK, &written,
+				 CHUNK, K_FOREVER), 0, NULL);
+}
+
+/**
+ * @addtogroup kernel_pipe_tests
+ * @{
+ */
+
+/**
+ * @brief Write and read a pipe in place, across the buffer wrap
+ * @see k_pipe_put_claim(), k_pipe_put_commit(), k_pipe_get_claim(),
+ * k_pipe_get_commit()
+ */
+void test_pipe_claim_commit(void)
+{
+	unsigned char rx[PIPE_LEN];
+	size_t bytes_read;
+	u8_t *buf;
+
+	/* Offset the indices so the claims below wrap */
+	claim_fill(&claim_pipe, data, CHUNK);
+	zassert_equal(k_pipe_get(&claim_pipe, rx, CHUNK, &bytes_read, CHUNK,
+				 K_NO_WAIT), 0, NULL);
+
+	/**TESTPOINT: a claim stops at the end of the ring buffer*/
+	zassert_equal(k_pipe_put_claim(&claim_pipe, &buf, PIPE_LEN),
+		      PIPE_LEN - CHUNK, NULL);
+	zassert_equal(k_pipe_put_commit(&claim_pipe, 0), 0, NULL);
+
+	claim_fill(&claim_pipe, data, PIPE_LEN);
+	zassert_equal(k_pipe_put_claim(&claim_pipe, &buf, 1), 0, NULL);
+	/**TESTPOINT: can't commit more than there is room for*/
+	zassert_equal(k_pipe_put_commit(&claim_pipe, 1), -EINVAL, NULL);
+
+	/**TESTPOINT: read back in place, in order*/
+	for (size_t off = 0; off < PIPE_LEN; ) {
+		size_t n = k_pipe_get_claim(&claim_pipe, &buf, PIPE_LEN);
+
+		zassert_true(n > 0, NULL);
+		zassert_mem_equal(buf, &data[off], n, NULL);
+		zassert_equal(k_pipe_get_commit(&claim_pipe, n), 0, NULL);
+		off += n;
+	}
+
+	zassert_equal(k_pipe_get_claim(&claim_pipe, &buf, 1), 0, NULL);
+	zassert_equal(k_pipe_get_commit(&claim_pipe, 1), -EINVAL, NULL);
+}
+
+/**
+ * @brief A put commit hands data to a waiting reader
+ */
+void test_pipe_put_commit_wakes_reader(void)
+{
+	k_tid_t tid = k_thread_create(&tdata, tstack, STACK_SIZE,
+				      reader_entry, NULL, NULL, NULL,
+				      K_PRIO_PREEMPT(0), 0, K_NO_WAIT);
+
+	k_sleep(10);
+	rx_bytes = 0;
+
+	claim_fill(&claim_pipe, data, CHUNK);
+
+	/**TESTPOINT: the commit copies straight into the reader*/
+	zassert_mem_equal(rx_data, data, CHUNK, NULL);
+	zassert_equal(claim_pipe.bytes_used, 0, NULL);
+
+	k_sleep(10);
+	zassert_equal(rx_bytes, CHUNK, NULL);
+
+	k_thread_abort(tid);
+}
+
+/**
+ * @brief A get commit lets a waiting writer refill the pipe
+ */
+void test_pipe_get_commit_wakes_writer(void)
+{
+	unsigned char rx[PIPE_LEN];
+	size_t bytes_read, n;
+	k_tid_t tid;
+	u8_t *buf;
+
+	claim_fill(&claim_pipe, data, PIPE_LEN);
+
+	tid = k_thread_create(&tdata, tstack, STACK_SIZE,
+			      writer_entry, NULL, NULL, NULL,
+			      K_PRIO_PREEMPT(0), 0, K_NO_WAIT);
+	k_sleep(10);
+
+	/* Drain exactly one ring buffer's worth in place */
+	for (size_t off = 0; off < PIPE_LEN; off += n) {
+		n = k_pipe_get_claim(&claim_pipe, &buf, PIPE_LEN - off);
+		zassert_true(n > 0, NULL);
+		zassert_equal(k_pipe_get_commit(&claim_pipe, n), 0, NULL);
+	}
+
+	/**TESTPOINT: the blocked writer's data is now in the pipe*/
+	zassert_equal(claim_pipe.bytes_used, CHUNK, NULL);
+	zassert_equal(k_pipe_get(&claim_pipe, rx, CHUNK, &bytes_read, CHUNK,
+				 K_NO_WAIT), 0, NULL);
+	zassert_mem_equal(rx, data, CHUNK, NULL);
+
+	k_thread_abort(tid);
+}
+
+/**
+ * @brief A get commit finishes a waiting asynchronous put
+ * @see k_pipe_block_put(), k_pipe_get_commit()
+ */
+void test_pipe_get_commit_block_put(void)
+{
+	struct k_mem_block block;
+	unsigned char rx[CHUNK];
+	struct k_sem sem;
+	size_t bytes_read, n;
+	u8_t *buf;
+
+	k_sem_init(&sem, 0, 1);
+	claim_fill(&claim_pipe, data, PIPE_LEN);
+
+	/* The pool block is released when the put finishes */
+	zassert_equal(k_mem_pool_alloc(&claim_pool, &block, CHUNK,
+				       K_NO_WAIT), 0, NULL);
+	memcpy(block.data, data, CHUNK);
+	k_pipe_block_put(&claim_pipe, &block, CHUNK, &sem);
+	zassert_equal(k_sem_take(&sem, K_NO_WAIT), -EBUSY, NULL);
+
+	for (size_t off = 0; off < PIPE_LEN; off += n) {
+		n = k_pipe_get_claim(&claim_pipe, &buf, PIPE_LEN - off);
+		zassert_true(n > 0, NULL);
+		zassert_equal(k_pipe_get_commit(&claim_pipe, n), 0, NULL);
+	}
+
+	/**TESTPOINT: the put is finished and its data is in the pipe*/
+	zassert_equal(k_sem_take(&sem, K_NO_WAIT), 0, NULL);
+	zassert_equal(claim_pipe.bytes_used, CHUNK, NULL);
+	zassert_equal(k_pipe_get(&claim_pipe, rx, CHUNK, &bytes_read, CHUNK,
+				 K_NO_WAIT), 0, NULL);
+	zassert_mem_equal(rx, data, CHUNK, NULL);
+}
+
+/**
+ * @}
+ */
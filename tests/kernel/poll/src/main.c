@@ -12,6 +12,10 @@ extern void test_poll_cancel_main_high_prio(void);
 extern void test_poll_multi(void);
 extern void test_poll_threadstate(void);
 extern void test_poll_grant_access(void);
+extern void test_poll_set_ready(void);
+extern void test_poll_set_rotate(void);
+extern void test_poll_set_wait(void);
+extern void test_poll_set_membership(void);
 
 K_MEM_POOL_DEFINE(test_pool, 128, 128, 4, 4);
 
@@ -28,6 +32,10 @@ void test_main(void)
 			 ztest_1cpu_unit_test(test_poll_cancel_main_low_prio),
 			 ztest_1cpu_unit_test(test_poll_cancel_main_high_prio),
 			 ztest_unit_test(test_poll_multi),
-			 ztest_1cpu_unit_test(test_poll_threadstate));
+			 ztest_1cpu_unit_test(test_poll_threadstate),
+			 ztest_1cpu_unit_test(test_poll_set_ready),
+			 ztest_1cpu_unit_test(test_poll_set_rotate),
+			 ztest_1cpu_unit_test(test_poll_set_wait),
+			 ztest_1cpu_unit_test(test_poll_set_membership));
 	ztest_run_test_suite(poll_api);
 }
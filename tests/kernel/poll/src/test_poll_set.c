@@ -0,0 +1,212 @@
+/*
+ * Copyright (c) 2019 Wind River Systems, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+#include <kernel.h>
+
+#define NUM_SEMS 16
+#define STACK_SIZE (1024 + CONFIG_TEST_EXTRA_STACKSIZE)
+#define SIGNAL_DELAY 50
+
+static struct k_poll_set set;
+static struct k_sem sems[NUM_SEMS];
+static struct k_poll_event sem_events[NUM_SEMS];
+static struct k_fifo fifo;
+static struct k_poll_event fifo_event;
+static struct k_poll_signal signal;
+static struct k_poll_event signal_event;
+
+static struct k_thread raise_thread;
+K_THREAD_STACK_DEFINE(raise_stack, STACK_SIZE);
+
+static void set_setup(void)
+{
+	k_poll_set_init(&set);
+
+	for (int i = 0; i < NUM_SEMS; i++) {
+		k_sem_init(&sems[i], 0, 1);
+		k_poll_event_init(&sem_events[i], K_POLL_TYPE_SEM_AVAILABLE,
+				  K_POLL_MODE_NOTIFY_ONLY, &sems[i]);
+		zassert_equal(k_poll_set_add(&set, &sem_events[i]), 0, NULL);
+	}
+
+	k_fifo_init(&fifo);
+	k_poll_event_init(&fifo_event, K_POLL_TYPE_FIFO_DATA_AVAILABLE,
+			  K_POLL_MODE_NOTIFY_ONLY, &fifo);
+	zassert_equal(k_poll_set_add(&set, &fifo_event), 0, NULL);
+
+	k_poll_signal_init(&signal);
+	k_poll_event_init(&signal_event, K_POLL_TYPE_SIGNAL,
+			  K_POLL_MODE_NOTIFY_ONLY, &signal);
+	zassert_equal(k_poll_set_add(&set, &signal_event), 0, NULL);
+}
+
+static void set_teardown(void)
+{
+	for (int i = 0; i < NUM_SEMS; i++) {
+		zassert_equal(k_poll_set_remove(&set, &sem_events[i]), 0, NULL);
+	}
+	zassert_equal(k_poll_set_remove(&set, &fifo_event), 0, NULL);
+	zassert_equal(k_poll_set_remove(&set, &signal_event), 0, NULL);
+}
+
+/**
+ * @brief Test that a poll set reports the events signaled, for as long
+ * as they stay ready
+ *
+ * @ingroup kernel_poll_tests
+ *
+ * @see k_poll_set_add(), k_poll_set_wait()
+ */
+void test_poll_set_ready(void)
+{
+	struct k_poll_event *ready[4];
+	static struct { void *reserved; u32_t value; } msg;
+
+	set_setup();
+	zassert_equal(k_poll_set_wait(&set, ready, ARRAY_SIZE(ready),
+				      K_NO_WAIT), -EAGAIN, NULL);
+
+	k_sem_give(&sems[5]);
+	zassert_equal(k_poll_set_wait(&set, ready, ARRAY_SIZE(ready),
+				      K_NO_WAIT), 1, NULL);
+	zassert_equal_ptr(ready[0], &sem_events[5], NULL);
+	zassert_equal(ready[0]->state, K_POLL_STATE_SEM_AVAILABLE, NULL);
+
+	/**TESTPOINT: still available, so reported again*/
+	zassert_equal(k_poll_set_wait(&set, ready, ARRAY_SIZE(ready),
+				      K_NO_WAIT), 1, NULL);
+	zassert_equal(k_sem_take(&sems[5], K_NO_WAIT), 0, NULL);
+	zassert_equal(k_poll_set_wait(&set, ready, ARRAY_SIZE(ready),
+				      K_NO_WAIT), -EAGAIN, NULL);
+
+	/**TESTPOINT: the event went back to watching its semaphore*/
+	k_sem_give(&sems[5]);
+	k_fifo_put(&fifo, &msg);
+	zassert_equal(k_poll_set_wait(&set, ready, ARRAY_SIZE(ready),
+				      K_NO_WAIT), 2, NULL);
+	zassert_equal_ptr(ready[0], &sem_events[5], NULL);
+	zassert_equal_ptr(ready[1], &fifo_event, NULL);
+	zassert_equal(ready[1]->state, K_POLL_STATE_FIFO_DATA_AVAILABLE, NULL);
+
+	zassert_equal(k_sem_take(&sems[5], K_NO_WAIT), 0, NULL);
+	zassert_equal_ptr(k_fifo_get(&fifo, K_NO_WAIT), &msg, NULL);
+	set_teardown();
+}
+
+/**
+ * @brief Test that ready events beyond the array size get their turn
+ *
+ * @ingroup kernel_poll_tests
+ *
+ * @see k_poll_set_wait()
+ */
+void test_poll_set_rotate(void)
+{
+	struct k_poll_event *ready[2];
+
+	set_setup();
+	for (int i = 0; i < 3; i++) {
+		k_sem_give(&sems[i]);
+	}
+
+	zassert_equal(k_poll_set_wait(&set, ready, ARRAY_SIZE(ready),
+				      K_NO_WAIT), 2, NULL);
+	zassert_equal_ptr(ready[0], &sem_events[0], NULL);
+	zassert_equal_ptr(ready[1], &sem_events[1], NULL);
+
+	zassert_equal(k_poll_set_wait(&set, ready, ARRAY_SIZE(ready),
+				      K_NO_WAIT), 2, NULL);
+	zassert_equal_ptr(ready[0], &sem_events[2], NULL);
+	zassert_equal_ptr(ready[1], &sem_events[0], NULL);
+
+	for (int i = 0; i < 3; i++) {
+		zassert_equal(k_sem_take(&sems[i], K_NO_WAIT), 0, NULL);
+	}
+	set_teardown();
+}
+
+static void raise_entry(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	k_sleep(SIGNAL_DELAY);
+	k_poll_signal_raise(&signal, 0);
+}
+
+/**
+ * @brief Test waiting on a poll set
+ *
+ * @ingroup kernel_poll_tests
+ *
+ * @see k_poll_set_wait()
+ */
+void test_poll_set_wait(void)
+{
+	struct k_poll_event *ready[4];
+
+	set_setup();
+
+	/**TESTPOINT: time out with nothing signaled*/
+	zassert_equal(k_poll_set_wait(&set, ready, ARRAY_SIZE(ready),
+				      SIGNAL_DELAY), -EAGAIN, NULL);
+
+	k_thread_create(&raise_thread, raise_stack, STACK_SIZE, raise_entry,
+			NULL, NULL, NULL, K_PRIO_PREEMPT(0), 0, K_NO_WAIT);
+
+	zassert_equal(k_poll_set_wait(&set, ready, ARRAY_SIZE(ready),
+				      K_FOREVER), 1, NULL);
+	zassert_equal_ptr(ready[0], &signal_event, NULL);
+	zassert_equal(ready[0]->state, K_POLL_STATE_SIGNALED, NULL);
+
+	k_poll_signal_reset(&signal);
+	k_thread_abort(&raise_thread);
+	set_teardown();
+}
+
+/**
+ * @brief Test poll set membership rules
+ *
+ * @ingroup kernel_poll_tests
+ *
+ * @see k_poll_set_add(), k_poll_set_remove()
+ */
+void test_poll_set_membership(void)
+{
+	static struct k_poll_set other;
+	struct k_poll_event *ready[1];
+	struct k_poll_event ignore;
+
+	set_setup();
+	k_poll_set_init(&other);
+
+	zassert_equal(k_poll_set_add(&other, &sem_events[0]), -EBUSY, NULL);
+	zassert_equal(k_poll_set_remove(&other, &sem_events[0]), -EINVAL,
+		      NULL);
+
+	k_poll_event_init(&ignore, K_POLL_TYPE_IGNORE,
+			  K_POLL_MODE_NOTIFY_ONLY, &ignore);
+	zassert_equal(k_poll_set_add(&set, &ignore), -EINVAL, NULL);
+
+	/**TESTPOINT: an event already ready is reported once added*/
+	zassert_equal(k_poll_set_remove(&set, &sem_events[0]), 0, NULL);
+	k_sem_give(&sems[0]);
+	zassert_equal(k_poll_set_wait(&set, ready, 1, K_NO_WAIT), -EAGAIN,
+		      NULL);
+	zassert_equal(k_poll_set_add(&other, &sem_events[0]), 0, NULL);
+	zassert_equal(k_poll_set_wait(&other, ready, 1, K_NO_WAIT), 1, NULL);
+
+	/**TESTPOINT: removing a ready event takes it off the ready list*/
+	zassert_equal(k_poll_set_remove(&other, &sem_events[0]), 0, NULL);
+	zassert_equal(k_poll_set_wait(&other, ready, 1, K_NO_WAIT), -EAGAIN,
+		      NULL);
+
+	zassert_equal(k_sem_take(&sems[0], K_NO_WAIT), 0, NULL);
+	zassert_equal(k_poll_set_add(&set, &sem_events[0]), 0, NULL);
+	set_teardown();
+}
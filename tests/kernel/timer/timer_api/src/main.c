@@ -19,6 +19,12 @@ struct timer_data {
 #define WITHIN_ERROR(var, target, epsilon)       \
 		(((var) >= (target)) && ((var) <= (target) + (epsilon)))
 
+/* Delays past the start of the top level of the timeout wheel (2^18
+ * ticks) and past its whole range (2^24 ticks)
+ */
+#define MID_TICKS (BIT(18) + 100)
+#define LONG_TICKS (BIT(24) + 100)
+
 static void duration_expire(struct k_timer *timer);
 static void duration_stop(struct k_timer *timer);
 
@@ -34,8 +40,11 @@ static struct k_timer status_timer;
 static struct k_timer status_anytime_timer;
 static struct k_timer status_sync_timer;
 static struct k_timer remain_timer;
+static struct k_timer mid_timer;
+static struct k_timer long_timer;
 
 static ZTEST_BMEM struct timer_data tdata;
+static ZTEST_BMEM s64_t mid_expiry, long_expiry;
 
 #define TIMER_ASSERT(exp, tmr)			 \
 	do {					 \
@@ -102,6 +111,15 @@ static void status_stop(struct k_timer *timer)
 	TIMER_ASSERT(k_timer_remaining_get(timer) == 0, timer);
 }
 
+static void long_expire(struct k_timer *timer)
+{
+	if (timer == &mid_timer) {
+		mid_expiry = k_uptime_get();
+	} else {
+		long_expiry = k_uptime_get();
+	}
+}
+
 /**
  * @brief Tests for the Timer kernel object
  * @defgroup kernel_timer_tests Timer
@@ -533,6 +551,63 @@ void test_timer_remaining_get(void)
 	zassert_true(remaining <= (DURATION / 2) + __ticks_to_ms(1), NULL);
 }
 
+/**
+ * @brief Test timers longer than the timeout wheel range
+ *
+ * Starts one timer that lands in the top level of the timeout wheel
+ * and one that is beyond the range of the wheel, and checks the time
+ * remaining on them.  Where time is simulated, also waits for them to
+ * expire and checks they did so on time, after being cascaded down
+ * the wheel levels.
+ *
+ * @ingroup kernel_timer_tests
+ *
+ * @see k_timer_start(), k_timer_remaining_get(), k_timer_status_sync()
+ */
+void test_timer_long_duration(void)
+{
+	s32_t mid = __ticks_to_ms(MID_TICKS);
+	s32_t dur = __ticks_to_ms(LONG_TICKS);
+	s32_t tick = __ticks_to_ms(1);
+	s32_t remaining;
+	s64_t start;
+
+	mid_expiry = 0;
+	long_expiry = 0;
+
+	/* Start on a tick boundary */
+	k_sleep(1);
+	start = k_uptime_get();
+	k_timer_start(&mid_timer, mid, K_NO_WAIT);
+	k_timer_start(&long_timer, dur, K_NO_WAIT);
+
+	remaining = k_timer_remaining_get(&mid_timer);
+	zassert_true(WITHIN_ERROR(remaining, mid - tick, tick),
+		     "%d ms remaining of %d", remaining, mid);
+	remaining = k_timer_remaining_get(&long_timer);
+	zassert_true(WITHIN_ERROR(remaining, dur - tick, tick),
+		     "%d ms remaining of %d", remaining, dur);
+
+	/* At usual tick rates these take days of real time to expire */
+	if (!IS_ENABLED(CONFIG_BOARD_NATIVE_POSIX) ||
+	    IS_ENABLED(CONFIG_NATIVE_POSIX_SLOWDOWN_TO_REAL_TIME)) {
+		k_timer_stop(&mid_timer);
+		k_timer_stop(&long_timer);
+		return;
+	}
+
+	zassert_equal(k_timer_status_sync(&mid_timer), 1, NULL);
+	zassert_equal(long_expiry, 0, "long timer expired early");
+	zassert_true(WITHIN_ERROR(mid_expiry - start, mid, tick),
+		     "mid timer expired after %d ms instead of %d",
+		     (s32_t)(mid_expiry - start), mid);
+
+	zassert_equal(k_timer_status_sync(&long_timer), 1, NULL);
+	zassert_true(WITHIN_ERROR(long_expiry - start, dur, tick),
+		     "long timer expired after %d ms instead of %d",
+		     (s32_t)(long_expiry - start), dur);
+}
+
 static void timer_init(struct k_timer *timer, k_timer_expiry_t expiry_fn,
 		       k_timer_stop_t stop_fn)
 {
@@ -551,6 +626,8 @@ void test_main(void)
 	timer_init(&status_anytime_timer, NULL, NULL);
 	timer_init(&status_sync_timer, duration_expire, duration_stop);
 	timer_init(&remain_timer, NULL, NULL);
+	timer_init(&mid_timer, long_expire, NULL);
+	timer_init(&long_timer, long_expire, NULL);
 
 	k_thread_access_grant(k_current_get(), &ktimer, &timer0, &timer1,
 			      &timer2, &timer3, &timer4);
@@ -565,6 +642,7 @@ void test_main(void)
 			 ztest_user_unit_test(test_timer_status_sync),
 			 ztest_user_unit_test(test_timer_k_define),
 			 ztest_user_unit_test(test_timer_user_data),
-			 ztest_user_unit_test(test_timer_remaining_get));
+			 ztest_user_unit_test(test_timer_remaining_get),
+			 ztest_user_unit_test(test_timer_long_duration));
 	ztest_run_test_suite(timer_api);
 }
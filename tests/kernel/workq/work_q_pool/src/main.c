@@ -0,0 +1,211 @@
+/*
+ * Copyright (c) 2019 Wind River Systems, Inc.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+
+#define STACK_SIZE (1024 + CONFIG_TEST_EXTRA_STACKSIZE)
+#define NUM_THREADS 3
+#define NUM_ITEMS 4
+#define WORK_PRIO K_PRIO_PREEMPT(1)
+#define TIMEOUT 100
+
+static struct k_work_q pool_q, lane_q;
+
+static K_THREAD_STACK_ARRAY_DEFINE(pool_stacks, NUM_THREADS, STACK_SIZE);
+static struct k_thread pool_threads[NUM_THREADS - 1];
+static K_THREAD_STACK_DEFINE(lane_stack, STACK_SIZE);
+static K_THREAD_STACK_DEFINE(cpu_stack, STACK_SIZE);
+static struct k_thread cpu_thread;
+
+static K_SEM_DEFINE(release, 0, UINT_MAX);
+static K_SEM_DEFINE(done, 0, UINT_MAX);
+
+static atomic_t started;
+
+struct test_item {
+	int key;
+	struct k_work work;
+};
+
+static struct test_item items[NUM_ITEMS];
+static struct k_work blocker;
+
+static int results[NUM_ITEMS];
+static int num_results;
+
+static void blocking_handler(struct k_work *work)
+{
+	ARG_UNUSED(work);
+
+	(void)atomic_inc(&started);
+	k_sem_take(&release, K_FOREVER);
+	k_sem_give(&done);
+}
+
+static void recording_handler(struct k_work *work)
+{
+	struct test_item *ti = CONTAINER_OF(work, struct test_item, work);
+
+	results[num_results++] = ti->key;
+}
+
+static void delayed_handler(struct k_work *work)
+{
+	ARG_UNUSED(work);
+
+	zassert_unreachable("canceled work item ran");
+}
+
+/* Keeps the single thread of lane_q busy until release is given */
+static void block_lane_q(void)
+{
+	k_work_init(&blocker, blocking_handler);
+	k_work_submit_to_queue(&lane_q, &blocker);
+	k_sleep(TIMEOUT);
+	zassert_equal(atomic_get(&started), 1, NULL);
+}
+
+static void unblock_lane_q(void)
+{
+	k_sem_give(&release);
+	zassert_equal(k_sem_take(&done, TIMEOUT), 0, NULL);
+	k_sleep(TIMEOUT);
+	atomic_set(&started, 0);
+}
+
+/**
+ * @addtogroup kernel_workqueue_tests
+ * @{
+ */
+
+/**
+ * @brief A blocked handler only holds up its own thread
+ * @see k_work_q_thread_add()
+ */
+void test_workq_threads(void)
+{
+	struct k_work work[NUM_THREADS];
+
+	k_work_q_start(&pool_q, pool_stacks[0], STACK_SIZE, WORK_PRIO);
+	for (int i = 1; i < NUM_THREADS; i++) {
+		zassert_equal(k_work_q_thread_add(&pool_q, &pool_threads[i - 1],
+						  pool_stacks[i], STACK_SIZE,
+						  WORK_PRIO, -1), 0, NULL);
+	}
+
+	for (int i = 0; i < NUM_THREADS; i++) {
+		k_work_init(&work[i], blocking_handler);
+		k_work_submit_to_queue(&pool_q, &work[i]);
+	}
+	k_sleep(TIMEOUT);
+
+	/**TESTPOINT: every handler got a thread of its own*/
+	zassert_equal(atomic_get(&started), NUM_THREADS, NULL);
+
+	for (int i = 0; i < NUM_THREADS; i++) {
+		k_sem_give(&release);
+	}
+	for (int i = 0; i < NUM_THREADS; i++) {
+		zassert_equal(k_sem_take(&done, TIMEOUT), 0, NULL);
+	}
+	k_sleep(TIMEOUT);
+	atomic_set(&started, 0);
+}
+
+/**
+ * @brief Higher lanes are processed first, each in submission order
+ * @see k_work_lane_set()
+ */
+void test_workq_lanes(void)
+{
+	static const int lanes[NUM_ITEMS] = { 0, 0, 3, 1 };
+	static const int expected[NUM_ITEMS] = { 2, 3, 0, 1 };
+
+	k_work_q_start(&lane_q, lane_stack, STACK_SIZE, WORK_PRIO);
+	block_lane_q();
+
+	for (int i = 0; i < NUM_ITEMS; i++) {
+		items[i].key = i;
+		k_work_init(&items[i].work, recording_handler);
+		k_work_lane_set(&items[i].work, lanes[i]);
+		k_work_submit_to_queue(&lane_q, &items[i].work);
+	}
+
+	unblock_lane_q();
+
+	zassert_equal(num_results, NUM_ITEMS, NULL);
+	for (int i = 0; i < NUM_ITEMS; i++) {
+		zassert_equal(results[i], expected[i], "item %d", i);
+	}
+}
+
+/**
+ * @brief A delayed work item pending in a lane can be canceled
+ * @see k_delayed_work_cancel()
+ */
+void test_workq_lane_delayed_cancel(void)
+{
+	static struct k_delayed_work dwork;
+
+	block_lane_q();
+
+	k_delayed_work_init(&dwork, delayed_handler);
+	k_work_lane_set(&dwork.work, 2);
+	zassert_equal(k_delayed_work_submit_to_queue(&lane_q, &dwork, 0), 0,
+		      NULL);
+	zassert_true(k_work_pending(&dwork.work), NULL);
+	zassert_equal(k_delayed_work_cancel(&dwork), 0, NULL);
+
+	unblock_lane_q();
+
+	/**TESTPOINT: the queue keeps working after the canceled item*/
+	num_results = 0;
+	items[0].key = 0;
+	k_work_init(&items[0].work, recording_handler);
+	k_work_submit_to_queue(&lane_q, &items[0].work);
+	k_sleep(TIMEOUT);
+	zassert_equal(num_results, 1, NULL);
+}
+
+/**
+ * @brief Threads can be pinned to existing CPUs only
+ * @see k_work_q_thread_add()
+ */
+void test_workq_thread_cpu(void)
+{
+	zassert_equal(k_work_q_thread_add(&lane_q, &cpu_thread, cpu_stack,
+					  STACK_SIZE, WORK_PRIO,
+					  CONFIG_MP_NUM_CPUS), -EINVAL, NULL);
+	zassert_equal(k_work_q_thread_add(&lane_q, &cpu_thread, cpu_stack,
+					  STACK_SIZE, WORK_PRIO, 0), 0, NULL);
+	zassert_equal(cpu_thread.base.cpu_mask, BIT(0), NULL);
+
+	/**TESTPOINT: the pinned thread serves lane_q while its first
+	 * thread is blocked
+	 */
+	block_lane_q();
+
+	num_results = 0;
+	k_work_submit_to_queue(&lane_q, &items[0].work);
+	k_sleep(TIMEOUT);
+	zassert_equal(num_results, 1, NULL);
+
+	unblock_lane_q();
+}
+
+/**
+ * @}
+ */
+
+void test_main(void)
+{
+	ztest_test_suite(work_q_pool,
+			 ztest_1cpu_unit_test(test_workq_threads),
+			 ztest_1cpu_unit_test(test_workq_lanes),
+			 ztest_1cpu_unit_test(test_workq_lane_delayed_cancel),
+			 ztest_1cpu_unit_test(test_workq_thread_cpu));
+	ztest_run_test_suite(work_q_pool);
+}
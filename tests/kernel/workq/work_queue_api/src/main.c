@@ -21,8 +21,10 @@
 
 static K_THREAD_STACK_DEFINE(tstack, STACK_SIZE);
 static K_THREAD_STACK_DEFINE(user_tstack, STACK_SIZE);
+static K_THREAD_STACK_DEFINE(user_add_tstack, STACK_SIZE);
 static struct k_work_q workq;
 static struct k_work_q user_workq;
+static struct k_thread user_add_thread;
 static ZTEST_BMEM struct k_work work[NUM_OF_WORK];
 static struct k_delayed_work new_work;
 static struct k_delayed_work delayed_work[NUM_OF_WORK], delayed_work_sleepy;
@@ -392,6 +394,24 @@ void test_user_workq_granted_access(void)
 	k_object_access_grant(&dummy_sema, &user_workq.thread);
 }
 
+/**
+ * @brief Test adding a thread to a user mode work queue
+ *
+ * The added thread must run in user mode like the first one.
+ *
+ * @ingroup kernel_workqueue_tests
+ *
+ * @see k_work_q_thread_add()
+ */
+void test_user_workq_thread_add(void)
+{
+	zassert_equal(k_work_q_thread_add(&user_workq, &user_add_thread,
+					  user_add_tstack, STACK_SIZE,
+					  CONFIG_MAIN_THREAD_PRIORITY, -1),
+		      0, NULL);
+	zassert_true(user_add_thread.base.user_options & K_USER, NULL);
+}
+
 /**
  * @brief Test work submission to work queue
  *
@@ -801,6 +821,7 @@ void test_main(void)
 			 ztest_user_unit_test(test_user_workq_start_before_submit),
 			 ztest_unit_test(test_user_workq_granted_access_setup),
 			 ztest_user_unit_test(test_user_workq_granted_access),
+			 ztest_unit_test(test_user_workq_thread_add),
 			 /* End order-important tests */
 
 			 ztest_1cpu_unit_test(test_work_submit_to_multipleq),
@@ -457,6 +457,39 @@ static void net_buf_test_var_pool(void)
 	zassert_equal(destroy_called, 3, "Incorrect destroy callback count");
 }
 
+static void net_buf_test_pool_usage(void)
+{
+#if defined(CONFIG_NET_BUF_POOL_USAGE)
+	struct net_buf *bufs[10];
+	u32_t failed = fixed_pool.usage.failed;
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(bufs); i++) {
+		bufs[i] = net_buf_alloc_len(&fixed_pool, 20, K_NO_WAIT);
+		zassert_not_null(bufs[i], "Failed to get buffer");
+	}
+
+	zassert_is_null(net_buf_alloc_len(&fixed_pool, 20, K_NO_WAIT),
+			"Pool not empty");
+	zassert_equal(fixed_pool.usage.used, ARRAY_SIZE(bufs),
+		      "Incorrect buffers in use");
+	zassert_equal(fixed_pool.usage.failed, failed + 1,
+		      "Failed allocation not counted");
+
+	for (i = 0; i < ARRAY_SIZE(bufs); i++) {
+		net_buf_unref(bufs[i]);
+	}
+
+	zassert_equal(fixed_pool.usage.used, 0, "Buffers still in use");
+	zassert_equal(fixed_pool.usage.max_used, ARRAY_SIZE(bufs),
+		      "Incorrect peak");
+	zassert_equal(fixed_pool.avail_count, fixed_pool.buf_count,
+		      "Incorrect available count");
+#else
+	ztest_test_skip();
+#endif
+}
+
 void test_main(void)
 {
 	ztest_test_suite(net_buf_test,
@@ -468,7 +501,8 @@ void test_main(void)
 			 ztest_unit_test(net_buf_test_multi_frags),
 			 ztest_unit_test(net_buf_test_clone),
 			 ztest_unit_test(net_buf_test_fixed_pool),
-			 ztest_unit_test(net_buf_test_var_pool)
+			 ztest_unit_test(net_buf_test_var_pool),
+			 ztest_unit_test(net_buf_test_pool_usage)
 			 );
 
 	ztest_run_test_suite(net_buf_test);
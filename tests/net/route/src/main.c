@@ -468,6 +468,90 @@ static void route_del_many(void)
 	}
 }
 
+/* Make an address of the generic prefix that differs from it at byte pos */
+static void prefix_addr(struct in6_addr *addr, int pos, u8_t value)
+{
+	net_ipaddr_copy(addr, &generic_addr);
+	addr->s6_addr[pos] = value;
+}
+
+static void route_lookup_longest(void)
+{
+	static const u8_t lens[] = { 128, 112, 96, 64 };
+	struct net_route_entry *routes[ARRAY_SIZE(lens)];
+	struct in6_addr addr[ARRAY_SIZE(lens)];
+	struct in6_addr other;
+	int i;
+
+	/* Each route is outside the longer ones, as adding a route that a
+	 * longer one covers would return the longer one.
+	 */
+	net_ipaddr_copy(&addr[0], &dest_addresses[0]);
+	prefix_addr(&addr[1], 15, 0x11);
+	prefix_addr(&addr[2], 12, 0x11);
+	prefix_addr(&addr[3], 8, 0x11);
+
+	for (i = 0; i < ARRAY_SIZE(lens); i++) {
+		routes[i] = net_route_add(my_iface, &addr[i], lens[i],
+					  &peer_addr);
+		zassert_not_null(routes[i], "Route /%d add failed", lens[i]);
+	}
+
+	/* Each address finds its own route, not a shorter one */
+	for (i = 0; i < ARRAY_SIZE(lens); i++) {
+		zassert_equal_ptr(net_route_lookup(my_iface, &addr[i]),
+				  routes[i], "Wrong route for /%d", lens[i]);
+		zassert_equal_ptr(net_route_lookup(NULL, &addr[i]),
+				  routes[i], "Wrong route for /%d", lens[i]);
+	}
+
+	zassert_is_null(net_route_lookup(peer_iface, &addr[0]),
+			"Route found on the wrong interface");
+
+	prefix_addr(&other, 2, 0x11);
+	zassert_is_null(net_route_lookup(my_iface, &other),
+			"Route found outside the prefixes");
+
+	/* Deleting a route falls back to the next longest one */
+	zassert_false(net_route_del(routes[1]), "Route del failed");
+	zassert_equal_ptr(net_route_lookup(my_iface, &addr[1]), routes[2],
+			  "No fallback to /96");
+	zassert_equal_ptr(net_route_lookup(my_iface, &addr[0]), routes[0],
+			  "Wrong route for /128");
+
+	zassert_false(net_route_del(routes[2]), "Route del failed");
+	zassert_equal_ptr(net_route_lookup(my_iface, &addr[1]), routes[3],
+			  "No fallback to /64");
+
+	zassert_false(net_route_del(routes[0]), "Route del failed");
+	zassert_false(net_route_del(routes[3]), "Route del failed");
+
+	for (i = 0; i < ARRAY_SIZE(lens); i++) {
+		zassert_is_null(net_route_lookup(my_iface, &addr[i]),
+				"Deleted route /%d found", lens[i]);
+	}
+}
+
+static void route_lookup_stats(void)
+{
+	struct net_route_stats before, after;
+
+	net_route_stats_get(&before);
+
+	zassert_is_null(net_route_lookup(my_iface, &dest_addr),
+			"Route found");
+	zassert_is_null(net_route_lookup(my_iface, &dest_addr),
+			"Route found");
+
+	net_route_stats_get(&after);
+
+	zassert_equal(after.lookups - before.lookups, 2, "Lookups not counted");
+	zassert_equal(after.misses - before.misses, 2, "Misses not counted");
+	zassert_equal(after.cache_hits - before.cache_hits,
+		      CONFIG_NET_ROUTE_CACHE_SIZE > 0 ? 1 : 0,
+		      "Cache hits not counted");
+}
+
 /*test case main entry*/
 void test_main(void)
 {
@@ -487,6 +571,8 @@ void test_main(void)
 			ztest_unit_test(route_del_nexthop_again),
 			ztest_unit_test(populate_nbr_cache),
 			ztest_unit_test(route_add_many),
-			ztest_unit_test(route_del_many));
+			ztest_unit_test(route_del_many),
+			ztest_unit_test(route_lookup_longest),
+			ztest_unit_test(route_lookup_stats));
 	ztest_run_test_suite(test_route);
 }
@@ -0,0 +1,285 @@
+/* main.c - Application main entry point */
+
+/*
+ * Copyright (c) 2019 Linaro Limited
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <logging/log.h>
+LOG_MODULE_REGISTER(net_test, CONFIG_NET_CORE_LOG_LEVEL);
+
+#include <zephyr.h>
+#include <ztest.h>
+#include <string.h>
+
+#include <net/net_pkt.h>
+#include <net/net_if.h>
+#include <net/net_ip.h>
+#include <net/dummy.h>
+
+#include "net_private.h"
+#include "ipv4.h"
+#include "ipv6.h"
+#include "udp_internal.h"
+
+#define LOCAL_PORT 4242
+#define FLOW_COUNT 8
+#define PKTS_PER_FLOW 8
+
+#define WAIT_TIME K_SECONDS(1)
+
+static struct in_addr my_addr = { { { 192, 0, 2, 1 } } };
+static struct in_addr peer_addr = { { { 192, 0, 2, 2 } } };
+static struct in6_addr my_addr6 = { { { 0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 0,
+					0, 0, 0, 0, 0, 0, 0, 0x1 } } };
+static struct in6_addr peer_addr6 = { { { 0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 0,
+					  0, 0, 0, 0, 0, 0, 0, 0x2 } } };
+
+struct flow_data {
+	u32_t flow;
+	u32_t seq;
+};
+
+static struct {
+	u32_t next_seq;
+	k_tid_t thread;
+	bool reordered;
+	bool moved;
+} flows[FLOW_COUNT];
+
+static K_SEM_DEFINE(recv_sem, 0, UINT_MAX);
+
+static int steering_dev_init(struct device *dev)
+{
+	ARG_UNUSED(dev);
+
+	return 0;
+}
+
+static void steering_iface_init(struct net_if *iface)
+{
+	static u8_t mac[] = { 0x00, 0x00, 0x5e, 0x00, 0x53, 0x01 };
+
+	net_if_set_link_addr(iface, mac, sizeof(mac), NET_LINK_DUMMY);
+}
+
+static int steering_send(struct device *dev, struct net_pkt *pkt)
+{
+	ARG_UNUSED(dev);
+	ARG_UNUSED(pkt);
+
+	return 0;
+}
+
+static struct dummy_api steering_api = {
+	.iface_api.init = steering_iface_init,
+	.send = steering_send,
+};
+
+NET_DEVICE_INIT(steering, "steering", steering_dev_init, NULL, NULL,
+		CONFIG_KERNEL_INIT_PRIORITY_DEFAULT, &steering_api, DUMMY_L2,
+		NET_L2_GET_CTX_TYPE(DUMMY_L2), 1280);
+
+static enum net_verdict recv_cb(struct net_conn *conn,
+				struct net_pkt *pkt,
+				union net_ip_header *ip_hdr,
+				union net_proto_header *proto_hdr,
+				void *user_data)
+{
+	struct flow_data data;
+
+	ARG_UNUSED(conn);
+	ARG_UNUSED(ip_hdr);
+	ARG_UNUSED(proto_hdr);
+	ARG_UNUSED(user_data);
+
+	net_pkt_cursor_init(pkt);
+
+	if (!net_pkt_skip(pkt, net_pkt_get_len(pkt) - sizeof(data)) &&
+	    !net_pkt_read(pkt, &data, sizeof(data)) &&
+	    data.flow < FLOW_COUNT) {
+		if (data.seq != flows[data.flow].next_seq) {
+			flows[data.flow].reordered = true;
+		}
+
+		if (!flows[data.flow].thread) {
+			flows[data.flow].thread = k_current_get();
+		} else if (flows[data.flow].thread != k_current_get()) {
+			flows[data.flow].moved = true;
+		}
+
+		flows[data.flow].next_seq = data.seq + 1;
+	}
+
+	net_pkt_unref(pkt);
+	k_sem_give(&recv_sem);
+
+	return NET_OK;
+}
+
+static struct net_pkt *prepare_pkt(sa_family_t family, u32_t flow, u32_t seq)
+{
+	struct net_if *iface = net_if_get_default();
+	struct flow_data data = { .flow = flow, .seq = seq };
+	struct net_pkt *pkt;
+
+	pkt = net_pkt_rx_alloc_with_buffer(iface, sizeof(data), family,
+					   IPPROTO_UDP, K_NO_WAIT);
+	zassert_not_null(pkt, "Cannot allocate pkt");
+
+	if (family == AF_INET) {
+		zassert_equal(net_ipv4_create(pkt, &peer_addr, &my_addr), 0,
+			      "Cannot create IPv4 header");
+	} else {
+		zassert_equal(net_ipv6_create(pkt, &peer_addr6, &my_addr6), 0,
+			      "Cannot create IPv6 header");
+	}
+
+	/* Each flow has its own source port */
+	zassert_equal(net_udp_create(pkt, htons(5000 + flow),
+				     htons(LOCAL_PORT)), 0,
+		      "Cannot create UDP header");
+	zassert_equal(net_pkt_write(pkt, &data, sizeof(data)), 0,
+		      "Cannot write data");
+
+	net_pkt_cursor_init(pkt);
+
+	if (family == AF_INET) {
+		net_ipv4_finalize(pkt, IPPROTO_UDP);
+	} else {
+		net_ipv6_finalize(pkt, IPPROTO_UDP);
+	}
+
+	return pkt;
+}
+
+static u32_t worker_pkts(int *busy)
+{
+	struct net_tc_rx_worker_stats stats;
+	u32_t total = 0U;
+	int i, j;
+
+	*busy = 0;
+
+	for (i = 0; i < NET_TC_RX_COUNT; i++) {
+		for (j = 0; j < NET_TC_RX_WORKERS; j++) {
+			net_tc_rx_worker_stats_get(i, j, &stats);
+
+			total += stats.pkts;
+			if (stats.pkts) {
+				(*busy)++;
+			}
+		}
+	}
+
+	return total;
+}
+
+static void test_flows(sa_family_t family)
+{
+	struct net_if *iface = net_if_get_default();
+	int busy_before, busy_after, threads = 0;
+	u32_t flow, seq, pkts_before, pkts_after;
+	int i, j;
+
+	(void)memset(flows, 0, sizeof(flows));
+	k_sem_reset(&recv_sem);
+
+	pkts_before = worker_pkts(&busy_before);
+
+	/* Queue all the packets before any worker gets to run, so that the
+	 * flows are interleaved in the worker queues.
+	 */
+	k_sched_lock();
+
+	for (seq = 0U; seq < PKTS_PER_FLOW; seq++) {
+		for (flow = 0U; flow < FLOW_COUNT; flow++) {
+			zassert_equal(net_recv_data(iface,
+						    prepare_pkt(family, flow,
+								seq)), 0,
+				      "Cannot receive pkt");
+		}
+	}
+
+	k_sched_unlock();
+
+	for (i = 0; i < FLOW_COUNT * PKTS_PER_FLOW; i++) {
+		zassert_equal(k_sem_take(&recv_sem, WAIT_TIME), 0,
+			      "Only %d packets received", i);
+	}
+
+	for (i = 0; i < FLOW_COUNT; i++) {
+		zassert_equal(flows[i].next_seq, PKTS_PER_FLOW,
+			      "Flow %d incomplete", i);
+		zassert_false(flows[i].reordered, "Flow %d reordered", i);
+		zassert_false(flows[i].moved, "Flow %d changed worker", i);
+
+		for (j = 0; j < i && flows[j].thread != flows[i].thread; j++) {
+		}
+
+		if (j == i) {
+			threads++;
+		}
+	}
+
+	zassert_true(threads > 1, "All flows handled by one worker");
+
+	pkts_after = worker_pkts(&busy_after);
+	zassert_equal(pkts_after - pkts_before, FLOW_COUNT * PKTS_PER_FLOW,
+		      "Worker statistics do not match");
+	zassert_true(busy_after > 1, "Worker statistics not spread");
+}
+
+static void test_setup(void)
+{
+	struct net_if *iface = net_if_get_default();
+	struct net_conn_handle *handle;
+	struct sockaddr_in local = {
+		.sin_family = AF_INET,
+		.sin_port = htons(LOCAL_PORT),
+	};
+	struct sockaddr_in6 local6 = {
+		.sin6_family = AF_INET6,
+		.sin6_port = htons(LOCAL_PORT),
+	};
+
+	zassert_not_null(net_if_ipv4_addr_add(iface, &my_addr,
+					      NET_ADDR_MANUAL, 0),
+			 "Cannot add IPv4 address");
+	zassert_not_null(net_if_ipv6_addr_add(iface, &my_addr6,
+					      NET_ADDR_MANUAL, 0),
+			 "Cannot add IPv6 address");
+
+	net_ipaddr_copy(&local.sin_addr, &my_addr);
+	net_ipaddr_copy(&local6.sin6_addr, &my_addr6);
+
+	zassert_equal(net_udp_register(AF_INET, NULL,
+				       (struct sockaddr *)&local, 0,
+				       LOCAL_PORT, recv_cb, NULL, &handle), 0,
+		      "Cannot register IPv4 handler");
+	zassert_equal(net_udp_register(AF_INET6, NULL,
+				       (struct sockaddr *)&local6, 0,
+				       LOCAL_PORT, recv_cb, NULL, &handle), 0,
+		      "Cannot register IPv6 handler");
+}
+
+static void test_v4_flows(void)
+{
+	test_flows(AF_INET);
+}
+
+static void test_v6_flows(void)
+{
+	test_flows(AF_INET6);
+}
+
+void test_main(void)
+{
+	ztest_test_suite(net_rx_steering,
+			 ztest_unit_test(test_setup),
+			 ztest_unit_test(test_v4_flows),
+			 ztest_unit_test(test_v6_flows));
+
+	ztest_run_test_suite(net_rx_steering);
+}
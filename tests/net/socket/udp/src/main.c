@@ -655,6 +655,147 @@ void test_v6_sendmsg_recvfrom_connected(void)
 	zassert_equal(rv, 0, "close failed");
 }
 
+#define MMSG_COUNT 3
+
+static void comm_sendmmsg_recvmmsg(int client_sock,
+				   struct sockaddr *client_addr,
+				   socklen_t client_addrlen,
+				   int server_sock,
+				   struct sockaddr *server_addr,
+				   socklen_t server_addrlen)
+{
+	struct mmsghdr msgs[MMSG_COUNT + 1];
+	struct iovec tx_iov[MMSG_COUNT][2];
+	struct iovec rx_iov[MMSG_COUNT + 1][2];
+	struct sockaddr_in6 src[MMSG_COUNT + 1];
+	char rx_buf[MMSG_COUNT + 1][2][8];
+	int rv;
+	int i;
+
+	zassert_equal(bind(server_sock, server_addr, server_addrlen), 0,
+		      "server bind failed");
+	zassert_equal(bind(client_sock, client_addr, client_addrlen), 0,
+		      "client bind failed");
+
+	/* Messages of 4, 8 and 12 bytes, the last one in two pieces */
+	(void)memset(msgs, 0, sizeof(msgs));
+	for (i = 0; i < MMSG_COUNT; i++) {
+		tx_iov[i][0].iov_base = TEST_STR2;
+		tx_iov[i][0].iov_len = 4 * (i + 1);
+		tx_iov[i][1].iov_base = TEST_STR2 + 4 * (i + 1);
+		tx_iov[i][1].iov_len = 0;
+
+		msgs[i].msg_hdr.msg_iov = tx_iov[i];
+		msgs[i].msg_hdr.msg_iovlen = 2;
+		msgs[i].msg_hdr.msg_name = server_addr;
+		msgs[i].msg_hdr.msg_namelen = server_addrlen;
+	}
+
+	tx_iov[2][0].iov_len = 5;
+	tx_iov[2][1].iov_base = TEST_STR2 + 5;
+	tx_iov[2][1].iov_len = 7;
+
+	rv = sendmmsg(client_sock, msgs, MMSG_COUNT, 0);
+	zassert_equal(rv, MMSG_COUNT, "sendmmsg failed (%d)", errno);
+
+	for (i = 0; i < MMSG_COUNT; i++) {
+		zassert_equal(msgs[i].msg_len, 4 * (i + 1),
+			      "wrong length sent");
+	}
+
+	/* Let them all reach the socket before reading in one go */
+	k_sleep(K_MSEC(100));
+
+	/* 16 bytes per message, the last one only gets 8 */
+	(void)memset(msgs, 0, sizeof(msgs));
+	(void)memset(rx_buf, 0, sizeof(rx_buf));
+	for (i = 0; i <= MMSG_COUNT; i++) {
+		rx_iov[i][0].iov_base = rx_buf[i][0];
+		rx_iov[i][0].iov_len = sizeof(rx_buf[i][0]);
+		rx_iov[i][1].iov_base = rx_buf[i][1];
+		rx_iov[i][1].iov_len = sizeof(rx_buf[i][1]);
+
+		msgs[i].msg_hdr.msg_iov = rx_iov[i];
+		msgs[i].msg_hdr.msg_iovlen = i == MMSG_COUNT - 1 ? 1 : 2;
+		msgs[i].msg_hdr.msg_name = &src[i];
+		msgs[i].msg_hdr.msg_namelen = sizeof(src[i]);
+	}
+
+	/* Returns what is queued instead of waiting for a fourth one */
+	rv = recvmmsg(server_sock, msgs, MMSG_COUNT + 1, 0);
+	zassert_equal(rv, MMSG_COUNT, "recvmmsg failed (%d, %d)", rv, errno);
+
+	for (i = 0; i < MMSG_COUNT - 1; i++) {
+		zassert_equal(msgs[i].msg_len, 4 * (i + 1),
+			      "wrong length received");
+		zassert_mem_equal(rx_buf[i][0], TEST_STR2,
+				  MIN(8, msgs[i].msg_len), "wrong data");
+		zassert_equal(msgs[i].msg_hdr.msg_flags, 0,
+			      "unexpected flags");
+		zassert_equal(msgs[i].msg_hdr.msg_namelen, client_addrlen,
+			      "unexpected addrlen");
+		zassert_equal(((struct sockaddr *)&src[i])->sa_family,
+			      client_addr->sa_family, "unexpected family");
+	}
+
+	zassert_equal(msgs[1].msg_len, 8, "wrong length received");
+
+	zassert_equal(msgs[2].msg_len, 8, "not truncated");
+	zassert_equal(msgs[2].msg_hdr.msg_flags, MSG_TRUNC,
+		      "truncation not reported");
+	zassert_mem_equal(rx_buf[2][0], TEST_STR2, 8, "wrong data");
+
+	rv = recvmmsg(server_sock, msgs, MMSG_COUNT, MSG_DONTWAIT);
+	zassert_equal(rv, -1, "unexpected datagram");
+	zassert_equal(errno, EAGAIN, "unexpected errno %d", errno);
+}
+
+void test_v4_sendmmsg_recvmmsg(void)
+{
+	int client_sock;
+	int server_sock;
+	struct sockaddr_in client_addr;
+	struct sockaddr_in server_addr;
+
+	prepare_sock_udp_v4(CONFIG_NET_CONFIG_MY_IPV4_ADDR, CLIENT_PORT,
+			    &client_sock, &client_addr);
+	prepare_sock_udp_v4(CONFIG_NET_CONFIG_MY_IPV4_ADDR, SERVER_PORT,
+			    &server_sock, &server_addr);
+
+	comm_sendmmsg_recvmmsg(client_sock,
+			       (struct sockaddr *)&client_addr,
+			       sizeof(client_addr),
+			       server_sock,
+			       (struct sockaddr *)&server_addr,
+			       sizeof(server_addr));
+
+	zassert_equal(close(client_sock), 0, "close failed");
+	zassert_equal(close(server_sock), 0, "close failed");
+}
+
+void test_v6_sendmmsg_recvmmsg(void)
+{
+	int client_sock;
+	int server_sock;
+	struct sockaddr_in6 client_addr;
+	struct sockaddr_in6 server_addr;
+
+	prepare_sock_udp_v6(CONFIG_NET_CONFIG_MY_IPV6_ADDR, CLIENT_PORT,
+			    &client_sock, &client_addr);
+	prepare_sock_udp_v6(CONFIG_NET_CONFIG_MY_IPV6_ADDR, SERVER_PORT,
+			    &server_sock, &server_addr);
+
+	comm_sendmmsg_recvmmsg(client_sock,
+			       (struct sockaddr *)&client_addr,
+			       sizeof(client_addr),
+			       server_sock,
+			       (struct sockaddr *)&server_addr,
+			       sizeof(server_addr));
+
+	zassert_equal(close(client_sock), 0, "close failed");
+	zassert_equal(close(server_sock), 0, "close failed");
+}
+
 void test_so_txtime(void)
 {
 	struct sockaddr_in bind_addr4;
@@ -922,6 +1063,8 @@ void test_main(void)
 			 ztest_unit_test(test_v6_sendmsg_recvfrom),
 			 ztest_unit_test(test_v4_sendmsg_recvfrom_connected),
 			 ztest_unit_test(test_v6_sendmsg_recvfrom_connected),
+			 ztest_unit_test(test_v4_sendmmsg_recvmmsg),
+			 ztest_user_unit_test(test_v6_sendmmsg_recvmmsg),
 			 ztest_unit_test(setup_eth),
 			 ztest_unit_test(test_v6_sendmsg_with_txtime),
 			 ztest_user_unit_test(test_v6_sendmsg_with_txtime)
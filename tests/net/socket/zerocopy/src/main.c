@@ -0,0 +1,270 @@
+/*
+ * Copyright (c) 2019 Linaro Limited
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <logging/log.h>
+LOG_MODULE_REGISTER(net_test, CONFIG_NET_SOCKETS_LOG_LEVEL);
+
+#include <ztest_assert.h>
+#include <net/socket.h>
+#include <net/net_pkt.h>
+
+#include "../../socket_helpers.h"
+
+#define SERVER_PORT 4242
+#define CLIENT_PORT 9898
+
+/* Spans several net_buf fragments */
+#define TEST_LEN 300
+
+#define TCP_TEARDOWN_TIMEOUT K_SECONDS(1)
+
+static u8_t tx_data[TEST_LEN];
+static u8_t rx_data[TEST_LEN];
+
+/* Build a chain holding len bytes of tx_data, the way an application
+ * would fill buffers straight from its producer.
+ */
+static struct net_buf *prepare_frags(size_t len)
+{
+	struct net_buf *frags = NULL;
+	size_t offset = 0;
+
+	while (offset < len) {
+		struct net_buf *frag;
+		size_t chunk;
+
+		frag = net_pkt_get_reserve_tx_data(K_SECONDS(1));
+		zassert_not_null(frag, "out of TX data buffers");
+
+		chunk = MIN(net_buf_tailroom(frag), len - offset);
+		net_buf_add_mem(frag, tx_data + (offset % TEST_LEN), chunk);
+		offset += chunk;
+
+		if (frags) {
+			net_buf_frag_add(frags, frag);
+		} else {
+			frags = frag;
+		}
+	}
+
+	return frags;
+}
+
+static void check_frags(struct net_buf *frags, size_t len)
+{
+	zassert_not_null(frags, "no data received");
+	zassert_equal(net_buf_frags_len(frags), len, "wrong length");
+
+	(void)memset(rx_data, 0, sizeof(rx_data));
+	zassert_equal(net_buf_linearize(rx_data, sizeof(rx_data), frags, 0,
+					len), len, "linearize failed");
+	zassert_mem_equal(rx_data, tx_data, len, "wrong data");
+
+	net_buf_unref(frags);
+}
+
+static void udp_zerocopy(int client, struct sockaddr *client_addr,
+			 int server, struct sockaddr *server_addr,
+			 socklen_t addrlen)
+{
+	struct sockaddr_storage src;
+	struct net_buf *frags;
+	socklen_t src_len;
+	ssize_t ret;
+
+	zassert_equal(bind(client, client_addr, addrlen), 0, "bind failed");
+	zassert_equal(bind(server, server_addr, addrlen), 0, "bind failed");
+
+	frags = prepare_frags(TEST_LEN);
+	ret = zsock_sendbuf(client, frags, 0, server_addr, addrlen);
+	zassert_equal(ret, TEST_LEN, "sendbuf failed (%d)", errno);
+
+	/* The stack holds its own reference */
+	net_buf_unref(frags);
+
+	src_len = sizeof(src);
+	ret = zsock_recvbuf(server, &frags, 0, (struct sockaddr *)&src,
+			    &src_len);
+	zassert_equal(ret, TEST_LEN, "recvbuf failed (%d)", errno);
+	zassert_equal(src_len, addrlen, "wrong address length");
+	zassert_equal(src.ss_family, client_addr->sa_family,
+		      "wrong address family");
+	check_frags(frags, TEST_LEN);
+
+	/* Mixed with the copying API on the other side */
+	ret = sendto(client, tx_data, TEST_LEN, 0, server_addr, addrlen);
+	zassert_equal(ret, TEST_LEN, "sendto failed");
+	ret = zsock_recvbuf(server, &frags, 0, NULL, NULL);
+	zassert_equal(ret, TEST_LEN, "recvbuf failed (%d)", errno);
+	check_frags(frags, TEST_LEN);
+
+	ret = zsock_recvbuf(server, &frags, MSG_DONTWAIT, NULL, NULL);
+	zassert_equal(ret, -1, "unexpected data");
+	zassert_equal(errno, EAGAIN, "unexpected errno %d", errno);
+	zassert_is_null(frags, "frags not cleared");
+
+	zassert_equal(close(client), 0, "close failed");
+	zassert_equal(close(server), 0, "close failed");
+}
+
+static void test_v4_udp_zerocopy(void)
+{
+	struct sockaddr_in client_addr, server_addr;
+	int client, server;
+
+	prepare_sock_udp_v4(CONFIG_NET_CONFIG_MY_IPV4_ADDR, CLIENT_PORT,
+			    &client, &client_addr);
+	prepare_sock_udp_v4(CONFIG_NET_CONFIG_MY_IPV4_ADDR, SERVER_PORT,
+			    &server, &server_addr);
+
+	udp_zerocopy(client, (struct sockaddr *)&client_addr,
+		     server, (struct sockaddr *)&server_addr,
+		     sizeof(server_addr));
+}
+
+static void test_v6_udp_zerocopy(void)
+{
+	struct sockaddr_in6 client_addr, server_addr;
+	int client, server;
+
+	prepare_sock_udp_v6(CONFIG_NET_CONFIG_MY_IPV6_ADDR, CLIENT_PORT,
+			    &client, &client_addr);
+	prepare_sock_udp_v6(CONFIG_NET_CONFIG_MY_IPV6_ADDR, SERVER_PORT,
+			    &server, &server_addr);
+
+	udp_zerocopy(client, (struct sockaddr *)&client_addr,
+		     server, (struct sockaddr *)&server_addr,
+		     sizeof(server_addr));
+}
+
+static void test_udp_too_big(void)
+{
+	struct sockaddr_in server_addr;
+	struct net_buf *frags;
+	int sock;
+
+	prepare_sock_udp_v4(CONFIG_NET_CONFIG_MY_IPV4_ADDR, SERVER_PORT,
+			    &sock, &server_addr);
+
+	/* Larger than the loopback MTU, and there is no IPv4 fragmentation */
+	frags = prepare_frags(2 * TEST_LEN);
+	zassert_equal(zsock_sendbuf(sock, frags, 0,
+				    (struct sockaddr *)&server_addr,
+				    sizeof(server_addr)), -1,
+		      "oversized payload sent");
+	zassert_equal(errno, EMSGSIZE, "unexpected errno %d", errno);
+
+	/* Still owned by the caller after a failure */
+	net_buf_unref(frags);
+
+	zassert_equal(close(sock), 0, "close failed");
+}
+
+static void tcp_zerocopy(int client, int server, struct sockaddr *addr,
+			 socklen_t addrlen)
+{
+	struct net_buf *frags;
+	size_t received;
+	ssize_t ret;
+	int conn;
+
+	zassert_equal(bind(server, addr, addrlen), 0, "bind failed");
+	zassert_equal(listen(server, 1), 0, "listen failed");
+	zassert_equal(connect(client, addr, addrlen), 0, "connect failed");
+
+	conn = accept(server, NULL, NULL);
+	zassert_true(conn >= 0, "accept failed");
+
+	frags = prepare_frags(TEST_LEN);
+	ret = zsock_sendbuf(client, frags, 0, NULL, 0);
+	zassert_equal(ret, TEST_LEN, "sendbuf failed (%d)", errno);
+	net_buf_unref(frags);
+
+	ret = zsock_recvbuf(conn, &frags, 0, NULL, NULL);
+	zassert_equal(ret, TEST_LEN, "recvbuf failed (%d)", errno);
+	check_frags(frags, TEST_LEN);
+
+	/* Whatever zsock_recv() left of a segment is handed over */
+	ret = send(client, tx_data, TEST_LEN, 0);
+	zassert_equal(ret, TEST_LEN, "send failed");
+
+	received = 0;
+	while (received < 10) {
+		ret = recv(conn, rx_data + received, 10 - received, 0);
+		zassert_true(ret > 0, "recv failed");
+		received += ret;
+	}
+
+	ret = zsock_recvbuf(conn, &frags, 0, NULL, NULL);
+	zassert_equal(ret, TEST_LEN - 10, "recvbuf failed (%d)", errno);
+	zassert_equal(net_buf_frags_len(frags), TEST_LEN - 10,
+		      "wrong length");
+	zassert_equal(net_buf_linearize(rx_data + 10, sizeof(rx_data) - 10,
+					frags, 0, TEST_LEN - 10),
+		      TEST_LEN - 10, "linearize failed");
+	zassert_mem_equal(rx_data, tx_data, TEST_LEN, "wrong data");
+	net_buf_unref(frags);
+
+	/* The peer closing is reported as with recv() */
+	zassert_equal(close(client), 0, "close failed");
+
+	ret = zsock_recvbuf(conn, &frags, 0, NULL, NULL);
+	zassert_equal(ret, 0, "no EOF (%d, %d)", ret, errno);
+	zassert_is_null(frags, "data after EOF");
+
+	zassert_equal(close(conn), 0, "close failed");
+	zassert_equal(close(server), 0, "close failed");
+
+	k_sleep(TCP_TEARDOWN_TIMEOUT);
+}
+
+static void test_v4_tcp_zerocopy(void)
+{
+	struct sockaddr_in addr;
+	int client, server;
+
+	prepare_sock_tcp_v4(CONFIG_NET_CONFIG_MY_IPV4_ADDR, SERVER_PORT,
+			    &client, &addr);
+	prepare_sock_tcp_v4(CONFIG_NET_CONFIG_MY_IPV4_ADDR, SERVER_PORT,
+			    &server, &addr);
+
+	tcp_zerocopy(client, server, (struct sockaddr *)&addr, sizeof(addr));
+}
+
+static void test_v6_tcp_zerocopy(void)
+{
+	struct sockaddr_in6 addr;
+	int client, server;
+
+	prepare_sock_tcp_v6(CONFIG_NET_CONFIG_MY_IPV6_ADDR, SERVER_PORT,
+			    &client, &addr);
+	prepare_sock_tcp_v6(CONFIG_NET_CONFIG_MY_IPV6_ADDR, SERVER_PORT,
+			    &server, &addr);
+
+	tcp_zerocopy(client, server, (struct sockaddr *)&addr, sizeof(addr));
+}
+
+static void test_setup(void)
+{
+	int i;
+
+	for (i = 0; i < sizeof(tx_data); i++) {
+		tx_data[i] = i * 3;
+	}
+}
+
+void test_main(void)
+{
+	ztest_test_suite(socket_zerocopy,
+			 ztest_unit_test(test_setup),
+			 ztest_unit_test(test_v4_udp_zerocopy),
+			 ztest_unit_test(test_v6_udp_zerocopy),
+			 ztest_unit_test(test_udp_too_big),
+			 ztest_unit_test(test_v4_tcp_zerocopy),
+			 ztest_unit_test(test_v6_tcp_zerocopy));
+
+	ztest_run_test_suite(socket_zerocopy);
+}
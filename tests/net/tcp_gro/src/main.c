@@ -0,0 +1,299 @@
+/* main.c - Application main entry point */
+
+/*
+ * Copyright (c) 2019 Linaro Limited
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <logging/log.h>
+LOG_MODULE_REGISTER(net_test, CONFIG_NET_TCP_LOG_LEVEL);
+
+#include <zephyr.h>
+#include <ztest.h>
+#include <string.h>
+
+#include <net/net_pkt.h>
+#include <net/net_if.h>
+#include <net/dummy.h>
+#include <net/socket.h>
+
+#include "net_private.h"
+#include "tcp_internal.h"
+
+#define SERVER_PORT 4242
+#define SEG_LEN 64
+#define SEG_COUNT 8
+
+#define RECV_TIMEOUT_MS 5000
+
+/* Our own address, and the one the link reflects back to us */
+static struct in_addr my_addr = { { { 192, 0, 2, 1 } } };
+static struct in_addr peer_addr = { { { 192, 0, 2, 2 } } };
+static struct in_addr netmask = { { { 255, 255, 255, 0 } } };
+
+/* Link state, only looked at once the transfer is over */
+static struct {
+	/* Index (1-based) of the data segment to corrupt */
+	int corrupt;
+	int data_segs;
+	/* While set, reflected packets are kept back to be received at once */
+	bool hold;
+	int held_count;
+	struct net_pkt *held[SEG_COUNT];
+} link;
+
+static u8_t tx_data[SEG_LEN * SEG_COUNT];
+static u8_t rx_data[SEG_LEN * SEG_COUNT];
+
+/* Count the data segments sent to the server, and flip a payload bit of
+ * the segment picked to be corrupted.
+ */
+static void link_inspect(struct net_pkt *pkt)
+{
+	struct net_tcp_hdr hdr;
+	size_t data_len;
+	u8_t byte;
+
+	net_pkt_cursor_init(pkt);
+	net_pkt_set_overwrite(pkt, true);
+
+	if (net_pkt_skip(pkt, net_pkt_ip_hdr_len(pkt)) ||
+	    net_pkt_read(pkt, &hdr, sizeof(hdr))) {
+		return;
+	}
+
+	net_pkt_cursor_init(pkt);
+	net_pkt_skip(pkt, net_pkt_ip_hdr_len(pkt) + NET_TCP_HDR_LEN(&hdr));
+	data_len = net_pkt_remaining_data(pkt);
+
+	if (ntohs(hdr.src_port) != SERVER_PORT && data_len &&
+	    ++link.data_segs == link.corrupt) {
+		net_pkt_skip(pkt, data_len / 2);
+		net_pkt_read_u8(pkt, &byte);
+
+		net_pkt_cursor_init(pkt);
+		net_pkt_skip(pkt, net_pkt_ip_hdr_len(pkt) +
+			     NET_TCP_HDR_LEN(&hdr) + data_len / 2);
+		net_pkt_write_u8(pkt, byte ^ 0x01);
+	}
+
+	net_pkt_cursor_init(pkt);
+}
+
+static int reflect_dev_init(struct device *dev)
+{
+	ARG_UNUSED(dev);
+
+	return 0;
+}
+
+static void reflect_iface_init(struct net_if *iface)
+{
+	static u8_t mac[] = { 0x00, 0x00, 0x5e, 0x00, 0x53, 0x01 };
+
+	net_if_set_link_addr(iface, mac, sizeof(mac), NET_LINK_DUMMY);
+}
+
+/* Reflect every packet back to us with the addresses swapped, so that
+ * a connection to peer_addr ends up on a local listener.
+ */
+static int reflect_send(struct device *dev, struct net_pkt *pkt)
+{
+	struct net_pkt *cloned;
+	struct in_addr addr;
+
+	ARG_UNUSED(dev);
+
+	cloned = net_pkt_clone(pkt, K_MSEC(100));
+	if (!cloned) {
+		return -ENOMEM;
+	}
+
+	link_inspect(cloned);
+
+	net_ipaddr_copy(&addr, &NET_IPV4_HDR(cloned)->src);
+	net_ipaddr_copy(&NET_IPV4_HDR(cloned)->src,
+			&NET_IPV4_HDR(cloned)->dst);
+	net_ipaddr_copy(&NET_IPV4_HDR(cloned)->dst, &addr);
+
+	if (link.hold && link.held_count < SEG_COUNT) {
+		link.held[link.held_count++] = cloned;
+		return 0;
+	}
+
+	if (net_recv_data(net_pkt_iface(cloned), cloned) < 0) {
+		net_pkt_unref(cloned);
+	}
+
+	return 0;
+}
+
+static struct dummy_api reflect_api = {
+	.iface_api.init = reflect_iface_init,
+	.send = reflect_send,
+};
+
+NET_DEVICE_INIT(reflect, "reflect", reflect_dev_init, NULL, NULL,
+		CONFIG_KERNEL_INIT_PRIORITY_DEFAULT, &reflect_api, DUMMY_L2,
+		NET_L2_GET_CTX_TYPE(DUMMY_L2), 1280);
+
+static void test_setup(void)
+{
+	struct net_if *iface = net_if_get_default();
+	int i;
+
+	zassert_not_null(net_if_ipv4_addr_add(iface, &my_addr,
+					      NET_ADDR_MANUAL, 0),
+			 "Cannot add address");
+	net_if_ipv4_set_netmask(iface, &netmask);
+
+	for (i = 0; i < sizeof(tx_data); i++) {
+		tx_data[i] = i * 7;
+	}
+}
+
+/* Receive the packets kept back by the link before the Rx side gets to
+ * run, the way a driver hands over a burst of frames.
+ */
+static void release_held(void)
+{
+	int i;
+
+	k_sched_lock();
+
+	for (i = 0; i < link.held_count; i++) {
+		if (net_recv_data(net_pkt_iface(link.held[i]),
+				  link.held[i]) < 0) {
+			net_pkt_unref(link.held[i]);
+		}
+	}
+
+	link.held_count = 0;
+	link.hold = false;
+
+	k_sched_unlock();
+}
+
+/* Send SEG_COUNT segments that the link delivers together, so that they
+ * are queued together, and check they all arrive in order.
+ */
+static void transfer(int corrupt)
+{
+	struct sockaddr_in server_addr = {
+		.sin_family = AF_INET,
+		.sin_port = htons(SERVER_PORT),
+	};
+	struct sockaddr_in peer = {
+		.sin_family = AF_INET,
+		.sin_port = htons(SERVER_PORT),
+	};
+	struct net_gro_stats before, after;
+	size_t received = 0;
+	int server, client, conn;
+	s64_t start;
+	int i;
+
+	(void)memset(rx_data, 0, sizeof(rx_data));
+
+	net_ipaddr_copy(&server_addr.sin_addr, &my_addr);
+	net_ipaddr_copy(&peer.sin_addr, &peer_addr);
+
+	server = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	zassert_true(server >= 0, "socket failed");
+	client = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	zassert_true(client >= 0, "socket failed");
+
+	zassert_equal(bind(server, (struct sockaddr *)&server_addr,
+			   sizeof(server_addr)), 0, "bind failed");
+	zassert_equal(listen(server, 1), 0, "listen failed");
+	zassert_equal(connect(client, (struct sockaddr *)&peer,
+			      sizeof(peer)), 0, "connect failed");
+
+	conn = accept(server, NULL, NULL);
+	zassert_true(conn >= 0, "accept failed");
+
+	/* Let the handshake ACKs go before counting */
+	k_sleep(K_MSEC(50));
+
+	(void)memset(&link, 0, sizeof(link));
+	link.corrupt = corrupt;
+	link.hold = true;
+	net_gro_stats_get(&before);
+
+	for (i = 0; i < SEG_COUNT; i++) {
+		zassert_equal(send(client, tx_data + i * SEG_LEN, SEG_LEN, 0),
+			      SEG_LEN, "send failed");
+	}
+
+	start = k_uptime_get();
+
+	while (link.held_count < SEG_COUNT &&
+	       k_uptime_get() - start < RECV_TIMEOUT_MS) {
+		k_sleep(K_MSEC(1));
+	}
+
+	zassert_equal(link.held_count, SEG_COUNT, "%d segments sent",
+		      link.held_count);
+
+	release_held();
+
+	start = k_uptime_get();
+
+	while (received < sizeof(rx_data) &&
+	       k_uptime_get() - start < RECV_TIMEOUT_MS) {
+		ssize_t ret;
+
+		ret = recv(conn, rx_data + received,
+			   sizeof(rx_data) - received, MSG_DONTWAIT);
+		if (ret > 0) {
+			received += ret;
+		} else {
+			k_sleep(K_MSEC(10));
+		}
+	}
+
+	zassert_equal(received, sizeof(rx_data), "received %zu of %zu",
+		      received, sizeof(rx_data));
+	zassert_mem_equal(rx_data, tx_data, sizeof(rx_data),
+			  "data corrupted or reordered");
+
+	net_gro_stats_get(&after);
+	zassert_true(after.segs - before.segs > 1, "no segment merged");
+
+	if (corrupt) {
+		/* The batch with the bad segment is dropped as a whole */
+		zassert_true(link.data_segs > SEG_COUNT,
+			     "corrupted segment not retransmitted");
+	} else {
+		zassert_equal(link.data_segs, SEG_COUNT,
+			      "%d data segments sent", link.data_segs);
+	}
+
+	zassert_equal(close(client), 0, "close failed");
+	zassert_equal(close(conn), 0, "close failed");
+	zassert_equal(close(server), 0, "close failed");
+
+	/* Let the connections go through TIME_WAIT */
+	k_sleep(K_MSEC(CONFIG_NET_TCP_TIME_WAIT_DELAY * 4));
+}
+
+static void test_merge(void)
+{
+	transfer(0);
+}
+
+static void test_corrupted(void)
+{
+	transfer(3);
+}
+
+void test_main(void)
+{
+	ztest_test_suite(net_tcp_gro,
+			 ztest_unit_test(test_setup),
+			 ztest_unit_test(test_merge),
+			 ztest_unit_test(test_corrupted));
+
+	ztest_run_test_suite(net_tcp_gro);
+}
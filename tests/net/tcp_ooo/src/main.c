@@ -0,0 +1,641 @@
+/* main.c - Application main entry point */
+
+/*
+ * Copyright (c) 2019 Linaro Limited
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <logging/log.h>
+LOG_MODULE_REGISTER(net_test, CONFIG_NET_TCP_LOG_LEVEL);
+
+#include <zephyr.h>
+#include <ztest.h>
+#include <string.h>
+
+#include <net/net_pkt.h>
+#include <net/net_if.h>
+#include <net/dummy.h>
+#include <net/socket.h>
+
+#include "tcp_internal.h"
+
+#if defined(CONFIG_NET_TCP_RTT_ESTIMATION)
+extern void net_tcp_rtt_sample(struct net_tcp *tcp, u32_t rtt);
+#endif
+#if defined(CONFIG_NET_TCP_CONGESTION_CONTROL)
+extern void net_tcp_cc_init(struct net_tcp *tcp);
+extern void net_tcp_cc_ack(struct net_tcp *tcp, u32_t ack, bool pure_ack);
+extern void net_tcp_cc_timeout(struct net_tcp *tcp);
+#endif
+
+#define SERVER_PORT 4242
+#define SEG_LEN 64
+#define SEG_COUNT 8
+#define MAX_DROPS 2
+
+#define RECV_TIMEOUT_MS 5000
+
+/* Initial sequence number of the congestion control tests, close to the
+ * wrap so that the sequence comparisons are exercised too.
+ */
+#define CC_ISS 0xffffe000U
+#define CC_MSS 1000U
+
+/* Our own address, and the one the lossy link reflects back to us */
+static struct in_addr my_addr = { { { 192, 0, 2, 1 } } };
+static struct in_addr peer_addr = { { { 192, 0, 2, 2 } } };
+static struct in_addr netmask = { { { 255, 255, 255, 0 } } };
+
+/* Link state, protected by the fact that the test thread only looks at
+ * it once the transfer is over.
+ */
+static struct {
+	/* Indexes (1-based) of the data segments to lose */
+	int drop[MAX_DROPS];
+	int data_segs;
+	u32_t seq_seen[SEG_COUNT * 2];
+	int retransmits;
+	s64_t drop_time;
+	s64_t retransmit_time;
+	int syn_sack_perm;
+	int ack_sack;
+} link;
+
+/* Established connections seen by tcp_check_cb() */
+static int tcp_conns;
+
+/* Connection state driven directly by the congestion control tests */
+static struct net_tcp cc_tcp;
+
+static u8_t tx_data[SEG_LEN * SEG_COUNT];
+static u8_t rx_data[SEG_LEN * SEG_COUNT];
+
+static void link_inspect_opts(struct net_pkt *pkt, struct net_tcp_hdr *hdr)
+{
+	int optlen = NET_TCP_HDR_LEN(hdr) - sizeof(struct net_tcp_hdr);
+	u8_t opt, len;
+
+	while (optlen > 0 && !net_pkt_read_u8(pkt, &opt)) {
+		optlen--;
+
+		if (opt == NET_TCP_END_OPT) {
+			break;
+		} else if (opt == NET_TCP_NOP_OPT) {
+			continue;
+		}
+
+		if (net_pkt_read_u8(pkt, &len) || len < 2) {
+			break;
+		}
+
+		if (opt == NET_TCP_SACK_PERM_OPT &&
+		    (NET_TCP_FLAGS(hdr) & NET_TCP_SYN)) {
+			link.syn_sack_perm++;
+		} else if (opt == NET_TCP_SACK_OPT) {
+			link.ack_sack++;
+		}
+
+		net_pkt_skip(pkt, len - 2);
+		optlen -= len - 1;
+	}
+}
+
+/* Returns true if the segment is lost on the link. */
+static bool link_inspect(struct net_pkt *pkt)
+{
+	struct net_tcp_hdr hdr;
+	size_t data_len;
+	u32_t seq;
+	bool drop = false;
+	int i;
+
+	net_pkt_cursor_init(pkt);
+	net_pkt_set_overwrite(pkt, true);
+
+	if (net_pkt_skip(pkt, net_pkt_ip_hdr_len(pkt)) ||
+	    net_pkt_read(pkt, &hdr, sizeof(hdr))) {
+		return false;
+	}
+
+	link_inspect_opts(pkt, &hdr);
+
+	net_pkt_cursor_init(pkt);
+	net_pkt_skip(pkt, net_pkt_ip_hdr_len(pkt) + NET_TCP_HDR_LEN(&hdr));
+	data_len = net_pkt_remaining_data(pkt);
+	net_pkt_cursor_init(pkt);
+
+	if (!data_len) {
+		return false;
+	}
+
+	seq = sys_get_be32(hdr.seq);
+
+	for (i = 0; i < link.data_segs; i++) {
+		if (link.seq_seen[i] == seq) {
+			if (!link.retransmits++) {
+				link.retransmit_time = k_uptime_get();
+			}
+
+			return false;
+		}
+	}
+
+	if (link.data_segs == ARRAY_SIZE(link.seq_seen)) {
+		return false;
+	}
+
+	link.seq_seen[link.data_segs++] = seq;
+
+	for (i = 0; i < MAX_DROPS; i++) {
+		if (link.drop[i] == link.data_segs) {
+			drop = true;
+		}
+	}
+
+	if (drop && !link.drop_time) {
+		link.drop_time = k_uptime_get();
+	}
+
+	return drop;
+}
+
+static int lossy_dev_init(struct device *dev)
+{
+	ARG_UNUSED(dev);
+
+	return 0;
+}
+
+static void lossy_iface_init(struct net_if *iface)
+{
+	static u8_t mac[] = { 0x00, 0x00, 0x5e, 0x00, 0x53, 0x01 };
+
+	net_if_set_link_addr(iface, mac, sizeof(mac), NET_LINK_DUMMY);
+}
+
+/* Reflect every packet back to us with the addresses swapped, so that
+ * a connection to peer_addr ends up on a local listener, unless the
+ * segment is picked to be lost.
+ */
+static int lossy_send(struct device *dev, struct net_pkt *pkt)
+{
+	struct net_pkt *cloned;
+	struct in_addr addr;
+
+	ARG_UNUSED(dev);
+
+	if (link_inspect(pkt)) {
+		return 0;
+	}
+
+	cloned = net_pkt_clone(pkt, K_MSEC(100));
+	if (!cloned) {
+		return -ENOMEM;
+	}
+
+	net_ipaddr_copy(&addr, &NET_IPV4_HDR(cloned)->src);
+	net_ipaddr_copy(&NET_IPV4_HDR(cloned)->src,
+			&NET_IPV4_HDR(cloned)->dst);
+	net_ipaddr_copy(&NET_IPV4_HDR(cloned)->dst, &addr);
+
+	if (net_recv_data(net_pkt_iface(cloned), cloned) < 0) {
+		net_pkt_unref(cloned);
+	}
+
+	k_yield();
+
+	return 0;
+}
+
+static struct dummy_api lossy_api = {
+	.iface_api.init = lossy_iface_init,
+	.send = lossy_send,
+};
+
+NET_DEVICE_INIT(lossy, "lossy", lossy_dev_init, NULL, NULL,
+		CONFIG_KERNEL_INIT_PRIORITY_DEFAULT, &lossy_api, DUMMY_L2,
+		NET_L2_GET_CTX_TYPE(DUMMY_L2), 1280);
+
+static void test_setup(void)
+{
+	struct net_if *iface = net_if_get_default();
+	int i;
+
+	zassert_not_null(net_if_ipv4_addr_add(iface, &my_addr,
+					      NET_ADDR_MANUAL, 0),
+			 "Cannot add address");
+	net_if_ipv4_set_netmask(iface, &netmask);
+
+	for (i = 0; i < sizeof(tx_data); i++) {
+		tx_data[i] = i * 7;
+	}
+}
+
+#if defined(CONFIG_NET_TCP_RTT_ESTIMATION)
+static void tcp_check_cb(struct net_tcp *tcp, void *user_data)
+{
+	ARG_UNUSED(user_data);
+
+	if (net_tcp_get_state(tcp) != NET_TCP_ESTABLISHED) {
+		return;
+	}
+
+	tcp_conns++;
+
+	zassert_true(tcp->rto >= 100U && tcp->rto <= 60000U,
+		     "RTO %u out of bounds", tcp->rto);
+
+#if defined(CONFIG_NET_TCP_CONGESTION_CONTROL)
+	zassert_not_null(tcp->cc, "no congestion control");
+	zassert_true(tcp->cwnd >= tcp->send_mss, "cwnd %u below one MSS",
+		     tcp->cwnd);
+	zassert_false(tcp->flags & NET_TCP_FAST_RECOVERY,
+		      "still in fast recovery");
+#endif
+}
+#endif /* CONFIG_NET_TCP_RTT_ESTIMATION */
+
+/* Send SEG_COUNT segments over the lossy link, dropping the listed ones
+ * on first transmission, and check they all arrive in order.
+ */
+static void transfer(int drop1, int drop2)
+{
+	struct sockaddr_in server_addr = {
+		.sin_family = AF_INET,
+		.sin_port = htons(SERVER_PORT),
+	};
+	struct sockaddr_in peer = {
+		.sin_family = AF_INET,
+		.sin_port = htons(SERVER_PORT),
+	};
+	size_t received = 0;
+	s64_t start;
+	int server, client, conn;
+	int i;
+
+	(void)memset(&link, 0, sizeof(link));
+	(void)memset(rx_data, 0, sizeof(rx_data));
+
+	net_ipaddr_copy(&server_addr.sin_addr, &my_addr);
+	net_ipaddr_copy(&peer.sin_addr, &peer_addr);
+
+	server = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	zassert_true(server >= 0, "socket failed");
+	client = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	zassert_true(client >= 0, "socket failed");
+
+	zassert_equal(bind(server, (struct sockaddr *)&server_addr,
+			   sizeof(server_addr)), 0, "bind failed");
+	zassert_equal(listen(server, 1), 0, "listen failed");
+	zassert_equal(connect(client, (struct sockaddr *)&peer,
+			      sizeof(peer)), 0, "connect failed");
+
+	conn = accept(server, NULL, NULL);
+	zassert_true(conn >= 0, "accept failed");
+
+	link.drop[0] = drop1;
+	link.drop[1] = drop2;
+
+	for (i = 0; i < SEG_COUNT; i++) {
+		zassert_equal(send(client, tx_data + i * SEG_LEN, SEG_LEN, 0),
+			      SEG_LEN, "send failed");
+	}
+
+	start = k_uptime_get();
+
+	while (received < sizeof(rx_data) &&
+	       k_uptime_get() - start < RECV_TIMEOUT_MS) {
+		ssize_t ret;
+
+		ret = recv(conn, rx_data + received,
+			   sizeof(rx_data) - received, MSG_DONTWAIT);
+		if (ret > 0) {
+			received += ret;
+		} else {
+			k_sleep(K_MSEC(10));
+		}
+	}
+
+	zassert_equal(received, sizeof(rx_data), "received %zu of %zu",
+		      received, sizeof(rx_data));
+	zassert_mem_equal(rx_data, tx_data, sizeof(rx_data),
+			  "data corrupted or reordered");
+
+	/* Queued segments are delivered with the one that fills the hole,
+	 * so only the lost segments are ever sent twice.
+	 */
+	zassert_equal(link.retransmits, (drop1 ? 1 : 0) + (drop2 ? 1 : 0),
+		      "unexpected number of retransmits (%d)",
+		      link.retransmits);
+
+#if defined(CONFIG_NET_TCP_RTT_ESTIMATION)
+	tcp_conns = 0;
+	net_tcp_foreach(tcp_check_cb, NULL);
+	zassert_equal(tcp_conns, 2, "%d connections established",
+		      tcp_conns);
+#endif
+
+	zassert_equal(close(client), 0, "close failed");
+	zassert_equal(close(conn), 0, "close failed");
+	zassert_equal(close(server), 0, "close failed");
+
+	/* Let the connections go through TIME_WAIT */
+	k_sleep(K_MSEC(CONFIG_NET_TCP_TIME_WAIT_DELAY * 4));
+}
+
+static void test_no_loss(void)
+{
+	transfer(0, 0);
+}
+
+static void test_single_loss(void)
+{
+	transfer(3, 0);
+}
+
+static void test_multiple_loss(void)
+{
+	transfer(2, 5);
+}
+
+static void test_sack(void)
+{
+	if (!IS_ENABLED(CONFIG_NET_TCP_SACK)) {
+		ztest_test_skip();
+		return;
+	}
+
+	transfer(3, 0);
+
+	zassert_equal(link.syn_sack_perm, 2,
+		      "SACK not offered in both SYN and SYN-ACK");
+	zassert_true(link.ack_sack > 0, "no SACK blocks sent");
+
+	/* The hole is repaired on the first SACK, not by the timer */
+	zassert_true(link.retransmit_time - link.drop_time <
+		     CONFIG_NET_TCP_INIT_RETRANSMISSION_TIMEOUT,
+		     "retransmit took %d ms",
+		     (int)(link.retransmit_time - link.drop_time));
+}
+
+#if defined(CONFIG_NET_TCP_CONGESTION_CONTROL)
+/* A fresh connection with flight bytes sent and not acknowledged yet */
+static void cc_setup(u16_t mss, u32_t flight)
+{
+	(void)memset(&cc_tcp, 0, sizeof(cc_tcp));
+	cc_tcp.send_mss = mss;
+	cc_tcp.send_seq = CC_ISS;
+	net_tcp_cc_init(&cc_tcp);
+	cc_tcp.snd_nxt = CC_ISS + flight;
+}
+
+static void cc_dupacks(int count)
+{
+	while (count--) {
+		net_tcp_cc_ack(&cc_tcp, cc_tcp.snd_una, true);
+	}
+}
+
+static bool cc_is_newreno(void)
+{
+	return cc_tcp.cc == &net_tcp_cc_newreno;
+}
+#endif
+
+static void test_cc_slow_start(void)
+{
+#if defined(CONFIG_NET_TCP_CONGESTION_CONTROL)
+	/* Initial window, RFC 5681 section 3.1 */
+	cc_setup(2200U, 0U);
+	zassert_equal(cc_tcp.cwnd, 4400U, "cwnd %u", cc_tcp.cwnd);
+	cc_setup(1460U, 0U);
+	zassert_equal(cc_tcp.cwnd, 4380U, "cwnd %u", cc_tcp.cwnd);
+
+	cc_setup(CC_MSS, 8000U);
+	zassert_equal(cc_tcp.cwnd, 4000U, "cwnd %u", cc_tcp.cwnd);
+	zassert_equal(cc_tcp.ssthresh, UINT_MAX, "ssthresh %u",
+		      cc_tcp.ssthresh);
+
+	/* One MSS per ACK, however much it acknowledges */
+	net_tcp_cc_ack(&cc_tcp, CC_ISS + 1000U, true);
+	zassert_equal(cc_tcp.cwnd, 5000U, "cwnd %u", cc_tcp.cwnd);
+	net_tcp_cc_ack(&cc_tcp, CC_ISS + 3000U, true);
+	zassert_equal(cc_tcp.cwnd, 6000U, "cwnd %u", cc_tcp.cwnd);
+	net_tcp_cc_ack(&cc_tcp, CC_ISS + 3500U, true);
+	zassert_equal(cc_tcp.cwnd, 6500U, "cwnd %u", cc_tcp.cwnd);
+
+	/* Old and data carrying ACKs are not duplicates */
+	net_tcp_cc_ack(&cc_tcp, CC_ISS + 1000U, true);
+	net_tcp_cc_ack(&cc_tcp, CC_ISS + 3500U, false);
+	zassert_equal(cc_tcp.dupacks, 0U, "%u dupacks", cc_tcp.dupacks);
+	zassert_equal(cc_tcp.cwnd, 6500U, "cwnd %u", cc_tcp.cwnd);
+	zassert_equal(cc_tcp.snd_una, CC_ISS + 3500U, "snd_una %u",
+		      cc_tcp.snd_una);
+#else
+	ztest_test_skip();
+#endif
+}
+
+static void test_cc_fast_retransmit(void)
+{
+#if defined(CONFIG_NET_TCP_CONGESTION_CONTROL)
+	u32_t ssthresh;
+
+	cc_setup(CC_MSS, 10000U);
+	cc_tcp.cwnd = 10000U;
+
+	cc_dupacks(2);
+	zassert_equal(cc_tcp.dupacks, 2U, "%u dupacks", cc_tcp.dupacks);
+	zassert_equal(cc_tcp.cwnd, 10000U, "cwnd %u", cc_tcp.cwnd);
+	zassert_equal(cc_tcp.ssthresh, UINT_MAX, "ssthresh %u",
+		      cc_tcp.ssthresh);
+
+	/* Half the flight for NewReno, 0.7 of the window for CUBIC */
+	ssthresh = cc_is_newreno() ? 5000U : 7001U;
+
+	cc_dupacks(1);
+	zassert_true(cc_tcp.flags & NET_TCP_FAST_RECOVERY,
+		     "no fast retransmit");
+	zassert_equal(cc_tcp.ssthresh, ssthresh, "ssthresh %u",
+		      cc_tcp.ssthresh);
+	zassert_equal(cc_tcp.cwnd, ssthresh + 3000U, "cwnd %u", cc_tcp.cwnd);
+	zassert_equal(cc_tcp.recover, CC_ISS + 10000U, "recover %u",
+		      cc_tcp.recover);
+
+	/* Inflated by one MSS per further duplicate */
+	cc_dupacks(2);
+	zassert_equal(cc_tcp.cwnd, ssthresh + 5000U, "cwnd %u", cc_tcp.cwnd);
+
+	/* Partial ACK: deflated by the amount acked, plus one MSS */
+	net_tcp_cc_ack(&cc_tcp, CC_ISS + 4000U, true);
+	zassert_true(cc_tcp.flags & NET_TCP_FAST_RECOVERY,
+		     "left fast recovery on a partial ACK");
+	zassert_equal(cc_tcp.cwnd, ssthresh + 2000U, "cwnd %u", cc_tcp.cwnd);
+
+	/* Full ACK: the window is what is in flight plus one MSS */
+	cc_tcp.snd_nxt = CC_ISS + 12000U;
+	net_tcp_cc_ack(&cc_tcp, CC_ISS + 10000U, true);
+	zassert_false(cc_tcp.flags & NET_TCP_FAST_RECOVERY,
+		      "still in fast recovery");
+	zassert_equal(cc_tcp.cwnd, 3000U, "cwnd %u", cc_tcp.cwnd);
+	zassert_equal(cc_tcp.ssthresh, ssthresh, "ssthresh %u",
+		      cc_tcp.ssthresh);
+
+	/* Duplicates of the ACK that ended recovery do not start
+	 * another one (RFC 6582 section 3.2 step 2).
+	 */
+	cc_dupacks(3);
+	zassert_false(cc_tcp.flags & NET_TCP_FAST_RECOVERY,
+		      "fast retransmit for a recovered loss");
+	zassert_equal(cc_tcp.cwnd, 3000U, "cwnd %u", cc_tcp.cwnd);
+
+	/* Back in slow start below ssthresh */
+	net_tcp_cc_ack(&cc_tcp, CC_ISS + 11000U, true);
+	zassert_equal(cc_tcp.cwnd, 4000U, "cwnd %u", cc_tcp.cwnd);
+#else
+	ztest_test_skip();
+#endif
+}
+
+static void test_cc_timeout(void)
+{
+#if defined(CONFIG_NET_TCP_CONGESTION_CONTROL)
+	u32_t ssthresh;
+	int i;
+
+	cc_setup(CC_MSS, 8000U);
+	cc_tcp.cwnd = 8000U;
+	ssthresh = cc_is_newreno() ? 4000U : 5601U;
+
+	cc_tcp.retry_timeout_shift = 1U;
+	net_tcp_cc_timeout(&cc_tcp);
+	zassert_equal(cc_tcp.cwnd, CC_MSS, "cwnd %u", cc_tcp.cwnd);
+	zassert_equal(cc_tcp.ssthresh, ssthresh, "ssthresh %u",
+		      cc_tcp.ssthresh);
+
+	/* Only the first timeout of a series lowers ssthresh */
+	cc_tcp.retry_timeout_shift = 2U;
+	net_tcp_cc_timeout(&cc_tcp);
+	zassert_equal(cc_tcp.cwnd, CC_MSS, "cwnd %u", cc_tcp.cwnd);
+	zassert_equal(cc_tcp.ssthresh, ssthresh, "ssthresh %u",
+		      cc_tcp.ssthresh);
+
+	if (!cc_is_newreno()) {
+		return;
+	}
+
+	/* Slow start up to ssthresh ... */
+	for (i = 1; i <= 3; i++) {
+		net_tcp_cc_ack(&cc_tcp, CC_ISS + i * 1000U, true);
+	}
+
+	zassert_equal(cc_tcp.cwnd, 4000U, "cwnd %u", cc_tcp.cwnd);
+
+	/* ... then one MSS per window of data acknowledged */
+	for (i = 4; i <= 7; i++) {
+		zassert_equal(cc_tcp.cwnd, 4000U, "cwnd %u after %d ACKs",
+			      cc_tcp.cwnd, i - 1);
+		net_tcp_cc_ack(&cc_tcp, CC_ISS + i * 1000U, true);
+	}
+
+	zassert_equal(cc_tcp.cwnd, 5000U, "cwnd %u", cc_tcp.cwnd);
+#else
+	ztest_test_skip();
+#endif
+}
+
+static void test_cc_cubic(void)
+{
+#if defined(CONFIG_NET_TCP_CC_CUBIC)
+	cc_setup(CC_MSS, 20000U);
+	cc_tcp.cwnd = 10000U;
+	cc_tcp.ssthresh = 5000U;
+
+	/* With no previous loss the curve starts flat at cwnd, so the
+	 * growth is that of the TCP-friendly region: 9/17 MSS for a
+	 * window of data.
+	 */
+	net_tcp_cc_ack(&cc_tcp, CC_ISS + 10000U, true);
+	zassert_equal(cc_tcp.cwnd, 10529U, "cwnd %u", cc_tcp.cwnd);
+
+	/* Backs off to 0.7 of the window and remembers it as w_max */
+	cc_dupacks(3);
+	zassert_equal(cc_tcp.ssthresh, 7372U, "ssthresh %u",
+		      cc_tcp.ssthresh);
+	zassert_equal(cc_tcp.cwnd, 10372U, "cwnd %u", cc_tcp.cwnd);
+	zassert_equal(cc_tcp.cc_data.cubic.w_max, 10529U, "w_max %u",
+		      cc_tcp.cc_data.cubic.w_max);
+
+	net_tcp_cc_ack(&cc_tcp, CC_ISS + 20000U, true);
+	zassert_equal(cc_tcp.cwnd, 2000U, "cwnd %u", cc_tcp.cwnd);
+
+	/* A loss below w_max lowers it further (fast convergence) */
+	cc_tcp.snd_nxt = CC_ISS + 22000U;
+	cc_tcp.retry_timeout_shift = 1U;
+	net_tcp_cc_timeout(&cc_tcp);
+	zassert_equal(cc_tcp.cc_data.cubic.w_max, 1700U, "w_max %u",
+		      cc_tcp.cc_data.cubic.w_max);
+	zassert_equal(cc_tcp.ssthresh, 2000U, "ssthresh %u",
+		      cc_tcp.ssthresh);
+	zassert_equal(cc_tcp.cwnd, CC_MSS, "cwnd %u", cc_tcp.cwnd);
+#else
+	ztest_test_skip();
+#endif
+}
+
+static void test_rto(void)
+{
+#if defined(CONFIG_NET_TCP_RTT_ESTIMATION)
+	struct net_tcp *tcp = &cc_tcp;
+
+	(void)memset(tcp, 0, sizeof(*tcp));
+
+	/* First sample R: SRTT = R, RTTVAR = R / 2, RTO = SRTT + 4 RTTVAR */
+	net_tcp_rtt_sample(tcp, 200U);
+	zassert_equal(tcp->srtt, 200U << 3, "srtt %u", tcp->srtt);
+	zassert_equal(tcp->rttvar, 100U << 2, "rttvar %u", tcp->rttvar);
+	zassert_equal(tcp->rto, 600U, "rto %u", tcp->rto);
+
+	/* RTTVAR = 3/4 100 + 1/4 |200 - 100|, SRTT = 7/8 200 + 1/8 100 */
+	net_tcp_rtt_sample(tcp, 100U);
+	zassert_equal(tcp->srtt, 1500U, "srtt %u", tcp->srtt);
+	zassert_equal(tcp->rttvar, 400U, "rttvar %u", tcp->rttvar);
+	zassert_equal(tcp->rto, 587U, "rto %u", tcp->rto);
+
+	/* Same again, the error being taken against SRTT in whole ms */
+	net_tcp_rtt_sample(tcp, 400U);
+	zassert_equal(tcp->srtt, 1713U, "srtt %u", tcp->srtt);
+	zassert_equal(tcp->rttvar, 513U, "rttvar %u", tcp->rttvar);
+	zassert_equal(tcp->rto, 727U, "rto %u", tcp->rto);
+
+	/* Clamped to 100 ms ... */
+	(void)memset(tcp, 0, sizeof(*tcp));
+	net_tcp_rtt_sample(tcp, 10U);
+	zassert_equal(tcp->rto, 100U, "rto %u", tcp->rto);
+
+	/* ... and to 60 s */
+	(void)memset(tcp, 0, sizeof(*tcp));
+	net_tcp_rtt_sample(tcp, 30000U);
+	zassert_equal(tcp->rto, 60000U, "rto %u", tcp->rto);
+#else
+	ztest_test_skip();
+#endif
+}
+
+void test_main(void)
+{
+	ztest_test_suite(net_tcp_ooo,
+			 ztest_unit_test(test_setup),
+			 ztest_unit_test(test_no_loss),
+			 ztest_unit_test(test_single_loss),
+			 ztest_unit_test(test_multiple_loss),
+			 ztest_unit_test(test_sack),
+			 ztest_unit_test(test_cc_slow_start),
+			 ztest_unit_test(test_cc_fast_retransmit),
+			 ztest_unit_test(test_cc_timeout),
+			 ztest_unit_test(test_cc_cubic),
+			 ztest_unit_test(test_rto));
+
+	ztest_run_test_suite(net_tcp_ooo);
+}
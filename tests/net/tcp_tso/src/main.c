@@ -0,0 +1,273 @@
+/* main.c - Application main entry point */
+
+/*
+ * Copyright (c) 2019 Linaro Limited
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <logging/log.h>
+LOG_MODULE_REGISTER(net_test, CONFIG_NET_TCP_LOG_LEVEL);
+
+#include <zephyr.h>
+#include <ztest.h>
+#include <string.h>
+
+#include <net/net_pkt.h>
+#include <net/net_if.h>
+#include <net/ethernet.h>
+#include <net/socket.h>
+
+#include "net_private.h"
+
+#define SERVER_PORT 4242
+#define DATA_LEN 3000
+
+#define RECV_TIMEOUT_MS 5000
+
+/* Our own address, and the one the link reflects back to us */
+static struct in_addr my_addr = { { { 192, 0, 2, 1 } } };
+static struct in_addr peer_addr = { { { 192, 0, 2, 2 } } };
+static struct in_addr netmask = { { { 255, 255, 255, 0 } } };
+
+static u8_t my_mac[] = { 0x00, 0x00, 0x5e, 0x00, 0x53, 0x01 };
+static u8_t peer_mac[] = { 0x00, 0x00, 0x5e, 0x00, 0x53, 0x02 };
+
+/* Link state, only looked at once the transfer is over */
+static struct {
+	int tso_pkts;
+	size_t max_pkt_len;
+	int frames;
+	int oversize;
+	int bad_chksum;
+} link;
+
+static u8_t frame_buf[NET_ETH_MAX_FRAME_SIZE];
+static u8_t reflect_buf[NET_ETH_MAX_FRAME_SIZE];
+
+static u8_t tx_data[DATA_LEN];
+static u8_t rx_data[DATA_LEN];
+
+static void tso_iface_init(struct net_if *iface)
+{
+	net_if_set_link_addr(iface, my_mac, sizeof(my_mac),
+			     NET_LINK_ETHERNET);
+
+	ethernet_init(iface);
+}
+
+static enum ethernet_hw_caps tso_get_capabilities(struct device *dev)
+{
+	ARG_UNUSED(dev);
+
+	return ETHERNET_HW_TX_CHKSUM_OFFLOAD | ETHERNET_HW_TX_TSO;
+}
+
+static void check_chksums(struct net_ipv4_hdr *ip)
+{
+	size_t hdr_len = (ip->vhl & 0x0f) * 4U;
+	size_t len = ntohs(ip->len) - hdr_len;
+	u16_t sum;
+
+	if (net_chksum_add(0U, ip, hdr_len) != 0xffff) {
+		link.bad_chksum++;
+	}
+
+	if (ip->proto != IPPROTO_TCP) {
+		return;
+	}
+
+	sum = net_chksum_add(len + IPPROTO_TCP, &ip->src,
+			     2 * sizeof(struct in_addr));
+	sum = net_chksum_add(sum, (u8_t *)ip + hdr_len, len);
+	if (sum != 0xffff) {
+		link.bad_chksum++;
+	}
+}
+
+/* Check each frame the device would put on the wire, then reflect it back
+ * to us with the addresses swapped, so that a connection to peer_addr
+ * ends up on a local listener.
+ */
+static int reflect_frame(u8_t *frame, size_t len, void *user_data)
+{
+	struct net_eth_hdr *eth = (struct net_eth_hdr *)reflect_buf;
+	struct net_ipv4_hdr *ip = (struct net_ipv4_hdr *)(eth + 1);
+	struct net_if *iface = user_data;
+	struct net_pkt *pkt;
+	struct in_addr addr;
+
+	link.frames++;
+
+	if (len > NET_ETH_MAX_FRAME_SIZE) {
+		link.oversize++;
+		return -EMSGSIZE;
+	}
+
+	/* The frame is reused for the next segment, leave it as is */
+	memcpy(reflect_buf, frame, len);
+
+	check_chksums(ip);
+
+	net_ipaddr_copy(&addr, &ip->src);
+	net_ipaddr_copy(&ip->src, &ip->dst);
+	net_ipaddr_copy(&ip->dst, &addr);
+
+	memcpy(eth->dst.addr, my_mac, sizeof(my_mac));
+	memcpy(eth->src.addr, peer_mac, sizeof(peer_mac));
+
+	pkt = net_pkt_rx_alloc_with_buffer(iface, len, AF_UNSPEC, 0,
+					   K_MSEC(100));
+	if (!pkt) {
+		return -ENOMEM;
+	}
+
+	if (net_pkt_write(pkt, reflect_buf, len) ||
+	    net_recv_data(iface, pkt) < 0) {
+		net_pkt_unref(pkt);
+	}
+
+	return 0;
+}
+
+static int tso_send(struct device *dev, struct net_pkt *pkt)
+{
+	int ret;
+
+	ARG_UNUSED(dev);
+
+	if (net_pkt_tso_mss(pkt)) {
+		link.tso_pkts++;
+	}
+
+	link.max_pkt_len = MAX(link.max_pkt_len, net_pkt_get_len(pkt));
+
+	ret = net_eth_tx_offload(pkt, frame_buf, sizeof(frame_buf),
+				 reflect_frame, net_pkt_iface(pkt));
+
+	k_yield();
+
+	return ret;
+}
+
+static int tso_dev_init(struct device *dev)
+{
+	ARG_UNUSED(dev);
+
+	return 0;
+}
+
+static const struct ethernet_api tso_api = {
+	.iface_api.init = tso_iface_init,
+	.get_capabilities = tso_get_capabilities,
+	.send = tso_send,
+};
+
+ETH_NET_DEVICE_INIT(tso, "tso", tso_dev_init, NULL, NULL,
+		    CONFIG_ETH_INIT_PRIORITY, &tso_api, NET_ETH_MTU);
+
+static void test_setup(void)
+{
+	struct net_if *iface = net_if_get_default();
+	int i;
+
+	zassert_false(net_if_need_calc_tx_checksum(iface),
+		      "Checksum offload not used");
+	zassert_false(net_if_need_tcp_segmentation(iface),
+		      "TCP segmentation offload not used");
+
+	zassert_not_null(net_if_ipv4_addr_add(iface, &my_addr,
+					      NET_ADDR_MANUAL, 0),
+			 "Cannot add address");
+	net_if_ipv4_set_netmask(iface, &netmask);
+
+	for (i = 0; i < sizeof(tx_data); i++) {
+		tx_data[i] = i * 7;
+	}
+}
+
+/* Send more than an MSS with one call, and check that it reaches the
+ * device as one packet that the device splits into frames of the MTU.
+ */
+static void test_transfer(void)
+{
+	struct sockaddr_in server_addr = {
+		.sin_family = AF_INET,
+		.sin_port = htons(SERVER_PORT),
+	};
+	struct sockaddr_in peer = {
+		.sin_family = AF_INET,
+		.sin_port = htons(SERVER_PORT),
+	};
+	size_t sent = 0, received = 0;
+	int server, client, conn;
+	s64_t start;
+
+	(void)memset(&link, 0, sizeof(link));
+
+	net_ipaddr_copy(&server_addr.sin_addr, &my_addr);
+	net_ipaddr_copy(&peer.sin_addr, &peer_addr);
+
+	server = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	zassert_true(server >= 0, "socket failed");
+	client = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	zassert_true(client >= 0, "socket failed");
+
+	zassert_equal(bind(server, (struct sockaddr *)&server_addr,
+			   sizeof(server_addr)), 0, "bind failed");
+	zassert_equal(listen(server, 1), 0, "listen failed");
+	zassert_equal(connect(client, (struct sockaddr *)&peer,
+			      sizeof(peer)), 0, "connect failed");
+
+	conn = accept(server, NULL, NULL);
+	zassert_true(conn >= 0, "accept failed");
+
+	while (sent < sizeof(tx_data)) {
+		ssize_t ret;
+
+		ret = send(client, tx_data + sent, sizeof(tx_data) - sent, 0);
+		zassert_true(ret > 0, "send failed");
+		sent += ret;
+	}
+
+	start = k_uptime_get();
+
+	while (received < sizeof(rx_data) &&
+	       k_uptime_get() - start < RECV_TIMEOUT_MS) {
+		ssize_t ret;
+
+		ret = recv(conn, rx_data + received,
+			   sizeof(rx_data) - received, MSG_DONTWAIT);
+		if (ret > 0) {
+			received += ret;
+		} else {
+			k_sleep(K_MSEC(10));
+		}
+	}
+
+	zassert_equal(received, sizeof(rx_data), "received %zu of %zu",
+		      received, sizeof(rx_data));
+	zassert_mem_equal(rx_data, tx_data, sizeof(rx_data),
+			  "data corrupted or reordered");
+
+	zassert_true(link.tso_pkts > 0, "No packet to segment");
+	zassert_true(link.max_pkt_len > NET_ETH_MAX_FRAME_SIZE,
+		     "Largest packet %zu bytes", link.max_pkt_len);
+	zassert_equal(link.oversize, 0, "%d frames over the MTU",
+		      link.oversize);
+	zassert_equal(link.bad_chksum, 0, "%d bad checksums",
+		      link.bad_chksum);
+
+	zassert_equal(close(client), 0, "close failed");
+	zassert_equal(close(conn), 0, "close failed");
+	zassert_equal(close(server), 0, "close failed");
+}
+
+void test_main(void)
+{
+	ztest_test_suite(net_tcp_tso,
+			 ztest_unit_test(test_setup),
+			 ztest_unit_test(test_transfer));
+
+	ztest_run_test_suite(net_tcp_tso);
+}
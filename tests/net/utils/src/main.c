@@ -832,12 +832,151 @@ void test_addr_parse(void)
 #endif
 }
 
+/* The 16-bit word at a time algorithm of RFC 1071 */
+static u16_t ref_chksum(u16_t sum, const u8_t *data, size_t len)
+{
+	u32_t acc = sum;
+	size_t i;
+
+	for (i = 0; i < len; i++) {
+		acc += (i % 2) ? data[i] : data[i] << 8;
+	}
+
+	while (acc >> 16) {
+		acc = (acc & 0xffff) + (acc >> 16);
+	}
+
+	return acc;
+}
+
+#define CHKSUM_HDR_LEN sizeof(struct net_ipv4_hdr)
+
+static u8_t chksum_data[600];
+
+/* Split the data after the IPv4 header into fragments of the given
+ * lengths (the last one repeated), each starting "reserve" bytes into
+ * its buffer so that odd and unaligned starts get tested.
+ */
+static struct net_pkt *chksum_pkt(size_t len, const size_t *frag_lens,
+				  size_t reserve)
+{
+	struct net_pkt *pkt;
+	struct net_buf *frag;
+	size_t pos = 0, frag_len;
+
+	pkt = net_pkt_alloc(K_NO_WAIT);
+	zassert_not_null(pkt, "Cannot allocate pkt");
+
+	net_pkt_set_family(pkt, AF_INET);
+	net_pkt_set_ip_hdr_len(pkt, CHKSUM_HDR_LEN);
+
+	while (pos < CHKSUM_HDR_LEN + len) {
+		frag = net_pkt_get_frag(pkt, K_NO_WAIT);
+		zassert_not_null(frag, "Cannot allocate frag");
+
+		net_buf_reserve(frag, reserve);
+
+		frag_len = MIN(*frag_lens, net_buf_tailroom(frag));
+		frag_len = MIN(frag_len, CHKSUM_HDR_LEN + len - pos);
+
+		net_buf_add_mem(frag, chksum_data + pos, frag_len);
+		net_pkt_frag_add(pkt, frag);
+
+		pos += frag_len;
+		if (frag_lens[1]) {
+			frag_lens++;
+		}
+	}
+
+	return pkt;
+}
+
+void test_chksum(void)
+{
+	static const size_t frag_lens[][5] = {
+		{ 512, 0 },
+		{ 21, 0 },
+		{ 27, 1, 45, 0 },
+		{ 23, 32, 7, 61 },
+		{ 20, 3, 64, 0 },
+	};
+	static const size_t lens[] = { 0, 1, 2, 3, 15, 63, 64, 255, 300 };
+	struct net_pkt *pkt;
+	u16_t ref;
+	int i, j, reserve;
+
+	for (i = 0; i < sizeof(chksum_data); i++) {
+		chksum_data[i] = (i * 131U + 7U) ^ (i >> 3);
+	}
+
+	for (i = 0; i < ARRAY_SIZE(lens); i++) {
+		/* The pseudo header: addresses, protocol and length */
+		ref = ref_chksum(0U, chksum_data + 12, 8);
+		ref = ref_chksum(ref, chksum_data + CHKSUM_HDR_LEN, lens[i]);
+		ref = ref_chksum(ref, (u8_t []){ 0, IPPROTO_UDP,
+						 lens[i] >> 8, lens[i] }, 4);
+		ref = htons(ref ? ref : 0xffff);
+		ref = ~ref;
+
+		for (j = 0; j < ARRAY_SIZE(frag_lens); j++) {
+			for (reserve = 0; reserve < 4; reserve++) {
+				pkt = chksum_pkt(lens[i], frag_lens[j],
+						 reserve);
+
+				zassert_equal(net_calc_chksum(pkt, IPPROTO_UDP),
+					      ref, "len %zu frags %d reserve %d",
+					      lens[i], j, reserve);
+
+				net_pkt_unref(pkt);
+			}
+		}
+	}
+}
+
+void test_chksum_update(void)
+{
+	static const u8_t new_data[] = { 0xff, 0xff, 0x00, 0x00,
+					 0x12, 0x34, 0xab, 0xcd };
+	struct net_pkt *pkt;
+	u8_t old_data[sizeof(new_data)];
+	u16_t chksum, updated;
+	int i, len;
+
+	for (i = 0; i < sizeof(chksum_data); i++) {
+		chksum_data[i] = i * 29U + 3U;
+	}
+
+	for (len = 2; len <= sizeof(new_data); len += 2) {
+		for (i = CHKSUM_HDR_LEN; i < CHKSUM_HDR_LEN + 16; i += 2) {
+			pkt = chksum_pkt(64, (size_t []){ 512, 0 }, 0);
+			chksum = net_calc_chksum(pkt, IPPROTO_UDP);
+			net_pkt_unref(pkt);
+
+			memcpy(old_data, chksum_data + i, len);
+			memcpy(chksum_data + i, new_data, len);
+
+			pkt = chksum_pkt(64, (size_t []){ 512, 0 }, 0);
+			updated = net_chksum_update(chksum, old_data,
+						    new_data, len);
+
+			zassert_equal(updated,
+				      net_calc_chksum(pkt, IPPROTO_UDP),
+				      "offset %d len %d", i, len);
+
+			net_pkt_unref(pkt);
+			memcpy(chksum_data + i, old_data, len);
+		}
+	}
+}
+
 void test_main(void)
 {
 	ztest_test_suite(test_utils_fn,
 			 ztest_unit_test(test_net_addr),
 			 ztest_user_unit_test(test_net_addr),
-			 ztest_unit_test(test_addr_parse));
+			 ztest_unit_test(test_addr_parse),
+			 ztest_unit_test(test_chksum),
+			 ztest_unit_test(test_chksum_update));
 
 	ztest_run_test_suite(test_utils_fn);
 }
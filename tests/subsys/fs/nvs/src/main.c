@@ -28,6 +28,7 @@
 #define TEST_FLASH_AREA_STORAGE_OFFSET	DT_FLASH_AREA_STORAGE_OFFSET
 #define TEST_DATA_ID			1
 #define TEST_SECTOR_COUNT		5U
+#define TEST_MANY_IDS			64U
 
 static struct nvs_fs fs;
 struct stats_hdr *sim_stats;
@@ -39,7 +40,7 @@ void setup(void)
 	sim_thresholds = stats_group_find("flash_sim_thresholds");
 
 	/* Verify if NVS is initialized. */
-	if (fs.sector_count != 0) {
+	if (fs.ready) {
 		int err;
 
 		err = nvs_clear(&fs);
@@ -596,6 +597,247 @@ void test_delete(void)
 		     " any footprint in the storage");
 }
 
+/**
+ * @brief Test case with many ids overwritten through garbage collection,
+ * then read back before and after re-initialization.
+ *
+ * With the lookup cache enabled and smaller than TEST_MANY_IDS, several ids
+ * share each cache position.
+ */
+void test_nvs_many_ids(void)
+{
+	int err;
+	ssize_t len;
+	u16_t id, round, pass;
+	u32_t data;
+
+	fs.sector_count = 3;
+
+	err = nvs_init(&fs, DT_FLASH_DEV_NAME);
+	zassert_true(err == 0,  "nvs_init call failure: %d", err);
+
+	for (round = 0; round < 8; round++) {
+		for (id = 0; id < TEST_MANY_IDS; id++) {
+			data = (round << 16) | id;
+			len = nvs_write(&fs, id, &data, sizeof(data));
+			zassert_true(len == sizeof(data),
+				     "nvs_write failed: %d", len);
+		}
+	}
+
+	for (id = 0; id < TEST_MANY_IDS; id += 3) {
+		err = nvs_delete(&fs, id);
+		zassert_true(err == 0,  "nvs_delete call failure: %d", err);
+	}
+
+	for (pass = 0; pass < 2; pass++) {
+		for (id = 0; id < TEST_MANY_IDS; id++) {
+			len = nvs_read(&fs, id, &data, sizeof(data));
+			if (id % 3 == 0) {
+				zassert_true(len == -ENOENT,
+					     "nvs_read found deleted %d", id);
+				continue;
+			}
+
+			zassert_true(len == sizeof(data),
+				     "nvs_read %d failed: %d", id, len);
+			zassert_equal(data, (7 << 16) | id,
+				      "read unexpected data: %x for %d",
+				      data, id);
+		}
+
+		err = nvs_init(&fs, DT_FLASH_DEV_NAME);
+		zassert_true(err == 0,  "nvs_init call failure: %d", err);
+	}
+}
+
+/**
+ * @brief Test case with more ids than the lookup cache holds, most of which
+ * are deleted again. Once garbage collection has dropped them from flash,
+ * the cache holds every id left and no longer sends misses to flash.
+ */
+void test_nvs_lookup_cache_overflow(void)
+{
+#ifdef CONFIG_NVS_LOOKUP_CACHE
+	int err;
+	ssize_t len;
+	u16_t id, round;
+	u32_t data;
+
+	fs.sector_count = 3;
+
+	err = nvs_init(&fs, DT_FLASH_DEV_NAME);
+	zassert_true(err == 0,  "nvs_init call failure: %d", err);
+
+	for (id = 0; id < 2 * CONFIG_NVS_LOOKUP_CACHE_SIZE; id++) {
+		data = id;
+		len = nvs_write(&fs, id, &data, sizeof(data));
+		zassert_true(len == sizeof(data), "nvs_write failed: %d", len);
+	}
+	zassert_true(fs.lookup_cache_full, "lookup cache didn't overflow");
+
+	for (id = CONFIG_NVS_LOOKUP_CACHE_SIZE / 2;
+	     id < 2 * CONFIG_NVS_LOOKUP_CACHE_SIZE; id++) {
+		err = nvs_delete(&fs, id);
+		zassert_true(err == 0,  "nvs_delete call failure: %d", err);
+	}
+
+	/* rewrite the ids left until every sector was garbage collected */
+	for (round = 1; fs.lookup_cache_full && round < 1000; round++) {
+		for (id = 0; id < CONFIG_NVS_LOOKUP_CACHE_SIZE / 2; id++) {
+			data = (round << 16) | id;
+			len = nvs_write(&fs, id, &data, sizeof(data));
+			zassert_true(len == sizeof(data),
+				     "nvs_write failed: %d", len);
+		}
+	}
+	zassert_false(fs.lookup_cache_full, "lookup cache still overflowed");
+
+	for (id = 0; id < 2 * CONFIG_NVS_LOOKUP_CACHE_SIZE; id++) {
+		len = nvs_read(&fs, id, &data, sizeof(data));
+		if (id >= CONFIG_NVS_LOOKUP_CACHE_SIZE / 2) {
+			zassert_true(len == -ENOENT,
+				     "nvs_read found deleted %d", id);
+			continue;
+		}
+
+		zassert_true(len == sizeof(data), "nvs_read %d failed: %d",
+			     id, len);
+		zassert_equal(data, ((round - 1) << 16) | id,
+			      "read unexpected data: %x for %d", data, id);
+	}
+#else
+	ztest_test_skip();
+#endif
+}
+
+/**
+ * @brief Test case with writes spaced out so that background garbage
+ * collection frees the sectors before the writes fill them up.
+ */
+void test_nvs_gc_background(void)
+{
+#if defined(CONFIG_NVS_GC_BACKGROUND) && defined(CONFIG_NVS_GC_STATS)
+	int err;
+	struct nvs_gc_stats before, stats;
+	const u16_t max_id = 10;
+	const u16_t max_writes = 10000;
+	u16_t i;
+
+	fs.sector_count = TEST_SECTOR_COUNT;
+
+	err = nvs_init(&fs, DT_FLASH_DEV_NAME);
+	zassert_true(err == 0,  "nvs_init call failure: %d", err);
+
+	/* the counters include the earlier test cases */
+	err = nvs_gc_stats_get(&fs, &before);
+	zassert_true(err == 0,  "nvs_gc_stats_get call failure: %d", err);
+
+	for (i = 0; i < max_writes; i++) {
+		/* the data of check_content() must fit in a byte */
+		write_content(max_id, i % 250, i % 250 + 1, &fs);
+
+		/* let background garbage collection run */
+		k_sleep(K_MSEC(1));
+
+		err = nvs_gc_stats_get(&fs, &stats);
+		zassert_true(err == 0,  "nvs_gc_stats_get call failure: %d",
+			     err);
+		if (stats.gc_sectors - before.gc_sectors >=
+		    2 * TEST_SECTOR_COUNT) {
+			break;
+		}
+	}
+
+	zassert_true(i < max_writes, "garbage collection did not run");
+	zassert_equal(stats.gc_write_sectors, before.gc_write_sectors,
+		      "%u sectors garbage collected by writes",
+		      stats.gc_write_sectors - before.gc_write_sectors);
+	zassert_equal(stats.free_sectors,
+		      MIN(CONFIG_NVS_GC_FREE_SECTORS, TEST_SECTOR_COUNT - 3),
+		      "%u sectors freed", stats.free_sectors);
+	zassert_true(stats.gc_bytes - before.gc_bytes <
+		     stats.write_bytes - before.write_bytes,
+		     "unexpected write amplification");
+
+	check_content(max_id, &fs);
+
+	err = nvs_init(&fs, DT_FLASH_DEV_NAME);
+	zassert_true(err == 0,  "nvs_init call failure: %d", err);
+
+	check_content(max_id, &fs);
+#else
+	ztest_test_skip();
+#endif
+}
+
+/*
+ * Test that clearing or initializing again a file system is safe while a
+ * background garbage collection step is queued.
+ */
+void test_nvs_gc_background_reinit(void)
+{
+#if defined(CONFIG_NVS_GC_BACKGROUND)
+	int err;
+	ssize_t len;
+	u8_t buf[32];
+	const u16_t max_id = 10;
+#if defined(CONFIG_NVS_GC_STATS)
+	struct nvs_gc_stats stats;
+#endif
+
+	fs.sector_count = TEST_SECTOR_COUNT;
+
+	err = nvs_init(&fs, DT_FLASH_DEV_NAME);
+	zassert_true(err == 0,  "nvs_init call failure: %d", err);
+
+	/* fill sectors, the garbage collection thread does not run yet */
+	for (u16_t i = 0; i < 100; i++) {
+		write_content(max_id, i % 250, i % 250 + 1, &fs);
+	}
+
+	err = nvs_clear(&fs);
+	zassert_true(err == 0,  "nvs_clear call failure: %d", err);
+
+	len = nvs_write(&fs, 1, buf, sizeof(buf));
+	zassert_true(len == -EACCES, "nvs_write after nvs_clear: %d", len);
+	len = nvs_read(&fs, 1, buf, sizeof(buf));
+	zassert_true(len == -EACCES, "nvs_read after nvs_clear: %d", len);
+
+	/* a queued step must not touch the cleared flash */
+	k_sleep(K_MSEC(10));
+
+	err = nvs_init(&fs, DT_FLASH_DEV_NAME);
+	zassert_true(err == 0,  "nvs_init call failure: %d", err);
+
+#if defined(CONFIG_NVS_GC_STATS)
+	/* the sectors of the cleared flash need no garbage collection */
+	err = nvs_gc_stats_get(&fs, &stats);
+	zassert_true(err == 0,  "nvs_gc_stats_get call failure: %d", err);
+	zassert_equal(stats.free_sectors,
+		      MIN(CONFIG_NVS_GC_FREE_SECTORS, TEST_SECTOR_COUNT - 3),
+		      "%u blank sectors counted", stats.free_sectors);
+#endif
+
+	len = nvs_read(&fs, 1, buf, sizeof(buf));
+	zassert_true(len == -ENOENT, "nvs_read of a cleared id: %d", len);
+
+	for (u16_t i = 0; i < 100; i++) {
+		write_content(max_id, i % 250, i % 250 + 1, &fs);
+	}
+
+	/* initialize again with a step queued, then let it run */
+	err = nvs_init(&fs, DT_FLASH_DEV_NAME);
+	zassert_true(err == 0,  "nvs_init call failure: %d", err);
+
+	k_sleep(K_MSEC(10));
+
+	check_content(max_id, &fs);
+#else
+	ztest_test_skip();
+#endif
+}
+
 void test_main(void)
 {
 	ztest_test_suite(test_nvs,
@@ -615,7 +857,16 @@ void test_main(void)
 			 ztest_unit_test_setup_teardown(test_nvs_full_sector,
 				 setup, teardown),
 			 ztest_unit_test_setup_teardown(test_delete, setup,
-				 teardown)
+				 teardown),
+			 ztest_unit_test_setup_teardown(test_nvs_many_ids,
+				 setup, teardown),
+			 ztest_unit_test_setup_teardown(
+				 test_nvs_lookup_cache_overflow, setup,
+				 teardown),
+			 ztest_unit_test_setup_teardown(test_nvs_gc_background,
+				 setup, teardown),
+			 ztest_unit_test_setup_teardown(
+				 test_nvs_gc_background_reinit, setup, teardown)
 			);
 
 	ztest_run_test_suite(test_nvs);
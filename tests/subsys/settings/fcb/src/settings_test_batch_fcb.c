@@ -0,0 +1,180 @@
+/*
+ * Copyright (c) 2019 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "settings_test.h"
+#include "settings_priv.h"
+#include "settings/settings_fcb.h"
+
+#if defined(CONFIG_SETTINGS_BATCH)
+static int count_entries_cb(struct fcb_entry_ctx *loc_ctx, void *arg)
+{
+	int *count = arg;
+
+	(*count)++;
+	return 0;
+}
+
+static int count_entries(struct settings_fcb *cf)
+{
+	int count = 0;
+	int rc;
+
+	rc = fcb_walk(&cf->cf_fcb, NULL, count_entries_cb, &count);
+	zassert_true(rc == 0, "fcb walk error");
+
+	return count;
+}
+
+/*
+ * A batch cut by a reset before its commit marker is not loaded, not even
+ * once the sectors holding it are compressed, while a committed one is.
+ */
+static void test_config_batch_fcb_reset(struct settings_fcb *cf,
+					u64_t val64_saved)
+{
+	const struct settings_store_itf *itf = cf->cf_store.cs_itf;
+	char str[SETTINGS_MAX_VAL_LEN];
+	char name[16];
+	u16_t first_id;
+	u8_t val;
+	int rc;
+
+	snprintk(name, sizeof(name), "%c", SETTINGS_BATCH_BEGIN);
+	rc = itf->csi_save(&cf->cf_store, name, NULL, 0);
+	zassert_true(rc == 0, "fcb write error");
+
+	val = 9U;
+	snprintk(name, sizeof(name), "%cmyfoo/mybar", SETTINGS_BATCH_PREFIX);
+	rc = itf->csi_save(&cf->cf_store, name, (const char *)&val,
+			   sizeof(val));
+	zassert_true(rc == 0, "fcb write error");
+
+	val8 = 0U;
+	rc = settings_load();
+	zassert_true(rc == 0, "fcb read error");
+	zassert_true(val8 == 2U, "value of a batch not committed read");
+
+	rc = settings_batch_begin();
+	zassert_true(rc == 0, "batch begin error");
+	val = 3U;
+	rc = settings_save_one("myfoo/mybar", &val, sizeof(val));
+	zassert_true(rc == 0, "batch save error");
+	rc = settings_save_one("myfoo/mybar64", &val64_saved,
+			       sizeof(val64_saved));
+	zassert_true(rc == 0, "batch save error");
+	rc = settings_batch_commit();
+	zassert_true(rc == 0, "batch commit error");
+
+	c2_var_count = 1;
+	(void)memset(str, 0, sizeof(str));
+	first_id = cf->cf_fcb.f_active_id;
+
+	while (cf->cf_fcb.f_active_id - first_id < ARRAY_SIZE(fcb_sectors)) {
+		str[0]++;
+		rc = settings_save_one("2nd/string0", str, sizeof(str) - 1);
+		zassert_true(rc == 0, "fcb write error");
+	}
+
+	val8 = 0U;
+	val64 = 0U;
+	rc = settings_load();
+	zassert_true(rc == 0, "fcb read error");
+	zassert_true(val8 == 3U, "bad value read");
+	zassert_true(val64 == val64_saved, "bad value read");
+}
+#endif
+
+/*
+ * Batched saves only write the last value of each name, and only if it
+ * changed.
+ */
+void test_config_batch_fcb(void)
+{
+#if defined(CONFIG_SETTINGS_BATCH)
+	int rc;
+	struct settings_fcb cf;
+	u8_t val;
+	u64_t val64_saved = 0x8765432112345678;
+
+	config_wipe_srcs();
+	config_wipe_fcb(fcb_sectors, ARRAY_SIZE(fcb_sectors));
+
+	cf.cf_fcb.f_magic = CONFIG_SETTINGS_FCB_MAGIC;
+	cf.cf_fcb.f_sectors = fcb_sectors;
+	cf.cf_fcb.f_sector_cnt = ARRAY_SIZE(fcb_sectors);
+
+	rc = settings_fcb_src(&cf);
+	zassert_true(rc == 0, "can't register FCB as configuration source");
+
+	rc = settings_fcb_dst(&cf);
+	zassert_true(rc == 0,
+		     "can't register FCB as configuration destination");
+
+	rc = settings_batch_begin();
+	zassert_true(rc == 0, "batch begin error");
+	rc = settings_batch_begin();
+	zassert_true(rc == -EBUSY, "nested batch begin");
+
+	val = 1U;
+	rc = settings_save_one("myfoo/mybar", &val, sizeof(val));
+	zassert_true(rc == 0, "batch save error");
+	val = 2U;
+	rc = settings_save_one("myfoo/mybar", &val, sizeof(val));
+	zassert_true(rc == 0, "batch save error");
+	rc = settings_save_one("myfoo/mybar64", &val64_saved,
+			       sizeof(val64_saved));
+	zassert_true(rc == 0, "batch save error");
+
+	zassert_equal(count_entries(&cf), 0, "batch written before commit");
+
+	rc = settings_batch_commit();
+	zassert_true(rc == 0, "batch commit error");
+	zassert_equal(count_entries(&cf), 4,
+		      "values not written between markers");
+
+	val8 = 0U;
+	val64 = 0U;
+	rc = settings_load();
+	zassert_true(rc == 0, "fcb read error");
+	zassert_true(val8 == 2U, "bad value read");
+	zassert_true(val64 == val64_saved, "bad value read");
+
+	/*
+	 * Only the delete is written, mybar has not changed, and as a single
+	 * record it needs no markers.
+	 */
+	rc = settings_batch_begin();
+	zassert_true(rc == 0, "batch begin error");
+	rc = settings_save_one("myfoo/mybar", &val, sizeof(val));
+	zassert_true(rc == 0, "batch save error");
+	rc = settings_delete("myfoo/mybar64");
+	zassert_true(rc == 0, "batch delete error");
+	rc = settings_batch_commit();
+	zassert_true(rc == 0, "batch commit error");
+	zassert_equal(count_entries(&cf), 5, "unexpected number of entries");
+
+	/* Nothing is written on abort */
+	rc = settings_batch_begin();
+	zassert_true(rc == 0, "batch begin error");
+	val = 7U;
+	rc = settings_save_one("myfoo/mybar", &val, sizeof(val));
+	zassert_true(rc == 0, "batch save error");
+	settings_batch_abort();
+	zassert_equal(count_entries(&cf), 5, "unexpected number of entries");
+
+	rc = settings_batch_commit();
+	zassert_true(rc == -EINVAL, "commit without a batch");
+
+	val8 = 0U;
+	rc = settings_load();
+	zassert_true(rc == 0, "fcb read error");
+	zassert_true(val8 == 2U, "bad value read");
+
+	test_config_batch_fcb_reset(&cf, val64_saved);
+#else
+	ztest_test_skip();
+#endif
+}
@@ -379,6 +379,7 @@ void test_config_compress_deleted(void);
 void test_setting_raw_read(void);
 void test_setting_val_read(void);
 void test_config_save_fcb_unaligned(void);
+void test_config_batch_fcb(void);
 
 void test_main(void)
 {
@@ -409,7 +410,8 @@ void test_main(void)
 			 ztest_unit_test(test_config_save_3_fcb),
 			 ztest_unit_test(test_config_compress_reset),
 			 ztest_unit_test(test_config_save_one_fcb),
-			 ztest_unit_test(test_config_compress_deleted)
+			 ztest_unit_test(test_config_compress_deleted),
+			 ztest_unit_test(test_config_batch_fcb)
 			);
 
 	ztest_run_test_suite(test_config_fcb);
@@ -42,6 +42,21 @@ int ctest_get_call_state(void);
 
 void config_wipe_srcs(void);
 
+/* Values of the idx/<n> names, and the number of times each was loaded */
+#define SETTINGS_TEST_NVS_IDX_CNT 64
+
+extern u8_t idx_val[SETTINGS_TEST_NVS_IDX_CNT];
+extern u8_t idx_set_count[SETTINGS_TEST_NVS_IDX_CNT];
+
+int idx_save(int idx, u8_t val);
+
+/*
+ * Erase the storage area, set it up as NVS back-end cf, and register the
+ * handler of the idx/<n> names.
+ */
+struct settings_nvs;
+void config_setup_nvs(struct settings_nvs *cf);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2019 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "settings_test.h"
+#include "settings/settings_nvs.h"
+
+#if defined(CONFIG_SETTINGS_BATCH)
+#define BATCH_COUNT CONFIG_SETTINGS_BATCH_COUNT
+
+static struct settings_nvs cf;
+
+static void batch_check(void)
+{
+	int rc;
+
+	(void)memset(idx_set_count, 0, sizeof(idx_set_count));
+
+	rc = settings_load();
+	zassert_true(rc == 0, "cannot load settings");
+
+	for (int i = 0; i < BATCH_COUNT; i++) {
+		zassert_equal(idx_set_count[i], 1, "idx/%d loaded %d times",
+			      i, idx_set_count[i]);
+		zassert_equal(idx_val[i], i, "idx/%d value %d", i,
+			      idx_val[i]);
+	}
+}
+
+/* Write the journal of a commit cut by a reset, two values of idx/0 and 1 */
+static void batch_journal_write(u8_t val)
+{
+	u8_t journal[2 * (sizeof("idx/0") + sizeof(u16_t) + 1)];
+	u16_t val_len = 1U;
+	u8_t *p = journal;
+	int rc;
+
+	for (int i = 0; i < 2; i++) {
+		p += snprintk((char *)p, sizeof("idx/0"), "idx/%d", i) + 1;
+		memcpy(p, &val_len, sizeof(val_len));
+		p += sizeof(val_len);
+		*p++ = val + i;
+	}
+
+	rc = nvs_write(&cf.cf_nvs, NVS_JOURNAL_ID, journal, sizeof(journal));
+	zassert_true(rc == sizeof(journal), "cannot write journal");
+}
+#endif
+
+/*
+ * NVS writes all the values of a batch to a journal entry first, and writes
+ * them again on init when a reset cut the commit.
+ */
+void test_config_batch_nvs(void)
+{
+#if defined(CONFIG_SETTINGS_BATCH)
+	u8_t val = 0U;
+	int rc;
+
+	config_setup_nvs(&cf);
+
+	rc = settings_batch_begin();
+	zassert_true(rc == 0, "batch begin error");
+
+	for (int i = 0; i < BATCH_COUNT; i++) {
+		rc = idx_save(i, 0);
+		zassert_true(rc == 0, "batch save error");
+	}
+
+	/* Saving a name again replaces its value */
+	for (int i = 0; i < BATCH_COUNT; i++) {
+		rc = idx_save(i, i);
+		zassert_true(rc == 0, "batch save error");
+	}
+
+	/* A new name does not fit, the batch is kept as is */
+	rc = settings_save_one("idx/extra", &val, sizeof(val));
+	zassert_true(rc == -ENOMEM, "batch overflow not detected");
+
+	rc = settings_batch_commit();
+	zassert_true(rc == 0, "batch commit error");
+
+	rc = nvs_read(&cf.cf_nvs, NVS_JOURNAL_ID, &val, sizeof(val));
+	zassert_true(rc == -ENOENT, "journal left after commit");
+
+	batch_check();
+
+	batch_journal_write(100U);
+	rc = settings_nvs_backend_init(&cf);
+	zassert_true(rc == 0, "cannot initialize NVS backend");
+
+	rc = nvs_read(&cf.cf_nvs, NVS_JOURNAL_ID, &val, sizeof(val));
+	zassert_true(rc == -ENOENT, "journal left after init");
+
+	(void)memset(idx_set_count, 0, sizeof(idx_set_count));
+	rc = settings_load();
+	zassert_true(rc == 0, "cannot load settings");
+	zassert_true(idx_val[0] == 100U && idx_val[1] == 101U,
+		     "journal not written on init");
+	zassert_true(idx_val[2] == 2U, "value not in the journal changed");
+#else
+	ztest_test_skip();
+#endif
+}
@@ -5,9 +5,12 @@
  */
 #include <stdlib.h>
 #include <string.h>
+#include <drivers/flash.h>
+#include <storage/flash_map.h>
 
 #include "settings_priv.h"
 #include "settings_test.h"
+#include "settings/settings_nvs.h"
 
 u8_t val8;
 u8_t val8_un;
@@ -163,6 +166,76 @@ void config_wipe_srcs(void)
 	settings_save_dst = NULL;
 }
 
+u8_t idx_val[SETTINGS_TEST_NVS_IDX_CNT];
+u8_t idx_set_count[SETTINGS_TEST_NVS_IDX_CNT];
+
+static int idx_handle_set(const char *name, size_t len,
+			  settings_read_cb read_cb, void *cb_arg)
+{
+	unsigned long idx;
+	char *eptr;
+	int rc;
+
+	idx = strtoul(name, &eptr, 10);
+	zassert_true(*eptr == '\0' && idx < SETTINGS_TEST_NVS_IDX_CNT,
+		     "unexpected name");
+
+	rc = read_cb(cb_arg, &idx_val[idx], sizeof(idx_val[idx]));
+	zassert_true(rc == sizeof(idx_val[idx]), "cannot read value");
+	idx_set_count[idx]++;
+
+	return 0;
+}
+
+static struct settings_handler idx_handler = {
+	.name = "idx",
+	.h_set = idx_handle_set,
+};
+
+int idx_save(int idx, u8_t val)
+{
+	char name[16];
+
+	snprintk(name, sizeof(name), "idx/%d", idx);
+	return settings_save_one(name, &val, sizeof(val));
+}
+
+void config_setup_nvs(struct settings_nvs *cf)
+{
+	const struct flash_area *fa;
+	struct flash_pages_info info;
+	int rc;
+
+	config_wipe_srcs();
+
+	rc = flash_area_open(DT_FLASH_AREA_STORAGE_ID, &fa);
+	zassert_true(rc == 0, "cannot open storage area");
+
+	flash_write_protection_set(flash_area_get_device(fa), false);
+	rc = flash_area_erase(fa, 0, fa->fa_size);
+	zassert_true(rc == 0, "cannot erase storage area");
+
+	rc = flash_get_page_info_by_offs(flash_area_get_device(fa),
+					 fa->fa_off, &info);
+	zassert_true(rc == 0, "cannot get page info");
+
+	cf->cf_nvs.offset = fa->fa_off;
+	cf->cf_nvs.sector_size = info.size;
+	cf->cf_nvs.sector_count = fa->fa_size / info.size;
+	cf->flash_dev_name = fa->fa_dev_name;
+
+	rc = settings_nvs_backend_init(cf);
+	zassert_true(rc == 0, "cannot initialize NVS backend");
+
+	rc = settings_nvs_src(cf);
+	zassert_true(rc == 0, "cannot register NVS as source");
+	rc = settings_nvs_dst(cf);
+	zassert_true(rc == 0, "cannot register NVS as destination");
+
+	rc = settings_register(&idx_handler);
+	zassert_true(rc == 0 || rc == -EEXIST, "cannot register handler");
+}
+
 char *c2_var_find(char *name)
 {
 	int idx = 0;
@@ -299,6 +372,8 @@ void test_config_getset_unknown(void);
 void test_config_getset_int(void);
 void test_config_getset_int64(void);
 void test_config_commit(void);
+void test_config_save_many_nvs(void);
+void test_config_batch_nvs(void);
 
 void test_main(void)
 {
@@ -309,7 +384,9 @@ void test_main(void)
 			 ztest_unit_test(test_config_getset_unknown),
 			 ztest_unit_test(test_config_getset_int),
 			 ztest_unit_test(test_config_getset_int64),
-			 ztest_unit_test(test_config_commit)
+			 ztest_unit_test(test_config_commit),
+			 ztest_unit_test(test_config_save_many_nvs),
+			 ztest_unit_test(test_config_batch_nvs)
 			);
 
 	ztest_run_test_suite(test_config_nvs);
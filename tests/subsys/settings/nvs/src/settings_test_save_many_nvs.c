@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2019 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "settings_test.h"
+#include "settings/settings_nvs.h"
+
+#define MANY_COUNT 40
+
+static struct settings_nvs cf;
+
+static void many_save(int idx, u8_t val)
+{
+	int rc;
+
+	rc = idx_save(idx, val);
+	zassert_true(rc == 0, "cannot save idx/%d", idx);
+}
+
+static void many_delete(int idx)
+{
+	char name[16];
+	int rc;
+
+	snprintk(name, sizeof(name), "idx/%d", idx);
+	rc = settings_delete(name);
+	zassert_true(rc == 0, "cannot delete %s", name);
+}
+
+/* Load the settings, and check each live name is set once to its value */
+static void many_check(int deleted_every, u8_t add)
+{
+	int rc;
+
+	(void)memset(idx_set_count, 0, sizeof(idx_set_count));
+
+	rc = settings_load();
+	zassert_true(rc == 0, "cannot load settings");
+
+	for (int i = 0; i < MANY_COUNT; i++) {
+		if (deleted_every && (i % deleted_every == 0)) {
+			zassert_equal(idx_set_count[i], 0, "idx/%d loaded",
+				      i);
+			continue;
+		}
+
+		zassert_equal(idx_set_count[i], 1, "idx/%d loaded %d times",
+			      i, idx_set_count[i]);
+		zassert_equal(idx_val[i], i + add, "idx/%d value %d", i,
+			      idx_val[i]);
+	}
+}
+
+/* Save, overwrite, delete and reload many names, going through the name
+ * cache when it is enabled.
+ */
+void test_config_save_many_nvs(void)
+{
+	int rc;
+
+	config_setup_nvs(&cf);
+
+	for (int i = 0; i < MANY_COUNT; i++) {
+		many_save(i, i);
+	}
+
+	many_check(0, 0);
+
+	for (int i = 0; i < MANY_COUNT; i++) {
+		many_save(i, i + 1);
+	}
+
+	for (int i = 0; i < MANY_COUNT; i += 4) {
+		many_delete(i);
+	}
+
+	many_check(4, 1);
+
+	/* Deleted names come back in the IDs they freed */
+	for (int i = 0; i < MANY_COUNT; i++) {
+		many_save(i, i + 2);
+	}
+
+	zassert_equal(cf.last_name_id, NVS_NAMECNT_ID + MANY_COUNT,
+		      "freed IDs not reused, last ID %x", cf.last_name_id);
+
+	many_check(0, 2);
+
+	/* Deleting and adding a name over and over does not use up IDs */
+	for (int i = 0; i < 2 * MANY_COUNT; i++) {
+		many_delete(1);
+		many_save(1, 1 + 2);
+	}
+
+	zassert_equal(cf.last_name_id, NVS_NAMECNT_ID + MANY_COUNT,
+		      "freed IDs not reused, last ID %x", cf.last_name_id);
+
+	rc = settings_nvs_backend_init(&cf);
+	zassert_true(rc == 0, "cannot initialize NVS backend");
+
+	for (int i = 0; i < MANY_COUNT; i += 2) {
+		many_delete(i);
+	}
+
+	many_check(2, 2);
+}